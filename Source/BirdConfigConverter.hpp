@@ -8,8 +8,10 @@
 #include "JsonCommon.hpp"
 #include "JsonSchemaProperties.hpp"
 #include "Lib/ModuleRegistry.hpp"
+#include "Lib/PrefixSet.hpp"
 #include "Lib/Utils.hpp"
 #include "Modules.hpp"
+#include "PrefixListReader.hpp"
 
 namespace BirdConfigTree {
 using namespace StdLib;
@@ -45,14 +47,24 @@ using namespace StdLib;
 class BirdConfigConverter : public IConfigConverting {
 public:
     BirdConfigConverter(const SharedPtr<ModuleRegistry>& moduleRegistry)
-      : mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_TRANSL)) {}
+      : mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_TRANSL)), mPrefixListReader(mLog) {}
     virtual ~BirdConfigConverter() = default;
+    // SetPrefixAggregation() makes the prefix sets render into fewer ranges, which match exactly the same routes
+    void SetPrefixAggregation(const bool isEnabled) { mIsPrefixAggregationEnabled = isEnabled; }
+    // Options() describes the options which change the output of Convert() for the same config
+    String Options() const { return String("aggregate-prefixes=") + (mIsPrefixAggregationEnabled ? "1" : "0"); }
     Optional<ByteStream> Convert(const ByteStream& config) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "BirdConfigConverter::Convert");
         mAlreadyTakenListName.clear();
+        mPrefixLists.clear();
         Json::JSON jConfig;
         try {
             Stack<UniquePtr<ConfigNodeRendering>> configNodes;
             jConfig = Json::JSON::parse(config);
+            if (!LoadPrefixLists(jConfig)) {
+                mLog->error("Failed to load prefix lists");
+                return {};
+            }
 
             auto birdConfig = std::make_shared<OStrStream>();
             Optional<String> birdConfigPart;
@@ -114,7 +126,7 @@ public:
             *birdConfig << birdConfigPart.value();
 
             auto birdConfigStr = birdConfig->str();
-            mLog->trace("Converted JSON config into BIRD config:\n{}", birdConfigStr);
+            LOG_TRACE(mLog, "Converted JSON config into BIRD config:\n{}", birdConfigStr);
             return ByteStream(std::begin(birdConfigStr), std::end(birdConfigStr));
         }
         catch (const Exception &ex) {
@@ -132,7 +144,11 @@ public:
 private:
     SharedPtr<ModuleRegistry> mModuleRegistry;
     SharedPtr<Log::SpdLogger> mLog;
+    PrefixListReader mPrefixListReader;
     Map<String, String> mAlreadyTakenListName;
+    // Prefix lists of the last converted config by their names, a big list takes much less memory than in JSON
+    Map<String, Utils::PrefixSet> mPrefixLists;
+    bool mIsPrefixAggregationEnabled = false;
 
     static constexpr size_t DEFAULT_INDENT = 4;
     static constexpr String NEW_LINE = "\n";
@@ -333,6 +349,10 @@ private:
             mAlreadyTakenListName[policyListName] = Property::POLICY_LIST;
             filtersSection << String(indentSize, ' ') << "filter " << policyListName << " {" << NEW_LINE;
             for (auto& [termName, termDetails] : policyDetails.items()) {
+                if (termName == Property::DEFAULT_ACTION) {
+                    continue;
+                }
+
                 auto termOutput = RenderBgpPolicyIfStatement(jConfigBgpRoot, termDetails, indentSize + DEFAULT_INDENT);
                 if (!termOutput.has_value()) {
                     mLog->error("Failed to render term '{}'", termName);
@@ -342,13 +362,11 @@ private:
                 filtersSection << termOutput.value();
             }
 
-            auto defaultActionIt = policyListIt->find(Property::DEFAULT_ACTION);
-            String defaultAction;
-            if (defaultActionIt == policyListIt->end()) {
-                defaultAction = "reject";
-            }
-            else {
-                defaultAction = defaultActionIt.value().template get<String>();
+            // The default action of the policy is one of its entries next to the terms
+            auto defaultActionIt = policyDetails.find(Property::DEFAULT_ACTION);
+            String defaultAction = "reject";
+            if ((defaultActionIt != policyDetails.end()) && (defaultActionIt.value().template get<String>() == "permit")) {
+                defaultAction = "accept";
             }
 
             filtersSection << String(indentSize + DEFAULT_INDENT, ' ') << defaultAction << ";" << NEW_LINE;
@@ -358,8 +376,62 @@ private:
         return filtersSection.str();
     }
 
+    // MakePrefixSet() reads the prefixes (JSON object) into the set, which merges the duplicates
+    Optional<Utils::PrefixSet> MakePrefixSet(const Json::JSON& jPrefixes) {
+        auto readPfxSet = mPrefixListReader.MakePrefixSet(jPrefixes);
+        if (!readPfxSet.has_value()) {
+            return {};
+        }
+
+        auto& pfxSet = readPfxSet.value();
+        if (mIsPrefixAggregationEnabled) {
+            LOG_DEBUG(mLog, "Aggregating {} prefix range(s)", pfxSet.Ranges().size());
+            pfxSet.Aggregate();
+            LOG_DEBUG(mLog, "Aggregated the prefix ranges into {}", pfxSet.Ranges().size());
+        }
+
+        pfxSet.ShrinkToFit();
+        return readPfxSet;
+    }
+
+    /*
+        LoadPrefixLists() builds the named prefix lists once per config, before anything is rendered. The prefixes of
+        the lists are released from the JSON config, only the names of the lists are left there to check references.
+    */
+    bool LoadPrefixLists(Json::JSON& jConfig) {
+        auto bgpIt = jConfig.find(Property::BGP);
+        if (bgpIt == jConfig.end()) {
+            return true;
+        }
+
+        for (const auto& propertyPrefixList : { Property::PREFIX_V4_LIST, Property::PREFIX_V6_LIST }) {
+            auto pfxIpListIt = bgpIt->find(propertyPrefixList);
+            if (pfxIpListIt == bgpIt->end()) {
+                continue;
+            }
+
+            for (auto& [pfxListName, pfxList] : pfxIpListIt->items()) {
+                if (mPrefixLists.contains(pfxListName)) {
+                    mLog->error("There is already used list name '{}' in predefined list section '{}'", pfxListName, propertyPrefixList);
+                    return false;
+                }
+
+                auto pfxSet = MakePrefixSet(pfxList);
+                if (!pfxSet.has_value()) {
+                    mLog->error("Failed to make prefix list '{}'", pfxListName);
+                    return false;
+                }
+
+                mPrefixLists.emplace(pfxListName, std::move(pfxSet.value()));
+                pfxList = Json::JSON::object();
+            }
+        }
+
+        return true;
+    }
+
     Optional<String> RenderBgpPrefixIpCommonListSection(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize,
-            const String& sectionHeader, const String& propertyPrefixList, const uint16_t maxPfxLen) {
+            const String& sectionHeader, const String& propertyPrefixList) {
         OStrStream pfxIpListSection;
         auto pfxIpListIt = jConfigParent.find(propertyPrefixList);
         if (pfxIpListIt == jConfigParent.end()) {
@@ -368,7 +440,8 @@ private:
 
         pfxIpListSection << sectionHeader << NEW_LINE;
 
-        for (auto& [pfxListName, pfxList] : pfxIpListIt->items()) {
+        for (const auto& pfxListItem : pfxIpListIt->items()) {
+            const auto& pfxListName = pfxListItem.key();
             auto listNameIt = mAlreadyTakenListName.find(pfxListName);
             if (listNameIt != mAlreadyTakenListName.end()) {
                 mLog->error("There is already used list name '{}' in predefined list section '{}'", pfxListName, listNameIt->second);
@@ -376,49 +449,11 @@ private:
             }
 
             mAlreadyTakenListName[pfxListName] = propertyPrefixList;
+            // The prefixes are rendered in the sorted order, the duplicated ranges are merged
             pfxIpListSection << "define " << pfxListName << " = [";
-            for (auto& [pfx, attrs] : pfxList.items()) {
-                pfxIpListSection << NEW_LINE << String(indentSize + DEFAULT_INDENT, ' ') << pfx;
-                auto pfxLen = static_cast<uint16_t>(std::stoi(pfx.substr(pfx.find_last_of("/") + 1)));
-                auto geIt = attrs.find(Property::PREFIX_GE_ATTR);
-                auto leIt = attrs.find(Property::PREFIX_LE_ATTR);
-                if ((geIt != attrs.end()) && (leIt != attrs.end())) {
-                    auto minPfxRange = geIt.value().template get<uint16_t>();
-                    auto maxPfxRange = leIt.value().template get<uint16_t>();
-                    if ((pfxLen > minPfxRange) || (pfxLen > maxPfxRange) || (minPfxRange > maxPfxRange)) {
-                        mLog->error("Invalid prefix range <{},{}>", minPfxRange, maxPfxRange);
-                        return {};
-                    }
-
-                    pfxIpListSection << "{" << minPfxRange << "," << maxPfxRange << "}";
-                }
-                else if (geIt != attrs.end()) {
-                    auto minPfxRange = geIt.value().template get<uint16_t>();
-                    if (pfxLen > minPfxRange) {
-                        mLog->error("Prefix len '{}' is higher than its minimum range '{}'", pfxLen, minPfxRange);
-                        return {};
-                    }
-
-                    pfxIpListSection << "{" << minPfxRange << "," << maxPfxLen << "}";
-                }
-                else if (leIt != attrs.end()) {
-                    auto maxPfxRange = leIt.value().template get<uint16_t>();
-                    if (pfxLen > maxPfxRange) {
-                        mLog->error("Prefix len '{}' is higher than its maximum range '{}'", pfxLen, maxPfxRange);
-                        return {};
-                    }
-
-                    pfxIpListSection << "{" << pfxLen << "," << maxPfxRange << "}";
-                }
-
-                pfxIpListSection << ",";
-            }
-
-            // Let's get rid of comma ',' after last entry of the list
-            const auto& pfxIpListSectionStr = pfxIpListSection.str();
-            if (pfxIpListSectionStr[pfxIpListSectionStr.size() - 1] == ',') {
-                pfxIpListSection.seekp(-1, std::ios_base::end);
-                // pfxIpListSection << '\0'; // NULL terminating string
+            auto pfxRanges = mPrefixLists.at(pfxListName).Ranges();
+            for (size_t rangeIdx = 0; rangeIdx < pfxRanges.size(); ++rangeIdx) {
+                pfxIpListSection << ((rangeIdx > 0) ? "," : "") << NEW_LINE << String(indentSize + DEFAULT_INDENT, ' ') << pfxRanges[rangeIdx].ToString();
             }
 
             pfxIpListSection << NEW_LINE << "];" << NEW_LINE;
@@ -431,14 +466,14 @@ private:
     Optional<String> RenderBgpPrefixIPv4ListSection(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
         return RenderBgpPrefixIpCommonListSection(jConfigBgpRoot, jConfigParent, indentSize,
                     "#####################\n# PREFIX-IPV4-LISTS #\n#####################",
-                    Property::PREFIX_V4_LIST, 32);
+                    Property::PREFIX_V4_LIST);
     }
 
     /** RenderBgpPrefixIPv6ListSection expects JSON data inside of "prefix-v6-list" property/node */
     Optional<String> RenderBgpPrefixIPv6ListSection(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
         return RenderBgpPrefixIpCommonListSection(jConfigBgpRoot, jConfigParent, indentSize,
                     "#####################\n# PREFIX-IPV6-LISTS #\n#####################",
-                    Property::PREFIX_V6_LIST, 128);
+                    Property::PREFIX_V6_LIST);
     }
 
     // This is section which represents conditional checks in if-statement
@@ -610,106 +645,91 @@ private:
         return RenderBgpExtCommunityCommonCheckStatement(jConfigBgpRoot, jConfigParent, indentSize, Property::EXT_COMMUNITY_IN, "~");
     }
 
-    Optional<String> RenderBgpNetEqCheckStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
-        OStrStream netCheckStmt;
-        auto netEqIt = jConfigParent.find(Property::NET_EQ);
-        if (netEqIt == jConfigParent.end()) {
+    Optional<String> RenderBgpLargeCommunityCommonCheckStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize,
+            const String& propertyCommunityCond, const String& condOp) {
+        OStrStream largeCommCheckStmt;
+        auto largeCommMatchIt = jConfigParent.find(propertyCommunityCond);
+        if (largeCommMatchIt == jConfigParent.end()) {
             return "";
         }
 
-        auto pfxIPv4It = netEqIt->find(Property::PREFIX_V4);
-        if ((pfxIPv4It != netEqIt->end()) && (pfxIPv4It->begin() != pfxIPv4It->end())) {
-            const auto& pfx = pfxIPv4It->begin().key();
-            const auto& attrs = pfxIPv4It->begin().value();
-            netCheckStmt << "(net = " << pfx;
-            auto pfxLen = static_cast<uint16_t>(std::stoi(pfx.substr(pfx.find_last_of("/") + 1)));
-            auto geIt = attrs.find(Property::PREFIX_GE_ATTR);
-            auto leIt = attrs.find(Property::PREFIX_LE_ATTR);
-            if ((geIt != attrs.end()) && (leIt != attrs.end())) {
-                auto minPfxRange = geIt.value().template get<uint16_t>();
-                auto maxPfxRange = leIt.value().template get<uint16_t>();
-                if ((pfxLen > minPfxRange) || (pfxLen > maxPfxRange) || (minPfxRange > maxPfxRange)) {
-                    mLog->error("Invalid prefix range <{},{}>", minPfxRange, maxPfxRange);
-                    return {};
-                }
+        auto largeCommListIt = largeCommMatchIt->find(Property::LARGE_COMMUNITY_LIST);
+        if (largeCommListIt != largeCommMatchIt->end()) {
+            if (!largeCommListIt->is_string()) { // Reference to predefined large-community list
+                mLog->error("Unsupported type of large community list property. Expected 'string' as predefined large community list name");
+                return {};
+            }
 
-                netCheckStmt << "{" << minPfxRange << "," << maxPfxRange << "}";
+            // Check if community list exists
+            auto largeCommListSectionIt = jConfigBgpRoot.find(Property::LARGE_COMMUNITY_LIST);
+            if (largeCommListSectionIt == jConfigBgpRoot.end()) {
+                mLog->error("Large community list section does not exist");
+                return {};
             }
-            else if (geIt != attrs.end()) {
-                auto minPfxRange = geIt.value().template get<uint16_t>();
-                if (pfxLen > minPfxRange) {
-                    mLog->error("Prefix len '{}' is higher than its minimum range '{}'", pfxLen, minPfxRange);
-                    return {};
-                }
 
-                netCheckStmt << "{" << minPfxRange << ",32}";
+            auto largeCommListName = largeCommListIt.value().template get<String>();
+            if (!largeCommListSectionIt->contains(largeCommListName)) {
+                mLog->error("Large community list '{}' does not exist", largeCommListName);
+                return {};
             }
-            else if (leIt != attrs.end()) {
-                auto maxPfxRange = leIt.value().template get<uint16_t>();
-                if (pfxLen > maxPfxRange) {
-                    mLog->error("Prefix len '{}' is higher than its maximum range '{}'", pfxLen, maxPfxRange);
-                    return {};
-                }
 
-                netCheckStmt << "{" << pfxLen << "," << maxPfxRange << "}";
+            largeCommCheckStmt << "(bgp_large_community " << condOp << " " << largeCommListName << ")";
+        }
+        else { // In-place large-community list
+            if (!largeCommMatchIt->is_array() || largeCommMatchIt->empty()) {
+                mLog->error("Unsupported type of large community list property. Expected non-empty 'array' as list of large communities");
+                return {};
+            }
+
+            auto largeCommList = largeCommMatchIt.value().template get<Vector<String>>();
+            largeCommCheckStmt << "(bgp_large_community " << condOp << " [";
+            for (size_t i = 0; i < largeCommList.size() - 1; ++i) {
+                largeCommCheckStmt << "(" << Utils::fFindAndReplaceAll(largeCommList[i], ":", ",") << "),";
             }
 
-            netCheckStmt << ")";
+            largeCommCheckStmt << "(" << Utils::fFindAndReplaceAll(largeCommList[largeCommList.size() - 1], ":", ",") << ")])";
         }
 
-        auto pfxIPv6It = netEqIt->find(Property::PREFIX_V6);
-        if ((pfxIPv6It != netEqIt->end()) && (pfxIPv6It->begin() != pfxIPv6It->end())) {
-            const auto& pfx = pfxIPv6It->begin().key();
-            const auto& attrs = pfxIPv6It->begin().value();
-            netCheckStmt << "(net = " << pfx;
-            auto pfxLen = static_cast<uint16_t>(std::stoi(pfx.substr(pfx.find_last_of("/") + 1)));
-            auto geIt = attrs.find(Property::PREFIX_GE_ATTR);
-            auto leIt = attrs.find(Property::PREFIX_LE_ATTR);
-            if ((geIt != attrs.end()) && (leIt != attrs.end())) {
-                auto minPfxRange = geIt.value().template get<uint16_t>();
-                auto maxPfxRange = leIt.value().template get<uint16_t>();
-                if ((pfxLen > minPfxRange) || (pfxLen > maxPfxRange) || (minPfxRange > maxPfxRange)) {
-                    mLog->error("Invalid prefix range <{},{}>", minPfxRange, maxPfxRange);
-                    return {};
-                }
+        return largeCommCheckStmt.str();
+    }
 
-                netCheckStmt << "{" << minPfxRange << "," << maxPfxRange << "}";
-            }
-            else if (geIt != attrs.end()) {
-                auto minPfxRange = geIt.value().template get<uint16_t>();
-                if (pfxLen > minPfxRange) {
-                    mLog->error("Prefix len '{}' is higher than its minimum range '{}'", pfxLen, minPfxRange);
-                    return {};
-                }
+    Optional<String> RenderBgpLargeCommunityEqCheckStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
+        return RenderBgpLargeCommunityCommonCheckStatement(jConfigBgpRoot, jConfigParent, indentSize, Property::LARGE_COMMUNITY_EQ, "=");
+    }
 
-                netCheckStmt << "{" << minPfxRange << ",128}";
+    Optional<String> RenderBgpLargeCommunityInCheckStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
+        return RenderBgpLargeCommunityCommonCheckStatement(jConfigBgpRoot, jConfigParent, indentSize, Property::LARGE_COMMUNITY_IN, "~");
+    }
+
+    Optional<String> RenderBgpNetEqCheckStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize) {
+        OStrStream netCheckStmt;
+        auto netEqIt = jConfigParent.find(Property::NET_EQ);
+        if (netEqIt == jConfigParent.end()) {
+            return "";
+        }
+
+        for (const auto& propertyPfxIP : { Property::PREFIX_V4, Property::PREFIX_V6 }) {
+            auto pfxIPIt = netEqIt->find(propertyPfxIP);
+            if ((pfxIPIt == netEqIt->end()) || (pfxIPIt->begin() == pfxIPIt->end())) {
+                continue;
             }
-            else if (leIt != attrs.end()) {
-                auto maxPfxRange = leIt.value().template get<uint16_t>();
-                if (pfxLen > maxPfxRange) {
-                    mLog->error("Prefix len '{}' is higher than its maximum range '{}'", pfxLen, maxPfxRange);
-                    return {};
-                }
 
-                netCheckStmt << "{" << pfxLen << "," << maxPfxRange << "}";
+            auto pfxRange = mPrefixListReader.ParsePrefixRange(pfxIPIt->begin().key(), pfxIPIt->begin().value());
+            if (!pfxRange.has_value()) {
+                return {};
             }
 
-            netCheckStmt << ")";
+            netCheckStmt << "(net = " << pfxRange.value().ToString() << ")";
         }
 
         return netCheckStmt.str();
     }
 
-    Optional<String> RenderBgpNetInCheckCommonStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jConfigParent, const size_t indentSize,
-            const String& propertyPfxList, const String& propertyPfxIP, const String& pfxMaxLen) {
+    Optional<String> RenderBgpNetInCheckCommonStatement(const Json::JSON& jConfigBgpRoot, const Json::JSON& jNetMatch, const size_t indentSize,
+            const String& propertyPfxList, const String& propertyPfxIP) {
         OStrStream netCheckStmt;
-        auto netMatchIt = jConfigParent.find(propertyPfxList);
-        if (netMatchIt == jConfigParent.end()) {
-            return "";
-        }
-
-        if (netMatchIt->find(propertyPfxList) != netMatchIt->end()) {
-            auto netIpListIt = netMatchIt->find(propertyPfxList);
+        if (jNetMatch.find(propertyPfxList) != jNetMatch.end()) {
+            auto netIpListIt = jNetMatch.find(propertyPfxList);
             if (!netIpListIt->is_string()) { // Reference to predefined prefix IP list
                 mLog->error("Unsupported type of prefix IP list property. Expected 'string' as predefined prefix IP list name");
                 return {};
@@ -730,50 +750,16 @@ private:
                     
             netCheckStmt << "(net ~ " << prefixIPListName << ")";
         }
-        else if (netMatchIt->find(propertyPfxIP) != netMatchIt->end()) { // In-place prefixes IP
-            netCheckStmt << "(net ~ [";
-            for (const auto& [pfx, attrs] : netMatchIt->at(propertyPfxIP).items()) {
-                netCheckStmt << pfx;
-                auto pfxLen = static_cast<uint16_t>(std::stoi(pfx.substr(pfx.find_last_of("/") + 1)));
-                auto geIt = attrs.find(Property::PREFIX_GE_ATTR);
-                auto leIt = attrs.find(Property::PREFIX_LE_ATTR);
-                if ((geIt != attrs.end()) && (leIt != attrs.end())) {
-                    auto minPfxRange = geIt.value().template get<uint16_t>();
-                    auto maxPfxRange = leIt.value().template get<uint16_t>();
-                    if ((pfxLen > minPfxRange) || (pfxLen > maxPfxRange) || (minPfxRange > maxPfxRange)) {
-                        mLog->error("Invalid prefix range <{},{}>", minPfxRange, maxPfxRange);
-                        return {};
-                    }
-
-                    netCheckStmt << "{" << minPfxRange << "," << maxPfxRange << "}";
-                }
-                else if (geIt != attrs.end()) {
-                    auto minPfxRange = geIt.value().template get<uint16_t>();
-                    if (pfxLen > minPfxRange) {
-                        mLog->error("Prefix len '{}' is higher than its minimum range '{}'", pfxLen, minPfxRange);
-                        return {};
-                    }
-
-                    netCheckStmt << "{" << minPfxRange << "," << pfxMaxLen << "}";
-                }
-                else if (leIt != attrs.end()) {
-                    auto maxPfxRange = leIt.value().template get<uint16_t>();
-                    if (pfxLen > maxPfxRange) {
-                        mLog->error("Prefix len '{}' is higher than its maximum range '{}'", pfxLen, maxPfxRange);
-                        return {};
-                    }
-
-                    netCheckStmt << "{" << pfxLen << "," << maxPfxRange << "}";
-                }
-
-                netCheckStmt << ",";
+        else if (jNetMatch.find(propertyPfxIP) != jNetMatch.end()) { // In-place prefixes IP
+            auto pfxSet = MakePrefixSet(jNetMatch.at(propertyPfxIP));
+            if (!pfxSet.has_value()) {
+                return {};
             }
 
-            // Let's get rid of comma ',' after last entry of the list
-            const auto& netCheckStmtStr = netCheckStmt.str();
-            if (netCheckStmtStr[netCheckStmtStr.size() - 1] == ',') {
-                netCheckStmt.seekp(-1, std::ios_base::end);
-                // netCheckStmt << '\0'; // NULL terminating string
+            netCheckStmt << "(net ~ [";
+            auto pfxRanges = pfxSet.value().Ranges();
+            for (size_t rangeIdx = 0; rangeIdx < pfxRanges.size(); ++rangeIdx) {
+                netCheckStmt << ((rangeIdx > 0) ? "," : "") << pfxRanges[rangeIdx].ToString();
             }
 
             netCheckStmt << "])";
@@ -789,7 +775,7 @@ private:
             return "";
         }
 
-        auto perIpNetCheckStmt = RenderBgpNetInCheckCommonStatement(jConfigBgpRoot, jConfigParent, indentSize, Property::PREFIX_V4_LIST, Property::PREFIX_V4, "32");
+        auto perIpNetCheckStmt = RenderBgpNetInCheckCommonStatement(jConfigBgpRoot, *netMatchIt, indentSize, Property::PREFIX_V4_LIST, Property::PREFIX_V4);
         if (!perIpNetCheckStmt.has_value()) {
             mLog->error("Failed to render prefix IPv4 check in");
             return {};
@@ -799,7 +785,7 @@ private:
             return perIpNetCheckStmt.value(); 
         }
 
-        perIpNetCheckStmt = RenderBgpNetInCheckCommonStatement(jConfigBgpRoot, jConfigParent, indentSize, Property::PREFIX_V6_LIST, Property::PREFIX_V6, "128");
+        perIpNetCheckStmt = RenderBgpNetInCheckCommonStatement(jConfigBgpRoot, *netMatchIt, indentSize, Property::PREFIX_V6_LIST, Property::PREFIX_V6);
         if (!perIpNetCheckStmt.has_value()) {
             mLog->error("Failed to render prefix IPv6 check in");
             return {};
@@ -866,7 +852,7 @@ private:
             return {};
         }
 
-        auto asn = asnIt.value().template get<uint16_t>();
+        auto asn = asnIt.value().template get<uint32_t>();
         uint16_t count = 1;
         if (asPathPrependStmtIt->contains(Property::N_TIMES)) {
             count = asPathPrependStmtIt->at(Property::N_TIMES).template get<uint16_t>();
@@ -1378,6 +1364,40 @@ private:
             return {};
         }
 
+        if (!checkStmt.value().empty()) {
+            if (isFirstCondInStmt) {
+                ifStmtBody << ((ifMatchType == IfMatchType::ALL) ? " && " : " || ");
+            }
+            else {
+                isFirstCondInStmt = true;
+            }
+
+            ifStmtBody << checkStmt.value();
+        }
+
+        checkStmt = RenderBgpLargeCommunityEqCheckStatement(jConfigBgpRoot, *ifMatchStmtIt, indentSize);
+        if (!checkStmt.has_value()) {
+            mLog->error("Failed to render '{}' check statement", Property::LARGE_COMMUNITY_EQ);
+            return {};
+        }
+
+        if (!checkStmt.value().empty()) {
+            if (isFirstCondInStmt) {
+                ifStmtBody << ((ifMatchType == IfMatchType::ALL) ? " && " : " || ");
+            }
+            else {
+                isFirstCondInStmt = true;
+            }
+
+            ifStmtBody << checkStmt.value();
+        }
+
+        checkStmt = RenderBgpLargeCommunityInCheckStatement(jConfigBgpRoot, *ifMatchStmtIt, indentSize);
+        if (!checkStmt.has_value()) {
+            mLog->error("Failed to render '{}' check statement", Property::LARGE_COMMUNITY_IN);
+            return {};
+        }
+
         if (!checkStmt.value().empty()) {
             if (isFirstCondInStmt) {
                 ifStmtBody << ((ifMatchType == IfMatchType::ALL) ? " && " : " || ");
@@ -5,55 +5,119 @@
 
 #include "IConfigExecuting.hpp"
 
-#include "defer/defer.h"
 #include "FileStorage.hpp"
 #include "Lib/ModuleRegistry.hpp"
+#include "Lib/Subprocess.hpp"
 #include "Modules.hpp"
 
-#include <subprocess.h/subprocess.h>
+#include <array>
+#include <chrono>
 
 namespace Config {
 namespace Executing {
 class BirdConfigExecutor : public IConfigExecuting {
 public:
-    BirdConfigExecutor(const SharedPtr<Storage::IDataStorage> config, const String& birdcExecCmd, const SharedPtr<ModuleRegistry>& moduleRegistry)
-      : IConfigExecuting(config), mBirdcExecCmd(birdcExecCmd), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_EXEC)) {}
+    static constexpr auto DEFAULT_EXEC_TIMEOUT = std::chrono::seconds(30);
+
+    BirdConfigExecutor(const SharedPtr<Storage::IDataStorage> config, const String& birdcExecCmd, const SharedPtr<ModuleRegistry>& moduleRegistry, const std::chrono::milliseconds execTimeout = DEFAULT_EXEC_TIMEOUT)
+      : IConfigExecuting(config), mBirdcExecCmd(birdcExecCmd), mExecTimeout(execTimeout), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_EXEC)) {}
     virtual ~BirdConfigExecutor() = default;
     bool Validate() override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "BirdConfigExecutor::Validate");
         if (!IsSupportedConfigStorage()) {
             return false;
         }
 
-        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc configure check \"/etc/bird/bird.conf\"
-        auto birdcExecCmd = mBirdcExecCmd + " configure check \"/etc/bird/" + mConfig->URI() + "\"";
-        mLog->trace("Validation command to execute: '{}'", birdcExecCmd);
-        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { "Configuration OK" });
+        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc -v configure check \"/etc/bird/bird.conf\"
+        auto birdcExecCmd = mBirdcExecCmd + " " + BIRDC_VERBOSE_ARG + " configure check \"/etc/bird/" + mConfig->URI() + "\"";
+        LOG_TRACE(mLog, "Validation command to execute: '{}'", birdcExecCmd);
+        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { BirdReplyCode::CONFIGURATION_OK });
     }
 
     bool Load() override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "BirdConfigExecutor::Load");
         if (!IsSupportedConfigStorage()) {
             return false;
         }
 
-        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc configure \"/etc/bird/bird.conf\"
-        auto birdcExecCmd = mBirdcExecCmd + " configure \"/etc/bird/" + mConfig->URI() + "\"";
-        mLog->trace("Loading config command to execute: '{}'", birdcExecCmd);
-        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { "Reconfiguration in progress", "Reconfigured" });
+        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc -v configure \"/etc/bird/bird.conf\"
+        auto birdcExecCmd = mBirdcExecCmd + " " + BIRDC_VERBOSE_ARG + " configure \"/etc/bird/" + mConfig->URI() + "\"";
+        LOG_TRACE(mLog, "Loading config command to execute: '{}'", birdcExecCmd);
+        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { BirdReplyCode::RECONFIGURATION_IN_PROGRESS, BirdReplyCode::RECONFIGURED });
+    }
+
+    bool Load(const ConfigChange& change) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "BirdConfigExecutor::LoadChange");
+        using Kind = ConfigChange::Kind;
+        if (change.ChangeKind == Kind::NONE) {
+            LOG_DEBUG(mLog, "Config has not changed - nothing to load");
+            return true;
+        }
+
+        if (change.ChangeKind != Kind::FILTER_ONLY) {
+            return Load();
+        }
+
+        if (!IsSupportedConfigStorage()) {
+            return false;
+        }
+
+        // The soft reconfiguration changes the filters without re-evaluation of the routes, so only the sessions with
+        // the changed filters are reloaded next, e.g.: /opt/podman/bin/podman exec -it bird birdc -v configure soft \"/etc/bird/bird.conf\"
+        auto birdcExecCmd = mBirdcExecCmd + " " + BIRDC_VERBOSE_ARG + " configure soft \"/etc/bird/" + mConfig->URI() + "\"";
+        LOG_TRACE(mLog, "Loading config softly command to execute: '{}'", birdcExecCmd);
+        if (!ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { BirdReplyCode::RECONFIGURATION_IN_PROGRESS, BirdReplyCode::RECONFIGURED })) {
+            return false;
+        }
+
+        for (const auto& sessionName : change.FilterChangedSessions) {
+            // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc -v reload \"SESSION_NAME\"
+            birdcExecCmd = mBirdcExecCmd + " " + BIRDC_VERBOSE_ARG + " reload \"" + sessionName + "\"";
+            LOG_TRACE(mLog, "Reloading session command to execute: '{}'", birdcExecCmd);
+            if (!ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { BirdReplyCode::RELOADING })) {
+                mLog->error("Failed to reload routes of session '{}'", sessionName);
+                // BIRD has already taken the new filters softly, so they are undone before reporting the failure. The undo is
+                // not soft, thus the routes of the sessions reloaded so far are evaluated by the previous filters again
+                if (!Rollback(mConfig)) {
+                    mLog->error("Failed to undo soft reconfiguration after failed reload of session '{}'", sessionName);
+                }
+
+                return false;
+            }
+        }
+
+        return true;
     }
 
     bool Rollback([[maybe_unused]] const SharedPtr<Storage::IDataStorage> backupConfig) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "BirdConfigExecutor::Rollback");
         if (!IsSupportedConfigStorage()) {
             return false;
         }
 
-        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc configure undo
-        auto birdcExecCmd = mBirdcExecCmd + " configure undo";
-        mLog->trace("Rollback command to execute: '{}'", birdcExecCmd);
-        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { "Reconfiguration in progress", "Reconfigured" });
+        // Combine full execution command, e.g.: /opt/podman/bin/podman exec -it bird birdc -v configure undo
+        auto birdcExecCmd = mBirdcExecCmd + " " + BIRDC_VERBOSE_ARG + " configure undo";
+        LOG_TRACE(mLog, "Rollback command to execute: '{}'", birdcExecCmd);
+        return ExecuteCmdAndMatchForExpectedOutput(birdcExecCmd, { BirdReplyCode::RECONFIGURATION_IN_PROGRESS, BirdReplyCode::RECONFIGURED });
     }
 
 private:
+    // With '-v' birdc starts each reply line with the 4-digit reply code of BIRD (see doc/reply_codes in BIRD sources), so
+    // the result is told by the code rather than by the words of the message, which may also be a part of a name or path
+    static constexpr auto BIRDC_VERBOSE_ARG = "-v";
+    struct BirdReplyCode {
+        static constexpr auto RECONFIGURED = "0003";
+        static constexpr auto RECONFIGURATION_IN_PROGRESS = "0004";
+        static constexpr auto RELOADING = "0015";
+        static constexpr auto CONFIGURATION_OK = "0020";
+    };
+    // Codes 8xxx are the run-time errors (e.g. '8002 Configuration error'), codes 9xxx the parse errors of the command
+    static constexpr std::array<const char*, 2> BIRD_FAILURE_CODE_PREFIXES = { "8", "9" };
+    // Lines of stderr kept for the report of the failed command
+    static constexpr size_t MAX_KEPT_STDERR_LINES_COUNT = 8;
+
     const String mBirdcExecCmd;
+    const std::chrono::milliseconds mExecTimeout;
     const SharedPtr<ModuleRegistry> mModuleRegistry;
     SharedPtr<Log::SpdLogger> mLog;
 
@@ -66,58 +130,50 @@ private:
         return false;
     }
 
-    bool ExecuteCmdAndMatchForExpectedOutput(const String& cmd, const ForwardList<String>& matchOutput) {
+    bool ExecuteCmdAndMatchForExpectedOutput(const String& cmd, const Vector<String>& matchOutput) {
         auto cmdArguments = Utils::fSplitStringByWhitespace(cmd);
-        Vector<const char*> nullTermCmdArgs(cmdArguments.size() + 1, nullptr);
-        for (size_t i = 0; i < cmdArguments.size(); ++i) {
-            nullTermCmdArgs[i] = cmdArguments[i].c_str();
-            mLog->trace("Bird arg: '{}'", nullTermCmdArgs[i]);
-        }
-
-        subprocess_s process;
-        auto result = subprocess_create(nullTermCmdArgs.data(), 0, &process);
-        if (result != 0) {
-            mLog->error("Failed to create subprocess '{}'", cmd);
-            return false;
+        for (const auto& cmdArgument : cmdArguments) {
+            LOG_TRACE(mLog, "Bird arg: '{}'", cmdArgument);
         }
 
-        DEFER({
-            auto result = subprocess_destroy(&process);
-            if (result != 0) {
-                mLog->error("Failed to destroy process '{}'", cmd);
+        // The stderr (e.g. warnings of 'podman exec') does not decide the result, it is reported only if the command fails
+        Vector<String> stderrLines;
+        Utils::Subprocess::Options options;
+        options.SuccessMarkers = matchOutput;
+        options.FailureMarkers = { BIRD_FAILURE_CODE_PREFIXES.begin(), BIRD_FAILURE_CODE_PREFIXES.end() };
+        options.AreMarkersLinePrefixes = true;
+        options.Timeout = mExecTimeout;
+        options.OnLine = [this, &stderrLines](const StringView line, const bool isStderr) {
+            LOG_TRACE(mLog, "Output line from process{}: '{}'", isStderr ? " (stderr)" : "", line);
+            if (isStderr && (stderrLines.size() < MAX_KEPT_STDERR_LINES_COUNT)) {
+                stderrLines.emplace_back(line);
             }
+        };
 
-            mLog->trace("Successfully finished spawned process '{}'", cmd);
-        });
-
-        int processStatus;
-        result = subprocess_join(&process, &processStatus);
-        if (result != 0) {
-            mLog->error("Failed to join spawned process '{}'", cmd);
-            return false;
-        }
-
-        if (processStatus != EXIT_SUCCESS) {
-            mLog->error("Failed to execute process '{}'. Returned process status: {}", cmd, processStatus);
-            return false;
-        }
-
-        mLog->trace("Process return status code: {}", processStatus);
-        ::FILE* processStdout = subprocess_stdout(&process);
-        char output[1024];
-        while (::fgets(output, sizeof(output), processStdout)) {
-            mLog->trace("Output line from process: '{}'", output);
-            if (std::find_if(matchOutput.begin(), matchOutput.end(),
-                [&output](const String& match) {
-                    return String(output).find(match) != String::npos;
-                }) != matchOutput.end()) {
-                return true;
+        Tracing::ScopedSpan subprocessSpan(*mModuleRegistry->Tracer(), "Subprocess::Run");
+        auto result = Utils::Subprocess::Run(cmdArguments, options);
+        if (result.RunStatus != Utils::Subprocess::Status::SUCCESS_MARKER) {
+            for (const auto& stderrLine : stderrLines) {
+                mLog->error("Error output line from process '{}': '{}'", cmd, stderrLine);
             }
         }
 
-        ::FILE* processStderr = subprocess_stderr(&process);
-        while (::fgets(output, sizeof(output), processStderr)) {
-            mLog->error("Output line from process: '{}'", output);
+        switch (result.RunStatus) {
+        case Utils::Subprocess::Status::SUCCESS_MARKER:
+            LOG_TRACE(mLog, "Successfully finished spawned process '{}'", cmd);
+            return true;
+        case Utils::Subprocess::Status::FAILURE_MARKER:
+            mLog->error("Process '{}' reported failure: '{}'", cmd, result.MatchedLine);
+            return false;
+        case Utils::Subprocess::Status::EXITED:
+            mLog->error("Process '{}' finished without expected output. Returned process status: {}", cmd, result.ExitCode);
+            return false;
+        case Utils::Subprocess::Status::TIMED_OUT:
+            mLog->error("Process '{}' has been terminated. Error: {}", cmd, result.Error);
+            return false;
+        case Utils::Subprocess::Status::FAILED_TO_START:
+            mLog->error("Failed to create subprocess '{}'. Error: {}", cmd, result.Error);
+            return false;
         }
 
         return false;
@@ -0,0 +1,209 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Common.hpp"
+#include "IConfigExecuting.hpp"
+#include "JsonCommon.hpp"
+#include "JsonSchemaProperties.hpp"
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+
+#include <algorithm>
+#include <array>
+#include <set>
+
+namespace Config {
+using namespace Json::Schema;
+using namespace StdLib;
+
+/*
+    Tells how the config to load differs from the loaded one, so the executor can avoid the restart of the sessions
+    (and the full re-evaluation of their routes) when only the filters have changed. The lists ('*-list') are used
+    only by the policies, and the policies only by the sessions ('policy-in' and 'policy-out' of the address
+    families), so the change of the list changes the filters of the sessions which use it through any policy.
+    Anything out of the BGP policies and sessions is the global change.
+*/
+class ConfigChangeClassifier {
+public:
+    using ConfigChange = Executing::ConfigChange;
+
+    explicit ConfigChangeClassifier(const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_MNGMT)) {}
+
+    ConfigChange Classify(const ByteStream& loadedConfig, const ByteStream& newConfig) {
+        try {
+            auto change = Classify(Json::JSON::parse(loadedConfig), Json::JSON::parse(newConfig));
+            LOG_DEBUG(mLog, "Config change is classified as {} with {} sessions of changed filters", static_cast<int>(change.ChangeKind), change.FilterChangedSessions.size());
+            return change;
+        }
+        catch (const Exception& ex) {
+            mLog->error("Failed to classify config change. Error: {}", ex.what());
+        }
+
+        return ConfigChange { ConfigChange::Kind::GLOBAL, {} };
+    }
+
+    ConfigChange Classify(const Json::JSON& jLoadedConfig, const Json::JSON& jNewConfig) {
+        using Kind = ConfigChange::Kind;
+        ConfigChange change { Kind::NONE, {} };
+        if (jLoadedConfig == jNewConfig) {
+            return change;
+        }
+
+        if (!jLoadedConfig.is_object() || !jNewConfig.is_object() || (Without(jLoadedConfig, { Property::BGP }) != Without(jNewConfig, { Property::BGP }))) {
+            change.ChangeKind = Kind::GLOBAL;
+            return change;
+        }
+
+        const auto& jLoadedBgp = Member(jLoadedConfig, Property::BGP);
+        const auto& jNewBgp = Member(jNewConfig, Property::BGP);
+        Vector<String> bgpFilterKeys(LIST_SECTIONS.begin(), LIST_SECTIONS.end());
+        bgpFilterKeys.push_back(Property::POLICY_LIST);
+        bgpFilterKeys.push_back(Property::SESSIONS);
+        if (Without(jLoadedBgp, bgpFilterKeys) != Without(jNewBgp, bgpFilterKeys)) {
+            change.ChangeKind = Kind::GLOBAL;
+            return change;
+        }
+
+        // Lists as pairs of the section and the name, since the policy refers to the list like {"community-list": "NAME"}
+        std::set<Pair<String, String>> changedLists;
+        for (const auto& listSection : LIST_SECTIONS) {
+            for (const auto& listName : ChangedMembers(Member(jLoadedBgp, listSection), Member(jNewBgp, listSection))) {
+                changedLists.emplace(listSection, listName);
+            }
+        }
+
+        const auto& jNewPolicies = Member(jNewBgp, Property::POLICY_LIST);
+        auto changedPolicies = ChangedMembers(Member(jLoadedBgp, Property::POLICY_LIST), jNewPolicies);
+        for (const auto& [policyName, jPolicy] : jNewPolicies.items()) {
+            if (!changedPolicies.contains(policyName) && RefersToAny(jPolicy, changedLists)) {
+                changedPolicies.insert(policyName);
+            }
+        }
+
+        const auto& jLoadedSessions = Member(jLoadedBgp, Property::SESSIONS);
+        const auto& jNewSessions = Member(jNewBgp, Property::SESSIONS);
+        auto raiseChangeKind = [&change](const Kind changeKind) { change.ChangeKind = std::max(change.ChangeKind, changeKind); };
+        std::set<String> filterChangedSessions;
+        for (const auto& sessionName : ChangedMembers(jLoadedSessions, jNewSessions)) {
+            if (!jLoadedSessions.contains(sessionName) || !jNewSessions.contains(sessionName)) {
+                raiseChangeKind(Kind::SESSION_SET);
+                continue;
+            }
+
+            const auto& jLoadedSession = jLoadedSessions.at(sessionName);
+            const auto& jNewSession = jNewSessions.at(sessionName);
+            if (WithoutPolicies(jLoadedSession) != WithoutPolicies(jNewSession)) {
+                raiseChangeKind(Kind::SESSION_ATTRIBUTE);
+            }
+
+            if (SessionPolicies(jLoadedSession) != SessionPolicies(jNewSession)) {
+                filterChangedSessions.insert(sessionName);
+            }
+        }
+
+        // The new sessions start with their filters anyway
+        for (const auto& [sessionName, jNewSession] : jNewSessions.items()) {
+            auto sessionPolicies = SessionPolicies(jNewSession);
+            if (jLoadedSessions.contains(sessionName)
+                && std::ranges::any_of(sessionPolicies, [&changedPolicies](const String& policyName) { return changedPolicies.contains(policyName); })) {
+                filterChangedSessions.insert(sessionName);
+            }
+        }
+
+        change.FilterChangedSessions.assign(filterChangedSessions.begin(), filterChangedSessions.end());
+
+        // The file has changed anyway, e.g. the policy which is not used by any session
+        raiseChangeKind(Kind::FILTER_ONLY);
+        return change;
+    }
+
+private:
+    static constexpr std::array<const char*, 6> LIST_SECTIONS = {
+        Property::AS_PATH_LIST, Property::COMMUNITY_LIST, Property::EXT_COMMUNITY_LIST,
+        Property::LARGE_COMMUNITY_LIST, Property::PREFIX_V4_LIST, Property::PREFIX_V6_LIST
+    };
+
+    SharedPtr<Log::SpdLogger> mLog;
+
+    static const Json::JSON& Member(const Json::JSON& jParent, const String& key) {
+        static const Json::JSON EMPTY_OBJECT = Json::JSON::object();
+        auto memberIt = jParent.find(key);
+        return (memberIt != jParent.end()) ? memberIt.value() : EMPTY_OBJECT;
+    }
+
+    static Json::JSON Without(const Json::JSON& jObject, const Vector<String>& keys) {
+        auto jRest = jObject;
+        for (const auto& key : keys) {
+            jRest.erase(key);
+        }
+
+        return jRest;
+    }
+
+    // ChangedMembers() returns the names of the added, removed and modified members of the JSON object
+    static std::set<String> ChangedMembers(const Json::JSON& jLoaded, const Json::JSON& jNew) {
+        std::set<String> changedMembers;
+        for (const auto& [name, jLoadedMember] : jLoaded.items()) {
+            auto newMemberIt = jNew.find(name);
+            if ((newMemberIt == jNew.end()) || (newMemberIt.value() != jLoadedMember)) {
+                changedMembers.insert(name);
+            }
+        }
+
+        for (const auto& [name, jNewMember] : jNew.items()) {
+            if (!jLoaded.contains(name)) {
+                changedMembers.insert(name);
+            }
+        }
+
+        return changedMembers;
+    }
+
+    static bool RefersToAny(const Json::JSON& jNode, const std::set<Pair<String, String>>& lists) {
+        if (lists.empty() || !jNode.is_structured()) {
+            return false;
+        }
+
+        if (jNode.is_object()) {
+            for (const auto& [key, jValue] : jNode.items()) {
+                if (jValue.is_string() && lists.contains({ key, jValue.template get<String>() })) {
+                    return true;
+                }
+            }
+        }
+
+        return std::any_of(jNode.begin(), jNode.end(), [&lists](const Json::JSON& jChild) { return RefersToAny(jChild, lists); });
+    }
+
+    // SessionPolicies() returns 'policy-in' and 'policy-out' of all the address families of the session
+    static Vector<String> SessionPolicies(const Json::JSON& jSession) {
+        Vector<String> policyNames;
+        for (const auto& [addrFamily, jAddrFamily] : Member(jSession, Property::ADDRESS_FAMILY).items()) {
+            for (const auto& propertyPolicy : { Property::POLICY_IN, Property::POLICY_OUT }) {
+                auto policyIt = jAddrFamily.find(propertyPolicy);
+                policyNames.push_back((policyIt != jAddrFamily.end()) ? policyIt.value().template get<String>() : String());
+            }
+        }
+
+        return policyNames;
+    }
+
+    static Json::JSON WithoutPolicies(const Json::JSON& jSession) {
+        auto jRest = jSession;
+        auto addrFamilyIt = jRest.find(Property::ADDRESS_FAMILY);
+        if (addrFamilyIt == jRest.end()) {
+            return jRest;
+        }
+
+        for (auto& [addrFamily, jAddrFamily] : addrFamilyIt->items()) {
+            jAddrFamily.erase(Property::POLICY_IN);
+            jAddrFamily.erase(Property::POLICY_OUT);
+        }
+
+        return jRest;
+    }
+}; // class ConfigChangeClassifier
+} // namespace Config
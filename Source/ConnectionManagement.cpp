@@ -6,6 +6,8 @@
 #include <spdlog/spdlog.h>
 
 #include "ConnectionManagement.hpp"
+#include "JsonCommon.hpp"
+#include "Lib/LogRing.hpp"
 #include "Lib/Utils.hpp"
 
 #include <httplib/httplib.h>
@@ -46,6 +48,23 @@ Server::Server(Std::SharedPtr<ModuleRegistry>& module_registry)
     });
 }
 
+const char* Server::methodName(const HTTP::Method method) {
+    switch (method) {
+    case HTTP::Method::GET:
+        return "GET";
+    case HTTP::Method::PATCH:
+        return "PATCH";
+    case HTTP::Method::PUT:
+        return "PUT";
+    case HTTP::Method::POST:
+        return "POST";
+    case HTTP::Method::DEL:
+        return "DELETE";
+    }
+
+    return "UNKNOWN";
+}
+
 bool Server::addConnectionHandler(Map<String, RequestCallback>& callbacks, const String& id, RequestCallback handler) {
     callbacks[id] = handler;
     return true;
@@ -99,6 +118,24 @@ bool Server::removeOnPatchConnectionHandler(const String& id) {
 bool Server::Run(const String& host, const uint16_t port) {
     static const String NO_SESSION_TOKEN = "";
     Http::Server srv;
+    // Each request is handled by a single thread from the routing till the response, so the thread carries the root span
+    srv.set_pre_routing_handler([this](const Http::Request &req, [[maybe_unused]] Http::Response &res) {
+        _module_registry->Tracer()->BeginRequest(req.method + " " + req.path);
+        // The log messages of the request are tagged with its session, see Log::StructuredLogRing
+        Log::LogSession::Set(SessionManager::PeekSessionToken(req).value_or(""));
+        return Http::Server::HandlerResponse::Unhandled;
+    });
+
+    srv.set_post_routing_handler([this]([[maybe_unused]] const Http::Request &req, Http::Response &res) {
+        auto request_id = Tracing::Tracer::CurrentRequestId();
+        if (request_id != 0) {
+            res.set_header(HTTP::Header::REQUEST_ID, std::to_string(request_id));
+        }
+
+        _module_registry->Tracer()->EndRequest();
+        Log::LogSession::Set("");
+    });
+
     srv.Post(ConnectionManagement::URIRequestPath::Session::TOKEN_CREATE, [this](const Http::Request &req, Http::Response &res) {
         _session_mngr.RegisterSessionToken(req, res);
         return res.status;
@@ -108,46 +145,50 @@ bool Server::Run(const String& host, const uint16_t port) {
         _session_mngr.RemoveSessionToken(req, res);
     });
 
-    srv.Get(ConnectionManagement::URIRequestPath::Config::RUNNING, [this](const Http::Request &req, Http::Response &res) {
+    srv.Get(ConnectionManagement::URIRequestPath::Config::RUNNING, [this, &request_latency = requestLatency(HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING)](const Http::Request &req, Http::Response &res) {
         String return_data;
-        auto status = processRequest(NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING, req.body, return_data);
+        auto status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING, req.body, return_data);
         auto return_message = status ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
         res.status = status ? HTTP::StatusCode::OK : HTTP::StatusCode::INTERNAL_SERVER_ERROR;
     });
 
-    srv.Patch(ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE, [this](const Http::Request &req, Http::Response &res) {
+    srv.Patch(ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE, [this, &request_latency = requestLatency(HTTP::Method::PATCH, ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.SetActiveSessionToken(req, res)) {
             return;
         }
 
         auto session_token = _session_mngr.GetSessionToken(req).value();
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::PATCH, ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE, req.body, return_data);
-        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
+        res.status = processRequest(request_latency, session_token, HTTP::Method::PATCH, ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE, req.body, return_data);
+        // Rejected config comes back with its validation errors
+        auto status = static_cast<HTTP::StatusCode>(res.status);
+        auto return_message = (HTTP::IsSuccess(status) || HTTP::IsClientError(status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Get(ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF, [this](const Http::Request &req, Http::Response &res) {
+    srv.Get(ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF, [this, &request_latency = requestLatency(HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF)](const Http::Request &req, Http::Response &res) {
         String return_data;
-        res.status = processRequest(NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF, req.body, return_data);
-        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF, req.body, return_data);
+        // Rejected config comes back with its validation errors
+        auto status = static_cast<HTTP::StatusCode>(res.status);
+        auto return_message = (HTTP::IsSuccess(status) || HTTP::IsClientError(status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Get(ConnectionManagement::URIRequestPath::Config::CANDIDATE, [this](const Http::Request &req, Http::Response &res) {
+    srv.Get(ConnectionManagement::URIRequestPath::Config::CANDIDATE, [this, &request_latency = requestLatency(HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::CANDIDATE)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.CheckActiveSessionToken(req, res)) {
             _log->info("There is not active session to get candidate config");
             return;
         }
 
         String return_data;
-        res.status = processRequest(NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req.body, return_data);
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req.body, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT, [this](const Http::Request &req, Http::Response &res) {
+    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.CheckActiveSessionToken(req, res)) {
             return;
         }
@@ -155,12 +196,12 @@ bool Server::Run(const String& host, const uint16_t port) {
         auto session_token = _session_mngr.GetSessionToken(req).value();
         _session_mngr.CancelSessionTokenTimerOnce(req);
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT, req.body, return_data);
+        res.status = processRequest(request_latency, session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT, req.body, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM, [this](const Http::Request &req, Http::Response &res) {
+    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.CheckActiveSessionToken(req, res)) {
             return;
         }
@@ -168,12 +209,13 @@ bool Server::Run(const String& host, const uint16_t port) {
         auto session_token = _session_mngr.GetSessionToken(req).value();
         _session_mngr.CancelSessionTokenTimerOnce(req);
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM, req.body, return_data);
+        res.status = processRequest(request_latency, session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM, req.body, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT, [this](const Http::Request &req, Http::Response &res) {
+    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT),
+                  &discard_latency = requestLatency(HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE)](const Http::Request &req, Http::Response &res) {
         String request_data = req.matches[1];
         auto timeout = std::stoi(request_data);
         if (timeout > DEFAULT_SESSION_TOKEN_EXPIRE_TIMEOUT) {
@@ -188,13 +230,13 @@ bool Server::Run(const String& host, const uint16_t port) {
         auto session_token = _session_mngr.GetSessionToken(req).value();
         _session_mngr.CancelSessionTokenTimerOnce(req);
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT, request_data, return_data);
+        res.status = processRequest(request_latency, session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT, request_data, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
-        if (!_session_mngr.SetSessionTokenTimerOnce(req, [this]([[maybe_unused]] const String session_token) {
+        if (!_session_mngr.SetSessionTokenTimerOnce(req, [this, &discard_latency]([[maybe_unused]] const String session_token) {
                 String req_data_stub;
                 String res_data_stub;
-                processRequest(session_token, HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req_data_stub, res_data_stub);
+                processRequest(discard_latency, session_token, HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req_data_stub, res_data_stub);
                 _session_mngr.RemoveActiveSessionToken(session_token);
             },
             std::chrono::seconds(timeout))) {
@@ -202,7 +244,7 @@ bool Server::Run(const String& host, const uint16_t port) {
         }
     });
 
-    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL, [this](const Http::Request &req, Http::Response &res) {
+    srv.Post(ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.CheckActiveSessionToken(req, res)) {
             return;
         }
@@ -210,12 +252,12 @@ bool Server::Run(const String& host, const uint16_t port) {
         auto session_token = _session_mngr.GetSessionToken(req).value();
         _session_mngr.CancelSessionTokenTimerOnce(req);
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL, req.body, return_data);
+        res.status = processRequest(request_latency, session_token, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL, req.body, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Delete(ConnectionManagement::URIRequestPath::Config::CANDIDATE, [this](const Http::Request &req, Http::Response &res) {
+    srv.Delete(ConnectionManagement::URIRequestPath::Config::CANDIDATE, [this, &request_latency = requestLatency(HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE)](const Http::Request &req, Http::Response &res) {
         if (!_session_mngr.CheckActiveSessionToken(req, res)) {
             return;
         }
@@ -223,18 +265,58 @@ bool Server::Run(const String& host, const uint16_t port) {
         auto session_token = _session_mngr.GetSessionToken(req).value();
         _session_mngr.CancelSessionTokenTimerOnce(req);
         String return_data;
-        res.status = processRequest(session_token, HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req.body, return_data);
+        res.status = processRequest(request_latency, session_token, HTTP::Method::DEL, ConnectionManagement::URIRequestPath::Config::CANDIDATE, req.body, return_data);
         auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
     });
 
-    srv.Get(ConnectionManagement::URIRequestPath::Logs::LATEST_N, [this](const Http::Request &req, Http::Response &res) {
+    srv.Get(ConnectionManagement::URIRequestPath::Logs::LATEST_N, [this, &request_latency = requestLatency(HTTP::Method::GET, ConnectionManagement::URIRequestPath::Logs::LATEST_N)](const Http::Request &req, Http::Response &res) {
+        // GET /logs/latest/{n}?session=TOKEN&level=LEVEL
+        Json::JSON request = { { "count", req.matches[1].str() } };
+        for (const auto param : { "session", "level" }) {
+            if (req.has_param(param)) {
+                request[param] = req.get_param_value(param);
+            }
+        }
+
         String return_data;
-        String request_data = req.matches[1];
-        auto status = processRequest(NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Logs::LATEST_N, request_data, return_data);
-        auto return_message = status ? return_data : "Failed";
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Logs::LATEST_N, request.dump(), return_data);
+        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
         res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
-        res.status = status ? HTTP::StatusCode::OK : HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+    });
+
+    srv.Post(ConnectionManagement::URIRequestPath::Policy::SIMULATE, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Policy::SIMULATE)](const Http::Request &req, Http::Response &res) {
+        String return_data;
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Policy::SIMULATE, req.body, return_data);
+        auto status = static_cast<HTTP::StatusCode>(res.status);
+        auto return_message = (HTTP::IsSuccess(status) || HTTP::IsClientError(status)) ? return_data : "Failed";
+        res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
+    });
+
+    srv.Post(ConnectionManagement::URIRequestPath::Admin::SCHEMA_RELOAD, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Admin::SCHEMA_RELOAD)](const Http::Request &req, Http::Response &res) {
+        String return_data;
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Admin::SCHEMA_RELOAD, req.body, return_data);
+        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
+        res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
+    });
+
+    srv.Get(ConnectionManagement::URIRequestPath::Admin::SCHEMA_STATISTICS, [this, &request_latency = requestLatency(HTTP::Method::GET, ConnectionManagement::URIRequestPath::Admin::SCHEMA_STATISTICS)](const Http::Request &req, Http::Response &res) {
+        String return_data;
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::GET, ConnectionManagement::URIRequestPath::Admin::SCHEMA_STATISTICS, req.body, return_data);
+        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
+        res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
+    });
+
+    srv.Post(ConnectionManagement::URIRequestPath::Admin::TRACE_DUMP, [this, &request_latency = requestLatency(HTTP::Method::POST, ConnectionManagement::URIRequestPath::Admin::TRACE_DUMP)](const Http::Request &req, Http::Response &res) {
+        String return_data;
+        res.status = processRequest(request_latency, NO_SESSION_TOKEN, HTTP::Method::POST, ConnectionManagement::URIRequestPath::Admin::TRACE_DUMP, req.body, return_data);
+        auto return_message = HTTP::IsSuccess(static_cast<HTTP::StatusCode>(res.status)) ? return_data : "Failed";
+        res.set_content(return_message, HTTP::ContentType::TEXT_PLAIN_RESP_CONTENT);
+    });
+
+    srv.Get(ConnectionManagement::URIRequestPath::Admin::METRICS, [this](const Http::Request &req, Http::Response &res) {
+        res.set_content(_module_registry->Metrics()->RenderPrometheusText(), HTTP::ContentType::PROMETHEUS_TEXT_RESP_CONTENT);
+        res.status = HTTP::StatusCode::OK;
     });
 
     _log->info("Started listening on {}:{}", host, port);
@@ -242,12 +324,20 @@ bool Server::Run(const String& host, const uint16_t port) {
 }
 
 // FIXME: Extend about Error Message
-HTTP::StatusCode Server::processRequest(const String& session_token, const HTTP::Method method, const String& path, const String& request_data, String& return_data) {
+Metrics::LatencyHistogram& Server::requestLatency(const HTTP::Method method, const String& path) {
+    // The path is the route (e.g. with the pattern of the timeout), so the number of the histograms is bounded
+    return _module_registry->Metrics()->GetHistogram("bgp_config_api_request_duration_seconds", "Duration of the handling of the requests by their route",
+        { { "method", methodName(method) }, { "path", path } });
+}
+
+HTTP::StatusCode Server::processRequest(Metrics::LatencyHistogram& request_latency, const String& session_token, const HTTP::Method method, const String& path, const String& request_data, String& return_data) {
     auto check_internal_success = [](const HTTP::StatusCode status_code) {
         return status_code == HTTP::StatusCode::INTERNAL_SUCCESS;
     };
 
     HTTP::StatusCode status_code = HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+    Tracing::ScopedSpan dispatch_span(*_module_registry->Tracer(), "Server::processRequest");
+    Metrics::ScopedLatency request_latency_scope(request_latency);
 
     switch (method) {
     case HTTP::Method::GET: {
@@ -13,6 +13,13 @@
 
 namespace ConnectionManagement {
 namespace URIRequestPath {
+namespace Admin {
+    static constexpr auto SCHEMA_RELOAD = "/admin/schema/reload";
+    static constexpr auto SCHEMA_STATISTICS = "/admin/schema/statistics";
+    static constexpr auto METRICS = "/metrics";
+    static constexpr auto TRACE_DUMP = "/admin/trace/dump";
+} // namespace Admin
+
 namespace Config {
     static constexpr auto CANDIDATE = "/config/candidate";
     static constexpr auto CANDIDATE_COMMIT = "/config/candidate/commit";
@@ -25,9 +32,14 @@ namespace Config {
 } // namespace Config
 
 namespace Logs {
-    static constexpr auto LATEST_N = R"(/logs/latest/(\d+))"; // FIXME: Limit allowed number value
+    // The number of the logs is bounded by the size of the log ring
+    static constexpr auto LATEST_N = R"(/logs/latest/(\d+))";
 }
 
+namespace Policy {
+    static constexpr auto SIMULATE = "/policy/simulate";
+} // namespace Policy
+
 namespace Session {
     static constexpr auto TOKEN = "/session/token";
     static constexpr auto TOKEN_CREATE = "/session/token/create";
@@ -60,7 +72,10 @@ public:
     bool Run(const Std::String& host, const uint16_t port);
 
 private:
-    HTTP::StatusCode processRequest(const Std::String& session_token, const HTTP::Method method, const Std::String& path, const Std::String& request_data, Std::String& return_data);
+    static const char* methodName(const HTTP::Method method);
+    // requestLatency() returns the histogram of the route, which the handler of the route looks up once and keeps
+    Metrics::LatencyHistogram& requestLatency(const HTTP::Method method, const Std::String& path);
+    HTTP::StatusCode processRequest(Metrics::LatencyHistogram& request_latency, const Std::String& session_token, const HTTP::Method method, const Std::String& path, const Std::String& request_data, Std::String& return_data);
     bool addConnectionHandler(Std::Map<Std::String, RequestCallback>& callbacks, const Std::String& id, RequestCallback handler);
     bool removeConnectionHandler(Std::Map<Std::String, RequestCallback>& callbacks, const Std::String& id);
     Std::Map<Std::String, RequestCallback> _on_delete_callback_by_id;
@@ -0,0 +1,133 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "IConfigExecuting.hpp"
+
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+
+#include <functional>
+
+namespace Config {
+namespace Executing {
+/*
+    Validates and loads the config on many instances of the target program (e.g. the BIRD daemon per VRF or per
+    address family), each with its own executor and target config file. The instances are driven concurrently,
+    by the thread per instance since the executors mostly wait for the external program, so the whole operation
+    takes about as long as on the slowest instance. The load is all-or-nothing: if any instance fails, the instances
+    which have loaded the config are rolled back.
+*/
+class FanOutConfigExecutor : public IConfigExecuting {
+public:
+    FanOutConfigExecutor(const SharedPtr<Storage::IDataStorage> config, const Vector<SharedPtr<IConfigExecuting>>& executors, const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : IConfigExecuting(config), mExecutors(executors), mTracer(moduleRegistry->Tracer()), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_EXEC)) {}
+    virtual ~FanOutConfigExecutor() = default;
+
+    bool Validate() override {
+        auto results = RunOnAll([](IConfigExecuting& executor) { return executor.Validate(); });
+        return IsSucceededOnAll(results, "validate");
+    }
+
+    bool Load() override {
+        return LoadOnAll([](IConfigExecuting& executor) { return executor.Load(); });
+    }
+
+    bool Load(const ConfigChange& change) override {
+        return LoadOnAll([&change](IConfigExecuting& executor) { return executor.Load(change); });
+    }
+
+    bool Rollback(const SharedPtr<Storage::IDataStorage> backupConfig) override {
+        auto results = RunOnAll([&backupConfig](IConfigExecuting& executor) { return executor.Rollback(backupConfig); });
+        return IsSucceededOnAll(results, "roll back");
+    }
+
+private:
+    using Operation = std::function<bool(IConfigExecuting& executor)>;
+
+    const Vector<SharedPtr<IConfigExecuting>> mExecutors;
+    SharedPtr<Tracing::Tracer> mTracer;
+    SharedPtr<Log::SpdLogger> mLog;
+
+    bool LoadOnAll(const Operation& load) {
+        auto results = RunOnAll(load);
+        if (IsSucceededOnAll(results, "load")) {
+            return true;
+        }
+
+        Vector<size_t> loadedIdxs;
+        for (size_t executorIdx = 0; executorIdx < mExecutors.size(); ++executorIdx) {
+            if (results[executorIdx]) {
+                loadedIdxs.push_back(executorIdx);
+            }
+        }
+
+        auto rollbackResults = RunOn(loadedIdxs, [this](IConfigExecuting& executor) { return executor.Rollback(mConfig); });
+        for (size_t i = 0; i < loadedIdxs.size(); ++i) {
+            if (!rollbackResults[i]) {
+                mLog->error("Failed to roll back config of instance #{} after failed load on other instance", loadedIdxs[i]);
+            }
+        }
+
+        return false;
+    }
+
+    Vector<bool> RunOnAll(const Operation& operation) {
+        Vector<size_t> executorIdxs(mExecutors.size());
+        for (size_t executorIdx = 0; executorIdx < mExecutors.size(); ++executorIdx) {
+            executorIdxs[executorIdx] = executorIdx;
+        }
+
+        return RunOn(executorIdxs, operation);
+    }
+
+    // RunOn() runs the operation on the given executors at once and returns their results in the same order
+    Vector<bool> RunOn(const Vector<size_t>& executorIdxs, const Operation& operation) {
+        // Not Vector<bool>, whose elements cannot be written by many threads
+        Vector<uint8_t> results(executorIdxs.size(), false);
+        Vector<Thread> threads;
+        threads.reserve(executorIdxs.size());
+        // Spans of the instances nest in the span of the request which drives them
+        auto request = mTracer->CurrentRequest();
+        for (size_t i = 0; i < executorIdxs.size(); ++i) {
+            auto runOperation = [this, &operation, &results, &executorIdxs, &request, i]() {
+                Tracing::ScopedRequestContext requestContext(*mTracer, request);
+                try {
+                    results[i] = operation(*mExecutors[executorIdxs[i]]);
+                }
+                catch (const Exception& ex) {
+                    mLog->error("Failed to execute operation on instance #{}. Error: {}", executorIdxs[i], ex.what());
+                }
+            };
+
+            // The last one runs on the calling thread
+            if (i + 1 < executorIdxs.size()) {
+                threads.emplace_back(runOperation);
+            }
+            else {
+                runOperation();
+            }
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        return Vector<bool>(results.begin(), results.end());
+    }
+
+    bool IsSucceededOnAll(const Vector<bool>& results, const char* operationName) {
+        bool result = true;
+        for (size_t executorIdx = 0; executorIdx < results.size(); ++executorIdx) {
+            if (!results[executorIdx]) {
+                mLog->error("Failed to {} config on instance #{} ('{}')", operationName, executorIdx, mExecutors[executorIdx]->ConfigURI());
+                result = false;
+            }
+        }
+
+        return result;
+    }
+}; // class FanOutConfigExecutor
+} // namespace Executing
+} // namespace Config
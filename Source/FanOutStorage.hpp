@@ -0,0 +1,44 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "IDataStorage.hpp"
+#include "Common.hpp"
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+
+namespace Storage {
+/*
+    Keeps the same data in many storages, e.g. the target config of each of the BIRD instances. The data is saved
+    into all of them and loaded from the first one, whose URI stands for the whole set.
+*/
+class FanOutStorage : public IDataStorage {
+public:
+    FanOutStorage(const Vector<SharedPtr<IDataStorage>>& storages, const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : IDataStorage(storages.front()->URI()), mStorages(storages), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::DATA_STORAGE)) {}
+    virtual ~FanOutStorage() = default;
+
+    virtual Optional<ByteStream> LoadData() override { return mStorages.front()->LoadData(); }
+    virtual bool LoadDataView(const DataViewReader& reader) override { return mStorages.front()->LoadDataView(reader); }
+
+    virtual bool SaveData(const ByteStream& data) override {
+        // Each storage is tried anyway, so the caller which restores the previous data restores it everywhere
+        bool result = true;
+        for (const auto& storage : mStorages) {
+            if (!storage->SaveData(data)) {
+                mLog->error("Failed to save data into '{}'", storage->URI());
+                result = false;
+            }
+        }
+
+        return result;
+    }
+
+    const Vector<SharedPtr<IDataStorage>>& Storages() const { return mStorages; }
+
+private:
+    const Vector<SharedPtr<IDataStorage>> mStorages;
+    SharedPtr<Log::SpdLogger> mLog;
+}; // class FanOutStorage
+} // namespace Storage
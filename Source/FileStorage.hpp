@@ -5,10 +5,16 @@
 
 #include "IDataStorage.hpp"
 #include "Common.hpp"
+#include "Lib/MappedFile.hpp"
 
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <iterator>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace Storage {
 class FileStorage : public IDataStorage {
 public:
@@ -16,56 +22,110 @@ public:
       : IDataStorage(fileName), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::DATA_STORAGE)) {}
     virtual ~FileStorage() = default;
     virtual Optional<ByteStream> LoadData() override {
-        IFStream file(mURI, std::ios_base::binary);
-        if (!file.is_open()) {
-            mLog->error("Failed to open file '{}'", mURI);
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "FileStorage::LoadData");
+        Utils::MappedFile file;
+        if (!file.Open(mURI)) {
+            mLog->error("Failed to open file '{}'. Error: {}", mURI, file.Error());
             return {};
         }
 
-        return ByteStream(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return ByteStream(file.Data(), file.Data() + file.Size());
+    }
+
+    virtual bool LoadDataView(const DataViewReader& reader) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "FileStorage::LoadDataView");
+        Utils::MappedFile file;
+        if (!file.Open(mURI)) {
+            mLog->error("Failed to open file '{}'. Error: {}", mURI, file.Error());
+            return false;
+        }
+
+        return reader(file.Data(), file.Size());
     }
 
     virtual bool SaveData(const ByteStream& data) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "FileStorage::SaveData");
         if (data.size() == 0) {
             mLog->warn("No data to save in file {}", mURI);
             return true;
         }
 
-        auto tmpFileName = mURI + ".tmp";
-        OFStream tmpFile(tmpFileName);
-        if (!tmpFile.is_open()) {
-            mLog->error("Failed to open file {} to save data", tmpFileName);
+        return WriteFileDurably(mURI, data.data(), data.size());
+    }
+
+protected:
+    // WriteFileDurably() replaces the file atomically: the data goes into a temporary file which is synced
+    // to the disk before it is renamed over the target, and then the parent directory entry is synced as well
+    bool WriteFileDurably(const String& fileName, const void* data, const size_t size) {
+        auto tmpFileName = fileName + ".tmp";
+        int tmpFd = ::open(tmpFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (tmpFd < 0) {
+            mLog->error("Failed to open file {} to save data. Error: {}", tmpFileName, std::strerror(errno));
             return false;
         }
 
-        tmpFile.write(reinterpret_cast<const char*>(data.data()), data.size());
-        tmpFile.flush();
-        tmpFile.close();
-        if (!tmpFile.good()) {
-            mLog->error("Failed to save data to file {}", tmpFileName);
+        if (!WriteAll(tmpFd, data, size) || (::fsync(tmpFd) != 0)) {
+            mLog->error("Failed to save data to file {}. Error: {}", tmpFileName, std::strerror(errno));
+            ::close(tmpFd);
             std::filesystem::remove(std::filesystem::path(tmpFileName));
             return false;
         }
-        
+
+        ::close(tmpFd);
         std::error_code errCode = {};
-        std::filesystem::rename(std::filesystem::path(tmpFileName), mURI, errCode);
+        std::filesystem::rename(std::filesystem::path(tmpFileName), fileName, errCode);
         if (errCode) {
             mLog->error("Failed to save temporary filename {} into target filename {}. Error: {}",
-                tmpFileName, mURI, errCode.message());
+                tmpFileName, fileName, errCode.message());
+            std::filesystem::remove(std::filesystem::path(tmpFileName), errCode);
             return false;
         }
 
-        errCode.clear();
-        std::filesystem::remove(std::filesystem::path(tmpFileName), errCode);
-        if (errCode) {
-            mLog->warn("Failed to remove temporary filename {}. Error: {}",
-                tmpFileName, errCode.message());
+        return SyncParentDir(fileName);
+    }
+
+    bool WriteAll(const int fd, const void* data, size_t size) {
+        auto buf = static_cast<const char*>(data);
+        while (size > 0) {
+            auto written = ::write(fd, buf, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            buf += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        return true;
+    }
+
+    // The rename is durable only after the directory holding the entry has been synced
+    bool SyncParentDir(const String& fileName) {
+        auto dirPath = std::filesystem::path(fileName).parent_path();
+        if (dirPath.empty()) {
+            dirPath = ".";
+        }
+
+        int dirFd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd < 0) {
+            mLog->error("Failed to open directory {} to sync it. Error: {}", dirPath.string(), std::strerror(errno));
+            return false;
+        }
+
+        auto result = ::fsync(dirFd);
+        ::close(dirFd);
+        if (result != 0) {
+            mLog->error("Failed to sync directory {}. Error: {}", dirPath.string(), std::strerror(errno));
+            return false;
         }
 
         return true;
     }
 
-protected:
     SharedPtr<ModuleRegistry> mModuleRegistry;
     SharedPtr<Log::SpdLogger> mLog;
 }; // class FileStorage
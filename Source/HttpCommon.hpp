@@ -27,19 +27,25 @@ enum StatusCode {
     // Redirection messages
     SEE_OTHER = 303,
     // Client error responses
+    START_CLIENT_ERROR = 400,
+    BAD_REQUEST = START_CLIENT_ERROR,
     CONFLICT = 409,
     INVALID_TOKEN = 498,
     TOKEN_REQUIRED = 499,
+    END_CLIENT_ERROR = 499,
     // Server error responses
     INTERNAL_SERVER_ERROR = 500,
 };
 
 static constexpr inline bool IsSuccess(const StatusCode status_code) { return (status_code >= StatusCode::START_SUCCESS) && (status_code <= StatusCode::END_SUCCESS); }
+static constexpr inline bool IsClientError(const StatusCode status_code) { return (status_code >= StatusCode::START_CLIENT_ERROR) && (status_code <= StatusCode::END_CLIENT_ERROR); }
 
 namespace ContentType {
     static constexpr auto TEXT_PLAIN_RESP_CONTENT = "text/plain";
+    static constexpr auto PROMETHEUS_TEXT_RESP_CONTENT = "text/plain; version=0.0.4";
 } // namespace ContentType
 namespace Header {
+    static constexpr auto REQUEST_ID = "X-Request-Id";
 namespace Tokens {
     static constexpr auto AUTHORIZATION = "Authorization";
     static constexpr auto BEARER = "Bearer";
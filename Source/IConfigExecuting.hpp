@@ -11,6 +11,24 @@ namespace Config {
 namespace Executing {
 using namespace StdLib;
 
+// Scope of the change between the loaded config and the config to load, from the least to the most disruptive
+struct ConfigChange {
+    enum class Kind : uint8_t {
+        NONE,
+        // Only policies and lists, i.e. the filters of the sessions
+        FILTER_ONLY,
+        // Other attributes of the existing sessions
+        SESSION_ATTRIBUTE,
+        // Added or removed sessions
+        SESSION_SET,
+        GLOBAL
+    };
+
+    Kind ChangeKind = Kind::GLOBAL;
+    // Sessions whose filters have changed, sorted
+    Vector<String> FilterChangedSessions;
+};
+
 class IConfigExecuting {
 public:
     IConfigExecuting(const SharedPtr<Storage::IDataStorage> config)
@@ -18,9 +36,13 @@ public:
     virtual ~IConfigExecuting() = default;
     virtual bool Validate() = 0;
     virtual bool Load() = 0;
+    // Load() with the known scope of the change lets the executor use the cheapest sufficient way of loading
+    virtual bool Load([[maybe_unused]] const ConfigChange& change) { return Load(); }
     virtual bool Rollback([[maybe_unused]] const SharedPtr<Storage::IDataStorage> backupConfig) = 0;
     // virtual bool Confirm() = 0; // ?
 
+    String ConfigURI() const { return mConfig->URI(); }
+
 protected:
     const SharedPtr<Storage::IDataStorage> mConfig;
 };
@@ -5,14 +5,29 @@
 
 #include "Common.hpp"
 
+#include <functional>
+
 namespace Storage {
 using namespace StdLib;
+using DataViewReader = std::function<bool(const Byte* data, const size_t size)>;
+
 class IDataStorage {
 public:
     IDataStorage(const String& uri) : mURI(uri) {}
     virtual ~IDataStorage() = default;
     virtual Optional<ByteStream> LoadData() = 0;
     virtual bool SaveData(const ByteStream& data) = 0;
+    // LoadDataView() hands the data over to the reader. Storage which is able to expose its content in place
+    // (e.g. memory-mapped file) avoids making the copy returned by LoadData()
+    virtual bool LoadDataView(const DataViewReader& reader) {
+        auto data = LoadData();
+        if (!data.has_value()) {
+            return false;
+        }
+
+        return reader(data.value().data(), data.value().size());
+    }
+
     String URI() const { return mURI; }
 
 protected:
@@ -11,5 +11,9 @@ public:
     virtual ~ISchemaManagement() = default;
     virtual bool LoadSchema() = 0;
     virtual bool ValidateData(const ByteStream& data) = 0;
+    // ValidateData() returns the validation errors as JSON array of objects (pointer, keyword, message)
+    virtual bool ValidateData(const ByteStream& data, String& errors) { return ValidateData(data); }
+    // Statistics() returns counters of the schema manager (e.g. of its caches) by their names
+    virtual Map<String, uint64_t> Statistics() { return {}; }
 }; // class ISchemaManagement
 } // namespace Schema
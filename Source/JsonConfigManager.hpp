@@ -8,26 +8,43 @@
 #include "Lib/ModuleRegistry.hpp"
 #include "Modules.hpp"
 
+#include <shared_mutex>
+
 namespace Config {
 using namespace StdLib;
+/*
+    The config is guarded by the shared mutex, since the request handlers replace it (e.g. on commit) while other
+    threads read it, like the schema reload which checks the running config from the file watcher thread.
+*/
 class JsonConfigManager : public IConfigManagement {
 public:
     explicit JsonConfigManager(SharedPtr<Storage::IDataStorage> dataStorage, const SharedPtr<ModuleRegistry>& moduleRegistry)
       : mDataStorage(dataStorage), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::CONFIG_MNGMT)) {}
-    JsonConfigManager(const JsonConfigManager&) = default;
+    JsonConfigManager(const JsonConfigManager& other)
+      : mDataStorage(other.mDataStorage), mModuleRegistry(other.mModuleRegistry), mLog(other.mLog) {
+        std::shared_lock lock(other.mConfigMutex);
+        mJsonConfig = other.mJsonConfig;
+        mIsConfigLoaded = other.mIsConfigLoaded;
+    }
     virtual ~JsonConfigManager() = default;
     bool LoadConfig() override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "JsonConfigManager::LoadConfig");
         try {
-            auto configData = mDataStorage->LoadData();
-            if (!configData.has_value()) {
+            Json::JSON jConfig;
+            auto isLoaded = mDataStorage->LoadDataView([&jConfig](const Byte* data, const size_t size) {
+                jConfig = Json::JSON::parse(data, data + size);
+                return true;
+            });
+
+            if (!isLoaded) {
                 mLog->error("Failed to load JSON config data from '{}'", mDataStorage->URI());
                 return false;
             }
 
-            auto jConfig = Json::JSON::parse(configData.value());
-            mJsonConfig = jConfig;
+            std::unique_lock lock(mConfigMutex);
+            mJsonConfig = std::move(jConfig);
             mIsConfigLoaded = true;
-            mLog->trace("Successfully loaded JSON config from file '{}':\n{}", mDataStorage->URI(), jConfig.dump(Json::DEFAULT_OUTPUT_INDENT));
+            LOG_TRACE(mLog, "Successfully loaded JSON config from file '{}':\n{}", mDataStorage->URI(), mJsonConfig.dump(Json::DEFAULT_OUTPUT_INDENT));
             return true;
         }
         catch (const Exception &ex) {
@@ -38,6 +55,8 @@ public:
     }
 
     Optional<ByteStream> SerializeConfig() override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "JsonConfigManager::SerializeConfig");
+        std::shared_lock lock(mConfigMutex);
         if (!mIsConfigLoaded) {
             mLog->error("JSON config has not been loaded yet");
             return {};
@@ -48,6 +67,8 @@ public:
     }
 
     Optional<ByteStream> MakeDiff(const ByteStream& otherConfig) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "JsonConfigManager::MakeDiff");
+        std::shared_lock lock(mConfigMutex);
         if (!mIsConfigLoaded) {
             mLog->error("JSON config has not been loaded yet");
             return {};
@@ -63,7 +84,7 @@ public:
             // Make diff between origin and new config
             auto jDiff = Json::JSON::diff(mJsonConfig, jNewConfig);
             String jData = jDiff.dump();
-            mLog->trace("Successfully make diff for requested config:\n{}", jDiff.dump(Json::DEFAULT_OUTPUT_INDENT));
+            LOG_TRACE(mLog, "Successfully make diff for requested config:\n{}", jDiff.dump(Json::DEFAULT_OUTPUT_INDENT));
             return ByteStream(jData.begin(), jData.end());
         }
         catch (const Exception &ex) {
@@ -74,8 +95,10 @@ public:
     }
 
     bool ApplyPatch(const ByteStream& patch) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "JsonConfigManager::ApplyPatch");
         try {
             auto jPatch = Json::JSON().parse(patch);
+            std::unique_lock lock(mConfigMutex);
             mJsonConfig.patch_inplace(jPatch);
             return true;
         }
@@ -91,6 +114,7 @@ public:
 
 private:
     Json::JSON mJsonConfig;
+    mutable std::shared_mutex mConfigMutex;
     SharedPtr<Storage::IDataStorage> mDataStorage;
     SharedPtr<ModuleRegistry> mModuleRegistry;
     SharedPtr<Log::SpdLogger> mLog;
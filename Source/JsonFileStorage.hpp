@@ -6,58 +6,50 @@
 #include "FileStorage.hpp"
 
 #include "JsonCommon.hpp"
+#include "JsonSchemaLoader.hpp"
 
 namespace Storage {
 class JsonFileStorage : public FileStorage {
 public:
     JsonFileStorage(const String& fileName, const SharedPtr<ModuleRegistry>& moduleRegistry)
-      : FileStorage(fileName, moduleRegistry) {}
+      : FileStorage(fileName, moduleRegistry), mSchemaLoader(mLog) {}
     virtual ~JsonFileStorage() = default;
-    Optional<ByteStream> LoadData() override final {
-        IFStream jsonFile(mURI);
-        if (!jsonFile.is_open()) {
-            mLog->error("Failed to open file '{}'", mURI);
+    // LoadJson() returns the document merged with other JSON files from the same directory (see JsonSchemaLoader).
+    // Users which need the JSON anyway take it from here rather than from LoadData(), which would be parsed back again
+    Optional<Json::JSON> LoadJson() {
+        auto jData = mSchemaLoader.Load(mURI);
+        if (!jData.has_value()) {
+            mLog->error("Failed to load JSON data from file '{}'", mURI);
             return {};
         }
 
-        try {
-            // Let's iterate over other files in current dir and try to load other (sub)files
-            Json::JSON jData = Json::JSON::parse(jsonFile);
-            const std::filesystem::path filePath = mURI;
-            for(const auto& otherFile: std::filesystem::recursive_directory_iterator(filePath.parent_path())) {
-                if (std::filesystem::is_directory(otherFile)
-                    || (otherFile.path() == mURI)) {
-                    continue;
-                }
-
-                IFStream subFile(otherFile.path());
-                auto jCombinedPatch = Json::JSON::array();
-                size_t i = 0;
-                for (auto& diffItem : Json::JSON::diff(jData, Json::JSON::parse(subFile))) {
-                    if (diffItem[Json::Diff::Field::OPERATION] == Json::Diff::Operation::ADD) {
-                        jCombinedPatch[i++] = diffItem;
-                    }
-                }
-
-                jData = jData.patch(jCombinedPatch);
-            }
+        if (jData.value().empty()) {
+            mLog->error("JSON file '{}' is empty", mURI);
+            return {};
+        }
 
-            if (jData.empty()) {
-                mLog->error("JSON file '{}' is empty", mURI);
-                return {};
-            }
+        LOG_TRACE(mLog, "Successfully loaded JSON data from file '{}':\n{}", mURI, jData.value().dump(Json::DEFAULT_OUTPUT_INDENT));
+        return jData;
+    }
 
-            mLog->trace("Successfully loaded JSON data from file '{}':\n{}", mURI, jData.dump(Json::DEFAULT_OUTPUT_INDENT));
-            String jStrData = jData.dump();
-            return ByteStream(jStrData.begin(), jStrData.end());
-        }
-        catch (const Exception &ex) {
-            mLog->error("Failed to load JSON data from file '{}'. Error: {}", mURI, ex.what());
+    Optional<ByteStream> LoadData() override final {
+        auto jData = LoadJson();
+        if (!jData.has_value()) {
             return {};
         }
 
-        mLog->error("Failed to load JSON data from file '{}'", mURI);
-        return {};
+        String jStrData = jData.value().dump();
+        return ByteStream(jStrData.begin(), jStrData.end());
+    }
+
+    // LoadDataView() has to see the merged document as well, not the mapped content of the root file only
+    bool LoadDataView(const DataViewReader& reader) override final {
+        return IDataStorage::LoadDataView(reader);
+    }
+
+    // ContentHash() returns hash of all the files LoadData() would merge, which is much cheaper than loading them
+    Optional<uint64_t> ContentHash() {
+        return mSchemaLoader.ContentHash(mURI);
     }
 
     bool SaveData(const ByteStream& data) override final {
@@ -78,5 +70,7 @@ public:
         return false;
     }
 
+private:
+    JsonSchemaLoader mSchemaLoader;
 }; // class JsonFileStorage
 } // namespace Storage
@@ -0,0 +1,283 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "JsonCommon.hpp"
+#include "Lib/Logging.hpp"
+#include "Lib/MappedFile.hpp"
+#include "Lib/Utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+#include <sys/stat.h>
+
+namespace Storage {
+using namespace StdLib;
+/*
+    Loads the schema split into several files. The root file is accompanied by all other *.json files found
+    (recursively) in its directory. Every file contributes its "$defs" into a single registry, which becomes
+    "$defs" of the root schema, so references like "#/$defs/community-type" resolve no matter in which file
+    the definition lives. Other properties of the accompanying files are merged into the root schema only
+    where the root (or a file merged before) does not define them yet.
+
+    Each file is parsed once and kept in the cache keyed by its inode, modification time and size, so loading
+    the schema again parses only the files which have changed since the previous load.
+*/
+class JsonSchemaLoader {
+public:
+    explicit JsonSchemaLoader(SharedPtr<Log::SpdLogger> logger) : mLog(logger) {}
+
+    Optional<Json::JSON> Load(const String& rootFileName) {
+        Vector<std::filesystem::path> fileNames;
+        if (!ListFiles(rootFileName, fileNames)) {
+            return {};
+        }
+
+        mParsedFilesCount = 0;
+        bool isAnyFileChanged = (fileNames.size() != mFileCache.size());
+        Vector<const CachedFile*> files;
+        for (const auto& fileName : fileNames) {
+            auto cachedFile = LoadFile(fileName.string(), isAnyFileChanged);
+            if (!cachedFile) {
+                return {};
+            }
+
+            files.push_back(cachedFile);
+        }
+
+        if (isAnyFileChanged) {
+            // Forget files which are gone, so they are not counted in again
+            for (auto fileIt = mFileCache.begin(); fileIt != mFileCache.end();) {
+                if (std::find(fileNames.begin(), fileNames.end(), std::filesystem::path(fileIt->first)) == fileNames.end()) {
+                    fileIt = mFileCache.erase(fileIt);
+                }
+                else {
+                    ++fileIt;
+                }
+            }
+        }
+
+        if (!isAnyFileChanged && mMergedSchema.has_value()) {
+            LOG_TRACE(mLog, "Schema files of '{}' have not changed since the last load", rootFileName);
+            return mMergedSchema;
+        }
+
+        auto jMergedSchema = Merge(fileNames, files);
+        if (!jMergedSchema.has_value()) {
+            return {};
+        }
+
+        LOG_DEBUG(mLog, "Loaded schema '{}' from {} file(s), parsed {} of them", rootFileName, files.size(), mParsedFilesCount);
+        mMergedSchema = std::move(jMergedSchema);
+        return mMergedSchema;
+    }
+
+    // ContentHash() returns hash of names and content of all the files which make up the schema, without parsing them
+    Optional<uint64_t> ContentHash(const String& rootFileName) {
+        Vector<std::filesystem::path> fileNames;
+        if (!ListFiles(rootFileName, fileNames)) {
+            return {};
+        }
+
+        uint64_t hash = Utils::fFnv1a64(nullptr, 0);
+        for (const auto& fileName : fileNames) {
+            Utils::MappedFile file;
+            if (!file.Open(fileName.string())) {
+                mLog->error("Failed to open schema file '{}'. Error: {}", fileName.string(), file.Error());
+                return {};
+            }
+
+            const auto& name = fileName.native();
+            // Both sizes are hashed too, so moving bytes from one file into the other changes the hash
+            const uint64_t sizes[] = { name.size(), file.Size() };
+            hash = Utils::fFnv1a64(sizes, sizeof(sizes), hash);
+            hash = Utils::fFnv1a64(name.data(), name.size(), hash);
+            hash = Utils::fFnv1a64(file.Data(), file.Size(), hash);
+        }
+
+        return hash;
+    }
+
+    // ParsedFilesCount() tells how many files had to be parsed by the latest Load()
+    size_t ParsedFilesCount() const { return mParsedFilesCount; }
+
+private:
+    static constexpr auto JSON_FILE_EXTENSION = ".json";
+    static constexpr auto DEFS = "$defs";
+    static constexpr auto REF = "$ref";
+    static constexpr auto LOCAL_DEFS_REF_PREFIX = "#/$defs/";
+
+    struct CachedFile {
+        dev_t Device;
+        ino_t Inode;
+        int64_t ModifiedAtNs;
+        off_t Size;
+        Json::JSON Data;
+    };
+
+    SharedPtr<Log::SpdLogger> mLog;
+    Map<String, CachedFile> mFileCache;
+    Optional<Json::JSON> mMergedSchema;
+    size_t mParsedFilesCount = 0;
+
+    // ListFiles() returns the root file followed by the other schema files in the sorted order
+    bool ListFiles(const String& rootFileName, Vector<std::filesystem::path>& fileNames) {
+        const std::filesystem::path rootFilePath = rootFileName;
+        try {
+            for (const auto& otherFile : std::filesystem::recursive_directory_iterator(rootFilePath.parent_path().empty() ? "." : rootFilePath.parent_path())) {
+                if (otherFile.is_regular_file() && (otherFile.path().extension() == JSON_FILE_EXTENSION)
+                    && !std::filesystem::equivalent(otherFile.path(), rootFilePath)) {
+                    fileNames.emplace_back(otherFile.path());
+                }
+            }
+        }
+        catch (const Exception &ex) {
+            mLog->error("Failed to list schema files next to '{}'. Error: {}", rootFileName, ex.what());
+            return false;
+        }
+
+        // The directory order is unspecified, but the result of merging must not depend on it
+        std::sort(fileNames.begin(), fileNames.end());
+        fileNames.insert(fileNames.begin(), rootFilePath);
+        return true;
+    }
+
+    const CachedFile* LoadFile(const String& fileName, bool& isChanged) {
+        struct ::stat fileStat {};
+        if (::stat(fileName.c_str(), &fileStat) != 0) {
+            mLog->error("Failed to get status of schema file '{}'. Error: {}", fileName, std::strerror(errno));
+            return nullptr;
+        }
+
+        auto modifiedAtNs = static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1'000'000'000 + fileStat.st_mtim.tv_nsec;
+        auto cachedFileIt = mFileCache.find(fileName);
+        if ((cachedFileIt != mFileCache.end())
+            && (cachedFileIt->second.Device == fileStat.st_dev) && (cachedFileIt->second.Inode == fileStat.st_ino)
+            && (cachedFileIt->second.ModifiedAtNs == modifiedAtNs) && (cachedFileIt->second.Size == fileStat.st_size)) {
+            return &cachedFileIt->second;
+        }
+
+        Utils::MappedFile file;
+        if (!file.Open(fileName)) {
+            mLog->error("Failed to open schema file '{}'. Error: {}", fileName, file.Error());
+            return nullptr;
+        }
+
+        Json::JSON jData;
+        try {
+            jData = Json::JSON::parse(file.View());
+        }
+        catch (const Exception &ex) {
+            mLog->error("Failed to parse schema file '{}'. Error: {}", fileName, ex.what());
+            return nullptr;
+        }
+
+        if (!jData.is_object()) {
+            mLog->error("Schema file '{}' does not contain JSON object", fileName);
+            return nullptr;
+        }
+
+        ++mParsedFilesCount;
+        isChanged = true;
+        auto& cachedFile = mFileCache[fileName];
+        cachedFile = CachedFile { fileStat.st_dev, fileStat.st_ino, modifiedAtNs, fileStat.st_size, std::move(jData) };
+        return &cachedFile;
+    }
+
+    Optional<Json::JSON> Merge(const Vector<std::filesystem::path>& fileNames, const Vector<const CachedFile*>& files) {
+        // Registry of definitions: name of definition -> file which provides it
+        Map<String, String> defOwnerByName;
+        Json::JSON jMergedSchema = files[0]->Data;
+        Json::JSON jMergedDefs = jMergedSchema.contains(DEFS) ? jMergedSchema[DEFS] : Json::JSON::object();
+
+        for (const auto& [defName, _] : jMergedDefs.items()) {
+            defOwnerByName[defName] = fileNames[0].string();
+        }
+
+        for (size_t i = 1; i < files.size(); ++i) {
+            const auto& jData = files[i]->Data;
+            auto defsIt = jData.find(DEFS);
+            if (defsIt != jData.end()) {
+                for (const auto& [defName, jDef] : defsIt->items()) {
+                    auto defOwnerIt = defOwnerByName.find(defName);
+                    if (defOwnerIt == defOwnerByName.end()) {
+                        jMergedDefs[defName] = jDef;
+                        defOwnerByName[defName] = fileNames[i].string();
+                    }
+                    else if (jMergedDefs[defName] != jDef) {
+                        mLog->error("Definition '{}' in schema file '{}' conflicts with the one from '{}'", defName, fileNames[i].string(), defOwnerIt->second);
+                        return {};
+                    }
+                }
+            }
+
+            for (const auto& [key, jValue] : jData.items()) {
+                if (key != DEFS) {
+                    MergeMissing(jMergedSchema, key, jValue);
+                }
+            }
+        }
+
+        jMergedSchema[DEFS] = std::move(jMergedDefs);
+        String unresolvedRef;
+        if (!AreLocalRefsResolved(jMergedSchema, jMergedSchema[DEFS], unresolvedRef)) {
+            mLog->error("Reference '{}' does not point to any definition of the schema files", unresolvedRef);
+            return {};
+        }
+
+        return jMergedSchema;
+    }
+
+    static void MergeMissing(Json::JSON& jTarget, const String& key, const Json::JSON& jValue) {
+        auto targetIt = jTarget.find(key);
+        if (targetIt == jTarget.end()) {
+            jTarget[key] = jValue;
+            return;
+        }
+
+        if (targetIt->is_object() && jValue.is_object()) {
+            for (const auto& [subKey, jSubValue] : jValue.items()) {
+                MergeMissing(*targetIt, subKey, jSubValue);
+            }
+        }
+    }
+
+    static bool AreLocalRefsResolved(const Json::JSON& jNode, const Json::JSON& jDefs, String& unresolvedRef) {
+        if (jNode.is_object()) {
+            auto refIt = jNode.find(REF);
+            if ((refIt != jNode.end()) && refIt->is_string()) {
+                const auto& ref = refIt->template get_ref<const String&>();
+                if (ref.starts_with(LOCAL_DEFS_REF_PREFIX)) {
+                    try {
+                        if (!jDefs.contains(Json::JSON::json_pointer(ref.substr(std::strlen(LOCAL_DEFS_REF_PREFIX) - 1)))) {
+                            unresolvedRef = ref;
+                            return false;
+                        }
+                    }
+                    catch (const Exception&) {
+                        unresolvedRef = ref;
+                        return false;
+                    }
+                }
+            }
+
+            for (const auto& [_, jChild] : jNode.items()) {
+                if (!AreLocalRefsResolved(jChild, jDefs, unresolvedRef)) {
+                    return false;
+                }
+            }
+        }
+        else if (jNode.is_array()) {
+            for (const auto& jChild : jNode) {
+                if (!AreLocalRefsResolved(jChild, jDefs, unresolvedRef)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}; // class JsonSchemaLoader
+} // namespace Storage
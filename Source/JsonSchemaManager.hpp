@@ -7,32 +7,58 @@
 #include "IDataStorage.hpp"
 #include "JsonCommon.hpp"
 #include "JsonFileStorage.hpp"
+#include "JsonValidationCache.hpp"
+#include "Lib/IpAddress.hpp"
 #include "Lib/ModuleRegistry.hpp"
+#include "Lib/WorkerPool.hpp"
 #include "Modules.hpp"
 
 #include <nlohmann/json-schema.hpp>
 
+#include <algorithm>
+#include <bitset>
+#include <cctype>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 namespace Schema {
 using namespace StdLib;
 class JsonSchemaManager : public ISchemaManagement {
 public:
-    explicit JsonSchemaManager(SharedPtr<Storage::IDataStorage> dataStorage, const SharedPtr<ModuleRegistry>& moduleRegistry)
-      : mValidator(nullptr, nlohmann::json_schema::default_string_format_check), mDataStorage(dataStorage), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::SCHEMA_MNGMT)) {}
+    // The worker pool can be shared by several schema managers (e.g. the current and the reloaded one)
+    explicit JsonSchemaManager(SharedPtr<Storage::IDataStorage> dataStorage, const SharedPtr<ModuleRegistry>& moduleRegistry, SharedPtr<Utils::WorkerPool> workerPool = nullptr)
+      : mValidator(nullptr, &JsonSchemaManager::CheckStringFormat), mDataStorage(dataStorage), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::SCHEMA_MNGMT)),
+        mWorkerPool(workerPool ? workerPool : std::make_shared<Utils::WorkerPool>()), mValidationCache(VALIDATION_CACHE_CAPACITY_BYTES) {}
     bool LoadSchema() override {
         try {
-            auto schemaData = mDataStorage->LoadData();
-            if (!schemaData.has_value()) {
+            Json::JSON jSchema;
+            bool isLoaded = false;
+            // The merged schema is taken as it is, there is no point in serialising it just to parse it back
+            if (auto jsonFileStorage = std::dynamic_pointer_cast<Storage::JsonFileStorage>(mDataStorage)) {
+                auto jMergedSchema = jsonFileStorage->LoadJson();
+                if (jMergedSchema.has_value()) {
+                    jSchema = std::move(jMergedSchema.value());
+                    isLoaded = true;
+                }
+            }
+            else {
+                isLoaded = mDataStorage->LoadDataView([&jSchema](const Byte* data, const size_t size) {
+                    jSchema = Json::JSON::parse(data, data + size);
+                    return true;
+                });
+            }
+
+            if (!isLoaded) {
                 mLog->error("Failed to load JSON schema data from '{}'", mDataStorage->URI());
                 return false;
             }
 
-            Json::JSON jSchema = Json::JSON::parse(schemaData.value());
-            mValidator.set_root_schema(jSchema);
+            LockGuard<Mutex> lock(mValidatorMutex);
+            mJsonSchema = std::move(jSchema);
+            CompileValidators();
             mIsSchemaLoaded = true;
-            mLog->trace("Successfully loaded JSON schema from file {}:\n{}", mDataStorage->URI(), jSchema.dump(Json::DEFAULT_OUTPUT_INDENT));
+            LOG_TRACE(mLog, "Successfully loaded JSON schema from file {}:\n{}", mDataStorage->URI(), mJsonSchema.dump(Json::DEFAULT_OUTPUT_INDENT));
         }
         catch (const Exception &ex) {
             mLog->error("Failed to load JSON schema from file {}. Error: {}", mDataStorage->URI(), ex.what());
@@ -42,7 +68,31 @@ public:
         return true;
     }
 
+    // LoadSchema() takes the schema which has been already merged (e.g. restored from the snapshot). Compiling
+    // the validator is deferred until the first validation, so it does not delay the startup
+    bool LoadSchema(Json::JSON jSchema) {
+        if (!jSchema.is_object()) {
+            mLog->error("Failed to load JSON schema. Error: The schema is not JSON object");
+            return false;
+        }
+
+        LockGuard<Mutex> lock(mValidatorMutex);
+        mJsonSchema = std::move(jSchema);
+        mIsValidatorReady = false;
+        mIsSchemaLoaded = true;
+        return true;
+    }
+
+    // Schema() returns the merged schema which the data are validated against
+    const Json::JSON& Schema() const { return mJsonSchema; }
+
     bool ValidateData(const ByteStream& data) override {
+        String errors;
+        return ValidateData(data, errors);
+    }
+
+    bool ValidateData(const ByteStream& data, String& errors) override {
+        Tracing::ScopedSpan span(*mModuleRegistry->Tracer(), "JsonSchemaManager::ValidateData");
         if (!mIsSchemaLoaded) {
             mLog->error("Failed to validate data against the schema. Error: The schema has not been loaded yet");
             return false;
@@ -50,13 +100,34 @@ public:
 
         try {
             auto jdata = Json::JSON::parse(data);
-            ErrorHandler err(mLog);
-            mValidator.validate(jdata, err);
-            if (err) {
+            {
+                LockGuard<Mutex> lock(mValidatorMutex);
+                if (!mIsValidatorReady) {
+                    CompileValidators();
+                    LOG_DEBUG(mLog, "Compiled JSON schema validator on the first use");
+                }
+            }
+
+            // The validator works on unordered JSON, so convert the data once instead of each validated part apart
+            const nlohmann::json jInstance = jdata;
+            ErrorHandler err(mLog, mMaxErrorsCount);
+            try {
+                mValidator.validate(jInstance, err);
+            }
+            catch (const ErrorHandler::ErrorsLimitReached&) {
+                // Do not look for more errors
+            }
+
+            if (!err.IsLimitReached()) {
+                ValidateCollectionEntries(jInstance, err);
+            }
+
+            if (err.HasErrors()) {
+                errors = err.ToJson().dump();
                 mLog->error("Failed to validate data against schema. Error: {}", err.MsgError());
 		        return false;
             }
-            mLog->trace("Successfuly validated data against schema. Data:\n{}", jdata.dump(Json::DEFAULT_OUTPUT_INDENT));
+            LOG_TRACE(mLog, "Successfuly validated data against schema. Data:\n{}", jdata.dump(Json::DEFAULT_OUTPUT_INDENT));
         }
         catch (const nlohmann::json_schema::basic_error_handler &ex) {
             mLog->error("Caught non standard expecption.");
@@ -70,31 +141,481 @@ public:
         return true;
     }
 
-private:
-    nlohmann::json_schema::json_validator mValidator;
-    SharedPtr<Storage::IDataStorage> mDataStorage;
-    SharedPtr<ModuleRegistry> mModuleRegistry;
-    SharedPtr<Log::SpdLogger> mLog;
-    bool mIsSchemaLoaded = false;
+    // SetMaxErrorsCount() makes the validation stop once the given number of errors has been found (e.g. 1 - fail fast).
+    // Value 0 means that all the errors are reported
+    void SetMaxErrorsCount(const size_t maxErrorsCount) { mMaxErrorsCount = maxErrorsCount; }
+
+    Map<String, uint64_t> Statistics() override {
+        auto cacheStats = mValidationCache.Stats();
+        return {
+            { "validation_cache_hits", cacheStats.Hits },
+            { "validation_cache_misses", cacheStats.Misses },
+            { "validation_cache_evictions", cacheStats.Evictions },
+            { "validation_cache_entries", cacheStats.EntriesCount },
+            { "validation_cache_size_bytes", cacheStats.SizeBytes }
+        };
+    }
 
+private:
+    /*
+        Collects the errors as (pointer, keyword, message). The validator of the library does not stop by itself,
+        so once the limit of errors is reached, the error handler throws ErrorsLimitReached to break the validation.
+    */
     class ErrorHandler : public nlohmann::json_schema::basic_error_handler {
     public:
-        ErrorHandler(SharedPtr<Log::SpdLogger> logger) : mLog(logger) {}
-        String MsgError() { return osstream.str(); }
-    
+        struct ErrorsLimitReached : public Exception {
+            const char* what() const noexcept override { return "Limit of validation errors has been reached"; }
+        };
+
+        ErrorHandler(SharedPtr<Log::SpdLogger> logger, const size_t maxErrorsCount) : mLog(logger), mMaxErrorsCount(maxErrorsCount) {}
+        String MsgError() const {
+            std::ostringstream osstream;
+            for (const auto& error : mErrors) {
+                osstream << "'" << error.Pointer << "' (" << error.Keyword << "): " << error.Message << "\n";
+            }
+
+            if (IsLimitReached()) {
+                osstream << "Stopped after " << mErrors.size() << " error(s)\n";
+            }
+
+            return osstream.str();
+        }
+
+        Json::JSON ToJson() const {
+            Json::JSON jErrors = Json::JSON::array();
+            for (const auto& error : mErrors) {
+                jErrors.push_back({ { "pointer", error.Pointer }, { "keyword", error.Keyword }, { "message", error.Message } });
+            }
+
+            return jErrors;
+        }
+
+        bool HasErrors() const { return !mErrors.empty(); }
+        size_t ErrorsCount() const { return mErrors.size(); }
+        bool IsLimitReached() const { return (mMaxErrorsCount > 0) && (mErrors.size() >= mMaxErrorsCount); }
+        // Pointer of the instance, if it is only a part of the validated document
+        void SetPointerPrefix(const String& pointerPrefix) { mPointerPrefix = pointerPrefix; }
+        // Append() takes the errors of the other handler as long as they fit in the limit
+        void Append(ErrorHandler&& other) {
+            for (auto& error : other.mErrors) {
+                if (IsLimitReached()) {
+                    break;
+                }
+
+                mErrors.push_back(std::move(error));
+            }
+        }
+
+        // SortByPointer() orders the errors by the pointer, but keeps the order of errors of the same instance
+        void SortByPointer() {
+            std::stable_sort(mErrors.begin(), mErrors.end(), [](const ValidationError& lhs, const ValidationError& rhs) {
+                return IsPointerLess(lhs.Pointer, rhs.Pointer);
+            });
+        }
+
+        // IsPointerLess() compares the pointers token by token. Tokens which are array indices are compared as numbers,
+        // so "/10" goes after "/2"
+        static bool IsPointerLess(const StringView lhs, const StringView rhs) {
+            size_t lhsPos = 0;
+            size_t rhsPos = 0;
+            while ((lhsPos < lhs.size()) && (rhsPos < rhs.size())) {
+                auto lhsToken = lhs.substr(lhsPos, lhs.find('/', lhsPos + 1) - lhsPos);
+                auto rhsToken = rhs.substr(rhsPos, rhs.find('/', rhsPos + 1) - rhsPos);
+                if (lhsToken != rhsToken) {
+                    if (IsArrayIndex(lhsToken) && IsArrayIndex(rhsToken) && (lhsToken.size() != rhsToken.size())) {
+                        return lhsToken.size() < rhsToken.size();
+                    }
+
+                    return lhsToken < rhsToken;
+                }
+
+                lhsPos += lhsToken.size();
+                rhsPos += rhsToken.size();
+            }
+
+            // The pointer to the parent goes before the pointers to its children
+            return (lhsPos >= lhs.size()) && (rhsPos < rhs.size());
+        }
+
+        // IsArrayIndex() tells if the token (together with its leading '/') is a number without leading zeros
+        static bool IsArrayIndex(const StringView token) {
+            auto digits = token.substr(1);
+            return !digits.empty() && ((digits.size() == 1) || (digits.front() != '0'))
+                && std::all_of(digits.begin(), digits.end(), [](const char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+        }
+
     private:
+        struct ValidationError {
+            String Pointer;
+            String Keyword;
+            String Message;
+        };
+
         void error(const Json::JSON::json_pointer &ptr, const nlohmann::json &instance, const std::string &message) override {
             nlohmann::json_schema::basic_error_handler::error(ptr, instance, message);
-            osstream << "'" << ptr << "' >> '" << instance << "': " << message << "\n";
+            // The instance is not kept, since it can be as big as the whole document
+            mErrors.push_back({ mPointerPrefix + ptr.to_string(), KeywordOf(message), message });
             // 1. Check if it is oneOf
             // 2. If there in not an error 'not found in object', it points out correct oneOf entry which missing attribute
             if (message.find("case#0") != String::npos) {
-                mLog->trace("{}", osstream.str());
+                LOG_TRACE(mLog, "{}", MsgError());
+            }
+
+            if (IsLimitReached()) {
+                throw ErrorsLimitReached();
+            }
+        }
+
+        // KeywordOf() tells which keyword of the schema has failed. The library reports only the message, so the keyword is
+        // recognized by the message
+        static String KeywordOf(const String& message) {
+            static const Vector<Pair<String, String>> KEYWORD_BY_MESSAGE_PART = {
+                { "additional property", "additionalProperties" },
+                { "false-schema", "false" },
+                { "unexpected instance type", "type" },
+                { "required enum", "enum" },
+                { "instance not const", "const" },
+                { "required property", "required" },
+                { "as a dependency", "dependencies" },
+                { "one of them is required to validate", "oneOf" },
+                { "exactly one of them is required", "oneOf" },
+                { "all of them are required to validate", "allOf" },
+                { "required to not validate", "not" },
+                { "minLength", "minLength" },
+                { "maxLength", "maxLength" },
+                { "regex pattern", "pattern" },
+                { "format-checking failed", "format" },
+                { "exceeds or equals maximum", "exclusiveMaximum" },
+                { "below or equals minimum", "exclusiveMinimum" },
+                { "exceeds maximum", "maximum" },
+                { "below minimum", "minimum" },
+                { "multiple of", "multipleOf" },
+                { "too many items", "maxItems" },
+                { "too few items", "minItems" },
+                { "unique", "uniqueItems" },
+                { "'contains'", "contains" },
+                { "too many properties", "maxProperties" },
+                { "too few properties", "minProperties" },
+                { "property name", "propertyNames" }
+            };
+
+            for (const auto& [messagePart, keyword] : KEYWORD_BY_MESSAGE_PART) {
+                if (message.find(messagePart) != String::npos) {
+                    return keyword;
+                }
             }
+
+            return "unknown";
         }
 
         SharedPtr<Log::SpdLogger> mLog;
-        std::ostringstream osstream;
+        size_t mMaxErrorsCount;
+        String mPointerPrefix;
+        Vector<ValidationError> mErrors;
     };
+
+    // Entries of smaller collections are not worth to be handed over to the other threads
+    static constexpr size_t PARALLEL_MIN_ENTRIES_COUNT = 64;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+    static constexpr size_t VALIDATION_CACHE_CAPACITY_BYTES = 64 * 1024 * 1024;
+    static constexpr auto DEFS = "$defs";
+    static constexpr auto REF = "$ref";
+    static constexpr auto LOCAL_DEFS_REF_PREFIX = "#/$defs/";
+    static constexpr auto IPV4_FORMAT = "ipv4";
+    static constexpr auto IPV6_FORMAT = "ipv6";
+    static constexpr auto IPV4_PREFIX_FORMAT = "ipv4-prefix";
+    static constexpr auto IPV6_PREFIX_FORMAT = "ipv6-prefix";
+
+    /*
+        Matches names of entries of the collection without std::regex, since it is done for each entry of each
+        validated document. Only the pattern of the form "^[<characters and ranges>]+$" (e.g. "^[a-zA-Z0-9_]+$")
+        is understood, which covers names of the entries in the schema. Collection with other pattern is not split
+    */
+    class EntryNameMatcher {
+    public:
+        static Optional<EntryNameMatcher> Compile(const StringView pattern) {
+            constexpr StringView PATTERN_BEGIN = "^[";
+            constexpr StringView PATTERN_END = "]+$";
+            if (!pattern.starts_with(PATTERN_BEGIN) || !pattern.ends_with(PATTERN_END)
+                || (pattern.size() <= PATTERN_BEGIN.size() + PATTERN_END.size())) {
+                return {};
+            }
+
+            auto charClass = pattern.substr(PATTERN_BEGIN.size(), pattern.size() - PATTERN_BEGIN.size() - PATTERN_END.size());
+            EntryNameMatcher matcher;
+            for (size_t i = 0; i < charClass.size(); ++i) {
+                auto first = static_cast<unsigned char>(charClass[i]);
+                if ((first == '\\') || (first == '[') || (first == ']') || ((i == 0) && (first == '^'))) {
+                    return {};
+                }
+
+                auto last = first;
+                if ((i + 2 < charClass.size()) && (charClass[i + 1] == '-')) {
+                    last = static_cast<unsigned char>(charClass[i + 2]);
+                    if ((last < first) || (last == '\\') || (last == '[') || (last == ']')) {
+                        return {};
+                    }
+
+                    i += 2;
+                }
+
+                for (auto c = static_cast<unsigned>(first); c <= last; ++c) {
+                    matcher.mAllowedChars.set(c);
+                }
+            }
+
+            return matcher;
+        }
+
+        bool Matches(const StringView name) const {
+            return !name.empty() && std::all_of(name.begin(), name.end(), [this](const char c) { return mAllowedChars.test(static_cast<unsigned char>(c)); });
+        }
+
+    private:
+        std::bitset<256> mAllowedChars;
+    };
+
+    // Collection (JSON object) whose entries are validated independently against the same subschema
+    struct EntryCollection {
+        Json::JSON::json_pointer InstancePointer;
+        EntryNameMatcher EntryName;
+        SharedPtr<nlohmann::json_schema::json_validator> EntryValidator;
+    };
+
+    struct CollectionEntry {
+        String Pointer;
+        const nlohmann::json* Data;
+        size_t CollectionIdx;
+    };
+
+    nlohmann::json_schema::json_validator mValidator;
+    Json::JSON mJsonSchema;
+    Vector<EntryCollection> mEntryCollections;
+    Mutex mValidatorMutex;
+    SharedPtr<Storage::IDataStorage> mDataStorage;
+    SharedPtr<ModuleRegistry> mModuleRegistry;
+    SharedPtr<Log::SpdLogger> mLog;
+    SharedPtr<Utils::WorkerPool> mWorkerPool;
+    // Entries which have passed the validation against subschema of their collection
+    JsonValidationCache mValidationCache;
+    bool mIsSchemaLoaded = false;
+    bool mIsValidatorReady = false;
+    size_t mMaxErrorsCount = 0;
+
+    /*
+        Big collections of independent entries, like BGP sessions or prefix lists, are validated apart from the rest
+        of the document, so their entries can be validated in parallel. Such collection gets its own validator of
+        a single entry, and the validator of the whole document accepts any entry of the collection (the names of
+        entries are still checked by it). Splitting is safe only if the subschema of entry does not depend on
+        the rest of the document, so it is done only if all references point to "$defs".
+    */
+    void CompileValidators() {
+        Json::JSON jDocumentSchema = mJsonSchema;
+        Vector<EntryCollection> entryCollections;
+        if (AreAllRefsToDefs(mJsonSchema)) {
+            FindEntryCollections(jDocumentSchema, Json::JSON::json_pointer(), entryCollections);
+        }
+
+        mValidator.set_root_schema(jDocumentSchema);
+        mEntryCollections = std::move(entryCollections);
+        mIsValidatorReady = true;
+        LOG_DEBUG(mLog, "Entries of {} collection(s) are validated apart from the document", mEntryCollections.size());
+    }
+
+    void FindEntryCollections(Json::JSON& jSchemaNode, const Json::JSON::json_pointer& instancePointer, Vector<EntryCollection>& entryCollections) {
+        auto propertiesIt = jSchemaNode.find("properties");
+        if ((propertiesIt == jSchemaNode.end()) || !propertiesIt->is_object()) {
+            return;
+        }
+
+        for (auto propertyIt = propertiesIt->begin(); propertyIt != propertiesIt->end(); ++propertyIt) {
+            auto& jPropertySchema = propertyIt.value();
+            if (!jPropertySchema.is_object()) {
+                continue;
+            }
+
+            auto propertyPointer = instancePointer / propertyIt.key();
+            auto entryName = IsEntryCollection(jPropertySchema) ? EntryNameMatcher::Compile(jPropertySchema["patternProperties"].begin().key()) : std::nullopt;
+            if (!entryName.has_value()) {
+                FindEntryCollections(jPropertySchema, propertyPointer, entryCollections);
+                continue;
+            }
+
+            auto entryPatternIt = jPropertySchema["patternProperties"].begin();
+            auto& jEntrySchema = entryPatternIt.value();
+            Json::JSON jEntryRootSchema = jEntrySchema;
+            for (const auto& key : { "$schema", DEFS }) {
+                if (mJsonSchema.contains(key)) {
+                    jEntryRootSchema[key] = mJsonSchema[key];
+                }
+            }
+
+            auto entryValidator = std::make_shared<nlohmann::json_schema::json_validator>(nullptr, &JsonSchemaManager::CheckStringFormat);
+            entryValidator->set_root_schema(jEntryRootSchema);
+            entryCollections.push_back({ propertyPointer, entryName.value(), entryValidator });
+            jEntrySchema = true;
+        }
+    }
+
+    // IsEntryCollection() tells if the subschema describes JSON object whose values are checked only by single pattern property
+    static bool IsEntryCollection(const Json::JSON& jSchema) {
+        static const Vector<String> ALLOWED_KEYWORDS = {
+            "type", "patternProperties", "additionalProperties", "minProperties", "maxProperties", "propertyNames", "$comment", "description", "title"
+        };
+
+        for (const auto& [keyword, _] : jSchema.items()) {
+            if (std::find(ALLOWED_KEYWORDS.begin(), ALLOWED_KEYWORDS.end(), keyword) == ALLOWED_KEYWORDS.end()) {
+                return false;
+            }
+        }
+
+        auto patternPropertiesIt = jSchema.find("patternProperties");
+        auto additionalPropertiesIt = jSchema.find("additionalProperties");
+        return (jSchema.value("type", "") == "object")
+            && (patternPropertiesIt != jSchema.end()) && patternPropertiesIt->is_object() && (patternPropertiesIt->size() == 1)
+            && patternPropertiesIt->begin()->is_object() && !patternPropertiesIt->begin()->contains(DEFS)
+            && (additionalPropertiesIt != jSchema.end()) && (*additionalPropertiesIt == false);
+    }
+
+    /*
+        CheckStringFormat() checks formats of IP addresses and prefixes without std::regex, which the default format
+        checker of the library uses, since a big config can have millions of them. Other formats are left to the library.
+        The error is reported by the exception (as the library expects)
+    */
+    static void CheckStringFormat(const String& format, const String& value) {
+        Optional<Utils::IpAddress::Family> addrFamily;
+        if ((format == IPV4_FORMAT) || (format == IPV6_FORMAT)) {
+            // Link-local IPv6 address can be followed by the zone (interface) (e.g. fe80::1%eth0)
+            auto zonePos = (format == IPV6_FORMAT) ? value.find('%') : String::npos;
+            auto address = Utils::IpAddress::Parse(StringView(value).substr(0, zonePos));
+            if (address.has_value() && (zonePos != String::npos) && !IsLinkLocalZone(address.value(), StringView(value).substr(zonePos + 1))) {
+                address.reset();
+            }
+
+            addrFamily = address.has_value() ? Optional<Utils::IpAddress::Family>(address.value().AddrFamily) : std::nullopt;
+        }
+        else if ((format == IPV4_PREFIX_FORMAT) || (format == IPV6_PREFIX_FORMAT)) {
+            auto prefix = Utils::IpPrefix::Parse(value);
+            addrFamily = prefix.has_value() ? Optional<Utils::IpAddress::Family>(prefix.value().Address.AddrFamily) : std::nullopt;
+        }
+        else {
+            nlohmann::json_schema::default_string_format_check(format, value);
+            return;
+        }
+
+        auto expectedAddrFamily = ((format == IPV4_FORMAT) || (format == IPV4_PREFIX_FORMAT)) ? Utils::IpAddress::Family::IPV4 : Utils::IpAddress::Family::IPV6;
+        if (addrFamily != expectedAddrFamily) {
+            throw std::invalid_argument(value + " is not a valid " + format);
+        }
+    }
+
+    static bool IsLinkLocalZone(const Utils::IpAddress& address, const StringView zone) {
+        // fe80::/10
+        return (address.Bytes[0] == 0xFE) && ((address.Bytes[1] & 0xC0) == 0x80) && !zone.empty()
+            && std::all_of(zone.begin(), zone.end(), [](const char c) { return std::isalnum(static_cast<unsigned char>(c)); });
+    }
+
+    static bool AreAllRefsToDefs(const Json::JSON& jNode) {
+        if (jNode.is_object()) {
+            auto refIt = jNode.find(REF);
+            if ((refIt != jNode.end()) && (!refIt->is_string() || !refIt->template get_ref<const String&>().starts_with(LOCAL_DEFS_REF_PREFIX))) {
+                return false;
+            }
+        }
+
+        if (jNode.is_structured()) {
+            for (const auto& jChild : jNode) {
+                if (!AreAllRefsToDefs(jChild)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void ValidateCollectionEntries(const nlohmann::json& jData, ErrorHandler& err) {
+        Vector<CollectionEntry> entries;
+        for (size_t collectionIdx = 0; collectionIdx < mEntryCollections.size(); ++collectionIdx) {
+            const auto& entryCollection = mEntryCollections[collectionIdx];
+            if (!jData.contains(entryCollection.InstancePointer)) {
+                continue;
+            }
+
+            const auto& jCollection = jData.at(entryCollection.InstancePointer);
+            if (!jCollection.is_object()) {
+                // The validator of the document has already reported it
+                continue;
+            }
+
+            for (auto entryIt = jCollection.begin(); entryIt != jCollection.end(); ++entryIt) {
+                // Entries with other names are rejected by the validator of the document
+                if (!entryCollection.EntryName.Matches(entryIt.key())) {
+                    continue;
+                }
+
+                entries.push_back({ (entryCollection.InstancePointer / entryIt.key()).to_string(), &entryIt.value(), collectionIdx });
+            }
+        }
+
+        if (entries.empty()) {
+            return;
+        }
+
+        auto threadsCount = (entries.size() < PARALLEL_MIN_ENTRIES_COUNT) ? 1 : (mWorkerPool->WorkersCount() + 1);
+        auto chunksCount = std::min(entries.size(), threadsCount * CHUNKS_PER_THREAD);
+        auto chunkSize = (entries.size() + chunksCount - 1) / chunksCount;
+        chunksCount = (entries.size() + chunkSize - 1) / chunkSize;
+        // Each chunk looks for as many errors as fit in the limit. If the chunks before it have already found enough
+        // errors, the chunk stops, because its errors would not be reported anyway. This way the reported errors do not
+        // depend on how the chunks have been scheduled
+        auto maxChunkErrorsCount = (mMaxErrorsCount > 0) ? (mMaxErrorsCount - err.ErrorsCount()) : 0;
+        Vector<ErrorHandler> chunkErrs(chunksCount, ErrorHandler(mLog, maxChunkErrorsCount));
+        Vector<std::atomic<size_t>> chunkErrorsCounts(chunksCount);
+        auto isLimitReachedBefore = [&chunkErrorsCounts, maxChunkErrorsCount](const size_t chunkIdx) {
+            size_t errorsCount = 0;
+            for (size_t i = 0; i < chunkIdx; ++i) {
+                errorsCount += chunkErrorsCounts[i];
+            }
+
+            return (maxChunkErrorsCount > 0) && (errorsCount >= maxChunkErrorsCount);
+        };
+
+        mWorkerPool->RunParallel(chunksCount, [this, &entries, &chunkErrs, &chunkErrorsCounts, &isLimitReachedBefore, chunkSize](const size_t chunkIdx) {
+            auto& chunkErr = chunkErrs[chunkIdx];
+            auto chunkEnd = std::min(entries.size(), (chunkIdx + 1) * chunkSize);
+            for (auto entryIdx = chunkIdx * chunkSize; (entryIdx < chunkEnd) && !isLimitReachedBefore(chunkIdx); ++entryIdx) {
+                const auto& entry = entries[entryIdx];
+                auto entryKey = JsonValidationCache::KeyOf(*entry.Data);
+                if (mValidationCache.Contains(entry.CollectionIdx, *entry.Data, entryKey)) {
+                    continue;
+                }
+
+                auto errorsCount = chunkErr.ErrorsCount();
+                chunkErr.SetPointerPrefix(entry.Pointer);
+                try {
+                    mEntryCollections[entry.CollectionIdx].EntryValidator->validate(*entry.Data, chunkErr);
+                }
+                catch (const ErrorHandler::ErrorsLimitReached&) {
+                    chunkErrorsCounts[chunkIdx] = chunkErr.ErrorsCount();
+                    return;
+                }
+
+                if (chunkErr.ErrorsCount() == errorsCount) {
+                    mValidationCache.Insert(entry.CollectionIdx, *entry.Data, entryKey);
+                }
+                else {
+                    chunkErrorsCounts[chunkIdx] = chunkErr.ErrorsCount();
+                }
+            }
+        });
+
+        // The chunks follow the order of entries, but errors of the document have been reported before them
+        for (auto& chunkErr : chunkErrs) {
+            err.Append(std::move(chunkErr));
+        }
+
+        err.SortByPointer();
+    }
 }; // JsonSchemaManager
 } // namespace Schema
@@ -0,0 +1,176 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "IDataStorage.hpp"
+#include "JsonCommon.hpp"
+#include "Lib/MappedFile.hpp"
+#include "Lib/ModuleRegistry.hpp"
+#include "Lib/Utils.hpp"
+#include "Modules.hpp"
+
+#include <cstring>
+
+namespace Schema {
+using namespace StdLib;
+/*
+    Binary snapshot of what the startup has already done once: the merged schema (in CBOR) with the hash of the
+    schema files it has been made of, and the hashes of the startup config which has passed the validation
+    against that schema and of the target config which has been accepted by the external program.
+
+    The snapshot is only a cache. Each part of it is used only when the hash of its sources is still the same,
+    otherwise the startup does the full work and saves the snapshot again.
+
+    The snapshot made by other build is not used at all, since that build could merge the schema or convert
+    the config differently.
+
+    File layout: magic (8 bytes), CRC-32 of the payload (4 bytes, little endian), payload (CBOR).
+*/
+class JsonSchemaSnapshot {
+public:
+    explicit JsonSchemaSnapshot(SharedPtr<Storage::IDataStorage> dataStorage, const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : mDataStorage(dataStorage), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::SCHEMA_MNGMT)) {}
+
+    // Load() reads the snapshot. Missing or damaged snapshot is not an error, it is just not used then
+    bool Load() {
+        mJsonSnapshot = {};
+        Utils::MappedFile file;
+        if (!file.Open(mDataStorage->URI())) {
+            mLog->info("Schema snapshot '{}' is not available. Error: {}", mDataStorage->URI(), file.Error());
+            return false;
+        }
+
+        if ((file.Size() < HEADER_SIZE) || (std::memcmp(file.Data(), MAGIC, MAGIC_SIZE) != 0)) {
+            mLog->warn("File '{}' is not the schema snapshot", mDataStorage->URI());
+            return false;
+        }
+
+        uint32_t payloadCrc = 0;
+        for (size_t i = 0; i < sizeof(payloadCrc); ++i) {
+            payloadCrc |= static_cast<uint32_t>(file.Data()[MAGIC_SIZE + i]) << (8 * i);
+        }
+
+        auto payload = file.Data() + HEADER_SIZE;
+        auto payloadSize = file.Size() - HEADER_SIZE;
+        if (Utils::fCrc32(payload, payloadSize) != payloadCrc) {
+            mLog->warn("Schema snapshot '{}' is damaged", mDataStorage->URI());
+            return false;
+        }
+
+        try {
+            auto jSnapshot = Json::JSON::from_cbor(payload, payload + payloadSize);
+            if (!jSnapshot.is_object() || !jSnapshot.contains(Field::SCHEMA_HASH) || !jSnapshot.contains(Field::SCHEMA)) {
+                mLog->warn("Schema snapshot '{}' misses the schema", mDataStorage->URI());
+                return false;
+            }
+
+            if (jSnapshot.value(Field::BUILD_TAG, "") != BUILD_TAG) {
+                mLog->info("Skipped schema snapshot '{}' made by other build", mDataStorage->URI());
+                return false;
+            }
+
+            mJsonSnapshot = std::move(jSnapshot);
+        }
+        catch (const Exception &ex) {
+            mLog->warn("Failed to decode schema snapshot '{}'. Error: {}", mDataStorage->URI(), ex.what());
+            return false;
+        }
+
+        LOG_DEBUG(mLog, "Loaded schema snapshot '{}'", mDataStorage->URI());
+        return true;
+    }
+
+    bool Save(const Json::JSON& jSchema, const uint64_t schemaHash, const Optional<uint64_t>& configHash, const Optional<uint64_t>& targetHash) {
+        Json::JSON jSnapshot;
+        jSnapshot[Field::BUILD_TAG] = BUILD_TAG;
+        jSnapshot[Field::SCHEMA_HASH] = schemaHash;
+        jSnapshot[Field::CONFIG_HASH] = configHash.has_value() ? Json::JSON(configHash.value()) : Json::JSON();
+        jSnapshot[Field::TARGET_HASH] = targetHash.has_value() ? Json::JSON(targetHash.value()) : Json::JSON();
+        jSnapshot[Field::SCHEMA] = jSchema;
+
+        ByteStream data(MAGIC, MAGIC + MAGIC_SIZE);
+        try {
+            auto payload = Json::JSON::to_cbor(jSnapshot);
+            auto payloadCrc = Utils::fCrc32(payload.data(), payload.size());
+            for (size_t i = 0; i < sizeof(payloadCrc); ++i) {
+                data.push_back(static_cast<Byte>(payloadCrc >> (8 * i)));
+            }
+
+            data.insert(data.end(), payload.begin(), payload.end());
+        }
+        catch (const Exception &ex) {
+            mLog->error("Failed to encode schema snapshot '{}'. Error: {}", mDataStorage->URI(), ex.what());
+            return false;
+        }
+
+        if (!mDataStorage->SaveData(data)) {
+            mLog->error("Failed to save schema snapshot into '{}'", mDataStorage->URI());
+            return false;
+        }
+
+        mJsonSnapshot = std::move(jSnapshot);
+        LOG_DEBUG(mLog, "Saved schema snapshot into '{}'", mDataStorage->URI());
+        return true;
+    }
+
+    // TakeSchema() hands over the merged schema if it has been made of the schema files with the same hash
+    Optional<Json::JSON> TakeSchema(const uint64_t schemaHash) {
+        if (!IsHashEqual(Field::SCHEMA_HASH, schemaHash)) {
+            return {};
+        }
+
+        Json::JSON jSchema = std::move(mJsonSnapshot[Field::SCHEMA]);
+        mJsonSnapshot.erase(Field::SCHEMA);
+        return jSchema;
+    }
+
+    // IsConfigValidated() tells if the config has already passed the validation against the schema
+    bool IsConfigValidated(const uint64_t schemaHash, const uint64_t configHash) const {
+        return IsHashEqual(Field::SCHEMA_HASH, schemaHash) && IsHashEqual(Field::CONFIG_HASH, configHash);
+    }
+
+    // IsTargetValidated() tells if the target config converted from the validated config has been accepted
+    bool IsTargetValidated(const uint64_t schemaHash, const uint64_t configHash, const uint64_t targetHash) const {
+        return IsConfigValidated(schemaHash, configHash) && IsHashEqual(Field::TARGET_HASH, targetHash);
+    }
+
+    // FilesHash() returns hash of the content of all the files, or nothing if any of them cannot be read
+    static Optional<uint64_t> FilesHash(const Vector<String>& fileNames, uint64_t hash = Utils::fFnv1a64(nullptr, 0)) {
+        for (const auto& fileName : fileNames) {
+            Utils::MappedFile file;
+            if (!file.Open(fileName)) {
+                return {};
+            }
+
+            hash = Utils::fFnv1a64(file.Data(), file.Size(), hash);
+        }
+
+        return hash;
+    }
+
+private:
+    static constexpr char MAGIC[] = { 'R', 'C', 'A', 'S', 'N', 'P', '0', '2' };
+    static constexpr auto BUILD_TAG = __DATE__ " " __TIME__;
+    static constexpr size_t MAGIC_SIZE = sizeof(MAGIC);
+    static constexpr size_t HEADER_SIZE = MAGIC_SIZE + sizeof(uint32_t);
+
+    struct Field {
+        static constexpr auto BUILD_TAG = "build-tag";
+        static constexpr auto CONFIG_HASH = "config-hash";
+        static constexpr auto SCHEMA = "schema";
+        static constexpr auto SCHEMA_HASH = "schema-hash";
+        static constexpr auto TARGET_HASH = "target-hash";
+    };
+
+    SharedPtr<Storage::IDataStorage> mDataStorage;
+    SharedPtr<ModuleRegistry> mModuleRegistry;
+    SharedPtr<Log::SpdLogger> mLog;
+    Json::JSON mJsonSnapshot;
+
+    bool IsHashEqual(const char* field, const uint64_t hash) const {
+        auto fieldIt = mJsonSnapshot.find(field);
+        return (fieldIt != mJsonSnapshot.end()) && fieldIt->is_number_unsigned() && (fieldIt->get<uint64_t>() == hash);
+    }
+}; // class JsonSchemaSnapshot
+} // namespace Schema
@@ -0,0 +1,226 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/StdLib.hpp"
+#include "Lib/Utils.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace Schema {
+using namespace StdLib;
+/*
+    Remembers instances which have passed the validation against the given subschema, so the same instance does not
+    have to be validated again. Only passes are recorded: errors have to be reported each time anyway. The instance
+    is looked up by its structural hash (see KeyOf()), which walks the JSON tree without serializing it, and then
+    compared with the remembered copy, so a hash collision cannot turn an error into a pass. The least recently used
+    instances are evicted once the total size of the remembered instances exceeds the capacity. The cache is split
+    into shards, so the threads validating in parallel rarely wait for each other.
+*/
+class JsonValidationCache {
+public:
+    struct Statistics {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        uint64_t Evictions = 0;
+        uint64_t EntriesCount = 0;
+        uint64_t SizeBytes = 0;
+    };
+
+    // Structural hash of the instance together with the approximate memory taken by its copy
+    struct InstanceKey {
+        uint64_t Hash = 0;
+        size_t SizeBytes = 0;
+    };
+
+    explicit JsonValidationCache(const size_t capacityBytes) : mShardCapacityBytes(capacityBytes / SHARDS_COUNT) {}
+
+    // KeyOf() hashes the instance once, the key is used by both Contains() and Insert(). Keys of the unordered JSON
+    // are sorted, so the same instance always gets the same hash
+    static InstanceKey KeyOf(const nlohmann::json& instance) {
+        InstanceKey key;
+        key.Hash = Utils::fFnv1a64(nullptr, 0);
+        HashNode(instance, key);
+        return key;
+    }
+
+    // Contains() tells if the instance has already passed the validation against the subschema
+    bool Contains(const size_t subschemaId, const nlohmann::json& instance, const InstanceKey& instanceKey) {
+        auto hash = Hash(subschemaId, instanceKey);
+        auto& shard = mShards[hash % SHARDS_COUNT];
+        LockGuard<Mutex> lock(shard.EntriesMutex);
+        auto entryIt = shard.EntryByKey.find(KeyView { subschemaId, &instance, hash });
+        if (entryIt == shard.EntryByKey.end()) {
+            ++mMisses;
+            return false;
+        }
+
+        shard.Entries.splice(shard.Entries.begin(), shard.Entries, entryIt->second);
+        ++mHits;
+        return true;
+    }
+
+    // Insert() records the instance which has passed the validation against the subschema
+    void Insert(const size_t subschemaId, const nlohmann::json& instance, const InstanceKey& instanceKey) {
+        auto entrySize = instanceKey.SizeBytes + ENTRY_OVERHEAD_BYTES;
+        if (entrySize > mShardCapacityBytes) {
+            return;
+        }
+
+        auto hash = Hash(subschemaId, instanceKey);
+        auto& shard = mShards[hash % SHARDS_COUNT];
+        LockGuard<Mutex> lock(shard.EntriesMutex);
+        if (shard.EntryByKey.contains(KeyView { subschemaId, &instance, hash })) {
+            return;
+        }
+
+        while (!shard.Entries.empty() && (shard.SizeBytes + entrySize > mShardCapacityBytes)) {
+            auto& lruEntry = shard.Entries.back();
+            shard.EntryByKey.erase(KeyView { lruEntry.SubschemaId, &lruEntry.Instance, lruEntry.Hash });
+            shard.SizeBytes -= lruEntry.SizeBytes;
+            shard.Entries.pop_back();
+            ++mEvictions;
+        }
+
+        shard.Entries.push_front(Entry { subschemaId, instance, hash, entrySize });
+        auto& entry = shard.Entries.front();
+        shard.EntryByKey.emplace(KeyView { entry.SubschemaId, &entry.Instance, entry.Hash }, shard.Entries.begin());
+        shard.SizeBytes += entrySize;
+    }
+
+    Statistics Stats() {
+        Statistics stats;
+        stats.Hits = mHits;
+        stats.Misses = mMisses;
+        stats.Evictions = mEvictions;
+        for (auto& shard : mShards) {
+            LockGuard<Mutex> lock(shard.EntriesMutex);
+            stats.EntriesCount += shard.Entries.size();
+            stats.SizeBytes += shard.SizeBytes;
+        }
+
+        return stats;
+    }
+
+private:
+    static constexpr size_t SHARDS_COUNT = 16;
+    // Approximate memory taken by the bookkeeping of single entry (list node, index entry)
+    static constexpr size_t ENTRY_OVERHEAD_BYTES = 128;
+
+    struct Entry {
+        size_t SubschemaId;
+        nlohmann::json Instance;
+        uint64_t Hash;
+        size_t SizeBytes;
+    };
+
+    // Key of the index refers to the instance kept in the list, so the instance is not stored twice
+    struct KeyView {
+        size_t SubschemaId;
+        const nlohmann::json* Instance;
+        uint64_t Hash;
+
+        bool operator==(const KeyView& other) const {
+            return (Hash == other.Hash) && (SubschemaId == other.SubschemaId) && (*Instance == *other.Instance);
+        }
+    };
+
+    struct KeyViewHash {
+        size_t operator()(const KeyView& key) const { return static_cast<size_t>(key.Hash); }
+    };
+
+    struct Shard {
+        Mutex EntriesMutex;
+        std::list<Entry> Entries; // The most recently used first
+        std::unordered_map<KeyView, std::list<Entry>::iterator, KeyViewHash> EntryByKey;
+        size_t SizeBytes = 0;
+    };
+
+    const size_t mShardCapacityBytes;
+    std::array<Shard, SHARDS_COUNT> mShards;
+    std::atomic<uint64_t> mHits = 0;
+    std::atomic<uint64_t> mMisses = 0;
+    std::atomic<uint64_t> mEvictions = 0;
+
+    static uint64_t Hash(const size_t subschemaId, const InstanceKey& instanceKey) {
+        uint64_t subschemaIdValue = subschemaId;
+        auto hash = Utils::fFnv1a64(&subschemaIdValue, sizeof(subschemaIdValue), instanceKey.Hash);
+        // The lower bits select the shard, the map of the shard uses the whole hash
+        return hash ^ (hash >> 32);
+    }
+
+    // HashNode() hashes the type, the size and the content of each node, so differently nested instances differ
+    static void HashNode(const nlohmann::json& node, InstanceKey& key) {
+        auto type = static_cast<uint8_t>(node.type());
+        key.Hash = Utils::fFnv1a64(&type, sizeof(type), key.Hash);
+        key.SizeBytes += sizeof(nlohmann::json);
+        switch (node.type()) {
+        case nlohmann::json::value_t::object: {
+            uint64_t size = node.size();
+            key.Hash = Utils::fFnv1a64(&size, sizeof(size), key.Hash);
+            for (auto it = node.begin(); it != node.end(); ++it) {
+                const auto& nodeKey = it.key();
+                uint64_t keySize = nodeKey.size();
+                key.Hash = Utils::fFnv1a64(&keySize, sizeof(keySize), key.Hash);
+                key.Hash = Utils::fFnv1a64(nodeKey.data(), nodeKey.size(), key.Hash);
+                key.SizeBytes += sizeof(String) + nodeKey.size();
+                HashNode(it.value(), key);
+            }
+
+            break;
+        }
+        case nlohmann::json::value_t::array: {
+            uint64_t size = node.size();
+            key.Hash = Utils::fFnv1a64(&size, sizeof(size), key.Hash);
+            for (const auto& item : node) {
+                HashNode(item, key);
+            }
+
+            break;
+        }
+        case nlohmann::json::value_t::string: {
+            const auto& value = node.get_ref<const String&>();
+            uint64_t size = value.size();
+            key.Hash = Utils::fFnv1a64(&size, sizeof(size), key.Hash);
+            key.Hash = Utils::fFnv1a64(value.data(), value.size(), key.Hash);
+            key.SizeBytes += sizeof(String) + value.size();
+            break;
+        }
+        case nlohmann::json::value_t::boolean: {
+            auto value = node.get<bool>();
+            key.Hash = Utils::fFnv1a64(&value, sizeof(value), key.Hash);
+            break;
+        }
+        case nlohmann::json::value_t::number_integer: {
+            auto value = node.get<int64_t>();
+            key.Hash = Utils::fFnv1a64(&value, sizeof(value), key.Hash);
+            break;
+        }
+        case nlohmann::json::value_t::number_unsigned: {
+            auto value = node.get<uint64_t>();
+            key.Hash = Utils::fFnv1a64(&value, sizeof(value), key.Hash);
+            break;
+        }
+        case nlohmann::json::value_t::number_float: {
+            auto value = node.get<double>();
+            key.Hash = Utils::fFnv1a64(&value, sizeof(value), key.Hash);
+            break;
+        }
+        case nlohmann::json::value_t::binary: {
+            const auto& value = node.get_binary();
+            key.Hash = Utils::fFnv1a64(value.data(), value.size(), key.Hash);
+            key.SizeBytes += value.size();
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}; // class JsonValidationCache
+} // namespace Schema
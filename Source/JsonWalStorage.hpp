@@ -0,0 +1,534 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "FileStorage.hpp"
+
+#include "JsonCommon.hpp"
+#include "Lib/Utils.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace Storage {
+/*
+    Stores JSON document as a checkpoint file (the URI) and an append-only write-ahead log (the URI + ".wal").
+    Each SaveData() appends only the JSON patch between the last saved document and the new one, so a commit
+    costs an append plus fsync instead of rewriting the whole file. Concurrent commits share a single fsync
+    (group commit). A background thread folds the log into the checkpoint file once it grows big enough.
+
+    WAL layout (host byte order):
+        header: magic[8] | base checkpoint CRC-32 (u32) | header CRC-32 (u32)
+        record: payload length (u32) | payload CRC-32 (u32) | payload (JSON patch)
+    The log is replayed only on top of the checkpoint whose CRC-32 matches its header. It makes the log
+    created before the latest checkpoint stale, so the records cannot be applied twice after a crash.
+    Replaying stops at the first torn or corrupted record and the log is truncated at that point.
+
+    The background checkpoint writes the full document without holding the lock, so commits go on appending
+    to the current log meanwhile. Once the document is durable in URI + ".next", the log based on it (carrying
+    the records committed in the meantime) is written to the WAL URI + ".next" and both files are renamed in
+    place: the checkpoint first, then the log. Recovery of a crash between the two renames finds the new
+    checkpoint together with the log still waiting in WAL URI + ".next".
+
+    A failed fsync leaves it unknown which records reached the disk. The document kept in memory is dropped
+    then and the next LoadData() recovers it from the disk again.
+*/
+class JsonWalStorage : public FileStorage {
+public:
+    struct Options {
+        size_t CheckpointRecords = 64;
+        size_t CheckpointBytes = 4 * 1024 * 1024;
+        // Leader of group commit waits that long before fsync to collect more appends
+        std::chrono::microseconds GroupCommitWindow = std::chrono::microseconds(0);
+    };
+
+    JsonWalStorage(const String& fileName, const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : JsonWalStorage(fileName, moduleRegistry, Options()) {}
+    JsonWalStorage(const String& fileName, const SharedPtr<ModuleRegistry>& moduleRegistry, const Options& options)
+      : FileStorage(fileName, moduleRegistry), mWalURI(fileName + WAL_FILE_SUFFIX), mOptions(options) {
+        mCheckpointThread = Thread([this]() { RunCheckpointing(); });
+    }
+
+    virtual ~JsonWalStorage() {
+        {
+            LockGuard<Mutex> _(mMutex);
+            mStop = true;
+        }
+
+        mCheckpointCondVar.notify_all();
+        if (mCheckpointThread.joinable()) {
+            mCheckpointThread.join();
+        }
+
+        if (mWalFd >= 0) {
+            ::close(mWalFd);
+        }
+    }
+
+    String WalURI() const { return mWalURI; }
+
+    // The first call recovers the document from the checkpoint and the log. Later calls return the document
+    // kept in memory, since every SaveData() goes through this instance
+    Optional<ByteStream> LoadData() override final {
+        LockGuard<Mutex> _(mMutex);
+        if (!mIsLoaded && !Recover()) {
+            return {};
+        }
+
+        String jStrData = mJsonData.dump();
+        return ByteStream(jStrData.begin(), jStrData.end());
+    }
+
+    bool SaveData(const ByteStream& data) override final {
+        if (data.size() == 0) {
+            mLog->error("No JSON data to save into file '{}'", mURI);
+            return false;
+        }
+
+        Json::JSON jNewData;
+        try {
+            jNewData = Json::JSON::parse(data);
+        }
+        catch (const Exception &ex) {
+            mLog->error("Failed to parse JSON data to save into '{}'. Error: {}", mURI, ex.what());
+            return false;
+        }
+
+        UniqueLock<Mutex> lock(mMutex);
+        if (!mIsLoaded || mIsWalBroken) {
+            // There is no consistent base for a patch, so write down full document and start the log from scratch
+            return Checkpoint(std::move(jNewData), lock);
+        }
+
+        String payload;
+        try {
+            auto jPatch = Json::JSON::diff(mJsonData, jNewData);
+            if (jPatch.empty()) {
+                return true;
+            }
+
+            payload = jPatch.dump();
+        }
+        catch (const Exception &ex) {
+            mLog->error("Failed to make JSON patch for '{}'. Error: {}", mURI, ex.what());
+            return false;
+        }
+
+        if (!AppendRecord(payload)) {
+            return false;
+        }
+
+        mJsonData = std::move(jNewData);
+        mPendingPatches.emplace_back(std::move(payload));
+        auto lsn = ++mWrittenLsn;
+        if (!WaitUntilDurable(lsn, lock)) {
+            // Neither the new nor the previous document is known to be the durable one
+            mIsLoaded = false;
+            mJsonData = {};
+            mPendingPatches.clear();
+            return false;
+        }
+
+        if (IsCheckpointRequired()) {
+            mCheckpointCondVar.notify_one();
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr auto WAL_FILE_SUFFIX = ".wal";
+    static constexpr auto NEXT_FILE_SUFFIX = ".next";
+    static constexpr char WAL_MAGIC[8] = { 'R', 'C', 'A', 'W', 'A', 'L', '0', '1' };
+    static constexpr size_t WAL_HEADER_SIZE = sizeof(WAL_MAGIC) + 2 * sizeof(uint32_t);
+    static constexpr size_t WAL_RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+    const String mWalURI;
+    const Options mOptions;
+    Json::JSON mJsonData;
+    Vector<String> mPendingPatches; // Records in the log which have not been checkpointed yet
+    int mWalFd = -1;
+    size_t mWalSize = 0;
+    uint64_t mWrittenLsn = 0;
+    uint64_t mSyncedLsn = 0;
+    bool mIsLoaded = false;
+    bool mIsSyncInProgress = false;
+    bool mIsWalBroken = false;
+    bool mStop = false;
+    uint64_t mCheckpointGeneration = 0; // Changed by every checkpoint and recovery
+    Mutex mMutex;
+    ConditionVariable mSyncCondVar;
+    ConditionVariable mCheckpointCondVar;
+    Thread mCheckpointThread;
+
+    bool Recover() {
+        uint32_t baseCrc = 0;
+        auto isLoaded = FileStorage::LoadDataView([this, &baseCrc](const Byte* data, const size_t size) {
+            try {
+                mJsonData = Json::JSON::parse(data, data + size);
+            }
+            catch (const Exception &ex) {
+                mLog->error("Failed to parse checkpoint JSON data from file '{}'. Error: {}", mURI, ex.what());
+                return false;
+            }
+
+            baseCrc = Utils::fCrc32(data, size);
+            return true;
+        });
+
+        if (!isLoaded) {
+            return false;
+        }
+
+        mPendingPatches.clear();
+        if (!FinishInterruptedCheckpoint(baseCrc)) {
+            return false;
+        }
+
+        Utils::MappedFile walData;
+        if (std::filesystem::exists(mWalURI) && !walData.Open(mWalURI)) {
+            mLog->error("Failed to open write-ahead log '{}'. Error: {}", mWalURI, walData.Error());
+            return false;
+        }
+
+        size_t validSize = 0;
+        if ((walData.Size() > 0) && IsValidWalHeader(walData, baseCrc)) {
+            validSize = ReplayRecords(walData);
+        }
+        else if (walData.Size() > 0) {
+            mLog->info("Skipped write-ahead log '{}' because it does not belong to checkpoint '{}'", mWalURI, mURI);
+        }
+
+        auto walSize = walData.Size();
+        walData.Close();
+
+        if (validSize == 0) {
+            // Start a new log which contains the records replayed so far (none)
+            if (!RotateWal(baseCrc)) {
+                return false;
+            }
+        }
+        else {
+            if (mWalFd >= 0) {
+                ::close(mWalFd);
+            }
+
+            mWalFd = ::open(mWalURI.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+            if (mWalFd < 0) {
+                mLog->error("Failed to open write-ahead log '{}'. Error: {}", mWalURI, std::strerror(errno));
+                return false;
+            }
+
+            if (validSize < walSize) {
+                mLog->warn("Truncated torn tail of write-ahead log '{}' at offset {} (file size {})", mWalURI, validSize, walSize);
+                if ((::ftruncate(mWalFd, static_cast<off_t>(validSize)) != 0) || (::fsync(mWalFd) != 0)) {
+                    mLog->error("Failed to truncate write-ahead log '{}'. Error: {}", mWalURI, std::strerror(errno));
+                    return false;
+                }
+            }
+
+            mWalSize = validSize;
+        }
+
+        mLog->info("Recovered JSON data from '{}' and {} record(s) of write-ahead log", mURI, mPendingPatches.size());
+        mIsLoaded = true;
+        mIsWalBroken = false;
+        ++mCheckpointGeneration;
+        mCheckpointCondVar.notify_one();
+        return true;
+    }
+
+    // FinishInterruptedCheckpoint() completes the checkpoint which crashed after its document had been renamed
+    // in place but before its log was. Files of checkpoint which crashed earlier than that are just removed
+    bool FinishInterruptedCheckpoint(const uint32_t baseCrc) {
+        std::error_code errCode = {};
+        std::filesystem::remove(mURI + NEXT_FILE_SUFFIX, errCode);
+        const auto nextWalURI = mWalURI + NEXT_FILE_SUFFIX;
+        if (!std::filesystem::exists(nextWalURI)) {
+            return true;
+        }
+
+        Utils::MappedFile nextWalData;
+        if (!nextWalData.Open(nextWalURI)) {
+            mLog->error("Failed to open write-ahead log '{}'. Error: {}", nextWalURI, nextWalData.Error());
+            return false;
+        }
+
+        auto isNextWalValid = IsValidWalHeader(nextWalData, baseCrc);
+        nextWalData.Close();
+        if (!isNextWalValid) {
+            std::filesystem::remove(nextWalURI, errCode);
+            return true;
+        }
+
+        mLog->info("Completed interrupted checkpoint of '{}' with write-ahead log '{}'", mURI, nextWalURI);
+        std::filesystem::rename(nextWalURI, mWalURI, errCode);
+        if (errCode) {
+            mLog->error("Failed to rename write-ahead log '{}' to '{}'. Error: {}", nextWalURI, mWalURI, errCode.message());
+            return false;
+        }
+
+        return SyncParentDir(mWalURI);
+    }
+
+    bool IsValidWalHeader(const Utils::MappedFile& walData, const uint32_t baseCrc) {
+        if (walData.Size() < WAL_HEADER_SIZE) {
+            return false;
+        }
+
+        uint32_t walBaseCrc = 0;
+        uint32_t headerCrc = 0;
+        std::memcpy(&walBaseCrc, walData.Data() + sizeof(WAL_MAGIC), sizeof(walBaseCrc));
+        std::memcpy(&headerCrc, walData.Data() + sizeof(WAL_MAGIC) + sizeof(walBaseCrc), sizeof(headerCrc));
+        return (std::memcmp(walData.Data(), WAL_MAGIC, sizeof(WAL_MAGIC)) == 0)
+            && (headerCrc == Utils::fCrc32(walData.Data(), WAL_HEADER_SIZE - sizeof(headerCrc)))
+            && (walBaseCrc == baseCrc);
+    }
+
+    // ReplayRecords() applies records onto mJsonData and returns offset just after the last valid record
+    size_t ReplayRecords(const Utils::MappedFile& walData) {
+        size_t offset = WAL_HEADER_SIZE;
+        while (walData.Size() - offset >= WAL_RECORD_HEADER_SIZE) {
+            uint32_t payloadSize = 0;
+            uint32_t payloadCrc = 0;
+            std::memcpy(&payloadSize, walData.Data() + offset, sizeof(payloadSize));
+            std::memcpy(&payloadCrc, walData.Data() + offset + sizeof(payloadSize), sizeof(payloadCrc));
+            auto payloadBegin = walData.Data() + offset + WAL_RECORD_HEADER_SIZE;
+            if ((payloadSize > walData.Size() - offset - WAL_RECORD_HEADER_SIZE)
+                || (Utils::fCrc32(payloadBegin, payloadSize) != payloadCrc)) {
+                break;
+            }
+
+            String payload(reinterpret_cast<const char*>(payloadBegin), payloadSize);
+            try {
+                mJsonData.patch_inplace(Json::JSON::parse(payload));
+            }
+            catch (const Exception &ex) {
+                mLog->error("Failed to replay record at offset {} of write-ahead log '{}'. Error: {}", offset, mWalURI, ex.what());
+                break;
+            }
+
+            mPendingPatches.emplace_back(std::move(payload));
+            offset += WAL_RECORD_HEADER_SIZE + payloadSize;
+        }
+
+        return offset;
+    }
+
+    static void AppendFrame(ByteStream& buf, const String& payload) {
+        uint32_t payloadSize = static_cast<uint32_t>(payload.size());
+        uint32_t payloadCrc = Utils::fCrc32(payload.data(), payload.size());
+        auto offset = buf.size();
+        buf.resize(offset + WAL_RECORD_HEADER_SIZE + payload.size());
+        std::memcpy(buf.data() + offset, &payloadSize, sizeof(payloadSize));
+        std::memcpy(buf.data() + offset + sizeof(payloadSize), &payloadCrc, sizeof(payloadCrc));
+        std::memcpy(buf.data() + offset + WAL_RECORD_HEADER_SIZE, payload.data(), payload.size());
+    }
+
+    bool AppendRecord(const String& payload) {
+        ByteStream frame;
+        AppendFrame(frame, payload);
+        if (!WriteAll(mWalFd, frame.data(), frame.size())) {
+            mLog->error("Failed to append record to write-ahead log '{}'. Error: {}", mWalURI, std::strerror(errno));
+            // Get rid of partially written record, otherwise it would hide all of the following records during replay
+            if (::ftruncate(mWalFd, static_cast<off_t>(mWalSize)) != 0) {
+                mIsWalBroken = true;
+            }
+
+            return false;
+        }
+
+        mWalSize += frame.size();
+        return true;
+    }
+
+    // WaitUntilDurable() implements group commit. The first waiter becomes the leader and syncs the log on behalf
+    // of all records written so far, while the others wait for its result
+    bool WaitUntilDurable(const uint64_t lsn, UniqueLock<Mutex>& lock) {
+        while ((mSyncedLsn < lsn) && !mIsWalBroken) {
+            if (mIsSyncInProgress) {
+                mSyncCondVar.wait(lock);
+                continue;
+            }
+
+            mIsSyncInProgress = true;
+            if (mOptions.GroupCommitWindow.count() > 0) {
+                lock.unlock();
+                std::this_thread::sleep_for(mOptions.GroupCommitWindow);
+                lock.lock();
+            }
+
+            auto syncLsn = mWrittenLsn;
+            auto walFd = mWalFd;
+            lock.unlock();
+            auto result = ::fdatasync(walFd);
+            lock.lock();
+            mIsSyncInProgress = false;
+            if (result != 0) {
+                mLog->error("Failed to sync write-ahead log '{}'. Error: {}", mWalURI, std::strerror(errno));
+                mIsWalBroken = true;
+            }
+            else {
+                mSyncedLsn = std::max(mSyncedLsn, syncLsn);
+            }
+
+            mSyncCondVar.notify_all();
+        }
+
+        return mSyncedLsn >= lsn;
+    }
+
+    bool IsCheckpointRequired() const {
+        return !mPendingPatches.empty()
+            && ((mPendingPatches.size() >= mOptions.CheckpointRecords) || (mWalSize >= mOptions.CheckpointBytes));
+    }
+
+    // Checkpoint() is called with locked mutex when the commit itself has to write down the full document. It blocks
+    // new commits until the log has been rotated, so no record can get into the old log once the new checkpoint
+    // is in place
+    bool Checkpoint(Json::JSON jData, UniqueLock<Mutex>& lock) {
+        mSyncCondVar.wait(lock, [this] { return !mIsSyncInProgress; });
+        String checkpointData = jData.dump();
+        if (!WriteFileDurably(mURI, checkpointData.data(), checkpointData.size())) {
+            mLog->error("Failed to write checkpoint file '{}'", mURI);
+            return false;
+        }
+
+        mJsonData = std::move(jData);
+        mPendingPatches.clear();
+        if (!RotateWal(Utils::fCrc32(checkpointData.data(), checkpointData.size()))) {
+            // The checkpoint is durable, however next save has to write full document again
+            mIsWalBroken = true;
+            return true;
+        }
+
+        mIsLoaded = true;
+        mIsWalBroken = false;
+        mSyncedLsn = mWrittenLsn;
+        ++mCheckpointGeneration;
+        LOG_TRACE(mLog, "Checkpointed JSON data into '{}'", mURI);
+        return true;
+    }
+
+    // CheckpointInBackground() is called with locked mutex, however it releases the lock while the snapshot of
+    // the document is written down. Records committed in the meantime are carried over into the new log
+    bool CheckpointInBackground(UniqueLock<Mutex>& lock) {
+        Json::JSON jSnapshot = mJsonData;
+        const auto foldedRecords = mPendingPatches.size();
+        const auto generation = mCheckpointGeneration;
+        const auto nextURI = mURI + NEXT_FILE_SUFFIX;
+        lock.unlock();
+        String checkpointData = jSnapshot.dump();
+        auto isWritten = WriteFileDurably(nextURI, checkpointData.data(), checkpointData.size());
+        lock.lock();
+        std::error_code errCode = {};
+        if (!isWritten) {
+            mLog->error("Failed to write checkpoint file '{}'", nextURI);
+            std::filesystem::remove(nextURI, errCode);
+            return false;
+        }
+
+        mSyncCondVar.wait(lock, [this] { return !mIsSyncInProgress; });
+        if ((generation != mCheckpointGeneration) || !mIsLoaded || mIsWalBroken) {
+            // Somebody has written down the full document meanwhile or the log has failed, so the snapshot is stale
+            std::filesystem::remove(nextURI, errCode);
+            return false;
+        }
+
+        const Vector<String> carriedPatches(mPendingPatches.begin() + foldedRecords, mPendingPatches.end());
+        const auto nextWalURI = mWalURI + NEXT_FILE_SUFFIX;
+        if (!WriteWal(nextWalURI, Utils::fCrc32(checkpointData.data(), checkpointData.size()), carriedPatches)) {
+            std::filesystem::remove(nextURI, errCode);
+            return false;
+        }
+
+        // From now on the recovery takes the new checkpoint together with the log waiting under the next name
+        std::filesystem::rename(nextURI, mURI, errCode);
+        if (errCode || !SyncParentDir(mURI)) {
+            mLog->error("Failed to rename checkpoint file '{}' to '{}'. Error: {}", nextURI, mURI, errCode.message());
+            std::filesystem::remove(nextWalURI, errCode);
+            return false;
+        }
+
+        ++mCheckpointGeneration;
+        std::filesystem::rename(nextWalURI, mWalURI, errCode);
+        if (errCode || !SyncParentDir(mWalURI) || !OpenWal(mWalURI)) {
+            mLog->error("Failed to rename write-ahead log '{}' to '{}'. Error: {}", nextWalURI, mWalURI, errCode.message());
+            // The old log does not belong to the new checkpoint, so next save has to write full document again
+            mIsWalBroken = true;
+            return false;
+        }
+
+        mPendingPatches = carriedPatches;
+        for (const auto& payload : mPendingPatches) {
+            mWalSize += WAL_RECORD_HEADER_SIZE + payload.size();
+        }
+
+        LOG_TRACE(mLog, "Checkpointed JSON data into '{}'", mURI);
+        return true;
+    }
+
+    // RotateWal() atomically replaces the log by a new one based on the given checkpoint and carrying records
+    // from mPendingPatches
+    bool RotateWal(const uint32_t baseCrc) {
+        return WriteWal(mWalURI, baseCrc, mPendingPatches) && OpenWal(mWalURI);
+    }
+
+    bool WriteWal(const String& walURI, const uint32_t baseCrc, const Vector<String>& patches) {
+        ByteStream walData(WAL_HEADER_SIZE);
+        std::memcpy(walData.data(), WAL_MAGIC, sizeof(WAL_MAGIC));
+        std::memcpy(walData.data() + sizeof(WAL_MAGIC), &baseCrc, sizeof(baseCrc));
+        uint32_t headerCrc = Utils::fCrc32(walData.data(), WAL_HEADER_SIZE - sizeof(headerCrc));
+        std::memcpy(walData.data() + sizeof(WAL_MAGIC) + sizeof(baseCrc), &headerCrc, sizeof(headerCrc));
+        for (const auto& payload : patches) {
+            AppendFrame(walData, payload);
+        }
+
+        if (!WriteFileDurably(walURI, walData.data(), walData.size())) {
+            mLog->error("Failed to create write-ahead log '{}'", walURI);
+            return false;
+        }
+
+        return true;
+    }
+
+    // OpenWal() makes the log the one which records are appended to. mWalSize counts the header only, the caller
+    // adds the records the log has been created with
+    bool OpenWal(const String& walURI) {
+
+        int walFd = ::open(walURI.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (walFd < 0) {
+            mLog->error("Failed to open write-ahead log '{}'. Error: {}", walURI, std::strerror(errno));
+            return false;
+        }
+
+        if (mWalFd >= 0) {
+            ::close(mWalFd);
+        }
+
+        mWalFd = walFd;
+        mWalSize = WAL_HEADER_SIZE;
+        return true;
+    }
+
+    void RunCheckpointing() {
+        UniqueLock<Mutex> lock(mMutex);
+        while (!mStop) {
+            mCheckpointCondVar.wait(lock, [this] { return mStop || (mIsLoaded && !mIsWalBroken && IsCheckpointRequired()); });
+            if (mStop) {
+                break;
+            }
+
+            auto pendingRecords = mPendingPatches.size();
+            if (!CheckpointInBackground(lock)) {
+                // Don't retry in a busy loop, next commit will wake us up again
+                mCheckpointCondVar.wait(lock, [this, pendingRecords] { return mStop || (mPendingPatches.size() > pendingRecords); });
+                continue;
+            }
+
+            mLog->info("Folded {} record(s) of write-ahead log into checkpoint '{}'", pendingRecords, mURI);
+        }
+    }
+}; // class JsonWalStorage
+} // namespace Storage
@@ -0,0 +1,182 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace Utils {
+using namespace StdLib;
+
+/*
+    Watches the directory tree (by inotify) for changes of the files with the given extension. Editors and
+    'cp' touch a file several times, so the callback is invoked from the watcher thread only once the changes
+    have settled down for the quiet period.
+*/
+class FileWatcher {
+public:
+    using ChangeCallback = std::function<void()>;
+
+    FileWatcher(const String& dirName, const String& fileExtension, ChangeCallback callback, const std::chrono::milliseconds quietPeriod = std::chrono::milliseconds(300))
+      : mDirName(dirName), mFileExtension(fileExtension), mCallback(std::move(callback)), mQuietPeriod(quietPeriod) {}
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    ~FileWatcher() { Stop(); }
+
+    bool Start() {
+        mInotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (mInotifyFd < 0) {
+            mError = std::strerror(errno);
+            return false;
+        }
+
+        mStopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mStopFd < 0) {
+            mError = std::strerror(errno);
+            Close();
+            return false;
+        }
+
+        try {
+            if (!AddWatch(mDirName)) {
+                Close();
+                return false;
+            }
+
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(mDirName)) {
+                if (entry.is_directory() && !AddWatch(entry.path().string())) {
+                    Close();
+                    return false;
+                }
+            }
+        }
+        catch (const Exception &ex) {
+            mError = ex.what();
+            Close();
+            return false;
+        }
+
+        mWatcherThread = Thread([this]() { Run(); });
+        return true;
+    }
+
+    void Stop() {
+        if (mWatcherThread.joinable()) {
+            uint64_t stop = 1;
+            [[maybe_unused]] auto written = ::write(mStopFd, &stop, sizeof(stop));
+            mWatcherThread.join();
+        }
+
+        Close();
+    }
+
+    const String& DirName() const { return mDirName; }
+    const String& Error() const { return mError; }
+
+private:
+    static constexpr uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+    String mDirName;
+    String mFileExtension;
+    ChangeCallback mCallback;
+    std::chrono::milliseconds mQuietPeriod;
+    Map<int, String> mDirNameByWatchFd;
+    int mInotifyFd = -1;
+    int mStopFd = -1;
+    Thread mWatcherThread;
+    String mError;
+
+    bool AddWatch(const String& dirName) {
+        int watchFd = ::inotify_add_watch(mInotifyFd, dirName.c_str(), WATCH_EVENTS);
+        if (watchFd < 0) {
+            mError = String("Failed to watch '") + dirName + "': " + std::strerror(errno);
+            return false;
+        }
+
+        mDirNameByWatchFd[watchFd] = dirName;
+        return true;
+    }
+
+    void Close() {
+        if (mInotifyFd >= 0) {
+            ::close(mInotifyFd);
+            mInotifyFd = -1;
+        }
+
+        if (mStopFd >= 0) {
+            ::close(mStopFd);
+            mStopFd = -1;
+        }
+
+        mDirNameByWatchFd.clear();
+    }
+
+    void Run() {
+        alignas(struct inotify_event) char buffer[4096];
+        bool isChangePending = false;
+        for (;;) {
+            struct pollfd fds[] = { { mInotifyFd, POLLIN, 0 }, { mStopFd, POLLIN, 0 } };
+            // Waiting for the next event ends the quiet period, if there is change to report
+            int timeoutMs = isChangePending ? static_cast<int>(mQuietPeriod.count()) : -1;
+            int result = ::poll(fds, 2, timeoutMs);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return;
+            }
+
+            if (fds[1].revents != 0) {
+                return;
+            }
+
+            if (result == 0) {
+                isChangePending = false;
+                mCallback();
+                continue;
+            }
+
+            for (;;) {
+                auto readBytes = ::read(mInotifyFd, buffer, sizeof(buffer));
+                if (readBytes <= 0) {
+                    break;
+                }
+
+                for (char* ptr = buffer; ptr < buffer + readBytes;) {
+                    auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+                    ptr += sizeof(struct inotify_event) + event->len;
+                    if (event->len == 0) {
+                        continue;
+                    }
+
+                    std::filesystem::path fileName = event->name;
+                    if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        // New subdirectory may bring new files as well
+                        auto dirNameIt = mDirNameByWatchFd.find(event->wd);
+                        if (dirNameIt != mDirNameByWatchFd.end()) {
+                            AddWatch((std::filesystem::path(dirNameIt->second) / fileName).string());
+                        }
+
+                        isChangePending = true;
+                    }
+                    else if (fileName.extension() == mFileExtension) {
+                        isChangePending = true;
+                    }
+                }
+            }
+        }
+    }
+}; // class FileWatcher
+} // namespace Utils
@@ -0,0 +1,270 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace Utils {
+using namespace StdLib;
+
+/*
+    IPv4 or IPv6 address in the network byte order (IPv4 takes the first 4 bytes). Parse() reads the text form
+    by hand, since std::regex is by far too slow to check each address of a big config.
+*/
+struct IpAddress {
+    enum class Family : uint8_t {
+        IPV4 = 4,
+        IPV6 = 6
+    };
+
+    static constexpr size_t IPV4_BYTES_COUNT = 4;
+    static constexpr size_t IPV6_BYTES_COUNT = 16;
+
+    Family AddrFamily = Family::IPV4;
+    std::array<uint8_t, IPV6_BYTES_COUNT> Bytes {};
+
+    size_t BitsCount() const { return (AddrFamily == Family::IPV4) ? (IPV4_BYTES_COUNT * 8) : (IPV6_BYTES_COUNT * 8); }
+
+    static Optional<IpAddress> Parse(const StringView text) {
+        return (text.find(':') != StringView::npos) ? ParseIPv6(text) : ParseIPv4(text);
+    }
+
+    // ParseIPv4() accepts only the dotted-decimal form with 4 octets without leading zeros (e.g. 192.168.0.1)
+    static Optional<IpAddress> ParseIPv4(const StringView text) {
+        IpAddress address;
+        address.AddrFamily = Family::IPV4;
+        size_t pos = 0;
+        for (size_t octetIdx = 0; octetIdx < IPV4_BYTES_COUNT; ++octetIdx) {
+            if (octetIdx > 0) {
+                if ((pos >= text.size()) || (text[pos] != '.')) {
+                    return {};
+                }
+
+                ++pos;
+            }
+
+            auto octetPos = pos;
+            unsigned value = 0;
+            while ((pos < text.size()) && IsDigit(text[pos]) && (pos - octetPos < 3)) {
+                value = value * 10 + (text[pos] - '0');
+                ++pos;
+            }
+
+            auto digitsCount = pos - octetPos;
+            if ((digitsCount == 0) || (value > UINT8_MAX) || ((digitsCount > 1) && (text[octetPos] == '0'))) {
+                return {};
+            }
+
+            address.Bytes[octetIdx] = static_cast<uint8_t>(value);
+        }
+
+        if (pos != text.size()) {
+            return {};
+        }
+
+        return address;
+    }
+
+    // ParseIPv6() accepts the text forms of RFC 4291: up to 8 groups, single '::' and IPv4 address in the last 32 bits
+    static Optional<IpAddress> ParseIPv6(const StringView text) {
+        static constexpr size_t GROUPS_COUNT = IPV6_BYTES_COUNT / 2;
+        std::array<uint16_t, GROUPS_COUNT> groups {};
+        size_t groupsCount = 0;
+        Optional<size_t> gapIdx;
+        size_t pos = 0;
+        if (text.starts_with("::")) {
+            gapIdx = 0;
+            pos = 2;
+        }
+        else if (text.starts_with(":")) {
+            return {};
+        }
+
+        while (pos < text.size()) {
+            if (groupsCount == GROUPS_COUNT) {
+                return {};
+            }
+
+            auto groupPos = pos;
+            unsigned value = 0;
+            while ((pos < text.size()) && IsHexDigit(text[pos]) && (pos - groupPos < 4)) {
+                value = (value << 4) | HexDigitValue(text[pos]);
+                ++pos;
+            }
+
+            if ((pos < text.size()) && (text[pos] == '.')) {
+                // IPv4 address takes the last two groups
+                auto ipv4Address = ParseIPv4(text.substr(groupPos));
+                if (!ipv4Address.has_value() || (groupsCount + 2 > GROUPS_COUNT)) {
+                    return {};
+                }
+
+                const auto& ipv4Bytes = ipv4Address.value().Bytes;
+                groups[groupsCount++] = static_cast<uint16_t>((ipv4Bytes[0] << 8) | ipv4Bytes[1]);
+                groups[groupsCount++] = static_cast<uint16_t>((ipv4Bytes[2] << 8) | ipv4Bytes[3]);
+                pos = text.size();
+                break;
+            }
+
+            if (pos == groupPos) {
+                return {};
+            }
+
+            groups[groupsCount++] = static_cast<uint16_t>(value);
+            if (pos == text.size()) {
+                break;
+            }
+
+            if (text[pos] != ':') {
+                return {};
+            }
+
+            ++pos;
+            if ((pos < text.size()) && (text[pos] == ':')) {
+                if (gapIdx.has_value()) {
+                    return {};
+                }
+
+                gapIdx = groupsCount;
+                ++pos;
+            }
+            else if (pos == text.size()) {
+                return {};
+            }
+        }
+
+        IpAddress address;
+        address.AddrFamily = Family::IPV6;
+        if (gapIdx.has_value()) {
+            // '::' stands for at least one group of zeros
+            if (groupsCount == GROUPS_COUNT) {
+                return {};
+            }
+
+            auto tailGroupsCount = groupsCount - gapIdx.value();
+            std::copy_backward(groups.begin() + gapIdx.value(), groups.begin() + groupsCount, groups.end());
+            std::fill(groups.begin() + gapIdx.value(), groups.end() - tailGroupsCount, 0);
+        }
+        else if (groupsCount != GROUPS_COUNT) {
+            return {};
+        }
+
+        for (size_t groupIdx = 0; groupIdx < GROUPS_COUNT; ++groupIdx) {
+            address.Bytes[groupIdx * 2] = static_cast<uint8_t>(groups[groupIdx] >> 8);
+            address.Bytes[groupIdx * 2 + 1] = static_cast<uint8_t>(groups[groupIdx] & 0xFF);
+        }
+
+        return address;
+    }
+
+    // ToString() returns the canonical text form (RFC 5952 for IPv6, i.e. lower case and the longest run of zeros as '::')
+    String ToString() const {
+        OStrStream text;
+        if (AddrFamily == Family::IPV4) {
+            text << unsigned(Bytes[0]) << '.' << unsigned(Bytes[1]) << '.' << unsigned(Bytes[2]) << '.' << unsigned(Bytes[3]);
+            return text.str();
+        }
+
+        static constexpr size_t GROUPS_COUNT = IPV6_BYTES_COUNT / 2;
+        std::array<uint16_t, GROUPS_COUNT> groups {};
+        for (size_t groupIdx = 0; groupIdx < GROUPS_COUNT; ++groupIdx) {
+            groups[groupIdx] = static_cast<uint16_t>((Bytes[groupIdx * 2] << 8) | Bytes[groupIdx * 2 + 1]);
+        }
+
+        // Single group of zeros is not replaced by '::'
+        size_t gapIdx = GROUPS_COUNT;
+        size_t gapSize = 1;
+        for (size_t groupIdx = 0; groupIdx < GROUPS_COUNT;) {
+            auto zerosEndIdx = groupIdx;
+            while ((zerosEndIdx < GROUPS_COUNT) && (groups[zerosEndIdx] == 0)) {
+                ++zerosEndIdx;
+            }
+
+            if (zerosEndIdx - groupIdx > gapSize) {
+                gapIdx = groupIdx;
+                gapSize = zerosEndIdx - groupIdx;
+            }
+
+            groupIdx = std::max(zerosEndIdx, groupIdx + 1);
+        }
+
+        text << std::hex;
+        for (size_t groupIdx = 0; groupIdx < GROUPS_COUNT; ++groupIdx) {
+            if (groupIdx == gapIdx) {
+                text << "::";
+                groupIdx += gapSize - 1;
+                continue;
+            }
+
+            if ((groupIdx > 0) && (groupIdx != gapIdx + gapSize)) {
+                text << ':';
+            }
+
+            text << groups[groupIdx];
+        }
+
+        return text.str();
+    }
+
+    bool operator==(const IpAddress& other) const = default;
+
+private:
+    static constexpr bool IsDigit(const char c) { return (c >= '0') && (c <= '9'); }
+    static constexpr bool IsHexDigit(const char c) { return IsDigit(c) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F')); }
+    static constexpr unsigned HexDigitValue(const char c) {
+        if (IsDigit(c)) {
+            return c - '0';
+        }
+
+        return ((c >= 'a') ? (c - 'a') : (c - 'A')) + 10;
+    }
+
+    friend struct IpPrefix;
+}; // struct IpAddress
+
+// IP prefix in the CIDR notation (e.g. 10.0.0.0/8). Bits of the address beyond the length do not have to be zero
+struct IpPrefix {
+    IpAddress Address;
+    uint8_t Length = 0;
+
+    static Optional<IpPrefix> Parse(const StringView text) {
+        auto slashPos = text.rfind('/');
+        if (slashPos == StringView::npos) {
+            return {};
+        }
+
+        auto address = IpAddress::Parse(text.substr(0, slashPos));
+        if (!address.has_value()) {
+            return {};
+        }
+
+        auto lengthText = text.substr(slashPos + 1);
+        if (lengthText.empty() || (lengthText.size() > 3) || ((lengthText.size() > 1) && (lengthText[0] == '0'))) {
+            return {};
+        }
+
+        unsigned length = 0;
+        for (const auto c : lengthText) {
+            if (!IpAddress::IsDigit(c)) {
+                return {};
+            }
+
+            length = length * 10 + (c - '0');
+        }
+
+        if (length > address.value().BitsCount()) {
+            return {};
+        }
+
+        return IpPrefix { address.value(), static_cast<uint8_t>(length) };
+    }
+
+    String ToString() const { return Address.ToString() + "/" + std::to_string(Length); }
+    bool operator==(const IpPrefix& other) const = default;
+}; // struct IpPrefix
+} // namespace Utils
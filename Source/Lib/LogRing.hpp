@@ -0,0 +1,168 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+#include "Tracing.hpp"
+
+#include <spdlog/details/log_msg.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace Log {
+using namespace StdLib;
+
+// Session of the request handled by the calling thread, which its log messages are tagged with
+class LogSession {
+public:
+    static const String& Current() { return Token(); }
+    static void Set(String sessionToken) { Token() = std::move(sessionToken); }
+
+private:
+    friend class ScopedLogSession;
+
+    static String& Token() {
+        thread_local String token;
+        return token;
+    }
+}; // class LogSession
+
+class ScopedLogSession {
+public:
+    explicit ScopedLogSession(String sessionToken) : mSavedToken(std::exchange(LogSession::Token(), std::move(sessionToken))) {}
+    ScopedLogSession(const ScopedLogSession&) = delete;
+    ScopedLogSession& operator=(const ScopedLogSession&) = delete;
+    ~ScopedLogSession() { LogSession::Token() = std::move(mSavedToken); }
+
+private:
+    String mSavedToken;
+}; // class ScopedLogSession
+
+struct LogEntry {
+    uint64_t Seq = 0;
+    spdlog::level::level_enum Level = spdlog::level::off;
+    spdlog::log_clock::time_point Time;
+    String Session;
+    String Module;
+    uint64_t RequestId = 0;
+    String Message;
+};
+
+/*
+    Ring of the latest log messages with their level, time, module, session and request id. The entries are
+    indexed by the session and by the level (as the sequence numbers in the order of logging), so the latest
+    entries of the session or of the levels are found without scanning the whole ring. The entry is evicted from
+    the indexes together with the ring, since the evicted entry is always the oldest one of its session and level.
+    The sink has to be written by the logging thread itself, which the session and the request id are taken from.
+*/
+class StructuredLogRing : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    explicit StructuredLogRing(const size_t capacity) : mEntries(std::max<size_t>(capacity, 1)) {}
+
+    size_t Capacity() const { return mEntries.size(); }
+
+    // Latest() returns up to the given number of the latest entries of at least the given level, from the oldest one
+    Vector<LogEntry> Latest(size_t count, const Optional<String>& session, const spdlog::level::level_enum minLevel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = std::min(count, mEntries.size());
+        Vector<LogEntry> entries;
+        if (session.has_value()) {
+            auto seqsIt = mSeqsBySession.find(session.value());
+            if (seqsIt != mSeqsBySession.end()) {
+                for (auto seqIt = seqsIt->second.rbegin(); (seqIt != seqsIt->second.rend()) && (entries.size() < count); ++seqIt) {
+                    const auto& entry = EntryOf(*seqIt);
+                    if (entry.Level >= minLevel) {
+                        entries.push_back(entry);
+                    }
+                }
+            }
+        }
+        else {
+            // Merge of the indexes of the levels from the newest entries
+            using SeqIt = std::deque<uint64_t>::const_reverse_iterator;
+            Vector<Pair<SeqIt, SeqIt>> cursors;
+            for (auto level = static_cast<size_t>(minLevel); level < LEVELS_COUNT; ++level) {
+                cursors.emplace_back(mSeqsByLevel[level].crbegin(), mSeqsByLevel[level].crend());
+            }
+
+            while (entries.size() < count) {
+                Pair<SeqIt, SeqIt>* newestCursor = nullptr;
+                for (auto& cursor : cursors) {
+                    if ((cursor.first != cursor.second) && (!newestCursor || (*cursor.first > *newestCursor->first))) {
+                        newestCursor = &cursor;
+                    }
+                }
+
+                if (!newestCursor) {
+                    break;
+                }
+
+                entries.push_back(EntryOf(*newestCursor->first));
+                ++newestCursor->first;
+            }
+        }
+
+        std::reverse(entries.begin(), entries.end());
+        return entries;
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        auto seq = mNextSeq++;
+        auto& entry = mEntries[seq % mEntries.size()];
+        if (seq >= mEntries.size()) {
+            Evict(entry);
+        }
+
+        entry.Seq = seq;
+        entry.Level = msg.level;
+        entry.Time = msg.time;
+        entry.Session = LogSession::Current();
+        entry.Module.assign(msg.logger_name.data(), msg.logger_name.size());
+        entry.RequestId = Tracing::Tracer::CurrentRequestId();
+        entry.Message.assign(msg.payload.data(), msg.payload.size());
+        mSeqsByLevel[LevelIdx(entry.Level)].push_back(seq);
+        if (!entry.Session.empty()) {
+            mSeqsBySession[entry.Session].push_back(seq);
+        }
+    }
+
+    void flush_() override {}
+
+private:
+    static constexpr size_t LEVELS_COUNT = spdlog::level::n_levels;
+
+    Vector<LogEntry> mEntries;
+    uint64_t mNextSeq = 0;
+    std::array<std::deque<uint64_t>, LEVELS_COUNT> mSeqsByLevel;
+    Map<String, std::deque<uint64_t>> mSeqsBySession;
+
+    const LogEntry& EntryOf(const uint64_t seq) const { return mEntries[seq % mEntries.size()]; }
+    static size_t LevelIdx(const spdlog::level::level_enum level) { return std::min(static_cast<size_t>(level), LEVELS_COUNT - 1); }
+
+    void Evict(const LogEntry& entry) {
+        auto& levelSeqs = mSeqsByLevel[LevelIdx(entry.Level)];
+        if (!levelSeqs.empty() && (levelSeqs.front() == entry.Seq)) {
+            levelSeqs.pop_front();
+        }
+
+        if (entry.Session.empty()) {
+            return;
+        }
+
+        auto seqsIt = mSeqsBySession.find(entry.Session);
+        if ((seqsIt != mSeqsBySession.end()) && !seqsIt->second.empty() && (seqsIt->second.front() == entry.Seq)) {
+            seqsIt->second.pop_front();
+            if (seqsIt->second.empty()) {
+                mSeqsBySession.erase(seqsIt);
+            }
+        }
+    }
+}; // class StructuredLogRing
+} // namespace Log
@@ -6,69 +6,418 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/common.h>
 
+#include <spdlog/details/log_msg_buffer.h>
 #include <spdlog/sinks/dist_sink.h>
 #include <spdlog/sinks/null_sink.h>
 
+#include "Metrics.hpp"
 #include "StdLib.hpp"
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <thread>
+
+/*
+    Calls of the log levels below LOG_ACTIVE_LEVEL are compiled out: by default the trace and debug calls are stripped
+    from the release (NDEBUG) builds. The arguments of the compiled in calls are evaluated only if the level is enabled
+    for the logger, so e.g. LOG_TRACE(mLog, "{}", jConfig.dump()) does not serialize the config unless it is logged.
+*/
+#ifndef LOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define LOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#else
+#define LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+#endif
+
+#define LOG_CALL(logger, level, ...) \
+    do { \
+        auto&& logCallLogger = (logger); \
+        if (logCallLogger->should_log(level)) { \
+            logCallLogger->log(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+// The stripped call is still compiled (but never evaluated), so the variables used only by the log do not become unused
+#define LOG_STRIPPED_CALL(logger, level, ...) \
+    do { \
+        if (false) { \
+            (logger)->log(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define LOG_TRACE(logger, ...) LOG_CALL(logger, spdlog::level::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(logger, ...) LOG_STRIPPED_CALL(logger, spdlog::level::trace, __VA_ARGS__)
+#endif
+
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define LOG_DEBUG(logger, ...) LOG_CALL(logger, spdlog::level::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(logger, ...) LOG_STRIPPED_CALL(logger, spdlog::level::debug, __VA_ARGS__)
+#endif
+
 namespace Log {
     using SpdLogger = spdlog::logger;
     using SpdSink = spdlog::sinks::sink;
     using namespace StdLib;
 
+    /*
+        Sink which only copies the message into the ring, while the dedicated thread writes it out into the wrapped
+        sink (e.g. the console and the file), so the logging thread never waits for the I/O. The slots are allocated
+        up front, but the copy of the message allocates if the logger name and the text exceed the inline buffer of
+        log_msg_buffer (250 bytes). The ring is
+        the bounded queue of Vyukov: each producer claims the slot by a single CAS and the slot is published by its
+        sequence number, so the producers do not lock each other. When the ring is full, the message either waits
+        for the free slot (BLOCK), replaces the oldest queued message (DROP_OLDEST) or is dropped (DROP_NEWEST).
+    */
+    class AsyncLogSink : public SpdSink {
+    public:
+        enum class OverflowPolicy : uint8_t {
+            BLOCK,
+            DROP_OLDEST,
+            DROP_NEWEST
+        };
+
+        struct Options {
+            size_t Capacity = 8192;
+            OverflowPolicy Policy = OverflowPolicy::DROP_NEWEST;
+            // Counters of the messages which have waited for the free slot, and which have been dropped (optional). The sink
+            // shares them with the metrics registry, since it may be flushed at the exit, after the registry is gone
+            SharedPtr<Metrics::Counter> BlockedCounter;
+            SharedPtr<Metrics::Counter> DroppedCounter;
+        };
+
+        AsyncLogSink(SharedPtr<SpdSink> sink, const Options& options)
+          : mSink(std::move(sink)), mOptions(options), mSlots(std::bit_ceil(std::max<size_t>(options.Capacity, 2))), mIdxMask(mSlots.size() - 1) {
+            for (size_t slotIdx = 0; slotIdx < mSlots.size(); ++slotIdx) {
+                mSlots[slotIdx].Sequence.store(slotIdx, std::memory_order_relaxed);
+            }
+
+            mFlushThread = Thread([this]() { WriteOut(); });
+        }
+
+        ~AsyncLogSink() override {
+            mIsStopping.store(true, std::memory_order_release);
+            WakeUp();
+            mFlushThread.join();
+        }
+
+        void log(const spdlog::details::log_msg& msg) override {
+            if (TryEnqueue(msg)) {
+                return;
+            }
+
+            switch (mOptions.Policy) {
+            case OverflowPolicy::BLOCK:
+                Increment(mOptions.BlockedCounter);
+                do {
+                    std::this_thread::yield();
+                } while (!TryEnqueue(msg));
+                return;
+            case OverflowPolicy::DROP_OLDEST:
+                // Another producer may take the freed slot first, then the message is dropped after all
+                if (spdlog::details::log_msg_buffer oldestMsg; TryDequeue(oldestMsg)) {
+                    mDequeuedCount.fetch_add(1, std::memory_order_release);
+                    Increment(mOptions.DroppedCounter);
+                    if (TryEnqueue(msg)) {
+                        return;
+                    }
+                }
+
+                break;
+            case OverflowPolicy::DROP_NEWEST:
+                break;
+            }
+
+            Increment(mOptions.DroppedCounter);
+        }
+
+        // flush() waits until the messages queued so far have been written out, and flushes the wrapped sink
+        void flush() override {
+            auto enqueuedCount = mEnqueuedCount.load(std::memory_order_acquire);
+            while (mDequeuedCount.load(std::memory_order_acquire) < enqueuedCount) {
+                std::this_thread::yield();
+            }
+
+            mSink->flush();
+        }
+
+        void set_pattern(const std::string& pattern) override { mSink->set_pattern(pattern); }
+        void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override { mSink->set_formatter(std::move(formatter)); }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> Sequence = 0;
+            spdlog::details::log_msg_buffer Message;
+        };
+
+        SharedPtr<SpdSink> mSink;
+        const Options mOptions;
+        Vector<Slot> mSlots;
+        const uint64_t mIdxMask;
+        alignas(64) std::atomic<uint64_t> mEnqueuePos = 0;
+        alignas(64) std::atomic<uint64_t> mDequeuePos = 0;
+        // The flush thread waits for the change of the signal, which is changed on each enqueued message and on stop
+        alignas(64) std::atomic<uint32_t> mWakeUpSignal = 0;
+        std::atomic<uint64_t> mEnqueuedCount = 0;
+        // Number of the messages written out or dropped from the ring
+        std::atomic<uint64_t> mDequeuedCount = 0;
+        std::atomic_bool mIsStopping = false;
+        Thread mFlushThread;
+
+        static void Increment(const SharedPtr<Metrics::Counter>& counter) {
+            if (counter) {
+                counter->Increment();
+            }
+        }
+
+        bool TryEnqueue(const spdlog::details::log_msg& msg) {
+            auto pos = mEnqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& slot = mSlots[pos & mIdxMask];
+                auto sequence = slot.Sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<int64_t>(sequence - pos);
+                if (diff == 0) {
+                    if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.Message = spdlog::details::log_msg_buffer(msg);
+                        slot.Sequence.store(pos + 1, std::memory_order_release);
+                        mEnqueuedCount.fetch_add(1, std::memory_order_release);
+                        WakeUp();
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = mEnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // TryDequeue() is called by the flush thread, and by the producer which drops the oldest message
+        bool TryDequeue(spdlog::details::log_msg_buffer& msg) {
+            auto pos = mDequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& slot = mSlots[pos & mIdxMask];
+                auto sequence = slot.Sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<int64_t>(sequence - (pos + 1));
+                if (diff == 0) {
+                    if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        msg = std::move(slot.Message);
+                        slot.Sequence.store(pos + mIdxMask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = mDequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void WakeUp() {
+            mWakeUpSignal.fetch_add(1, std::memory_order_release);
+            mWakeUpSignal.notify_one();
+        }
+
+        void WriteOut() {
+            spdlog::details::log_msg_buffer msg;
+            for (;;) {
+                auto wakeUpSignal = mWakeUpSignal.load(std::memory_order_acquire);
+                while (TryDequeue(msg)) {
+                    try {
+                        mSink->log(msg);
+                    }
+                    catch (const std::exception& ex) {
+                        // There is no other place to report the failure of the logging itself
+                        std::fprintf(stderr, "Failed to write log message. Error: %s\n", ex.what());
+                    }
+
+                    mDequeuedCount.fetch_add(1, std::memory_order_release);
+                }
+
+                if (mIsStopping.load(std::memory_order_acquire)) {
+                    break;
+                }
+
+                mWakeUpSignal.wait(wakeUpSignal, std::memory_order_acquire);
+            }
+
+            mSink->flush();
+        }
+    }; // class AsyncLogSink
+
+    // Identity of the module known at the compile time: the index of its logger in the registry and its name
+    struct ModuleId {
+        static constexpr size_t MAX_COUNT = 32;
+
+        template<typename IdxEnum>
+        constexpr ModuleId(const IdxEnum idx, const char* name) : Idx(static_cast<size_t>(idx)), Name(name) {}
+
+        size_t Idx;
+        const char* Name;
+    };
+
     class ILoggingRegistryManagement {
     public:
         virtual ~ILoggingRegistryManagement() = default;
+        virtual void RegisterModule(const ModuleId &module) = 0;
+        virtual SharedPtr<SpdLogger> Logger(const ModuleId &module) = 0;
+        // Modules known only at the run time (e.g. plugins) are looked up by name, which is slower than by ModuleId
         virtual void RegisterModule(const String &moduleName) = 0;
         virtual SharedPtr<SpdLogger> Logger(const String &moduleName) = 0;
         virtual void AddLogSink(SharedPtr<SpdSink> sink) = 0;
+        // AddSyncLogSink() adds the sink written by the logging thread itself, also when the others are written asynchronously
+        virtual void AddSyncLogSink(SharedPtr<SpdSink> sink) = 0;
+        // Flush() returns once the messages logged so far have been written out by all the sinks
+        virtual void Flush() = 0;
     };
 
     class NullLoggerRegistryManagement : public ILoggingRegistryManagement {
     public:
         ~NullLoggerRegistryManagement() override = default;
 
+        virtual void RegisterModule([[maybe_unused]] const ModuleId &) override { }
+        virtual SharedPtr<SpdLogger> Logger([[maybe_unused]] const ModuleId &) override { return NullLogger(); }
+
         virtual void RegisterModule([[maybe_unused]] const String &) override {
         };
 
         virtual SharedPtr<SpdLogger> Logger([[maybe_unused]] const String &) override {
-            static SharedPtr<SpdLogger> logger = std::make_shared<SpdLogger>("");
-            return logger;
+            return NullLogger();
         };
 
         virtual void AddLogSink([[maybe_unused]] SharedPtr<SpdSink>) override { }
+        virtual void AddSyncLogSink([[maybe_unused]] SharedPtr<SpdSink>) override { }
+        virtual void Flush() override { }
+
+    private:
+        static SharedPtr<SpdLogger> NullLogger() {
+            static SharedPtr<SpdLogger> logger = std::make_shared<SpdLogger>("");
+            return logger;
+        }
     };
 
+    /*
+        Loggers of the modules known at the compile time are kept in the fixed array indexed by ModuleId, so Logger()
+        is a single atomic load without any lock. The logger is created once, under the lock, by the first of
+        RegisterModule() and Logger(), and is never replaced: the logger of the module which has not been registered
+        yet is turned off, and RegisterModule() turns it on later. So all the holders of the logger see the change.
+    */
     class LoggerRegistry : public ILoggingRegistryManagement {
     public:
         virtual ~LoggerRegistry() = default;
 
-        LoggerRegistry(spdlog::sinks_init_list sinksList) : mSinksList(std::make_shared<spdlog::sinks::dist_sink_mt>()) {
+        LoggerRegistry(spdlog::sinks_init_list sinksList)
+          : mSinksList(std::make_shared<spdlog::sinks::dist_sink_mt>()), mLoggersSink(mSinksList), mSyncSinksList(mSinksList) {
             mSinksList->set_sinks(std::move(sinksList));
         }
 
+        // The loggers write the messages out into the sinks by the background thread, see AsyncLogSink
+        LoggerRegistry(spdlog::sinks_init_list sinksList, const AsyncLogSink::Options& asyncOptions)
+          : mSinksList(std::make_shared<spdlog::sinks::dist_sink_mt>()), mLoggersSink(std::make_shared<AsyncLogSink>(mSinksList, asyncOptions)),
+            mSyncSinksList(std::make_shared<spdlog::sinks::dist_sink_mt>()) {
+            mSinksList->set_sinks(std::move(sinksList));
+        }
+
+        virtual void RegisterModule(const ModuleId &module) override {
+            auto& slot = mLoggerByModuleId.at(module.Idx);
+            LockGuard<Mutex> _(mMutex);
+            Register(slot, module.Name);
+            slot.IsCreated.store(true, std::memory_order_release);
+        }
+
+        virtual SharedPtr<SpdLogger> Logger(const ModuleId &module) override {
+            auto& slot = mLoggerByModuleId.at(module.Idx);
+            if (slot.IsCreated.load(std::memory_order_acquire)) {
+                return slot.Logger;
+            }
+
+            LockGuard<Mutex> _(mMutex);
+            if (!slot.Logger) {
+                CreateTurnedOff(slot, module.Name);
+                slot.IsCreated.store(true, std::memory_order_release);
+            }
+
+            return slot.Logger;
+        }
+
         virtual void RegisterModule(const String &moduleName) override {
-            mLoggerByModuleName[moduleName] = std::make_shared<SpdLogger>(moduleName, mSinksList);
+            LockGuard<Mutex> _(mMutex);
+            Register(mLoggerByModuleName[moduleName], moduleName);
         }
 
         virtual SharedPtr<SpdLogger> Logger(const String &moduleName) override {
-            auto loggerIt = mLoggerByModuleName.find(moduleName);
-            if (loggerIt == mLoggerByModuleName.end()) {
+            LockGuard<Mutex> _(mMutex);
+            auto& slot = mLoggerByModuleName[moduleName];
+            if (!slot.Logger) {
                 // If currently the logger has not been registered yet then create new one and turn off logging possibility
-                mLoggerByModuleName[moduleName] = std::make_shared<SpdLogger>(moduleName);
-                loggerIt = mLoggerByModuleName.find(moduleName);
-                loggerIt->second->set_level(spdlog::level::off);
+                CreateTurnedOff(slot, moduleName);
             }
 
-            return loggerIt->second;
+            return slot.Logger;
         }
 
         virtual void AddLogSink(spdlog::sink_ptr sink) override {
             mSinksList->add_sink(sink);
         }
 
+        virtual void AddSyncLogSink(spdlog::sink_ptr sink) override {
+            mSyncSinksList->add_sink(sink);
+        }
+
+        virtual void Flush() override {
+            mLoggersSink->flush();
+        }
+
     private:
-        Map<String, SharedPtr<SpdLogger>> mLoggerByModuleName;
+        struct LoggerSlot {
+            // Set once the logger is created, after which the logger is only read
+            std::atomic_bool IsCreated = false;
+            bool IsRegistered = false;
+            SharedPtr<SpdLogger> Logger;
+        };
+
+        std::array<LoggerSlot, ModuleId::MAX_COUNT> mLoggerByModuleId;
+        Map<String, LoggerSlot> mLoggerByModuleName;
+        Mutex mMutex;
         SharedPtr<spdlog::sinks::dist_sink_mt> mSinksList; // We use dist_sink to add "new sink" after creating logger
+        SharedPtr<SpdSink> mLoggersSink; // The sinks list itself, or the async sink in front of it
+        SharedPtr<spdlog::sinks::dist_sink_mt> mSyncSinksList; // The sinks list itself, if the loggers are not async
+
+        SharedPtr<SpdLogger> NewLogger(const String& moduleName) {
+            if (mSyncSinksList == mLoggersSink) {
+                return std::make_shared<SpdLogger>(moduleName, mLoggersSink);
+            }
+
+            return std::make_shared<SpdLogger>(moduleName, spdlog::sinks_init_list { mLoggersSink, mSyncSinksList });
+        }
+
+        void CreateTurnedOff(LoggerSlot& slot, const String& moduleName) {
+            slot.Logger = NewLogger(moduleName);
+            slot.Logger->set_level(spdlog::level::off);
+        }
+
+        void Register(LoggerSlot& slot, const String& moduleName) {
+            if (slot.IsRegistered) {
+                return;
+            }
+
+            if (slot.Logger) {
+                slot.Logger->set_level(spdlog::level::info);
+            }
+            else {
+                slot.Logger = NewLogger(moduleName);
+            }
+
+            slot.IsRegistered = true;
+        }
     };
 } // namespace Log
@@ -0,0 +1,127 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utils {
+using namespace StdLib;
+
+/*
+    Read-only view of the whole file content. Regular files are memory-mapped, so the content is not copied into
+    the process heap and the pages can be dropped by the kernel once they have been consumed. Other files
+    (pipes, character devices, procfs entries reporting zero size) are read into an internal buffer by read().
+*/
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const String& fileName) {
+        Close();
+        int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            mError = std::strerror(errno);
+            return false;
+        }
+
+        struct ::stat fileStat {};
+        if (::fstat(fd, &fileStat) != 0) {
+            mError = std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+
+        bool result = false;
+        if (S_ISREG(fileStat.st_mode) && (fileStat.st_size > 0)) {
+            result = Map(fd, static_cast<size_t>(fileStat.st_size));
+        }
+        else {
+            result = ReadAll(fd);
+        }
+
+        ::close(fd);
+        return result;
+    }
+
+    void Close() {
+        if (mMappedData != nullptr) {
+            ::munmap(mMappedData, mSize);
+            mMappedData = nullptr;
+        }
+
+        mBuffer.clear();
+        mBuffer.shrink_to_fit();
+        mSize = 0;
+    }
+
+    const uint8_t* Data() const {
+        return (mMappedData != nullptr) ? static_cast<const uint8_t*>(mMappedData) : reinterpret_cast<const uint8_t*>(mBuffer.data());
+    }
+
+    size_t Size() const { return mSize; }
+    StringView View() const { return StringView(reinterpret_cast<const char*>(Data()), mSize); }
+    bool IsMapped() const { return mMappedData != nullptr; }
+    const String& Error() const { return mError; }
+
+private:
+    static constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+
+    void* mMappedData = nullptr;
+    size_t mSize = 0;
+    String mBuffer;
+    String mError;
+
+    bool Map(const int fd, const size_t size) {
+        auto mappedData = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mappedData == MAP_FAILED) {
+            // E.g. file system which does not support mmap. Let's try ordinary read
+            return ReadAll(fd);
+        }
+
+        // The content is consumed once from the beginning to the end by the parser
+        ::madvise(mappedData, size, MADV_SEQUENTIAL);
+        mMappedData = mappedData;
+        mSize = size;
+        return true;
+    }
+
+    bool ReadAll(const int fd) {
+        for (;;) {
+            auto offset = mBuffer.size();
+            mBuffer.resize(offset + READ_CHUNK_SIZE);
+            auto readBytes = ::read(fd, mBuffer.data() + offset, READ_CHUNK_SIZE);
+            if (readBytes < 0) {
+                if (errno == EINTR) {
+                    mBuffer.resize(offset);
+                    continue;
+                }
+
+                mError = std::strerror(errno);
+                mBuffer.clear();
+                return false;
+            }
+
+            mBuffer.resize(offset + static_cast<size_t>(readBytes));
+            if (readBytes == 0) {
+                break;
+            }
+        }
+
+        mSize = mBuffer.size();
+        return true;
+    }
+};
+} // namespace Utils
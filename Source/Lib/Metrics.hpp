@@ -0,0 +1,320 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <shared_mutex>
+#include <sstream>
+
+namespace Metrics {
+using namespace StdLib;
+using Labels = Vector<Pair<String, String>>;
+
+class Counter {
+public:
+    void Increment(const uint64_t value = 1) { mValue.fetch_add(value, std::memory_order_relaxed); }
+    uint64_t Value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> mValue = 0;
+}; // class Counter
+
+class Gauge {
+public:
+    void Set(const int64_t value) { mValue.store(value, std::memory_order_relaxed); }
+    void Add(const int64_t value) { mValue.fetch_add(value, std::memory_order_relaxed); }
+    int64_t Value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> mValue = 0;
+}; // class Gauge
+
+/*
+    Histogram of the latencies in nanoseconds with the buckets of HDR style: each power of two is split into
+    4 buckets of equal width, so any latency from 1 ns to centuries is kept with the relative error below 25%
+    in 256 buckets. The buckets include their upper bounds, like the 'le' buckets of Prometheus, so the count of
+    the latencies up to a power of two is exact. Each thread records into its own shard (the threads are spread over the shards round-robin),
+    so Record() is just the relaxed atomic increments of the memory not shared with other threads, and only
+    the reader sums up the shards.
+*/
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 2;
+    static constexpr size_t SUB_BUCKETS_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS_COUNT = 64 * SUB_BUCKETS_COUNT;
+
+    struct Snapshot {
+        std::array<uint64_t, BUCKETS_COUNT> BucketCounts {};
+        uint64_t Count = 0;
+        uint64_t SumNs = 0;
+
+        // CountUpTo() returns the number of the latencies lower than or equal to the bound, which is exact for the power of two
+        uint64_t CountUpTo(const uint64_t boundNs) const {
+            uint64_t count = 0;
+            for (size_t bucketIdx = 0; (bucketIdx < BUCKETS_COUNT) && (BucketUpperBound(bucketIdx) <= boundNs); ++bucketIdx) {
+                count += BucketCounts[bucketIdx];
+            }
+
+            return count;
+        }
+    };
+
+    void Record(const std::chrono::nanoseconds latency) {
+        auto latencyNs = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+        auto& shard = mShards[ThreadShardIdx()];
+        shard.BucketCounts[BucketIdx(latencyNs)].fetch_add(1, std::memory_order_relaxed);
+        shard.Count.fetch_add(1, std::memory_order_relaxed);
+        shard.SumNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    }
+
+    Snapshot TakeSnapshot() const {
+        Snapshot snapshot;
+        for (const auto& shard : mShards) {
+            for (size_t bucketIdx = 0; bucketIdx < BUCKETS_COUNT; ++bucketIdx) {
+                snapshot.BucketCounts[bucketIdx] += shard.BucketCounts[bucketIdx].load(std::memory_order_relaxed);
+            }
+
+            snapshot.Count += shard.Count.load(std::memory_order_relaxed);
+            snapshot.SumNs += shard.SumNs.load(std::memory_order_relaxed);
+        }
+
+        return snapshot;
+    }
+
+    // BucketIdx() places the latency in the bucket (BucketUpperBound(bucketIdx - 1), BucketUpperBound(bucketIdx)], 0 ns is in the first one
+    static size_t BucketIdx(const uint64_t latencyNs) {
+        auto value = (latencyNs > 0) ? latencyNs - 1 : 0;
+        if (value < SUB_BUCKETS_COUNT) {
+            return static_cast<size_t>(value);
+        }
+
+        auto highestBitIdx = static_cast<size_t>(std::bit_width(value) - 1);
+        auto subBucketIdx = static_cast<size_t>((value >> (highestBitIdx - SUB_BUCKET_BITS)) & (SUB_BUCKETS_COUNT - 1));
+        return ((highestBitIdx - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + subBucketIdx;
+    }
+
+    // BucketUpperBound() returns the highest latency of the bucket
+    static uint64_t BucketUpperBound(const size_t bucketIdx) {
+        if (bucketIdx >= LAST_BUCKET_IDX) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+
+        auto nextBucketIdx = bucketIdx + 1;
+        if (nextBucketIdx < SUB_BUCKETS_COUNT) {
+            return nextBucketIdx;
+        }
+
+        auto highestBitIdx = (nextBucketIdx >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+        return (uint64_t(SUB_BUCKETS_COUNT) + (nextBucketIdx & (SUB_BUCKETS_COUNT - 1))) << (highestBitIdx - SUB_BUCKET_BITS);
+    }
+
+private:
+    static constexpr size_t SHARDS_COUNT = 16;
+    // Bucket of the latencies up to the maximum of uint64_t, the buckets after it are never used
+    static constexpr size_t LAST_BUCKET_IDX = ((64 - SUB_BUCKET_BITS) << SUB_BUCKET_BITS) + SUB_BUCKETS_COUNT - 1;
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKETS_COUNT> BucketCounts {};
+        std::atomic<uint64_t> Count = 0;
+        std::atomic<uint64_t> SumNs = 0;
+    };
+
+    std::array<Shard, SHARDS_COUNT> mShards;
+
+    static size_t ThreadShardIdx() {
+        static std::atomic<size_t> nextShardIdx = 0;
+        thread_local size_t shardIdx = nextShardIdx.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+        return shardIdx;
+    }
+}; // class LatencyHistogram
+
+// Records the time elapsed till the end of the scope
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram) : mHistogram(histogram), mStart(std::chrono::steady_clock::now()) {}
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+    ~ScopedLatency() { mHistogram.Record(std::chrono::steady_clock::now() - mStart); }
+
+private:
+    LatencyHistogram& mHistogram;
+    const std::chrono::steady_clock::time_point mStart;
+}; // class ScopedLatency
+
+// Records the time elapsed since the previous lap, e.g. of each stage of the request handled one after another
+class LapTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LapTimer() : mLapStart(Clock::now()) {}
+
+    void Lap(LatencyHistogram& histogram) {
+        auto now = Clock::now();
+        histogram.Record(now - mLapStart);
+        mLapStart = now;
+    }
+
+private:
+    Clock::time_point mLapStart;
+}; // class LapTimer
+
+/*
+    Named metrics with their labels, rendered in the Prometheus text format. The metric is created on the first
+    request for its name and labels and lives as long as the registry, so the caller keeps the reference to it
+    and records the samples without any lookup. The counter which has to outlive the registry is created by its
+    owner and shared with the registry by AddCounter().
+*/
+class MetricsRegistry {
+public:
+    Counter& GetCounter(const String& name, const String& help, const Labels& labels = {}) {
+        return GetMetric<Counter>(mCounters, name, help, labels);
+    }
+
+    Gauge& GetGauge(const String& name, const String& help, const Labels& labels = {}) {
+        return GetMetric<Gauge>(mGauges, name, help, labels);
+    }
+
+    LatencyHistogram& GetHistogram(const String& name, const String& help, const Labels& labels = {}) {
+        return GetMetric<LatencyHistogram>(mHistograms, name, help, labels);
+    }
+
+    void AddCounter(const String& name, const String& help, SharedPtr<Counter> counter, const Labels& labels = {}) {
+        std::unique_lock lock(mMutex);
+        auto& family = mCounters[name];
+        family.Help = help;
+        family.Metrics[labels] = std::move(counter);
+    }
+
+    String RenderPrometheusText() const {
+        std::shared_lock lock(mMutex);
+        std::ostringstream text;
+        text.precision(12);
+        for (const auto& [name, family] : mCounters) {
+            RenderHeader(text, name, family.Help, "counter");
+            for (const auto& [labels, counter] : family.Metrics) {
+                text << name << RenderLabels(labels) << ' ' << counter->Value() << '\n';
+            }
+        }
+
+        for (const auto& [name, family] : mGauges) {
+            RenderHeader(text, name, family.Help, "gauge");
+            for (const auto& [labels, gauge] : family.Metrics) {
+                text << name << RenderLabels(labels) << ' ' << gauge->Value() << '\n';
+            }
+        }
+
+        for (const auto& [name, family] : mHistograms) {
+            RenderHeader(text, name, family.Help, "histogram");
+            for (const auto& [labels, histogram] : family.Metrics) {
+                RenderHistogram(text, name, labels, histogram->TakeSnapshot());
+            }
+        }
+
+        return text.str();
+    }
+
+private:
+    // Bounds of the rendered buckets are the powers of two from about 1 us to about 2 min, which are exact in the histogram
+    static constexpr size_t MIN_BOUND_BIT_IDX = 10;
+    static constexpr size_t MAX_BOUND_BIT_IDX = 37;
+
+    template<typename T>
+    struct Family {
+        String Help;
+        Map<Labels, SharedPtr<T>> Metrics;
+    };
+
+    mutable std::shared_mutex mMutex;
+    Map<String, Family<Counter>> mCounters;
+    Map<String, Family<Gauge>> mGauges;
+    Map<String, Family<LatencyHistogram>> mHistograms;
+
+    template<typename T>
+    T& GetMetric(Map<String, Family<T>>& families, const String& name, const String& help, const Labels& labels) {
+        {
+            std::shared_lock lock(mMutex);
+            auto familyIt = families.find(name);
+            if (familyIt != families.end()) {
+                auto metricIt = familyIt->second.Metrics.find(labels);
+                if (metricIt != familyIt->second.Metrics.end()) {
+                    return *metricIt->second;
+                }
+            }
+        }
+
+        std::unique_lock lock(mMutex);
+        auto& family = families[name];
+        family.Help = help;
+        auto& metric = family.Metrics[labels];
+        if (!metric) {
+            metric = std::make_shared<T>();
+        }
+
+        return *metric;
+    }
+
+    static void RenderHeader(std::ostringstream& text, const String& name, const String& help, const char* type) {
+        text << "# HELP " << name << ' ' << EscapeText(help, false) << '\n';
+        text << "# TYPE " << name << ' ' << type << '\n';
+    }
+
+    // EscapeText() escapes the backslash and the new line (and the double quote of the label value), as the text format requires
+    static String EscapeText(const String& text, const bool isLabelValue) {
+        String escapedText;
+        escapedText.reserve(text.size());
+        for (const auto character : text) {
+            if ((character == '\\') || (isLabelValue && (character == '"'))) {
+                escapedText += '\\';
+                escapedText += character;
+            }
+            else if (character == '\n') {
+                escapedText += "\\n";
+            }
+            else {
+                escapedText += character;
+            }
+        }
+
+        return escapedText;
+    }
+
+    static String RenderLabels(const Labels& labels, const String& extraLabel = {}) {
+        if (labels.empty() && extraLabel.empty()) {
+            return {};
+        }
+
+        String text = "{";
+        for (const auto& [labelName, labelValue] : labels) {
+            text += labelName + "=\"" + EscapeText(labelValue, true) + "\",";
+        }
+
+        text += extraLabel;
+        if (text.back() == ',') {
+            text.pop_back();
+        }
+
+        return text + "}";
+    }
+
+    static void RenderHistogram(std::ostringstream& text, const String& name, const Labels& labels, const LatencyHistogram::Snapshot& snapshot) {
+        for (auto boundBitIdx = MIN_BOUND_BIT_IDX; boundBitIdx <= MAX_BOUND_BIT_IDX; ++boundBitIdx) {
+            auto boundNs = uint64_t(1) << boundBitIdx;
+            std::ostringstream bound;
+            bound << "le=\"" << static_cast<double>(boundNs) / 1e9 << '"';
+            text << name << "_bucket" << RenderLabels(labels, bound.str()) << ' ' << snapshot.CountUpTo(boundNs) << '\n';
+        }
+
+        text << name << "_bucket" << RenderLabels(labels, "le=\"+Inf\"") << ' ' << snapshot.Count << '\n';
+        text << name << "_sum" << RenderLabels(labels) << ' ' << static_cast<double>(snapshot.SumNs) / 1e9 << '\n';
+        text << name << "_count" << RenderLabels(labels) << ' ' << snapshot.Count << '\n';
+    }
+}; // class MetricsRegistry
+} // namespace Metrics
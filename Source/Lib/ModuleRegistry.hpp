@@ -4,18 +4,25 @@
 #pragma once
 
 #include "Logging.hpp"
+#include "Metrics.hpp"
 #include "StdLib.hpp"
+#include "Tracing.hpp"
 
 class ModuleRegistry {
 public:
     ModuleRegistry()
-      : mLoggerRegistry { std::make_shared<Log::NullLoggerRegistryManagement>() } {
+      : mLoggerRegistry { std::make_shared<Log::NullLoggerRegistryManagement>() }, mMetrics { std::make_shared<Metrics::MetricsRegistry>() },
+        mTracer { std::make_shared<Tracing::Tracer>() } {
         // Nothing more to do
     }
 
     inline const StdLib::SharedPtr<Log::ILoggingRegistryManagement> LoggerRegistry() const { return mLoggerRegistry; }
     inline void SetLoggerRegistry(StdLib::SharedPtr<Log::ILoggingRegistryManagement> loggerRegistry) { mLoggerRegistry = loggerRegistry; }
+    inline const StdLib::SharedPtr<Metrics::MetricsRegistry> Metrics() const { return mMetrics; }
+    inline const StdLib::SharedPtr<Tracing::Tracer> Tracer() const { return mTracer; }
 
 private:
     StdLib::SharedPtr<Log::ILoggingRegistryManagement> mLoggerRegistry;
+    StdLib::SharedPtr<Metrics::MetricsRegistry> mMetrics;
+    StdLib::SharedPtr<Tracing::Tracer> mTracer;
 };
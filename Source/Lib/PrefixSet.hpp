@@ -0,0 +1,587 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "IpAddress.hpp"
+#include "StdLib.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace Utils {
+using namespace StdLib;
+
+// Prefix with the range of lengths of the routes it matches, like 10.0.0.0/8{16,24} in BIRD
+struct PrefixRange {
+    IpPrefix Prefix;
+    uint8_t MinLength = 0;
+    uint8_t MaxLength = 0;
+
+    bool IsValid() const { return (Prefix.Length <= MinLength) && (MinLength <= MaxLength) && (MaxLength <= Prefix.Address.BitsCount()); }
+    // ToString() uses the syntax of BIRD prefix sets
+    String ToString() const {
+        auto text = Prefix.ToString();
+        if ((MinLength != Prefix.Length) || (MaxLength != Prefix.Length)) {
+            text += "{" + std::to_string(MinLength) + "," + std::to_string(MaxLength) + "}";
+        }
+
+        return text;
+    }
+}; // struct PrefixRange
+
+/*
+    Path-compressed binary trie of the prefixes of single address family, packed into the integer of the address
+    width. Each prefix keeps the set of lengths of the routes it matches, so entries of the same prefix with
+    different ranges are merged without losing anything. The nodes are kept in a single vector and refer to
+    each other by index. The node keeps single range of lengths by itself, only the prefixes with more ranges
+    keep the set of lengths aside, so IPv4 node takes 16 bytes.
+*/
+template<typename AddressBits, size_t ADDRESS_BITS_COUNT>
+class PrefixTrie {
+public:
+    using Lengths = std::bitset<ADDRESS_BITS_COUNT + 1>;
+
+    // Insert() returns false if the prefix has already matched all the lengths
+    bool Insert(AddressBits address, const uint8_t length, const Lengths& lengths) {
+        address &= Mask(length);
+        auto parentIdx = NO_NODE;
+        uint8_t parentSide = 0;
+        auto nodeIdx = mRootIdx;
+        while (nodeIdx != NO_NODE) {
+            const auto& node = mNodes[nodeIdx];
+            auto commonLength = std::min({ CommonLength(node.Address, address), node.Length, length });
+            if ((commonLength == node.Length) && (node.Length == length)) {
+                auto matchedLengths = MatchedLengths(nodeIdx);
+                if ((lengths & ~matchedLengths).none()) {
+                    return false;
+                }
+
+                if (!matchedLengths.any()) {
+                    ++mPrefixesCount;
+                }
+
+                SetMatchedLengths(nodeIdx, matchedLengths | lengths);
+                return true;
+            }
+
+            if (commonLength == node.Length) {
+                parentIdx = nodeIdx;
+                parentSide = Bit(address, node.Length);
+                nodeIdx = node.Children[parentSide];
+                continue;
+            }
+
+            auto nodeAddress = node.Address;
+            if (commonLength == length) {
+                // The new prefix covers the node
+                auto newIdx = NewNode(address, length, lengths);
+                mNodes[newIdx].Children[Bit(nodeAddress, length)] = nodeIdx;
+                Link(parentIdx, parentSide, newIdx);
+                ++mPrefixesCount;
+                return true;
+            }
+
+            // The new prefix and the node differ after the common part, which becomes the node without lengths
+            auto forkIdx = NewNode(address & Mask(commonLength), commonLength, Lengths());
+            auto newIdx = NewNode(address, length, lengths);
+            mNodes[forkIdx].Children[Bit(address, commonLength)] = newIdx;
+            mNodes[forkIdx].Children[Bit(nodeAddress, commonLength)] = nodeIdx;
+            Link(parentIdx, parentSide, forkIdx);
+            ++mPrefixesCount;
+            return true;
+        }
+
+        Link(parentIdx, parentSide, NewNode(address, length, lengths));
+        ++mPrefixesCount;
+        return true;
+    }
+
+    // Matches() tells if the route is matched by any prefix of the trie
+    bool Matches(const AddressBits address, const uint8_t length) const {
+        for (auto nodeIdx = mRootIdx; nodeIdx != NO_NODE;) {
+            const auto& node = mNodes[nodeIdx];
+            if ((node.Length > length) || ((address & Mask(node.Length)) != node.Address)) {
+                return false;
+            }
+
+            if (MatchedLengths(nodeIdx).test(length)) {
+                return true;
+            }
+
+            if (node.Length == ADDRESS_BITS_COUNT) {
+                return false;
+            }
+
+            nodeIdx = node.Children[Bit(address, node.Length)];
+        }
+
+        return false;
+    }
+
+    // Duplicates() tells if the same prefix of the trie has already matched all the lengths
+    bool Duplicates(AddressBits address, const uint8_t length, const Lengths& lengths) const {
+        address &= Mask(length);
+        auto nodeIdx = mRootIdx;
+        while ((nodeIdx != NO_NODE) && (mNodes[nodeIdx].Length < length) && ((address & Mask(mNodes[nodeIdx].Length)) == mNodes[nodeIdx].Address)) {
+            nodeIdx = mNodes[nodeIdx].Children[Bit(address, mNodes[nodeIdx].Length)];
+        }
+
+        return (nodeIdx != NO_NODE) && (mNodes[nodeIdx].Length == length) && (mNodes[nodeIdx].Address == address) && (lengths & ~MatchedLengths(nodeIdx)).none();
+    }
+
+    // Overlaps() tells if any route matched by the prefix (with the lengths) is matched by the trie as well
+    bool Overlaps(AddressBits address, const uint8_t length, const Lengths& lengths) const {
+        address &= Mask(length);
+        auto nodeIdx = mRootIdx;
+        // Prefixes which cover the given one
+        while ((nodeIdx != NO_NODE) && (mNodes[nodeIdx].Length < length) && ((address & Mask(mNodes[nodeIdx].Length)) == mNodes[nodeIdx].Address)) {
+            if ((MatchedLengths(nodeIdx) & lengths).any()) {
+                return true;
+            }
+
+            nodeIdx = mNodes[nodeIdx].Children[Bit(address, mNodes[nodeIdx].Length)];
+        }
+
+        // Prefixes covered by the given one
+        return IsInside(nodeIdx, address, length) && AnyMatchedLengths(nodeIdx, lengths);
+    }
+
+    // Covers() tells if all the routes matched by the prefix (with the lengths) are matched by the trie
+    bool Covers(AddressBits address, const uint8_t length, Lengths lengths) const {
+        address &= Mask(length);
+        auto nodeIdx = mRootIdx;
+        while ((nodeIdx != NO_NODE) && (mNodes[nodeIdx].Length < length) && ((address & Mask(mNodes[nodeIdx].Length)) == mNodes[nodeIdx].Address)) {
+            lengths &= ~MatchedLengths(nodeIdx);
+            nodeIdx = mNodes[nodeIdx].Children[Bit(address, mNodes[nodeIdx].Length)];
+        }
+
+        return IsCovered(IsInside(nodeIdx, address, length) ? nodeIdx : NO_NODE, length, lengths);
+    }
+
+    // Visit() goes through the prefixes in the order of their addresses (the shorter prefix first)
+    template<typename Visitor>
+    void Visit(const Visitor& visitor) const {
+        Visit(mRootIdx, visitor);
+    }
+
+    size_t PrefixesCount() const { return mPrefixesCount; }
+    size_t MemoryBytes() const {
+        return (mNodes.capacity() * sizeof(Node)) + (mExtraLengths.size() * (sizeof(typename decltype(mExtraLengths)::value_type) + 2 * sizeof(void*)));
+    }
+
+    // ShrinkToFit() releases the memory reserved for new prefixes, e.g. once the whole list has been inserted
+    void ShrinkToFit() { mNodes.shrink_to_fit(); }
+
+    /*
+        Aggregate() rewrites the lengths of the prefixes, so the trie matches exactly the same routes with fewer
+        ranges. Lengths common to both halves of the prefix move up to the prefix (e.g. 10.0.0.0/9 and 10.128.0.0/9
+        become 10.0.0.0/8{9,9}), and lengths already matched by the covering prefixes are dropped, unless they join
+        two ranges into one.
+    */
+    void Aggregate() {
+        MergeHalves(mRootIdx);
+        DropCovered(mRootIdx, Lengths());
+        mPrefixesCount = 0;
+        for (uint32_t nodeIdx = 0; nodeIdx < mNodes.size(); ++nodeIdx) {
+            mPrefixesCount += MatchedLengths(nodeIdx).any() ? 1 : 0;
+        }
+    }
+
+private:
+    static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+    // Node only splits the trie, if its lengths range is empty
+    static constexpr uint8_t NO_LENGTHS_MIN = 1;
+    static constexpr uint8_t NO_LENGTHS_MAX = 0;
+    // Lengths do not make single range, so they are in mExtraLengths
+    static constexpr uint8_t EXTRA_LENGTHS_MIN = 2;
+    static constexpr uint8_t EXTRA_LENGTHS_MAX = 0;
+
+    struct Node {
+        AddressBits Address;
+        std::array<uint32_t, 2> Children = { NO_NODE, NO_NODE };
+        uint8_t Length;
+        uint8_t MinLength;
+        uint8_t MaxLength;
+    };
+
+    Vector<Node> mNodes;
+    std::unordered_map<uint32_t, Lengths> mExtraLengths;
+    uint32_t mRootIdx = NO_NODE;
+    size_t mPrefixesCount = 0;
+
+    Lengths MatchedLengths(const uint32_t nodeIdx) const {
+        const auto& node = mNodes[nodeIdx];
+        if (node.MinLength <= node.MaxLength) {
+            Lengths lengths;
+            for (auto length = node.MinLength; length <= node.MaxLength; ++length) {
+                lengths.set(length);
+            }
+
+            return lengths;
+        }
+
+        if (node.MinLength == EXTRA_LENGTHS_MIN) {
+            return mExtraLengths.at(nodeIdx);
+        }
+
+        return Lengths();
+    }
+
+    void SetMatchedLengths(const uint32_t nodeIdx, const Lengths& lengths) {
+        auto& node = mNodes[nodeIdx];
+        Optional<uint8_t> minLength;
+        uint8_t maxLength = 0;
+        bool isSingleRange = true;
+        for (size_t length = 0; length < lengths.size(); ++length) {
+            if (!lengths.test(length)) {
+                continue;
+            }
+
+            isSingleRange = isSingleRange && (!minLength.has_value() || (maxLength + 1U == length));
+            minLength = minLength.value_or(static_cast<uint8_t>(length));
+            maxLength = static_cast<uint8_t>(length);
+        }
+
+        if (!minLength.has_value()) {
+            node.MinLength = NO_LENGTHS_MIN;
+            node.MaxLength = NO_LENGTHS_MAX;
+            mExtraLengths.erase(nodeIdx);
+        }
+        else if (isSingleRange) {
+            node.MinLength = minLength.value();
+            node.MaxLength = maxLength;
+            mExtraLengths.erase(nodeIdx);
+        }
+        else {
+            node.MinLength = EXTRA_LENGTHS_MIN;
+            node.MaxLength = EXTRA_LENGTHS_MAX;
+            mExtraLengths[nodeIdx] = lengths;
+        }
+    }
+
+    static AddressBits Mask(const uint8_t length) {
+        return (length == 0) ? AddressBits(0) : static_cast<AddressBits>(~AddressBits(0) << (ADDRESS_BITS_COUNT - length));
+    }
+
+    static uint8_t Bit(const AddressBits address, const uint8_t bitIdx) {
+        return static_cast<uint8_t>((address >> (ADDRESS_BITS_COUNT - 1 - bitIdx)) & 1);
+    }
+
+    static uint8_t CommonLength(const AddressBits lhs, const AddressBits rhs) {
+        uint8_t length = 0;
+        while ((length < ADDRESS_BITS_COUNT) && (Bit(lhs, length) == Bit(rhs, length))) {
+            ++length;
+        }
+
+        return length;
+    }
+
+    uint32_t NewNode(const AddressBits address, const uint8_t length, const Lengths& lengths) {
+        mNodes.push_back(Node { address, { NO_NODE, NO_NODE }, length, NO_LENGTHS_MIN, NO_LENGTHS_MAX });
+        auto nodeIdx = static_cast<uint32_t>(mNodes.size() - 1);
+        SetMatchedLengths(nodeIdx, lengths);
+        return nodeIdx;
+    }
+
+    void Link(const uint32_t parentIdx, const uint8_t side, const uint32_t childIdx) {
+        if (parentIdx == NO_NODE) {
+            mRootIdx = childIdx;
+        }
+        else {
+            mNodes[parentIdx].Children[side] = childIdx;
+        }
+    }
+
+    bool IsInside(const uint32_t nodeIdx, const AddressBits address, const uint8_t length) const {
+        return (nodeIdx != NO_NODE) && (mNodes[nodeIdx].Length >= length) && ((mNodes[nodeIdx].Address & Mask(length)) == address);
+    }
+
+    bool AnyMatchedLengths(const uint32_t nodeIdx, const Lengths& lengths) const {
+        if (nodeIdx == NO_NODE) {
+            return false;
+        }
+
+        const auto& node = mNodes[nodeIdx];
+        return (MatchedLengths(nodeIdx) & lengths).any() || AnyMatchedLengths(node.Children[0], lengths) || AnyMatchedLengths(node.Children[1], lengths);
+    }
+
+    // IsCovered() tells if the routes of the lengths inside of the prefix of the given length are matched by the subtrie
+    bool IsCovered(const uint32_t nodeIdx, const uint8_t length, Lengths lengths) const {
+        if (lengths.none()) {
+            return true;
+        }
+
+        // Deeper node leaves the rest of the prefix uncovered
+        if ((nodeIdx == NO_NODE) || (mNodes[nodeIdx].Length > length)) {
+            return false;
+        }
+
+        const auto& node = mNodes[nodeIdx];
+        lengths &= ~MatchedLengths(nodeIdx);
+        if (lengths.none()) {
+            return true;
+        }
+
+        if ((length == ADDRESS_BITS_COUNT) || lengths.test(length)) {
+            return false;
+        }
+
+        return IsCovered(node.Children[0], length + 1, lengths) && IsCovered(node.Children[1], length + 1, lengths);
+    }
+
+    static size_t RangesCount(const Lengths& lengths) {
+        size_t rangesCount = 0;
+        for (size_t length = 0; length < lengths.size(); ++length) {
+            rangesCount += (lengths.test(length) && ((length == 0) || !lengths.test(length - 1))) ? 1 : 0;
+        }
+
+        return rangesCount;
+    }
+
+    void MergeHalves(const uint32_t nodeIdx) {
+        if (nodeIdx == NO_NODE) {
+            return;
+        }
+
+        auto childIdxs = mNodes[nodeIdx].Children;
+        MergeHalves(childIdxs[0]);
+        MergeHalves(childIdxs[1]);
+        // Only the node of the half (not deeper one) matches the routes of the whole half
+        auto halfLength = mNodes[nodeIdx].Length + 1;
+        if ((childIdxs[0] == NO_NODE) || (childIdxs[1] == NO_NODE) || (mNodes[childIdxs[0]].Length != halfLength) || (mNodes[childIdxs[1]].Length != halfLength)) {
+            return;
+        }
+
+        auto lengths = MatchedLengths(nodeIdx);
+        auto lowerHalfLengths = MatchedLengths(childIdxs[0]);
+        auto upperHalfLengths = MatchedLengths(childIdxs[1]);
+        auto commonLengths = lowerHalfLengths & upperHalfLengths;
+        if (commonLengths.none()) {
+            return;
+        }
+
+        auto rangesCount = RangesCount(lengths) + RangesCount(lowerHalfLengths) + RangesCount(upperHalfLengths);
+        auto mergedRangesCount = RangesCount(lengths | commonLengths) + RangesCount(lowerHalfLengths & ~commonLengths) + RangesCount(upperHalfLengths & ~commonLengths);
+        if (mergedRangesCount > rangesCount) {
+            return;
+        }
+
+        SetMatchedLengths(nodeIdx, lengths | commonLengths);
+        SetMatchedLengths(childIdxs[0], lowerHalfLengths & ~commonLengths);
+        SetMatchedLengths(childIdxs[1], upperHalfLengths & ~commonLengths);
+    }
+
+    void DropCovered(const uint32_t nodeIdx, const Lengths& coveredLengths) {
+        if (nodeIdx == NO_NODE) {
+            return;
+        }
+
+        auto lengths = MatchedLengths(nodeIdx);
+        // Covered lengths are left only between the ranges of the other lengths, where they join the ranges
+        auto requiredLengths = lengths & ~coveredLengths;
+        auto allowedLengths = lengths | coveredLengths;
+        auto newLengths = requiredLengths;
+        Optional<size_t> prevLength;
+        for (size_t length = 0; length < newLengths.size(); ++length) {
+            if (!requiredLengths.test(length)) {
+                continue;
+            }
+
+            if (prevLength.has_value() && (length > prevLength.value() + 1)) {
+                auto isGapAllowed = true;
+                for (auto gapLength = prevLength.value() + 1; gapLength < length; ++gapLength) {
+                    isGapAllowed = isGapAllowed && allowedLengths.test(gapLength);
+                }
+
+                for (auto gapLength = prevLength.value() + 1; isGapAllowed && (gapLength < length); ++gapLength) {
+                    newLengths.set(gapLength);
+                }
+            }
+
+            prevLength = length;
+        }
+
+        SetMatchedLengths(nodeIdx, newLengths);
+        auto childIdxs = mNodes[nodeIdx].Children;
+        DropCovered(childIdxs[0], coveredLengths | lengths);
+        DropCovered(childIdxs[1], coveredLengths | lengths);
+    }
+
+    template<typename Visitor>
+    void Visit(const uint32_t nodeIdx, const Visitor& visitor) const {
+        if (nodeIdx == NO_NODE) {
+            return;
+        }
+
+        const auto& node = mNodes[nodeIdx];
+        auto matchedLengths = MatchedLengths(nodeIdx);
+        if (matchedLengths.any()) {
+            visitor(node.Address, node.Length, matchedLengths);
+        }
+
+        Visit(node.Children[0], visitor);
+        Visit(node.Children[1], visitor);
+    }
+}; // class PrefixTrie
+
+/*
+    Set of prefix ranges (e.g. prefix list) of both address families. It takes a fraction of the memory of the
+    JSON representation and answers which routes it matches, and whether other ranges duplicate, overlap or are
+    covered by it. Ranges() gives back the minimal ranges in the order of the prefixes.
+*/
+class PrefixSet {
+public:
+    // Insert() returns false if the range is a duplicate, i.e. the set has already had it
+    bool Insert(const PrefixRange& range) {
+        if (range.Prefix.Address.AddrFamily == IpAddress::Family::IPV4) {
+            return mIPv4Trie.Insert(ToIPv4Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv4Trie>(range));
+        }
+
+        return mIPv6Trie.Insert(ToIPv6Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv6Trie>(range));
+    }
+
+    // Matches() tells if the route is matched the same way as by BIRD 'net ~ [ ... ]'
+    bool Matches(const IpPrefix& route) const {
+        if (route.Address.AddrFamily == IpAddress::Family::IPV4) {
+            return mIPv4Trie.Matches(ToIPv4Bits(route.Address), route.Length);
+        }
+
+        return mIPv6Trie.Matches(ToIPv6Bits(route.Address), route.Length);
+    }
+
+    // Duplicates() tells if the set has already had the range (the same prefix with at least the same lengths)
+    bool Duplicates(const PrefixRange& range) const {
+        if (range.Prefix.Address.AddrFamily == IpAddress::Family::IPV4) {
+            return mIPv4Trie.Duplicates(ToIPv4Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv4Trie>(range));
+        }
+
+        return mIPv6Trie.Duplicates(ToIPv6Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv6Trie>(range));
+    }
+
+    // Overlaps() tells if any route matched by the range is matched by the set as well
+    bool Overlaps(const PrefixRange& range) const {
+        if (range.Prefix.Address.AddrFamily == IpAddress::Family::IPV4) {
+            return mIPv4Trie.Overlaps(ToIPv4Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv4Trie>(range));
+        }
+
+        return mIPv6Trie.Overlaps(ToIPv6Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv6Trie>(range));
+    }
+
+    // Covers() tells if all the routes matched by the range are matched by the set, so the range adds nothing to it
+    bool Covers(const PrefixRange& range) const {
+        if (range.Prefix.Address.AddrFamily == IpAddress::Family::IPV4) {
+            return mIPv4Trie.Covers(ToIPv4Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv4Trie>(range));
+        }
+
+        return mIPv6Trie.Covers(ToIPv6Bits(range.Prefix.Address), range.Prefix.Length, ToLengths<IPv6Trie>(range));
+    }
+
+    // Ranges() returns IPv4 ranges first, each family sorted by the prefixes
+    Vector<PrefixRange> Ranges() const {
+        Vector<PrefixRange> ranges;
+        mIPv4Trie.Visit([&ranges](const uint32_t address, const uint8_t length, const IPv4Trie::Lengths& lengths) {
+            AppendRanges(ranges, FromIPv4Bits(address), length, lengths);
+        });
+
+        mIPv6Trie.Visit([&ranges](const Uint128 address, const uint8_t length, const IPv6Trie::Lengths& lengths) {
+            AppendRanges(ranges, FromIPv6Bits(address), length, lengths);
+        });
+
+        return ranges;
+    }
+
+    void ShrinkToFit() {
+        mIPv4Trie.ShrinkToFit();
+        mIPv6Trie.ShrinkToFit();
+    }
+
+    // Aggregate() makes the set match the same routes with fewer ranges
+    void Aggregate() {
+        mIPv4Trie.Aggregate();
+        mIPv6Trie.Aggregate();
+    }
+
+    bool IsEmpty() const { return PrefixesCount() == 0; }
+    size_t PrefixesCount() const { return mIPv4Trie.PrefixesCount() + mIPv6Trie.PrefixesCount(); }
+    size_t MemoryBytes() const { return sizeof(*this) + mIPv4Trie.MemoryBytes() + mIPv6Trie.MemoryBytes(); }
+
+private:
+    __extension__ using Uint128 = unsigned __int128;
+    using IPv4Trie = PrefixTrie<uint32_t, IpAddress::IPV4_BYTES_COUNT * 8>;
+    using IPv6Trie = PrefixTrie<Uint128, IpAddress::IPV6_BYTES_COUNT * 8>;
+
+    IPv4Trie mIPv4Trie;
+    IPv6Trie mIPv6Trie;
+
+    template<typename Trie>
+    static typename Trie::Lengths ToLengths(const PrefixRange& range) {
+        typename Trie::Lengths lengths;
+        for (auto length = range.MinLength; length <= range.MaxLength; ++length) {
+            lengths.set(length);
+        }
+
+        return lengths;
+    }
+
+    // AppendRanges() splits the lengths into continuous ranges
+    template<typename Lengths>
+    static void AppendRanges(Vector<PrefixRange>& ranges, const IpAddress& address, const uint8_t length, const Lengths& lengths) {
+        for (size_t minLength = length; minLength < lengths.size(); ++minLength) {
+            if (!lengths.test(minLength)) {
+                continue;
+            }
+
+            auto maxLength = minLength;
+            while ((maxLength + 1 < lengths.size()) && lengths.test(maxLength + 1)) {
+                ++maxLength;
+            }
+
+            ranges.push_back({ IpPrefix { address, length }, static_cast<uint8_t>(minLength), static_cast<uint8_t>(maxLength) });
+            minLength = maxLength;
+        }
+    }
+
+    static uint32_t ToIPv4Bits(const IpAddress& address) {
+        uint32_t bits = 0;
+        for (size_t byteIdx = 0; byteIdx < IpAddress::IPV4_BYTES_COUNT; ++byteIdx) {
+            bits = (bits << 8) | address.Bytes[byteIdx];
+        }
+
+        return bits;
+    }
+
+    static Uint128 ToIPv6Bits(const IpAddress& address) {
+        Uint128 bits = 0;
+        for (size_t byteIdx = 0; byteIdx < IpAddress::IPV6_BYTES_COUNT; ++byteIdx) {
+            bits = (bits << 8) | address.Bytes[byteIdx];
+        }
+
+        return bits;
+    }
+
+    static IpAddress FromIPv4Bits(const uint32_t bits) {
+        IpAddress address;
+        address.AddrFamily = IpAddress::Family::IPV4;
+        for (size_t byteIdx = 0; byteIdx < IpAddress::IPV4_BYTES_COUNT; ++byteIdx) {
+            address.Bytes[byteIdx] = static_cast<uint8_t>(bits >> (8 * (IpAddress::IPV4_BYTES_COUNT - 1 - byteIdx)));
+        }
+
+        return address;
+    }
+
+    static IpAddress FromIPv6Bits(const Uint128 bits) {
+        IpAddress address;
+        address.AddrFamily = IpAddress::Family::IPV6;
+        for (size_t byteIdx = 0; byteIdx < IpAddress::IPV6_BYTES_COUNT; ++byteIdx) {
+            address.Bytes[byteIdx] = static_cast<uint8_t>(bits >> (8 * (IpAddress::IPV6_BYTES_COUNT - 1 - byteIdx)));
+        }
+
+        return address;
+    }
+}; // class PrefixSet
+} // namespace Utils
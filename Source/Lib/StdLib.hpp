@@ -4,6 +4,7 @@
 #pragma once
 
 // Headers arranged in alphabetical order
+#include <condition_variable>
 #include <forward_list>
 #include <fstream>
 #include <map>
@@ -21,6 +22,7 @@
 /** Provides aliases for types from C++ Standard Library */
 namespace StdLib {
 // Aliases arranged in alphabetical order
+using ConditionVariable = std::condition_variable;
 using Exception = std::exception;
 using IFStream = std::ifstream;
 using Mutex = std::mutex;
@@ -35,6 +37,7 @@ template<class T> using LockGuard = std::lock_guard<T>;
 template<class T> using Optional = std::optional<T>;
 template<class T> using SharedPtr = std::shared_ptr<T>;
 template<class T> using Stack = std::stack<T>;
+template<class T> using UniqueLock = std::unique_lock<T>;
 template<class T> using UniquePtr = std::unique_ptr<T>;
 template<class T> using WeakPtr = std::weak_ptr<T>;
 template<class T> using Vector = std::vector<T>;
@@ -0,0 +1,339 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace Utils {
+using namespace StdLib;
+
+/*
+    Runs the child process and reads its stdout and stderr by poll() as they come, so the chatty child never blocks
+    on the full pipe. Each line is matched against the failure and the success markers, and Run() returns as soon as
+    any of them appears, without waiting for the rest of the output. The whole run is bounded by the deadline: the
+    child which has not finished on time (or which keeps running after the marker) is terminated by SIGTERM and then,
+    after the grace period, by SIGKILL. The child is started in its own process group, so the signals reach also
+    the processes spawned by it (e.g. by 'podman exec').
+*/
+class Subprocess {
+public:
+    using Clock = std::chrono::steady_clock;
+    using LineCallback = std::function<void(const StringView line, const bool isStderr)>;
+
+    enum class Status : uint8_t {
+        SUCCESS_MARKER,
+        FAILURE_MARKER,
+        // The child has exited without any marker, see ExitCode
+        EXITED,
+        TIMED_OUT,
+        FAILED_TO_START
+    };
+
+    struct Result {
+        Status RunStatus = Status::FAILED_TO_START;
+        // Exit code of the child, or -1 if it has been killed by the signal
+        int ExitCode = -1;
+        String MatchedLine;
+        String Error;
+    };
+
+    struct Options {
+        Vector<String> SuccessMarkers;
+        Vector<String> FailureMarkers;
+        // The markers match only at the beginning of the line (e.g. the reply codes), not anywhere in it
+        bool AreMarkersLinePrefixes = false;
+        std::chrono::milliseconds Timeout = std::chrono::seconds(30);
+        // Time given to the child to exit after the marker, and to SIGTERM before SIGKILL
+        std::chrono::milliseconds GracePeriod = std::chrono::seconds(1);
+        LineCallback OnLine;
+    };
+
+    static Result Run(const Vector<String>& args, const Options& options) {
+        Result result;
+        if (args.empty()) {
+            result.Error = "No command to execute";
+            return result;
+        }
+
+        auto deadline = Clock::now() + options.Timeout;
+        Pipe stdoutPipe;
+        Pipe stderrPipe;
+        if (!stdoutPipe.Open() || !stderrPipe.Open()) {
+            result.Error = String("Failed to create pipe: ") + std::strerror(errno);
+            return result;
+        }
+
+        auto childPid = Spawn(args, stdoutPipe.WriteFd, stderrPipe.WriteFd, result.Error);
+        stdoutPipe.CloseWrite();
+        stderrPipe.CloseWrite();
+        if (childPid < 0) {
+            return result;
+        }
+
+        Stream streams[] = { { stdoutPipe.ReadFd, false, {} }, { stderrPipe.ReadFd, true, {} } };
+        bool isMarkerFound = false;
+        for (;;) {
+            struct pollfd fds[2];
+            nfds_t fdsCount = 0;
+            for (auto& stream : streams) {
+                if (stream.Fd >= 0) {
+                    fds[fdsCount++] = { stream.Fd, POLLIN, 0 };
+                }
+            }
+
+            if (fdsCount == 0) {
+                break;
+            }
+
+            auto remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            if (remainingMs <= 0) {
+                result.RunStatus = Status::TIMED_OUT;
+                result.Error = "Deadline of " + std::to_string(options.Timeout.count()) + " ms exceeded";
+                break;
+            }
+
+            int pollResult = ::poll(fds, fdsCount, static_cast<int>(remainingMs));
+            if (pollResult < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                result.Error = String("Failed to poll output of process: ") + std::strerror(errno);
+                break;
+            }
+
+            for (nfds_t fdIdx = 0; (fdIdx < fdsCount) && !isMarkerFound; ++fdIdx) {
+                if (fds[fdIdx].revents == 0) {
+                    continue;
+                }
+
+                auto& stream = (fds[fdIdx].fd == streams[0].Fd) ? streams[0] : streams[1];
+                isMarkerFound = ReadLines(stream, options, result);
+            }
+
+            if (isMarkerFound) {
+                break;
+            }
+        }
+
+        ::close(stdoutPipe.ReadFd);
+        ::close(stderrPipe.ReadFd);
+        stdoutPipe.ReadFd = stderrPipe.ReadFd = -1;
+        if (!isMarkerFound && (result.RunStatus != Status::TIMED_OUT)) {
+            // The rest of the output, not terminated by the new line
+            for (auto& stream : streams) {
+                if (!stream.PartialLine.empty() && MatchLine(stream, stream.PartialLine, options, result)) {
+                    isMarkerFound = true;
+                    break;
+                }
+            }
+        }
+
+        // The child is given the rest of the time, or only the grace period after the marker, to exit by itself
+        auto waitDeadline = deadline;
+        if (result.RunStatus == Status::TIMED_OUT) {
+            waitDeadline = Clock::now();
+        }
+        else if (isMarkerFound) {
+            waitDeadline = std::min(deadline, Clock::now() + options.GracePeriod);
+        }
+
+        auto isExited = Reap(childPid, waitDeadline, options.GracePeriod, result.ExitCode);
+        if (!isMarkerFound && (result.RunStatus != Status::TIMED_OUT)) {
+            result.RunStatus = isExited ? Status::EXITED : Status::TIMED_OUT;
+            if (!isExited) {
+                result.Error = "Deadline of " + std::to_string(options.Timeout.count()) + " ms exceeded";
+            }
+        }
+
+        return result;
+    }
+
+private:
+    // Line longer than that is matched in parts, so the child cannot exhaust the memory
+    static constexpr size_t MAX_LINE_SIZE = 64 * 1024;
+
+    struct Pipe {
+        int ReadFd = -1;
+        int WriteFd = -1;
+
+        bool Open() {
+            int fds[2];
+            if (::pipe2(fds, O_CLOEXEC) != 0) {
+                return false;
+            }
+
+            ReadFd = fds[0];
+            WriteFd = fds[1];
+            return true;
+        }
+
+        void CloseWrite() {
+            if (WriteFd >= 0) {
+                ::close(WriteFd);
+                WriteFd = -1;
+            }
+        }
+
+        ~Pipe() {
+            CloseWrite();
+            if (ReadFd >= 0) {
+                ::close(ReadFd);
+            }
+        }
+    };
+
+    struct Stream {
+        int Fd = -1;
+        bool IsStderr = false;
+        String PartialLine;
+    };
+
+    static pid_t Spawn(const Vector<String>& args, const int stdoutFd, const int stderrFd, String& error) {
+        Vector<char*> nullTermArgs;
+        for (const auto& arg : args) {
+            nullTermArgs.push_back(const_cast<char*>(arg.c_str()));
+        }
+
+        nullTermArgs.push_back(nullptr);
+        posix_spawn_file_actions_t fileActions;
+        posix_spawnattr_t attributes;
+        ::posix_spawn_file_actions_init(&fileActions);
+        ::posix_spawnattr_init(&attributes);
+        ::posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        ::posix_spawn_file_actions_adddup2(&fileActions, stdoutFd, STDOUT_FILENO);
+        ::posix_spawn_file_actions_adddup2(&fileActions, stderrFd, STDERR_FILENO);
+        ::posix_spawnattr_setpgroup(&attributes, 0);
+        ::posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+
+        pid_t childPid = -1;
+        auto spawnResult = ::posix_spawnp(&childPid, nullTermArgs[0], &fileActions, &attributes, nullTermArgs.data(), environ);
+        ::posix_spawn_file_actions_destroy(&fileActions);
+        ::posix_spawnattr_destroy(&attributes);
+        if (spawnResult != 0) {
+            error = "Failed to spawn '" + args[0] + "': " + std::strerror(spawnResult);
+            return -1;
+        }
+
+        return childPid;
+    }
+
+    // ReadLines() returns true if any marker has been found. The stream is closed once the child has closed its end
+    static bool ReadLines(Stream& stream, const Options& options, Result& result) {
+        char buffer[4096];
+        auto readBytes = ::read(stream.Fd, buffer, sizeof(buffer));
+        if (readBytes < 0) {
+            if ((errno == EINTR) || (errno == EAGAIN)) {
+                return false;
+            }
+
+            readBytes = 0;
+        }
+
+        if (readBytes == 0) {
+            stream.Fd = -1;
+            return false;
+        }
+
+        StringView data(buffer, static_cast<size_t>(readBytes));
+        while (!data.empty()) {
+            auto lineEnd = data.find('\n');
+            if (lineEnd == StringView::npos) {
+                stream.PartialLine.append(data);
+                if (stream.PartialLine.size() < MAX_LINE_SIZE) {
+                    return false;
+                }
+
+                lineEnd = data.size();
+            }
+            else {
+                stream.PartialLine.append(data.substr(0, lineEnd));
+            }
+
+            data.remove_prefix(std::min(lineEnd + 1, data.size()));
+            auto isMarkerFound = MatchLine(stream, stream.PartialLine, options, result);
+            stream.PartialLine.clear();
+            if (isMarkerFound) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static bool MatchLine(const Stream& stream, const String& line, const Options& options, Result& result) {
+        if (options.OnLine) {
+            options.OnLine(line, stream.IsStderr);
+        }
+
+        auto isInLine = [&line, &options](const String& marker) {
+            return options.AreMarkersLinePrefixes ? line.starts_with(marker) : (line.find(marker) != String::npos);
+        };
+        // The failure wins, if the line has both the markers
+        if (std::ranges::any_of(options.FailureMarkers, isInLine)) {
+            result.RunStatus = Status::FAILURE_MARKER;
+        }
+        else if (std::ranges::any_of(options.SuccessMarkers, isInLine)) {
+            result.RunStatus = Status::SUCCESS_MARKER;
+        }
+        else {
+            return false;
+        }
+
+        result.MatchedLine = line;
+        return true;
+    }
+
+    // Reap() waits for the child until the deadline, then terminates it. Returns true if the child has exited by itself
+    static bool Reap(const pid_t childPid, const Clock::time_point deadline, const std::chrono::milliseconds gracePeriod, int& exitCode) {
+        int status = -1;
+        if (WaitUntil(childPid, deadline, status)) {
+            exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            return true;
+        }
+
+        ::kill(-childPid, SIGTERM);
+        if (!WaitUntil(childPid, Clock::now() + gracePeriod, status)) {
+            ::kill(-childPid, SIGKILL);
+            while ((::waitpid(childPid, &status, 0) < 0) && (errno == EINTR)) {}
+        }
+
+        exitCode = -1;
+        return false;
+    }
+
+    static bool WaitUntil(const pid_t childPid, const Clock::time_point deadline, int& status) {
+        static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(5);
+        for (;;) {
+            auto waitResult = ::waitpid(childPid, &status, WNOHANG);
+            if ((waitResult == childPid) || ((waitResult < 0) && (errno != EINTR))) {
+                return true;
+            }
+
+            auto now = Clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::min<Clock::duration>(POLL_INTERVAL, deadline - now));
+        }
+    }
+}; // class Subprocess
+} // namespace Utils
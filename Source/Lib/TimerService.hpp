@@ -1,126 +1,429 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
 #pragma once
-#include <thread>
+
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
-#include <functional>
-#include <atomic>
-#include <mutex>
 #include <condition_variable>
-#include <queue>
-#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    Callable of the timer, kept inline when it fits (e.g. the lambda capturing a few pointers or the std::function),
+    so scheduling the timer does not allocate. The bigger callable is moved to the heap.
+*/
+class TimerCallback {
+public:
+    static constexpr size_t INLINE_SIZE = 48;
+
+    TimerCallback() = default;
+    TimerCallback(const TimerCallback&) = delete;
+    TimerCallback& operator=(const TimerCallback&) = delete;
+    ~TimerCallback() { Reset(); }
+
+    template<typename Callable>
+    void Emplace(Callable&& callable) {
+        using Target = std::decay_t<Callable>;
+        Reset();
+        if constexpr (IS_INLINE<Target>) {
+            ::new (static_cast<void*>(mBuffer)) Target(std::forward<Callable>(callable));
+            mOps = &INLINE_OPS<Target>;
+        }
+        else {
+            ::new (static_cast<void*>(mBuffer)) Target*(new Target(std::forward<Callable>(callable)));
+            mOps = &HEAP_OPS<Target>;
+        }
+    }
+
+    void operator()() { mOps->Invoke(mBuffer); }
+
+    void Reset() {
+        if (mOps) {
+            mOps->Destroy(mBuffer);
+            mOps = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*Invoke)(std::byte* buffer);
+        void (*Destroy)(std::byte* buffer);
+    };
 
-class TimerService {
+    template<typename Target>
+    static constexpr bool IS_INLINE = (sizeof(Target) <= INLINE_SIZE) && (alignof(Target) <= alignof(std::max_align_t));
+
+    template<typename Target>
+    static constexpr Ops INLINE_OPS = {
+        [](std::byte* buffer) { (*std::launder(reinterpret_cast<Target*>(buffer)))(); },
+        [](std::byte* buffer) { std::launder(reinterpret_cast<Target*>(buffer))->~Target(); }
+    };
+
+    template<typename Target>
+    static constexpr Ops HEAP_OPS = {
+        [](std::byte* buffer) { (**std::launder(reinterpret_cast<Target**>(buffer)))(); },
+        [](std::byte* buffer) { delete *std::launder(reinterpret_cast<Target**>(buffer)); }
+    };
+
+    alignas(std::max_align_t) std::byte mBuffer[INLINE_SIZE];
+    const Ops* mOps = nullptr;
+}; // class TimerCallback
+
+/*
+    Timers of 1 ms resolution kept in the hierarchical timing wheel: 4 levels of 256 slots, where the level 0 slot
+    holds the timers of a single tick, and the slot of the higher level the timers of 256 slots of the level below.
+    The timer is an intrusive node of the slot list, so Once(), Repeat() and Cancel() are O(1), and Cancel() unlinks
+    the timer at once. The nodes are reused (the id tells the node and its generation), so the steady state does
+    not allocate. The worker sleeps until the next occupied slot (found by the bitmaps of the occupied slots), and
+    the timer of the higher level is moved to the lower one (cascaded) once its slot is reached. The clock which is
+    not steady (e.g. the manual clock of the tests) may jump, so the worker checks it every tick instead of sleeping.
+*/
+template<typename ClockType = std::chrono::steady_clock>
+class BasicTimerService {
 public:
     using TimerId = uint64_t;
+    using Clock = ClockType;
 
-    TimerService() : mStop(false), mNextId(1) {
+    BasicTimerService() : mStart(Clock::now()) {
         mWorker = std::thread([this]() { Run(); });
     }
 
-    ~TimerService() {
+    ~BasicTimerService() {
         {
             std::lock_guard<std::mutex> lock(mLock);
             mStop = true;
-            mCondVar.notify_all();
         }
 
+        mCondVar.notify_all();
         if (mWorker.joinable()) {
             mWorker.join();
         }
     }
 
     // Schedule a one-shot timer
-    TimerId Once(std::chrono::milliseconds delay, std::function<void()> callback) {
-        return ScheduleTimer(delay, std::chrono::milliseconds(0), std::move(callback));
+    template<typename Callback>
+    TimerId Once(const std::chrono::milliseconds delay, Callback&& callback) {
+        return ScheduleTimer(delay, std::chrono::milliseconds(0), std::forward<Callback>(callback));
     }
 
     // Schedule a repeating timer
-    TimerId Repeat(std::chrono::milliseconds interval, std::function<void()> callback) {
-        return ScheduleTimer(interval, interval, std::move(callback));
+    template<typename Callback>
+    TimerId Repeat(const std::chrono::milliseconds interval, Callback&& callback) {
+        return ScheduleTimer(interval, interval, std::forward<Callback>(callback));
     }
 
-    // Cancel a scheduled timer
+    // Cancel a scheduled timer. The repeating timer whose callback is running is not repeated any more
     void Cancel(const TimerId id) {
         std::lock_guard<std::mutex> lock(mLock);
-        mActiveTimers.erase(id); // will be skipped when popped
-        mCondVar.notify_all();
+        auto* node = FindNode(id);
+        if (!node) {
+            return;
+        }
+
+        if (node->State == NodeState::PENDING) {
+            Unlink(*node);
+            FreeNode(*node);
+        }
+        else {
+            node->State = NodeState::CANCELLED;
+        }
     }
 
 private:
-    struct TimerItem {
-        TimerId id;
-        std::chrono::steady_clock::time_point time;
-        std::chrono::milliseconds interval; // 0 for one-shot
-        std::function<void()> callback;
+    static constexpr size_t SLOT_BITS = 8;
+    static constexpr size_t SLOTS_COUNT = size_t(1) << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS_COUNT - 1;
+    static constexpr size_t LEVELS_COUNT = 4;
+    // The timer beyond the span of the wheel (about 49 days) waits in the last slot of the top level
+    static constexpr uint64_t MAX_DELTA_TICKS = (uint64_t(1) << (SLOT_BITS * LEVELS_COUNT)) - 1;
+    static constexpr uint64_t NO_TICK = std::numeric_limits<uint64_t>::max();
 
-        bool operator>(const TimerItem& other) const {
-            return time > other.time;
-        }
+    enum class NodeState : uint8_t {
+        FREE,
+        PENDING,
+        // The callback is about to run or running, so the node is on the list of the worker instead of the wheel
+        FIRING,
+        CANCELLED
+    };
+
+    struct TimerNode {
+        TimerNode* Next = nullptr;
+        TimerNode** PrevNext = nullptr;
+        uint64_t ExpiryTick = 0;
+        uint64_t IntervalTicks = 0; // 0 for one-shot
+        uint32_t Idx = 0;
+        uint32_t Generation = 1;
+        uint8_t Level = 0;
+        uint8_t Slot = 0;
+        NodeState State = NodeState::FREE;
+        TimerCallback Callback;
     };
 
-    TimerId ScheduleTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval, std::function<void()> callback) {
-        auto id = mNextId++;
-        auto time = std::chrono::steady_clock::now() + delay;
+    struct WheelLevel {
+        std::array<TimerNode*, SLOTS_COUNT> Slots {};
+        std::array<uint64_t, SLOTS_COUNT / 64> OccupiedSlots {};
+    };
 
+    const Clock::time_point mStart;
+    std::thread mWorker;
+    bool mStop = false;
+    std::array<WheelLevel, LEVELS_COUNT> mLevels;
+    uint64_t mCurrentTick = 0;
+    uint64_t mWakeUpTick = NO_TICK;
+    size_t mLinkedCount = 0;
+    std::deque<TimerNode> mNodes; // Nodes never move, so the wheel links them by pointers
+    std::vector<uint32_t> mFreeNodeIdxs;
+    std::condition_variable mCondVar;
+    std::mutex mLock;
+
+    template<typename Callback>
+    TimerId ScheduleTimer(const std::chrono::milliseconds delay, const std::chrono::milliseconds interval, Callback&& callback) {
+        auto expiryTime = Clock::now() + delay;
+        bool isEarlierWakeUp = false;
+        TimerId id = 0;
         {
             std::lock_guard<std::mutex> lock(mLock);
-            mTimers.push(TimerItem{id, time, interval, std::move(callback)});
-            mActiveTimers.insert(id);
+            auto& node = AllocNode();
+            node.Callback.Emplace(std::forward<Callback>(callback));
+            node.IntervalTicks = (interval.count() > 0) ? static_cast<uint64_t>(interval.count()) : 0;
+            // Rounded up, so the timer never fires before its delay
+            node.ExpiryTick = std::max(CeilTick(expiryTime), mCurrentTick + 1);
+            node.State = NodeState::PENDING;
+            Link(node);
+            if (node.ExpiryTick < mWakeUpTick) {
+                mWakeUpTick = node.ExpiryTick;
+                isEarlierWakeUp = true;
+            }
+
+            id = (TimerId(node.Generation) << 32) | node.Idx;
+        }
+
+        if (isEarlierWakeUp) {
+            mCondVar.notify_all();
         }
 
-        mCondVar.notify_all();
         return id;
     }
 
     void Run() {
         std::unique_lock<std::mutex> lock(mLock);
-
         while (!mStop) {
-            if (mTimers.empty()) {
-                mCondVar.wait(lock, [this] { return mStop || !mTimers.empty(); });
-                continue;
+            Advance(lock, FloorTick(Clock::now()));
+            if (mStop) {
+                break;
             }
 
-            auto now = std::chrono::steady_clock::now();
-            auto next = mTimers.top().time;
-
-            if (mCondVar.wait_until(lock, next, [this] {
-                return mStop || mTimers.empty() || mTimers.top().time <= std::chrono::steady_clock::now();
-            })) {
-                // Woken early (cancel, new timer, or stop)
+            mWakeUpTick = (mLinkedCount > 0) ? NextEventTick() : NO_TICK;
+            if (mWakeUpTick == NO_TICK) {
+                mCondVar.wait(lock);
+            }
+            else if constexpr (Clock::is_steady) {
+                mCondVar.wait_until(lock, mStart + std::chrono::milliseconds(mWakeUpTick));
+            }
+            else {
+                mCondVar.wait_for(lock, std::chrono::milliseconds(1));
             }
+        }
+    }
 
-            if (mStop) {
+    // Advance() processes the ticks up to the target one, skipping at once the ticks of no cascade or timer
+    void Advance(std::unique_lock<std::mutex>& lock, const uint64_t targetTick) {
+        while ((mCurrentTick < targetTick) && !mStop) {
+            auto nextTick = NextEventTick();
+            if (nextTick > targetTick) {
+                mCurrentTick = targetTick;
                 break;
             }
 
-            now = std::chrono::steady_clock::now();
-            while (!mTimers.empty() && mTimers.top().time <= now) {
-                auto item = mTimers.top();
-                mTimers.pop();
-
-                if (mActiveTimers.count(item.id)) {
-                    if (item.interval.count() > 0) {
-                        // Reschedule repeating timer
-                        item.time = now + item.interval;
-                        mTimers.push(item);
-                    } else {
-                        // One-shot: remove from active set
-                        mActiveTimers.erase(item.id);
-                    }
-
-                    lock.unlock();
-                    item.callback();
-                    lock.lock();
-                }
+            mCurrentTick = nextTick;
+            Cascade();
+            Fire(lock);
+        }
+    }
+
+    void Cascade() {
+        size_t topLevel = 0;
+        while ((topLevel + 1 < LEVELS_COUNT) && ((mCurrentTick & ((uint64_t(1) << (SLOT_BITS * (topLevel + 1))) - 1)) == 0)) {
+            ++topLevel;
+        }
+
+        for (auto level = topLevel; level > 0; --level) {
+            auto* node = Detach(level, (mCurrentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+            while (node) {
+                auto* nextNode = node->Next;
+                Link(*node);
+                node = nextNode;
+            }
+        }
+    }
+
+    void Fire(std::unique_lock<std::mutex>& lock) {
+        auto* node = Detach(0, mCurrentTick & SLOT_MASK);
+        for (auto* firingNode = node; firingNode; firingNode = firingNode->Next) {
+            firingNode->State = NodeState::FIRING;
+        }
+
+        while (node) {
+            auto* nextNode = node->Next;
+            if (node->State == NodeState::FIRING) {
+                lock.unlock();
+                node->Callback();
+                lock.lock();
             }
+
+            if ((node->State == NodeState::FIRING) && (node->IntervalTicks > 0)) {
+                // Reschedule repeating timer
+                node->ExpiryTick = std::max(mCurrentTick, FloorTick(Clock::now())) + node->IntervalTicks;
+                node->State = NodeState::PENDING;
+                Link(*node);
+            }
+            else {
+                FreeNode(*node);
+            }
+
+            node = nextNode;
         }
     }
 
-    std::thread mWorker;
-    std::atomic<bool> mStop;
-    std::atomic<TimerId> mNextId;
-    std::priority_queue<TimerItem, std::vector<TimerItem>, std::greater<TimerItem>> mTimers;
-    std::unordered_set<TimerId> mActiveTimers;
-    std::condition_variable mCondVar;
-    std::mutex mLock;
-};
+    void Link(TimerNode& node) {
+        auto deltaTicks = node.ExpiryTick - mCurrentTick;
+        auto placementTick = (deltaTicks > MAX_DELTA_TICKS) ? (mCurrentTick + MAX_DELTA_TICKS) : node.ExpiryTick;
+        size_t level = 0;
+        while ((level + 1 < LEVELS_COUNT) && (deltaTicks >= (uint64_t(1) << (SLOT_BITS * (level + 1))))) {
+            ++level;
+        }
+
+        auto slot = static_cast<size_t>((placementTick >> (SLOT_BITS * level)) & SLOT_MASK);
+        auto& head = mLevels[level].Slots[slot];
+        node.Level = static_cast<uint8_t>(level);
+        node.Slot = static_cast<uint8_t>(slot);
+        node.Next = head;
+        node.PrevNext = &head;
+        if (head) {
+            head->PrevNext = &node.Next;
+        }
+
+        head = &node;
+        mLevels[level].OccupiedSlots[slot / 64] |= uint64_t(1) << (slot % 64);
+        ++mLinkedCount;
+    }
+
+    void Unlink(TimerNode& node) {
+        *node.PrevNext = node.Next;
+        if (node.Next) {
+            node.Next->PrevNext = node.PrevNext;
+        }
+
+        auto& level = mLevels[node.Level];
+        if (!level.Slots[node.Slot]) {
+            level.OccupiedSlots[node.Slot / 64] &= ~(uint64_t(1) << (node.Slot % 64));
+        }
+
+        node.Next = nullptr;
+        node.PrevNext = nullptr;
+        --mLinkedCount;
+    }
+
+    // Detach() empties the slot and returns its nodes, still linked by Next
+    TimerNode* Detach(const size_t level, const size_t slot) {
+        auto* node = std::exchange(mLevels[level].Slots[slot], nullptr);
+        mLevels[level].OccupiedSlots[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        for (auto* detachedNode = node; detachedNode; detachedNode = detachedNode->Next) {
+            detachedNode->PrevNext = nullptr;
+            --mLinkedCount;
+        }
+
+        return node;
+    }
+
+    // NextEventTick() returns the nearest tick of the timer of level 0, or of the cascade of the occupied slot
+    uint64_t NextEventTick() const {
+        auto nextTick = NO_TICK;
+        for (size_t level = 0; level < LEVELS_COUNT; ++level) {
+            auto shift = SLOT_BITS * level;
+            auto distance = NextOccupiedSlotDistance(mLevels[level], static_cast<size_t>((mCurrentTick >> shift) & SLOT_MASK));
+            if (distance > 0) {
+                nextTick = std::min(nextTick, ((mCurrentTick >> shift) + distance) << shift);
+            }
+        }
+
+        return nextTick;
+    }
+
+    // NextOccupiedSlotDistance() returns the distance (1 to 256) to the next occupied slot after the given one, or 0 if none
+    static size_t NextOccupiedSlotDistance(const WheelLevel& level, const size_t slot) {
+        size_t scanned = 0;
+        while (scanned < SLOTS_COUNT) {
+            auto scannedSlot = (slot + 1 + scanned) & SLOT_MASK;
+            auto occupiedSlots = level.OccupiedSlots[scannedSlot / 64] >> (scannedSlot % 64);
+            if (occupiedSlots != 0) {
+                auto distance = scanned + static_cast<size_t>(std::countr_zero(occupiedSlots)) + 1;
+                return (distance <= SLOTS_COUNT) ? distance : 0;
+            }
+
+            scanned += 64 - (scannedSlot % 64);
+        }
+
+        return 0;
+    }
+
+    TimerNode& AllocNode() {
+        if (mFreeNodeIdxs.empty()) {
+            auto& node = mNodes.emplace_back();
+            node.Idx = static_cast<uint32_t>(mNodes.size() - 1);
+            return node;
+        }
+
+        auto& node = mNodes[mFreeNodeIdxs.back()];
+        mFreeNodeIdxs.pop_back();
+        return node;
+    }
+
+    void FreeNode(TimerNode& node) {
+        node.Callback.Reset();
+        node.State = NodeState::FREE;
+        // The ids of the freed node are stale from now on
+        if (++node.Generation == 0) {
+            node.Generation = 1;
+        }
+
+        mFreeNodeIdxs.push_back(node.Idx);
+    }
+
+    TimerNode* FindNode(const TimerId id) {
+        auto nodeIdx = static_cast<uint32_t>(id);
+        if (nodeIdx >= mNodes.size()) {
+            return nullptr;
+        }
+
+        auto& node = mNodes[nodeIdx];
+        if ((node.State == NodeState::FREE) || (node.Generation != static_cast<uint32_t>(id >> 32))) {
+            return nullptr;
+        }
+
+        return &node;
+    }
+
+    uint64_t FloorTick(const Clock::time_point time) const {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time - mStart).count();
+        return static_cast<uint64_t>(std::max<int64_t>(elapsed, 0));
+    }
+
+    uint64_t CeilTick(const Clock::time_point time) const {
+        auto tick = FloorTick(time);
+        return (mStart + std::chrono::milliseconds(tick) < time) ? tick + 1 : tick;
+    }
+}; // class BasicTimerService
+
+using TimerService = BasicTimerService<>;
@@ -0,0 +1,383 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Tracing {
+using namespace StdLib;
+
+// Span of the request, e.g. of the config validation. The name is copied (and truncated if needed)
+struct SpanRecord {
+    static constexpr size_t MAX_NAME_SIZE = 88;
+
+    uint64_t RequestId = 0;
+    uint64_t StartNs = 0;
+    uint64_t DurationNs = 0;
+    uint32_t SpanId = 0;
+    uint32_t ParentSpanId = 0;
+    uint32_t ThreadId = 0;
+    char Name[MAX_NAME_SIZE] = {};
+};
+
+/*
+    Ring of the latest spans. Push() is lock-free: the writer takes the next slot by a single atomic increment and
+    guards its copy of the record by the sequence number of the slot (odd while the record is written), so the reader
+    skips the records which are overwritten while being read instead of stopping the writers. The oldest records are
+    overwritten once the ring is full. The writer claims the slot by compare-and-swap of the sequence number, so two
+    writers which lap the ring onto the same slot never mix their words: the record is dropped if the slot is being
+    written or already keeps a newer record.
+*/
+class SpanRing {
+public:
+    explicit SpanRing(const size_t capacity) : mSlots(std::bit_ceil(std::max<size_t>(capacity, 2))), mIdxMask(mSlots.size() - 1) {}
+
+    void Push(const SpanRecord& record) {
+        auto recordIdx = mNextIdx.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = mSlots[recordIdx & mIdxMask];
+        auto words = std::bit_cast<std::array<uint64_t, WORDS_COUNT>>(record);
+        auto writtenSequence = 2 * recordIdx + 1;
+        auto sequence = slot.Sequence.load(std::memory_order_relaxed);
+        do {
+            if ((sequence % 2 != 0) || (sequence > writtenSequence)) {
+                return;
+            }
+        } while (!slot.Sequence.compare_exchange_weak(sequence, writtenSequence, std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t wordIdx = 0; wordIdx < WORDS_COUNT; ++wordIdx) {
+            slot.Words[wordIdx].store(words[wordIdx], std::memory_order_relaxed);
+        }
+
+        slot.Sequence.store(writtenSequence + 1, std::memory_order_release);
+    }
+
+    // Records() returns the complete records from the oldest to the newest
+    Vector<SpanRecord> Records() const {
+        Vector<SpanRecord> records;
+        records.reserve(mSlots.size());
+        for (const auto& slot : mSlots) {
+            auto sequence = slot.Sequence.load(std::memory_order_acquire);
+            if ((sequence == 0) || (sequence % 2 != 0)) {
+                continue;
+            }
+
+            std::array<uint64_t, WORDS_COUNT> words;
+            for (size_t wordIdx = 0; wordIdx < WORDS_COUNT; ++wordIdx) {
+                words[wordIdx] = slot.Words[wordIdx].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.Sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            records.push_back(std::bit_cast<SpanRecord>(words));
+        }
+
+        std::ranges::sort(records, [](const SpanRecord& lhs, const SpanRecord& rhs) { return lhs.StartNs < rhs.StartNs; });
+        return records;
+    }
+
+    size_t Capacity() const { return mSlots.size(); }
+    uint64_t PushedCount() const { return mNextIdx.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t WORDS_COUNT = (sizeof(SpanRecord) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    static_assert(sizeof(SpanRecord) == WORDS_COUNT * sizeof(uint64_t));
+
+    struct Slot {
+        std::atomic<uint64_t> Sequence = 0;
+        std::array<std::atomic<uint64_t>, WORDS_COUNT> Words {};
+    };
+
+    Vector<Slot> mSlots;
+    const uint64_t mIdxMask;
+    std::atomic<uint64_t> mNextIdx = 0;
+}; // class SpanRing
+
+/*
+    Tree of the timed spans of each request. The request is bound to the thread which handles it (as the HTTP server
+    does), so the current request and span are kept by the thread and the nested ScopedSpan needs no context passed
+    down the calls. The spans are exported as the Chrome trace events (opened by Perfetto or chrome://tracing) or as
+    OTLP JSON, so no collector service is needed. The request id is assigned also when the tracing is disabled.
+*/
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    enum class ExportFormat : uint8_t {
+        CHROME,
+        OTLP
+    };
+
+    // Span of the request to continue in another thread, e.g. by the worker which does the part of the request
+    struct RequestContext {
+        uint64_t RequestId = 0;
+        uint32_t SpanId = 0;
+    };
+
+    explicit Tracer(const size_t capacity = DEFAULT_CAPACITY) : mSpans(capacity) {
+        using namespace std::chrono;
+        mUnixOffsetNs = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() - NowNs();
+        std::random_device randomDevice;
+        mTraceIdPrefix = (uint64_t(randomDevice()) << 32) | randomDevice();
+    }
+
+    void SetEnabled(const bool isEnabled) { mIsEnabled.store(isEnabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return mIsEnabled.load(std::memory_order_relaxed); }
+
+    // BeginRequest() starts the root span of the request handled by the calling thread and returns the request id
+    uint64_t BeginRequest(const StringView name) {
+        auto& context = Context();
+        context.RequestId = mNextRequestId.fetch_add(1, std::memory_order_relaxed);
+        context.Owner = this;
+        context.RootSpanId = NextSpanId();
+        context.CurrentSpanId = context.RootSpanId;
+        context.RequestStartNs = NowNs();
+        CopyName(context.RequestName, name);
+        return context.RequestId;
+    }
+
+    void EndRequest() {
+        auto& context = Context();
+        if ((context.RequestId == 0) || (context.Owner != this)) {
+            return;
+        }
+
+        if (IsEnabled()) {
+            Record(context.RequestId, context.RootSpanId, 0, context.RequestStartNs, NowNs() - context.RequestStartNs, context.RequestName);
+        }
+
+        context = ThreadContext {};
+    }
+
+    RequestContext CurrentRequest() const {
+        const auto& context = Context();
+        return (context.Owner == this) ? RequestContext { context.RequestId, context.CurrentSpanId } : RequestContext {};
+    }
+
+    // CurrentRequestId() returns the id of the request handled by the calling thread, or 0 if there is none
+    static uint64_t CurrentRequestId() { return Context().RequestId; }
+
+    Vector<SpanRecord> Spans() const { return mSpans.Records(); }
+
+    String RenderChromeTrace() const {
+        auto pid = ::getpid();
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool isFirst = true;
+        for (const auto& span : Spans()) {
+            text << (isFirst ? "" : ",") << "\n{\"name\":\"" << EscapeJson(span.Name) << "\",\"cat\":\"request\",\"ph\":\"X\""
+                 << ",\"ts\":" << static_cast<double>(span.StartNs) / 1e3 << ",\"dur\":" << static_cast<double>(span.DurationNs) / 1e3
+                 << ",\"pid\":" << pid << ",\"tid\":" << span.ThreadId << ",\"args\":{\"request_id\":" << span.RequestId
+                 << ",\"span_id\":" << span.SpanId << ",\"parent_span_id\":" << span.ParentSpanId << "}}";
+            isFirst = false;
+        }
+
+        text << "\n]}\n";
+        return text.str();
+    }
+
+    String RenderOtlpJson() const {
+        std::ostringstream text;
+        text << "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":\"service.name\",\"value\":{\"stringValue\":\"" << SERVICE_NAME << "\"}}]}"
+             << ",\"scopeSpans\":[{\"scope\":{\"name\":\"" << SERVICE_NAME << "\"},\"spans\":[";
+        bool isFirst = true;
+        for (const auto& span : Spans()) {
+            auto startUnixNs = span.StartNs + mUnixOffsetNs;
+            text << (isFirst ? "" : ",") << "\n{\"traceId\":\"" << Hex(mTraceIdPrefix) << Hex(span.RequestId) << "\",\"spanId\":\"" << OtlpSpanId(span.RequestId, span.SpanId) << '"';
+            if (span.ParentSpanId != 0) {
+                text << ",\"parentSpanId\":\"" << OtlpSpanId(span.RequestId, span.ParentSpanId) << '"';
+            }
+
+            text << ",\"name\":\"" << EscapeJson(span.Name) << "\",\"kind\":" << ((span.ParentSpanId == 0) ? SPAN_KIND_SERVER : SPAN_KIND_INTERNAL)
+                 << ",\"startTimeUnixNano\":\"" << startUnixNs << "\",\"endTimeUnixNano\":\"" << startUnixNs + span.DurationNs << '"'
+                 << ",\"attributes\":[{\"key\":\"thread.id\",\"value\":{\"intValue\":\"" << span.ThreadId << "\"}}]}";
+            isFirst = false;
+        }
+
+        text << "\n]}]}]}\n";
+        return text.str();
+    }
+
+    bool DumpToFile(const String& fileName, const ExportFormat format, String& error) const {
+        std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+        if (!file) {
+            error = "Failed to open file '" + fileName + "'";
+            return false;
+        }
+
+        file << ((format == ExportFormat::OTLP) ? RenderOtlpJson() : RenderChromeTrace());
+        file.close();
+        if (!file) {
+            error = "Failed to write file '" + fileName + "'";
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    friend class ScopedSpan;
+    friend class ScopedRequestContext;
+
+    static constexpr int SPAN_KIND_INTERNAL = 1;
+    static constexpr int SPAN_KIND_SERVER = 2;
+    static constexpr auto SERVICE_NAME = "BgpConfigApi";
+
+    struct ThreadContext {
+        const Tracer* Owner = nullptr;
+        uint64_t RequestId = 0;
+        uint64_t RequestStartNs = 0;
+        uint32_t RootSpanId = 0;
+        uint32_t CurrentSpanId = 0;
+        char RequestName[SpanRecord::MAX_NAME_SIZE] = {};
+    };
+
+    SpanRing mSpans;
+    std::atomic_bool mIsEnabled = false;
+    std::atomic<uint64_t> mNextRequestId = 1;
+    // Span ids are unique in the process, since the spans of the request may be recorded by many threads
+    std::atomic<uint32_t> mNextSpanId = 1;
+    uint64_t mUnixOffsetNs = 0;
+    uint64_t mTraceIdPrefix = 0;
+
+    uint32_t NextSpanId() { return mNextSpanId.fetch_add(1, std::memory_order_relaxed); }
+
+    static ThreadContext& Context() {
+        thread_local ThreadContext context;
+        return context;
+    }
+
+    static uint64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint32_t ThreadId() {
+        thread_local auto threadId = static_cast<uint32_t>(::syscall(SYS_gettid));
+        return threadId;
+    }
+
+    static void CopyName(char (&destination)[SpanRecord::MAX_NAME_SIZE], const StringView name) {
+        auto nameSize = std::min(name.size(), SpanRecord::MAX_NAME_SIZE - 1);
+        std::memcpy(destination, name.data(), nameSize);
+        destination[nameSize] = '\0';
+    }
+
+    void Record(const uint64_t requestId, const uint32_t spanId, const uint32_t parentSpanId, const uint64_t startNs, const uint64_t durationNs, const StringView name) {
+        SpanRecord record;
+        record.RequestId = requestId;
+        record.StartNs = startNs;
+        record.DurationNs = durationNs;
+        record.SpanId = spanId;
+        record.ParentSpanId = parentSpanId;
+        record.ThreadId = ThreadId();
+        CopyName(record.Name, name);
+        mSpans.Push(record);
+    }
+
+    static String Hex(const uint64_t value) {
+        std::ostringstream text;
+        text << std::hex << std::setw(16) << std::setfill('0') << value;
+        return text.str();
+    }
+
+    // OtlpSpanId() makes the 64-bit span id, which stays unique once the 32-bit span ids wrap around
+    static String OtlpSpanId(const uint64_t requestId, const uint32_t spanId) { return Hex((requestId << 32) | spanId); }
+
+    static String EscapeJson(const StringView text) {
+        String escaped;
+        escaped.reserve(text.size());
+        for (auto character : text) {
+            if ((character == '"') || (character == '\\')) {
+                escaped += '\\';
+                escaped += character;
+            }
+            else if (static_cast<unsigned char>(character) < 0x20) {
+                escaped += ' ';
+            }
+            else {
+                escaped += character;
+            }
+        }
+
+        return escaped;
+    }
+}; // class Tracer
+
+// Span of the scope, nested in the span of the enclosing scope of the same request. Nothing is recorded out of the request
+class ScopedSpan {
+public:
+    ScopedSpan(Tracer& tracer, const char* name) {
+        auto& context = Tracer::Context();
+        if ((context.RequestId == 0) || (context.Owner != &tracer) || !tracer.IsEnabled()) {
+            return;
+        }
+
+        mTracer = &tracer;
+        mName = name;
+        mParentSpanId = context.CurrentSpanId;
+        mSpanId = tracer.NextSpanId();
+        context.CurrentSpanId = mSpanId;
+        mStartNs = Tracer::NowNs();
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    ~ScopedSpan() {
+        if (mTracer == nullptr) {
+            return;
+        }
+
+        auto& context = Tracer::Context();
+        context.CurrentSpanId = mParentSpanId;
+        mTracer->Record(context.RequestId, mSpanId, mParentSpanId, mStartNs, Tracer::NowNs() - mStartNs, mName);
+    }
+
+private:
+    Tracer* mTracer = nullptr;
+    const char* mName = nullptr;
+    uint64_t mStartNs = 0;
+    uint32_t mSpanId = 0;
+    uint32_t mParentSpanId = 0;
+}; // class ScopedSpan
+
+// Binds the calling thread to the request of another thread for the scope, so the spans of the thread nest in that request
+class ScopedRequestContext {
+public:
+    ScopedRequestContext(Tracer& tracer, const Tracer::RequestContext& request) : mSavedContext(Tracer::Context()) {
+        auto& context = Tracer::Context();
+        context = Tracer::ThreadContext {};
+        if (request.RequestId != 0) {
+            context.Owner = &tracer;
+            context.RequestId = request.RequestId;
+            context.CurrentSpanId = request.SpanId;
+        }
+    }
+
+    ScopedRequestContext(const ScopedRequestContext&) = delete;
+    ScopedRequestContext& operator=(const ScopedRequestContext&) = delete;
+    ~ScopedRequestContext() { Tracer::Context() = mSavedContext; }
+
+private:
+    const Tracer::ThreadContext mSavedContext;
+}; // class ScopedRequestContext
+} // namespace Tracing
@@ -5,6 +5,8 @@
 
 #include "StdLib.hpp"
 
+#include <array>
+#include <cstdint>
 #include <regex>
 
 namespace Utils {
@@ -62,4 +64,39 @@ static Vector<String> fSplitStringByWhitespace(const String& input) {
     return tokens;
 }
 
+// fCrc32() calculates CRC-32 (IEEE 802.3, reflected 0xEDB88320 polynomial). Pass previous result as 'crc' to continue the checksum
+inline uint32_t fCrc32(const void* data, const size_t size, uint32_t crc = 0) {
+    static constexpr auto CRC32_TABLE = [] {
+        std::array<uint32_t, 256> table {};
+        for (uint32_t i = 0; i < table.size(); ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+
+            table[i] = c;
+        }
+
+        return table;
+    }();
+
+    auto bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = CRC32_TABLE[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+// fFnv1a64() calculates 64-bit FNV-1a hash of the content. Pass previous result as 'hash' to continue hashing
+inline uint64_t fFnv1a64(const void* data, const size_t size, uint64_t hash = 0xCBF29CE484222325ull) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
 } // namespace Utils
@@ -0,0 +1,140 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "StdLib.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <queue>
+
+namespace Utils {
+using namespace StdLib;
+
+/*
+    Fixed set of worker threads for splitting CPU-bound work. RunParallel() runs the given number of tasks on
+    the workers and on the calling thread, and returns once all of them have finished. The calling thread
+    takes tasks as well, so the work goes on even if all the workers are busy with other callers.
+*/
+class WorkerPool {
+public:
+    using Task = std::function<void(const size_t taskIdx)>;
+
+    explicit WorkerPool(size_t workersCount = DefaultWorkersCount()) {
+        for (size_t i = 0; i < workersCount; ++i) {
+            mWorkers.emplace_back([this]() { Run(); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() {
+        {
+            LockGuard<Mutex> lock(mMutex);
+            mIsStopped = true;
+        }
+
+        mCondVar.notify_all();
+        for (auto& worker : mWorkers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    void RunParallel(const size_t tasksCount, const Task& task) {
+        if (tasksCount == 0) {
+            return;
+        }
+
+        auto job = std::make_shared<Job>(task, tasksCount);
+        if (!mWorkers.empty() && (tasksCount > 1)) {
+            {
+                LockGuard<Mutex> lock(mMutex);
+                // One entry per worker which can help, the tasks are taken from the job by index
+                for (size_t i = 0; i < std::min(tasksCount - 1, mWorkers.size()); ++i) {
+                    mJobs.push(job);
+                }
+            }
+
+            mCondVar.notify_all();
+        }
+
+        job->RunTasks();
+        UniqueLock<Mutex> lock(job->FinishedMutex);
+        job->FinishedCondVar.wait(lock, [&job]() { return job->FinishedTasksCount == job->TasksCount; });
+        if (job->FirstError) {
+            std::rethrow_exception(job->FirstError);
+        }
+    }
+
+    size_t WorkersCount() const { return mWorkers.size(); }
+
+    // DefaultWorkersCount() leaves one core for the calling thread, which takes the tasks as well
+    static size_t DefaultWorkersCount() {
+        auto coresCount = Thread::hardware_concurrency();
+        return (coresCount > 1) ? (coresCount - 1) : 0;
+    }
+
+private:
+    struct Job {
+        Job(const Task& task, const size_t tasksCount) : TaskFn(task), TasksCount(tasksCount) {}
+
+        void RunTasks() {
+            for (auto taskIdx = NextTaskIdx++; taskIdx < TasksCount; taskIdx = NextTaskIdx++) {
+                std::exception_ptr error;
+                try {
+                    TaskFn(taskIdx);
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+
+                LockGuard<Mutex> lock(FinishedMutex);
+                if (error && !FirstError) {
+                    FirstError = error;
+                }
+
+                if (++FinishedTasksCount == TasksCount) {
+                    FinishedCondVar.notify_all();
+                }
+            }
+        }
+
+        const Task& TaskFn;
+        const size_t TasksCount;
+        std::atomic<size_t> NextTaskIdx = 0;
+        size_t FinishedTasksCount = 0;
+        std::exception_ptr FirstError;
+        Mutex FinishedMutex;
+        ConditionVariable FinishedCondVar;
+    };
+
+    Vector<Thread> mWorkers;
+    std::queue<SharedPtr<Job>> mJobs;
+    Mutex mMutex;
+    ConditionVariable mCondVar;
+    bool mIsStopped = false;
+
+    void Run() {
+        for (;;) {
+            SharedPtr<Job> job;
+            {
+                UniqueLock<Mutex> lock(mMutex);
+                mCondVar.wait(lock, [this]() { return mIsStopped || !mJobs.empty(); });
+                if (mIsStopped) {
+                    return;
+                }
+
+                job = mJobs.front();
+                mJobs.pop();
+            }
+
+            job->RunTasks();
+        }
+    }
+}; // class WorkerPool
+} // namespace Utils
@@ -3,55 +3,93 @@
  */
 #include "BirdConfigConverter.hpp"
 #include "BirdConfigExecutor.hpp"
+#include "ConfigChangeClassifier.hpp"
 #include "ConnectionManagement.hpp"
+#include "FanOutConfigExecutor.hpp"
+#include "FanOutStorage.hpp"
 #include "FileStorage.hpp"
 #include "HttpCommon.hpp"
 #include "JsonConfigManager.hpp"
 #include "JsonFileStorage.hpp"
 #include "JsonSchemaManager.hpp"
+#include "JsonSchemaSnapshot.hpp"
+#include "JsonWalStorage.hpp"
 #include "Modules.hpp"
+#include "PolicySimulator.hpp"
+#include "ReloadableSchemaManager.hpp"
+#include "Lib/LogRing.hpp"
 #include "Lib/Utils.hpp"
 
 #include "args/args.hxx"
+#include "defer/defer.h"
 #include "httplib/httplib.h"
 #include "subprocess.h/subprocess.h"
 
+#include <fmt/chrono.h>
 #include <fmt/core.h>
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/ostream_sink.h>
-#include <spdlog/sinks/ringbuffer_sink.h>
 
+#include <charconv>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 
 namespace Std = StdLib;
 
-bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& cm, Std::UniquePtr<Config::IConfigManagement>& runningConfigMngr, Std::SharedPtr<Schema::ISchemaManagement> schemaMngr, Std::SharedPtr<Storage::IDataStorage>& runningConfigStorage, Std::SharedPtr<Storage::IDataStorage>& targetConfigStorage, Std::SharedPtr<Config::IConfigConverting> configConverter, Std::SharedPtr<Config::Executing::IConfigExecuting>& targetConfigExecutor, const Std::SharedPtr<ModuleRegistry>& moduleRegistry) {
+// Metrics of the config pipeline, i.e. of the PATCH of the running config and of applying the candidate config
+struct PipelineMetrics {
+    explicit PipelineMetrics(Metrics::MetricsRegistry& metrics)
+      : ApplyPatchLatency(StageLatency(metrics, "apply_patch")), SerializeConfigLatency(StageLatency(metrics, "serialize_config")),
+        ValidateDataLatency(StageLatency(metrics, "validate_data")), ConvertLatency(StageLatency(metrics, "convert")),
+        SaveDataLatency(StageLatency(metrics, "save_data")), ClassifyChangeLatency(StageLatency(metrics, "classify_change")),
+        ExecValidateLatency(StageLatency(metrics, "exec_validate")), ExecLoadLatency(StageLatency(metrics, "exec_load")),
+        CandidatesCreated(metrics.GetCounter("bgp_config_api_candidates_created_total", "Number of the candidate configs created")),
+        CommitsSucceeded(metrics.GetCounter("bgp_config_api_commits_total", "Number of the applied candidate configs", { { "result", "success" } })),
+        CommitsFailed(metrics.GetCounter("bgp_config_api_commits_total", "Number of the applied candidate configs", { { "result", "failure" } })) {}
+
+    Metrics::LatencyHistogram& ApplyPatchLatency;
+    Metrics::LatencyHistogram& SerializeConfigLatency;
+    Metrics::LatencyHistogram& ValidateDataLatency;
+    Metrics::LatencyHistogram& ConvertLatency;
+    Metrics::LatencyHistogram& SaveDataLatency;
+    Metrics::LatencyHistogram& ClassifyChangeLatency;
+    Metrics::LatencyHistogram& ExecValidateLatency;
+    Metrics::LatencyHistogram& ExecLoadLatency;
+    Metrics::Counter& CandidatesCreated;
+    Metrics::Counter& CommitsSucceeded;
+    Metrics::Counter& CommitsFailed;
+
+    static Metrics::LatencyHistogram& StageLatency(Metrics::MetricsRegistry& metrics, const char* stageName) {
+        return metrics.GetHistogram("bgp_config_api_stage_duration_seconds", "Duration of the stages of the config pipeline", { { "stage", stageName } });
+    }
+};
+
+bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& cm, Std::UniquePtr<Config::IConfigManagement>& runningConfigMngr, Std::SharedPtr<Schema::ISchemaManagement> schemaMngr, Std::SharedPtr<Storage::IDataStorage>& runningConfigStorage, Std::SharedPtr<Storage::IDataStorage>& targetConfigStorage, Std::SharedPtr<Config::IConfigConverting> configConverter, Std::SharedPtr<Config::Executing::IConfigExecuting>& targetConfigExecutor, Std::SharedPtr<Policy::PolicySimulator> policySimulator, const Std::SharedPtr<ModuleRegistry>& moduleRegistry, const Std::String& traceFilename, const size_t logRingSize) {
     auto loggerRegistry = moduleRegistry->LoggerRegistry();
     loggerRegistry->RegisterModule(Module::Name::SRV_USR_REQ_HANDLE);
 
-    static const size_t DEFAULT_RINGBUFFER_CAP = 64;
-    // The userReqLogMsgBuf is used to log messages related to external user interaction/handle request
-    auto srvUsrReqLogSink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(DEFAULT_RINGBUFFER_CAP);
-    srvUsrReqLogSink->set_level(spdlog::level::err);
-    srvUsrReqLogSink->set_pattern("%v"); // Pattern: message only
-    loggerRegistry->AddLogSink(srvUsrReqLogSink);
+    // The latest messages of all the modules, with the session and the request they have been logged for, are
+    // served by GET /logs/latest/{n}. The ring is written synchronously, by the thread which handles the request
+    auto logRing = std::make_shared<Log::StructuredLogRing>(logRingSize);
+    loggerRegistry->AddSyncLogSink(logRing);
 
     auto srvUsrReqLog = loggerRegistry->Logger(Module::Name::SRV_USR_REQ_HANDLE);
     srvUsrReqLog->set_level(spdlog::level::err);
 
     // Right now there can be active only single instance of candidate config
     static Std::UniquePtr<Config::IConfigManagement> gCandidateConfigMngr;
+    auto pipelineMetrics = std::make_shared<PipelineMetrics>(*moduleRegistry->Metrics());
 
-    cm->addOnPatchConnectionHandler("config_running_update", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, schemaMngr, runningConfigStorage, targetConfigStorage, configConverter, targetConfigExecutor, moduleRegistry, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+    cm->addOnPatchConnectionHandler("config_running_update", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, schemaMngr, runningConfigStorage, targetConfigStorage, configConverter, targetConfigExecutor, pipelineMetrics, moduleRegistry, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING_UPDATE);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request on {} with PATCH method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request on {} with PATCH method: {}", path, dataRequest);
 
         if (candidateConfigMngr) {
             srvUsrReqLog->error("There is other active session with pending candidate config changes");
@@ -63,6 +101,7 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         if (!candidateConfigMngr) {
             if (auto jsonBasedConfigMngr = dynamic_cast<Config::JsonConfigManager*>(runningConfigMngr.get())) {
                 candidateConfigMngr.reset(new Config::JsonConfigManager(*jsonBasedConfigMngr));
+                pipelineMetrics->CandidatesCreated.Increment();
             }
             else {
                 srvUsrReqLog->error("Unsupported type of derived class from Config::IConfigManagement");
@@ -70,12 +109,14 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
             }
         }
 
+        Metrics::LapTimer stageTimer;
         ByteStream patchData(dataRequest.begin(), dataRequest.end());
         if (!candidateConfigMngr->ApplyPatch(patchData)) {
             srvUsrReqLog->error("Failed to apply patch to running config");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->ApplyPatchLatency);
         auto configData = candidateConfigMngr->SerializeConfig();
         if (!configData.has_value()) {
             srvUsrReqLog->error("Failed to serialize candidate config");
@@ -83,12 +124,14 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
-        if (!schemaMngr->ValidateData(configData.value())) {
+        stageTimer.Lap(pipelineMetrics->SerializeConfigLatency);
+        if (!schemaMngr->ValidateData(configData.value(), returnData)) {
             srvUsrReqLog->error("Failed to validate candidate config data against its schema");
             candidateConfigMngr.reset(nullptr);
-            return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+            return returnData.empty() ? HTTP::StatusCode::INTERNAL_SERVER_ERROR : HTTP::StatusCode::BAD_REQUEST;
         }
 
+        stageTimer.Lap(pipelineMetrics->ValidateDataLatency);
         auto targetConfigData = configConverter->Convert(configData.value());
         if (!targetConfigData.has_value()) {
             srvUsrReqLog->error("Failed to convert native config into target config");
@@ -96,14 +139,18 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->ConvertLatency);
         if (!targetConfigStorage->SaveData(targetConfigData.value())) {
             srvUsrReqLog->error("Failed to save target config into file {}", targetConfigStorage->URI());
             candidateConfigMngr.reset(nullptr);
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->SaveDataLatency);
         if (targetConfigExecutor) {
-            if (!targetConfigExecutor->Validate()) {
+            auto isValid = targetConfigExecutor->Validate();
+            stageTimer.Lap(pipelineMetrics->ExecValidateLatency);
+            if (!isValid) {
                 srvUsrReqLog->error("Failed to validate candidate config by external program");
                 if (!targetConfigStorage->SaveData(configConverter->Convert(runningConfigMngr->SerializeConfig().value()).value())) {
                     srvUsrReqLog->error("Failed to restore running config into '{}'", targetConfigStorage->URI());
@@ -119,11 +166,11 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
     cm->addOnGetConnectionHandler("config_running_get", [&runningConfigMngr, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::RUNNING) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request running on {} with GET method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request running on {} with GET method: {}", path, dataRequest);
         auto configData = runningConfigMngr->SerializeConfig();
         if (!configData.has_value()) {
             srvUsrReqLog->error("Failed to serialize config");
@@ -139,17 +186,17 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         return HTTP::StatusCode::OK;
     });
 
-    cm->addOnGetConnectionHandler("config_running_diff", [&runningConfigMngr, &schemaMngr, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+    cm->addOnGetConnectionHandler("config_running_diff", [&runningConfigMngr, schemaMngr, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::RUNNING_DIFF);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request on {} with POST diff method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request on {} with POST diff method: {}", path, dataRequest);
         ByteStream otherConfigData(dataRequest.begin(), dataRequest.end());
-        if (!schemaMngr->ValidateData(otherConfigData)) {
+        if (!schemaMngr->ValidateData(otherConfigData, returnData)) {
             srvUsrReqLog->error("Failed to validate other config data against its schema");
-            return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+            return returnData.empty() ? HTTP::StatusCode::INTERNAL_SERVER_ERROR : HTTP::StatusCode::BAD_REQUEST;
         }
 
         auto patchData = runningConfigMngr->MakeDiff(otherConfigData);
@@ -166,11 +213,11 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
     cm->addOnGetConnectionHandler("config_candidate_get", [&candidateConfigMngr = gCandidateConfigMngr, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request candidate on {} with GET method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request candidate on {} with GET method: {}", path, dataRequest);
         if (!candidateConfigMngr) {
             srvUsrReqLog->error("Not found active candidate config");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
@@ -188,31 +235,50 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         return HTTP::StatusCode::OK;
     });
 
-    static auto fApplyConfig = [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &runningConfigStorage, configConverter, targetConfigStorage, targetConfigExecutor, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) -> HTTP::StatusCode {
+    auto configChangeClassifier = std::make_shared<Config::ConfigChangeClassifier>(moduleRegistry);
+    // Config last loaded into the target by the external program. It differs from the running config while the commit
+    // waits for the confirmation, and it is unknown (so the next config is loaded fully) after the start or a failed load
+    static Std::Optional<ByteStream> loadedTargetConfigData = {};
+    static auto fApplyConfig = [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &runningConfigStorage, configConverter, targetConfigStorage, targetConfigExecutor, configChangeClassifier, pipelineMetrics, srvUsrReqLog, &loadedConfigData = loadedTargetConfigData](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) -> HTTP::StatusCode {
+        bool isApplied = false;
+        DEFER({
+            (isApplied ? pipelineMetrics->CommitsSucceeded : pipelineMetrics->CommitsFailed).Increment();
+        });
+
         if (!candidateConfigMngr) {
-            spdlog::trace("Not found active candidate config");
+            LOG_TRACE(spdlog::default_logger_raw(), "Not found active candidate config");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        Metrics::LapTimer stageTimer;
         auto candidateConfigData = candidateConfigMngr->SerializeConfig();
         if (!candidateConfigData.has_value()) {
             srvUsrReqLog->error("Failed to serialize candidate config");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->SerializeConfigLatency);
         auto targetConfigData = configConverter->Convert(candidateConfigData.value());
         if (!targetConfigData.has_value()) {
             srvUsrReqLog->error("Failed to convert candidate config into target config");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->ConvertLatency);
         if (!targetConfigStorage->SaveData(targetConfigData.value())) {
             srvUsrReqLog->error("Failed to save target config into file {}", targetConfigStorage->URI());
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
+        stageTimer.Lap(pipelineMetrics->SaveDataLatency);
         if (targetConfigExecutor) {
-            if (!targetConfigExecutor->Load()) {
+            // The difference from the config loaded by the external program tells how to load the candidate config
+            auto configChange = loadedConfigData.has_value() ? configChangeClassifier->Classify(loadedConfigData.value(), candidateConfigData.value()) : Config::Executing::ConfigChange {};
+            stageTimer.Lap(pipelineMetrics->ClassifyChangeLatency);
+            auto isLoaded = targetConfigExecutor->Load(configChange);
+            stageTimer.Lap(pipelineMetrics->ExecLoadLatency);
+            loadedConfigData = isLoaded ? Std::Optional<ByteStream>(candidateConfigData.value()) : std::nullopt;
+            if (!isLoaded) {
                 srvUsrReqLog->error("Failed to load candidate config by external program");
                 if (!targetConfigStorage->SaveData(configConverter->Convert(runningConfigMngr->SerializeConfig().value()).value())) {
                     srvUsrReqLog->error("Failed to restore running config into '{}'", targetConfigStorage->URI());
@@ -222,6 +288,7 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
             }
         }
 
+        isApplied = true;
         return HTTP::StatusCode::OK;
     };
 
@@ -229,11 +296,11 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
     cm->addOnPostConnectionHandler("config_candidate_commit", [&applyConfig = fApplyConfig, &runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, runningConfigStorage, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request candidate on {} with POST method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request candidate on {} with POST method: {}", path, dataRequest);
         
         auto result = applyConfig(sessionId, path, dataRequest, returnData);
         if (result != HTTP::StatusCode::OK) {
@@ -256,11 +323,11 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
     cm->addOnPostConnectionHandler("config_candidate_commit_timeout", [&applyConfig = fApplyConfig, &confirmBySessionId = waitCommitConfirmSessionId](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_TIMEOUT);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request candidate on {} with POST method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request candidate on {} with POST method: {}", path, dataRequest);
         auto result = applyConfig(sessionId, path, dataRequest, returnData);
         if (result != HTTP::StatusCode::OK) {
             return result;
@@ -272,18 +339,18 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
     cm->addOnPostConnectionHandler("config_candidate_commit_confirm", [&applyConfig = fApplyConfig, &runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, runningConfigStorage, srvUsrReqLog, &confirmBySessionId = waitCommitConfirmSessionId](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CONFIRM);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        spdlog::debug("Get request candidate on {} with POST method: {}", path, dataRequest);
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request candidate on {} with POST method: {}", path, dataRequest);
         if (!confirmBySessionId.has_value()) {
-            spdlog::trace("There is not pending commit-confirm process");
+            LOG_TRACE(spdlog::default_logger_raw(), "There is not pending commit-confirm process");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
         if (confirmBySessionId.value() != sessionId) {
-            spdlog::trace("The session id '{}' is not owner of pending commit-confirm");
+            LOG_TRACE(spdlog::default_logger_raw(), "The session id '{}' is not owner of pending commit-confirm");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
@@ -301,24 +368,24 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         return HTTP::StatusCode::OK;
     });
 
-    cm->addOnPostConnectionHandler("config_candidate_commit_cancel", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &configConverter, targetConfigStorage, targetConfigExecutor, srvUsrReqLog, &confirmBySessionId = waitCommitConfirmSessionId](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+    cm->addOnPostConnectionHandler("config_candidate_commit_cancel", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &configConverter, targetConfigStorage, targetConfigExecutor, srvUsrReqLog, &confirmBySessionId = waitCommitConfirmSessionId, &loadedConfigData = loadedTargetConfigData](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE_COMMIT_CANCEL);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
         if (!confirmBySessionId.has_value()) {
-            srvUsrReqLog->trace("There is not pending commit-confirm process");
+            LOG_TRACE(srvUsrReqLog, "There is not pending commit-confirm process");
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
         if (confirmBySessionId.value() != sessionId) {
-            srvUsrReqLog->trace("The session id '{}' is not owner of pending commit-confirm process", sessionId);
+            LOG_TRACE(srvUsrReqLog, "The session id '{}' is not owner of pending commit-confirm process", sessionId);
             return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
         }
 
         if (!candidateConfigMngr) {
-            spdlog::debug("There is not active candidate config");
+            LOG_DEBUG(spdlog::default_logger_raw(), "There is not active candidate config");
             return HTTP::StatusCode::OK;
         }
 
@@ -328,6 +395,8 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         }
 
         if (targetConfigExecutor) {
+            // The undo returns to the config loaded before the last load, which is not tracked, so the next one is loaded fully
+            loadedConfigData = std::nullopt;
             if (!targetConfigExecutor->Rollback(targetConfigStorage)) {
                 srvUsrReqLog->error("Failed to load running config by external program");
                 return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
@@ -340,9 +409,9 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
     });
 
     // NOTE: It is also automatically called in case of expired session token
-    cm->addOnDeleteConnectionHandler("config_candidate_delete", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &configConverter, targetConfigStorage, targetConfigExecutor, srvUsrReqLog, &confirmBySessionId = waitCommitConfirmSessionId](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+    cm->addOnDeleteConnectionHandler("config_candidate_delete", [&runningConfigMngr, &candidateConfigMngr = gCandidateConfigMngr, &configConverter, targetConfigStorage, targetConfigExecutor, srvUsrReqLog, &confirmBySessionId = waitCommitConfirmSessionId, &loadedConfigData = loadedTargetConfigData](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Config::CANDIDATE) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Config::CANDIDATE);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
@@ -354,7 +423,7 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
         }
 
         if (!candidateConfigMngr) {
-            spdlog::trace("There is not active candidate config");
+            LOG_TRACE(spdlog::default_logger_raw(), "There is not active candidate config");
             return HTTP::StatusCode::OK;
         }
 
@@ -370,42 +439,219 @@ bool fSetupServerRequestHandlers(Std::SharedPtr<ConnectionManagement::Server>& c
 
         if (targetConfigExecutor) {
             // FIXME: Use targetConfigExecutor->Rollback()?
+            loadedConfigData = std::nullopt;
             if (!targetConfigExecutor->Load()) {
                 srvUsrReqLog->error("Failed to load running config by external program");
                 return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
             }
+
+            loadedConfigData = runningConfigMngr->SerializeConfig();
         }
         
         return HTTP::StatusCode::OK;
     });
 
-    cm->addOnGetConnectionHandler("logs_latest_n_get", [srvUsrReqLog, srvUsrReqLogSink](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+    cm->addOnPostConnectionHandler("admin_schema_reload", [schemaMngr, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+        if (path != ConnectionManagement::URIRequestPath::Admin::SCHEMA_RELOAD) {
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Admin::SCHEMA_RELOAD);
+            return HTTP::StatusCode::INTERNAL_SUCCESS;
+        }
+
+        // The schema manager is swapped only if the new schema is loaded successfully, so sessions are not affected
+        if (!schemaMngr->LoadSchema()) {
+            srvUsrReqLog->error("Failed to reload the schema");
+            return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+        }
+
+        return HTTP::StatusCode::OK;
+    });
+
+    cm->addOnGetConnectionHandler("admin_schema_statistics_get", [schemaMngr](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+        if (path != ConnectionManagement::URIRequestPath::Admin::SCHEMA_STATISTICS) {
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Admin::SCHEMA_STATISTICS);
+            return HTTP::StatusCode::INTERNAL_SUCCESS;
+        }
+
+        Json::JSON jStatistics = Json::JSON::object();
+        for (const auto& [name, value] : schemaMngr->Statistics()) {
+            jStatistics[name] = value;
+        }
+
+        returnData = jStatistics.dump(Json::DEFAULT_OUTPUT_INDENT);
+        return HTTP::StatusCode::OK;
+    });
+
+    cm->addOnPostConnectionHandler("admin_trace_dump", [tracer = moduleRegistry->Tracer(), traceFilename, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+        if (path != ConnectionManagement::URIRequestPath::Admin::TRACE_DUMP) {
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Admin::TRACE_DUMP);
+            return HTTP::StatusCode::INTERNAL_SUCCESS;
+        }
+
+        if (!tracer->IsEnabled()) {
+            srvUsrReqLog->error("Failed to dump trace. Error: Tracing is disabled (no trace file given)");
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        // Optional request: {"format": "chrome"} (default, for Perfetto) or {"format": "otlp"}
+        Std::String formatName = "chrome";
+        try {
+            if (!dataRequest.empty()) {
+                formatName = Json::JSON::parse(dataRequest).value("format", formatName);
+            }
+        }
+        catch (const Std::Exception& ex) {
+            srvUsrReqLog->error("Failed to parse trace dump request. Error: {}", ex.what());
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        if ((formatName != "chrome") && (formatName != "otlp")) {
+            srvUsrReqLog->error("Failed to dump trace. Error: Unsupported format '{}'", formatName);
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        Std::String error;
+        auto format = (formatName == "otlp") ? Tracing::Tracer::ExportFormat::OTLP : Tracing::Tracer::ExportFormat::CHROME;
+        if (!tracer->DumpToFile(traceFilename, format, error)) {
+            srvUsrReqLog->error("Failed to dump trace. Error: {}", error);
+            return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+        }
+
+        returnData = Json::JSON { { "file", traceFilename }, { "format", formatName } }.dump(Json::DEFAULT_OUTPUT_INDENT);
+        return HTTP::StatusCode::OK;
+    });
+
+    cm->addOnPostConnectionHandler("policy_simulate", [&runningConfigMngr, policySimulator, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
+        if (path != ConnectionManagement::URIRequestPath::Policy::SIMULATE) {
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Policy::SIMULATE);
+            return HTTP::StatusCode::INTERNAL_SUCCESS;
+        }
+
+        // The routes are not logged, there can be millions of them
+        LOG_DEBUG(spdlog::default_logger_raw(), "Get request on {} with POST method", path);
+        auto configData = runningConfigMngr->SerializeConfig();
+        if (!configData.has_value()) {
+            srvUsrReqLog->error("Failed to serialize config");
+            return HTTP::StatusCode::INTERNAL_SERVER_ERROR;
+        }
+
+        ByteStream requestData(dataRequest.begin(), dataRequest.end());
+        auto report = policySimulator->Simulate(configData.value(), requestData);
+        if (!report.has_value()) {
+            srvUsrReqLog->error("Failed to simulate the policy of the request");
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        returnData = report.value().dump(Json::DEFAULT_OUTPUT_INDENT);
+        return HTTP::StatusCode::OK;
+    });
+
+    cm->addOnGetConnectionHandler("logs_latest_n_get", [logRing, srvUsrReqLog](const Std::String& sessionId, const Std::String& path, Std::String dataRequest, Std::String& returnData) {
         if (path != ConnectionManagement::URIRequestPath::Logs::LATEST_N) {
-            spdlog::debug("Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Logs::LATEST_N);
+            LOG_DEBUG(spdlog::default_logger_raw(), "Unexpected URI requested '{}' - expected '{}'", path, ConnectionManagement::URIRequestPath::Logs::LATEST_N);
             return HTTP::StatusCode::INTERNAL_SUCCESS;
         }
 
-        Std::OStrStream returnDataBuf;
-        for (const auto& msg : srvUsrReqLogSink->last_raw(std::stoi(dataRequest))) {
-            returnDataBuf << fmt::format("{}\n", msg.payload);
+        // Request: {"count": "N", "session": "TOKEN", "level": "LEVEL"}, where the session and the level are optional
+        Std::String countText;
+        Std::Optional<Std::String> session;
+        auto minLevel = spdlog::level::trace;
+        try {
+            auto jRequest = Json::JSON::parse(dataRequest);
+            countText = jRequest.at("count").get<Std::String>();
+            if (jRequest.contains("session")) {
+                session = jRequest.at("session").get<Std::String>();
+            }
+
+            if (jRequest.contains("level")) {
+                auto levelName = jRequest.at("level").get<Std::String>();
+                minLevel = spdlog::level::from_str(levelName);
+                if ((minLevel == spdlog::level::off) && (levelName != "off")) {
+                    srvUsrReqLog->error("Failed to get latest logs. Error: Unsupported level '{}'", levelName);
+                    return HTTP::StatusCode::BAD_REQUEST;
+                }
+            }
+        }
+        catch (const Std::Exception& ex) {
+            srvUsrReqLog->error("Failed to parse latest logs request. Error: {}", ex.what());
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        // The count is bounded by the size of the ring, also when it does not fit in size_t
+        size_t count = 0;
+        auto [countEnd, countError] = std::from_chars(countText.data(), countText.data() + countText.size(), count);
+        if (countError == std::errc::result_out_of_range) {
+            count = logRing->Capacity();
+        }
+        else if ((countError != std::errc()) || (countEnd != countText.data() + countText.size())) {
+            srvUsrReqLog->error("Failed to get latest logs. Error: Invalid number of logs '{}'", countText);
+            return HTTP::StatusCode::BAD_REQUEST;
+        }
+
+        auto jEntries = Json::JSON::array();
+        for (const auto& entry : logRing->Latest(count, session, minLevel)) {
+            auto sinceEpochMs = std::chrono::duration_cast<std::chrono::milliseconds>(entry.Time.time_since_epoch()).count();
+            Json::JSON jEntry = {
+                { "seq", entry.Seq },
+                { "time", fmt::format("{:%Y-%m-%dT%H:%M:%S}.{:03}Z", fmt::gmtime(static_cast<std::time_t>(sinceEpochMs / 1000)), sinceEpochMs % 1000) },
+                { "level", Std::String(spdlog::level::to_string_view(entry.Level).data(), spdlog::level::to_string_view(entry.Level).size()) },
+                { "module", entry.Module },
+                { "request_id", entry.RequestId },
+                { "message", entry.Message }
+            };
+
+            // The session token is shown only to the caller which has given it
+            if (session.has_value()) {
+                jEntry["session"] = entry.Session;
+            }
+
+            jEntries.push_back(std::move(jEntry));
         }
 
-        returnData = returnDataBuf.str();
+        returnData = jEntries.dump(Json::DEFAULT_OUTPUT_INDENT);
         return HTTP::StatusCode::OK;
     });
 
     return true;
 }
 
+// fRunPolicySimulation() evaluates the policy of the request file against the config file, and prints the report
+bool fRunPolicySimulation(Policy::PolicySimulator& policySimulator, const Std::String& configFilename, const Std::String& requestFilename, const Std::SharedPtr<ModuleRegistry>& moduleRegistry) {
+    auto configData = Storage::FileStorage(configFilename, moduleRegistry).LoadData();
+    auto requestData = Storage::FileStorage(requestFilename, moduleRegistry).LoadData();
+    if (!configData.has_value() || !requestData.has_value()) {
+        spdlog::error("Failed to load config '{}' or simulation request '{}'", configFilename, requestFilename);
+        return false;
+    }
+
+    auto report = policySimulator.Simulate(configData.value(), requestData.value(), true);
+    if (!report.has_value()) {
+        spdlog::error("Failed to simulate the policy of the request '{}'", requestFilename);
+        return false;
+    }
+
+    std::cout << report.value().dump(Json::DEFAULT_OUTPUT_INDENT) << std::endl;
+    return true;
+}
+
 int main(const int argc, const char* argv[]) {
     args::ArgumentParser argParser("Configuration Management System");
     args::HelpFlag help(argParser, "HELP", "Show this help menu", {'h', "help"});
     args::ValueFlag<Std::String> thisHostAddress(argParser, "ADDRESS", "The host binding address (hostname or IP address)", { 'a', "address" });
     args::ValueFlag<Std::String> configFilename(argParser, "CONFIG", "The configuration file", { 'c', "config" });
-    args::ValueFlag<Std::String> execPath(argParser, "EXEC", "Path to the executable program to verify and load the config", { 'e', "exec" });
+    args::ValueFlagList<Std::String> execPath(argParser, "EXEC", "Path to the executable program to verify and load the config (once per target config file)", { 'e', "exec" });
+    args::ValueFlag<uint32_t> execTimeoutMs(argParser, "EXEC_TIMEOUT", "Time limit (in milliseconds) of each run of the executable program", { 'x', "exec-timeout" }, std::chrono::duration_cast<std::chrono::milliseconds>(Config::Executing::BirdConfigExecutor::DEFAULT_EXEC_TIMEOUT).count());
     args::ValueFlag<Std::String> schemaRootFilename(argParser, "SCHEMA", "The schema file", { 's', "schema" });
     args::ValueFlag<uint16_t> thisHostPort(argParser, "PORT", "The host binding port", { 'p', "port" });
-    args::ValueFlag<Std::String> targetConfigFilename(argParser, "TARGET", "The target config file", { 't', "target" });
+    args::ValueFlagList<Std::String> targetConfigFilename(argParser, "TARGET", "The target config file (once per instance of the executable program)", { 't', "target" });
+    args::ValueFlag<Std::String> snapshotFilename(argParser, "SNAPSHOT", "The schema snapshot file to speed up the startup", { 'n', "snapshot" });
+    args::Flag watchSchema(argParser, "WATCH", "Reload the schema whenever its files change", { 'r', "watch-schema" });
+    args::Flag useWriteAheadLog(argParser, "WAL", "Persist changes of the running config through the write-ahead log", { 'w', "wal" });
+    args::Flag aggregatePrefixes(argParser, "AGGREGATE", "Aggregate prefix sets of the target config into fewer ranges", { 'g', "aggregate-prefixes" });
+    args::ValueFlag<Std::String> simulationRequestFilename(argParser, "SIMULATE", "Evaluate the policy of the config against the routes of the request file, print the report and exit", { 'l', "simulate-policy" });
+    args::ValueFlag<Std::String> traceFilename(argParser, "TRACE", "Record timed spans of the requests and dump them into the given file on request to /admin/trace/dump", { 'f', "trace-file" });
+    args::ValueFlag<Std::String> asyncLogPolicy(argParser, "ASYNC_LOG", "Write the logs out by the background thread, with the given policy on the full queue (block, drop-oldest or drop-newest)", { 'q', "async-log" });
+    args::ValueFlag<size_t> logRingSize(argParser, "LOG_RING_SIZE", "The number of the latest log messages kept for GET /logs/latest/{n}", { 'k', "log-ring-size" }, 4096);
+    args::ValueFlag<size_t> maxErrorsCount(argParser, "MAX_ERRORS", "Stop validation of the config after the given number of errors (1 - fail fast, 0 - report all)", { 'm', "max-errors" }, 0);
     try {
         argParser.ParseCLI(argc, argv);
     }
@@ -424,7 +670,7 @@ int main(const int argc, const char* argv[]) {
         ::exit(EXIT_FAILURE);
     }
 
-    if (!configFilename || !schemaRootFilename || !thisHostAddress || !thisHostPort) {
+    if (!configFilename || (!simulationRequestFilename && (!schemaRootFilename || !thisHostAddress || !thisHostPort))) {
         std::cout << argParser;
         ::exit(EXIT_SUCCESS);
     }
@@ -437,7 +683,37 @@ int main(const int argc, const char* argv[]) {
     fileLogSink->set_level(spdlog::level::err);
     fileLogSink->set_pattern("%+");
 
-    auto loggerRegistry = std::make_shared<Log::LoggerRegistry>(spdlog::sinks_init_list{consoleLogSink, fileLogSink});
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    Std::SharedPtr<Log::LoggerRegistry> loggerRegistry;
+    if (asyncLogPolicy) {
+        static const Std::Map<Std::String, Log::AsyncLogSink::OverflowPolicy> ASYNC_LOG_POLICIES = {
+            { "block", Log::AsyncLogSink::OverflowPolicy::BLOCK },
+            { "drop-oldest", Log::AsyncLogSink::OverflowPolicy::DROP_OLDEST },
+            { "drop-newest", Log::AsyncLogSink::OverflowPolicy::DROP_NEWEST }
+        };
+
+        auto policyIt = ASYNC_LOG_POLICIES.find(args::get(asyncLogPolicy));
+        if (policyIt == ASYNC_LOG_POLICIES.end()) {
+            spdlog::error("Unsupported policy of the async logging '{}'", args::get(asyncLogPolicy));
+            ::exit(EXIT_FAILURE);
+        }
+
+        Log::AsyncLogSink::Options asyncLogOptions;
+        asyncLogOptions.Policy = policyIt->second;
+        asyncLogOptions.BlockedCounter = std::make_shared<Metrics::Counter>();
+        asyncLogOptions.DroppedCounter = std::make_shared<Metrics::Counter>();
+        moduleRegistry->Metrics()->AddCounter("bgp_config_api_log_messages_blocked_total", "Number of the log messages which have waited for the room in the queue of the async logging", asyncLogOptions.BlockedCounter);
+        moduleRegistry->Metrics()->AddCounter("bgp_config_api_log_messages_dropped_total", "Number of the log messages dropped by the full queue of the async logging", asyncLogOptions.DroppedCounter);
+        loggerRegistry = std::make_shared<Log::LoggerRegistry>(spdlog::sinks_init_list{consoleLogSink, fileLogSink}, asyncLogOptions);
+
+        // The queued messages are written out also when the daemon exits by ::exit()
+        static auto sAsyncLoggerRegistry = loggerRegistry;
+        std::atexit([]() { sAsyncLoggerRegistry->Flush(); });
+    }
+    else {
+        loggerRegistry = std::make_shared<Log::LoggerRegistry>(spdlog::sinks_init_list{consoleLogSink, fileLogSink});
+    }
+
     loggerRegistry->RegisterModule(Module::Name::CONFIG_EXEC);
     loggerRegistry->Logger(Module::Name::CONFIG_EXEC)->set_level(spdlog::level::err);
     loggerRegistry->RegisterModule(Module::Name::CONFIG_MNGMT);
@@ -448,32 +724,63 @@ int main(const int argc, const char* argv[]) {
     loggerRegistry->Logger(Module::Name::CONN_MNGMT)->set_level(spdlog::level::err);
     loggerRegistry->RegisterModule(Module::Name::DATA_STORAGE);
     loggerRegistry->Logger(Module::Name::DATA_STORAGE)->set_level(spdlog::level::err);
+    loggerRegistry->RegisterModule(Module::Name::POLICY_SIM);
+    loggerRegistry->Logger(Module::Name::POLICY_SIM)->set_level(spdlog::level::err);
     loggerRegistry->RegisterModule(Module::Name::SCHEMA_MNGMT);
     loggerRegistry->Logger(Module::Name::SCHEMA_MNGMT)->set_level(spdlog::level::err);
     loggerRegistry->RegisterModule(Module::Name::SESSION_MNGMT);
     loggerRegistry->Logger(Module::Name::SESSION_MNGMT)->set_level(spdlog::level::err);
 
-    auto moduleRegistry = std::make_shared<ModuleRegistry>();
     moduleRegistry->SetLoggerRegistry(loggerRegistry);
+    moduleRegistry->Tracer()->SetEnabled(static_cast<bool>(traceFilename));
 
     auto jConfigFilename = args::get(configFilename);
     auto jSchemaFilename = args::get(schemaRootFilename);
 
-    Std::SharedPtr<Storage::IDataStorage> jsonSchemaFileStorage = std::make_shared<Storage::JsonFileStorage>(jSchemaFilename, moduleRegistry);
-    auto jDataSchema = jsonSchemaFileStorage->LoadData();
-    if (!jDataSchema.has_value()) {
+    // Workers split CPU-bound work, like validation of big collections of independent entries (e.g. BGP sessions)
+    // or evaluation of a policy against many routes
+    auto workerPool = std::make_shared<Utils::WorkerPool>();
+    auto policySimulator = std::make_shared<Policy::PolicySimulator>(moduleRegistry, workerPool);
+    if (simulationRequestFilename) {
+        ::exit(fRunPolicySimulation(*policySimulator, jConfigFilename, args::get(simulationRequestFilename), moduleRegistry) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    // The schema files are loaded (and merged) only once, by the schema manager
+    auto jsonSchemaFileStorage = std::make_shared<Storage::JsonFileStorage>(jSchemaFilename, moduleRegistry);
+    auto jsonSchemaMngr = std::make_shared<Schema::JsonSchemaManager>(jsonSchemaFileStorage, moduleRegistry, workerPool);
+    jsonSchemaMngr->SetMaxErrorsCount(args::get(maxErrorsCount));
+    // The snapshot lets the startup skip the work which has been done for the same schema and config before
+    Std::UniquePtr<Schema::JsonSchemaSnapshot> schemaSnapshot;
+    Std::Optional<uint64_t> schemaHash;
+    bool isSnapshotUpToDate = false;
+    if (snapshotFilename) {
+        schemaSnapshot = std::make_unique<Schema::JsonSchemaSnapshot>(std::make_shared<Storage::FileStorage>(args::get(snapshotFilename), moduleRegistry), moduleRegistry);
+        schemaHash = jsonSchemaFileStorage->ContentHash();
+        if (schemaHash.has_value() && schemaSnapshot->Load()) {
+            auto jSchema = schemaSnapshot->TakeSchema(schemaHash.value());
+            isSnapshotUpToDate = jSchema.has_value() && jsonSchemaMngr->LoadSchema(std::move(jSchema.value()));
+        }
+    }
+
+    if (isSnapshotUpToDate) {
+        spdlog::info("Loaded JSON schema from snapshot '{}'", args::get(snapshotFilename));
+    }
+    else if (!jsonSchemaMngr->LoadSchema()) {
         spdlog::error("Failed to load JSON schema from file '{}'", jsonSchemaFileStorage->URI());
         ::exit(EXIT_FAILURE);
     }
+    else {
+        spdlog::info("Loaded JSON schema from file '{}'", jsonSchemaFileStorage->URI());
+    }
 
-    spdlog::info("Loaded JSON schema from file '{}'", jsonSchemaFileStorage->URI());
-    Std::SharedPtr<Schema::ISchemaManagement> jsonSchemaMngr = std::make_shared<Schema::JsonSchemaManager>(jsonSchemaFileStorage, moduleRegistry);
-    if (!jsonSchemaMngr->LoadSchema()) {
-        spdlog::error("Failed to load JSON schema");
-        ::exit(EXIT_FAILURE);
+    Std::SharedPtr<Storage::IDataStorage> configFileStorage;
+    if (useWriteAheadLog) {
+        configFileStorage = std::make_shared<Storage::JsonWalStorage>(jConfigFilename, moduleRegistry);
+    }
+    else {
+        configFileStorage = std::make_shared<Storage::FileStorage>(jConfigFilename, moduleRegistry);
     }
 
-    Std::SharedPtr<Storage::IDataStorage> configFileStorage = std::make_shared<Storage::FileStorage>(jConfigFilename, moduleRegistry);
     Std::UniquePtr<Config::IConfigManagement> jsonConfigMngr = std::make_unique<Config::JsonConfigManager>(configFileStorage, moduleRegistry);
     if (!jsonConfigMngr->LoadConfig()) {
         spdlog::error("Failed to load startup JSON config from file '{}'", configFileStorage->URI());
@@ -486,38 +793,114 @@ int main(const int argc, const char* argv[]) {
         ::exit(EXIT_FAILURE);
     }
 
-    if (!jsonSchemaMngr->ValidateData(startupConfigDataToValid.value())) {
+    auto startupConfigHash = Utils::fFnv1a64(startupConfigDataToValid.value().data(), startupConfigDataToValid.value().size());
+    isSnapshotUpToDate = isSnapshotUpToDate && schemaSnapshot->IsConfigValidated(schemaHash.value(), startupConfigHash);
+    if (isSnapshotUpToDate) {
+        spdlog::info("Startup JSON config has been already validated against the schema");
+    }
+    else if (!jsonSchemaMngr->ValidateData(startupConfigDataToValid.value())) {
         spdlog::error("Failed to validate startup JSON config against the schema");
         ::exit(EXIT_FAILURE);
     }
 
-    Std::SharedPtr<Config::IConfigConverting> birdConfigConverter = std::make_shared<Config::BirdConfigConverter>(moduleRegistry);
+    auto birdConfigConverter = std::make_shared<Config::BirdConfigConverter>(moduleRegistry);
+    birdConfigConverter->SetPrefixAggregation(aggregatePrefixes);
 
     Std::SharedPtr<Storage::IDataStorage> birdConfigFileStorage;
     Std::SharedPtr<Config::Executing::IConfigExecuting> birdConfigExecutor;
+    Std::Optional<uint64_t> birdConfigHash;
     if (execPath && targetConfigFilename) {
-        birdConfigFileStorage = std::make_shared<Storage::FileStorage>(args::get(targetConfigFilename), moduleRegistry);
-        birdConfigExecutor = std::make_shared<Config::Executing::BirdConfigExecutor>(birdConfigFileStorage, args::get(execPath), moduleRegistry);
-        
-        auto birdConfigData = birdConfigConverter->Convert(startupConfigDataToValid.value());
-        if (!birdConfigData.has_value()) {
-            spdlog::error("Failed to convert native config into BIRD config");
+        const auto& execPaths = args::get(execPath);
+        const auto& targetConfigFilenames = args::get(targetConfigFilename);
+        if (execPaths.size() != targetConfigFilenames.size()) {
+            spdlog::error("Each target config file needs its own executable program ({} vs {})", targetConfigFilenames.size(), execPaths.size());
             ::exit(EXIT_FAILURE);
         }
 
-        if (!birdConfigFileStorage->SaveData(birdConfigData.value())) {
-            spdlog::error("Failed to save BIRD config into file {}", birdConfigFileStorage->URI());
-            ::exit(EXIT_FAILURE);
+        // Each instance (e.g. the BIRD daemon per VRF) has its own target config file and its own control program
+        Std::Vector<Std::SharedPtr<Storage::IDataStorage>> birdConfigFileStorages;
+        Std::Vector<Std::SharedPtr<Config::Executing::IConfigExecuting>> birdConfigExecutors;
+        // The same target config converted with other options or validated by other program has to be validated again
+        const auto converterOptions = birdConfigConverter->Options();
+        uint64_t targetHashSeed = Utils::fFnv1a64(converterOptions.data(), converterOptions.size());
+        for (size_t instanceIdx = 0; instanceIdx < execPaths.size(); ++instanceIdx) {
+            birdConfigFileStorages.push_back(std::make_shared<Storage::FileStorage>(targetConfigFilenames[instanceIdx], moduleRegistry));
+            birdConfigExecutors.push_back(std::make_shared<Config::Executing::BirdConfigExecutor>(birdConfigFileStorages.back(), execPaths[instanceIdx], moduleRegistry, std::chrono::milliseconds(args::get(execTimeoutMs))));
+            targetHashSeed = Utils::fFnv1a64(execPaths[instanceIdx].data(), execPaths[instanceIdx].size(), targetHashSeed);
+        }
+
+        if (birdConfigExecutors.size() == 1) {
+            birdConfigFileStorage = birdConfigFileStorages.front();
+            birdConfigExecutor = birdConfigExecutors.front();
+        }
+        else {
+            birdConfigFileStorage = std::make_shared<Storage::FanOutStorage>(birdConfigFileStorages, moduleRegistry);
+            birdConfigExecutor = std::make_shared<Config::Executing::FanOutConfigExecutor>(birdConfigFileStorage, birdConfigExecutors, moduleRegistry);
+        }
+
+        if (isSnapshotUpToDate) {
+            birdConfigHash = Schema::JsonSchemaSnapshot::FilesHash(targetConfigFilenames, targetHashSeed);
+            isSnapshotUpToDate = birdConfigHash.has_value() && schemaSnapshot->IsTargetValidated(schemaHash.value(), startupConfigHash, birdConfigHash.value());
+        }
+
+        if (isSnapshotUpToDate) {
+            spdlog::info("BIRD config in {} target file(s) has been already validated", targetConfigFilenames.size());
         }
+        else {
+            auto birdConfigData = birdConfigConverter->Convert(startupConfigDataToValid.value());
+            if (!birdConfigData.has_value()) {
+                spdlog::error("Failed to convert native config into BIRD config");
+                ::exit(EXIT_FAILURE);
+            }
+
+            if (!birdConfigFileStorage->SaveData(birdConfigData.value())) {
+                spdlog::error("Failed to save BIRD config into file {}", birdConfigFileStorage->URI());
+                ::exit(EXIT_FAILURE);
+            }
+
+            if (!birdConfigExecutor->Validate()) {
+                spdlog::error("Failed to validate coverted config by external program");
+                ::exit(EXIT_FAILURE);
+            }
+
+            // Each instance has been given the same config, so it is enough to hash it once per target file
+            birdConfigHash = targetHashSeed;
+            for (size_t instanceIdx = 0; instanceIdx < targetConfigFilenames.size(); ++instanceIdx) {
+                birdConfigHash = Utils::fFnv1a64(birdConfigData.value().data(), birdConfigData.value().size(), birdConfigHash.value());
+            }
+        }
+    }
+
+    if (schemaSnapshot && schemaHash.has_value() && !isSnapshotUpToDate) {
+        // Failing to save the snapshot costs only the full startup next time
+        if (!schemaSnapshot->Save(jsonSchemaMngr->Schema(), schemaHash.value(), startupConfigHash, birdConfigHash)) {
+            spdlog::warn("Failed to save schema snapshot into file '{}'", args::get(snapshotFilename));
+        }
+    }
+
+    // The schema can be reloaded at runtime (on request or on change of its files). The new schema is used only
+    // if it still accepts the running config
+    auto reloadableSchemaMngr = std::make_shared<Schema::ReloadableSchemaManager>(jsonSchemaMngr, [jsonSchemaFileStorage, moduleRegistry, workerPool, maxErrorsCount = args::get(maxErrorsCount)]() {
+        auto newSchemaMngr = std::make_shared<Schema::JsonSchemaManager>(jsonSchemaFileStorage, moduleRegistry, workerPool);
+        newSchemaMngr->SetMaxErrorsCount(maxErrorsCount);
+        return newSchemaMngr;
+    }, moduleRegistry);
+    reloadableSchemaMngr->SetSchemaAcceptor([&jsonConfigMngr](Schema::ISchemaManagement& newSchemaMngr) {
+        // Called from the file watcher thread too, so the snapshot is taken under the lock of the config manager
+        auto runningConfigData = jsonConfigMngr->SerializeConfig();
+        return runningConfigData.has_value() && newSchemaMngr.ValidateData(runningConfigData.value());
+    });
 
-        if (!birdConfigExecutor->Validate()) {
-            spdlog::error("Failed to validate coverted config by external program");
+    if (watchSchema) {
+        auto schemaDirName = std::filesystem::path(jSchemaFilename).parent_path();
+        if (!reloadableSchemaMngr->StartWatching(schemaDirName.empty() ? "." : schemaDirName.string())) {
+            spdlog::error("Failed to watch schema files of '{}'", jSchemaFilename);
             ::exit(EXIT_FAILURE);
         }
     }
 
     auto cm = std::make_shared<ConnectionManagement::Server>(moduleRegistry);
-    if (!fSetupServerRequestHandlers(cm, jsonConfigMngr, jsonSchemaMngr, configFileStorage, birdConfigFileStorage, birdConfigConverter, birdConfigExecutor, moduleRegistry)) {
+    if (!fSetupServerRequestHandlers(cm, jsonConfigMngr, reloadableSchemaMngr, configFileStorage, birdConfigFileStorage, birdConfigConverter, birdConfigExecutor, policySimulator, moduleRegistry, args::get(traceFilename), args::get(logRingSize))) {
         spdlog::error("Failed to setup request handlers");
         ::exit(EXIT_FAILURE);
     }
@@ -3,18 +3,34 @@
  */
 #pragma once
 
-#include "Lib/StdLib.hpp"
+#include "Lib/Logging.hpp"
 
 namespace Module {
+// Index of the logger of the module in the LoggerRegistry
+enum class Idx : uint8_t {
+    CONFIG_EXEC,
+    CONFIG_MNGMT,
+    CONFIG_TRANSL,
+    CONN_MNGMT,
+    DATA_STORAGE,
+    POLICY_SIM,
+    SCHEMA_MNGMT,
+    SESSION_MNGMT,
+    SRV_USR_REQ_HANDLE,
+    COUNT
+};
+
+static_assert(static_cast<size_t>(Idx::COUNT) <= Log::ModuleId::MAX_COUNT);
+
 namespace Name {
-    using namespace StdLib;
-    const String CONFIG_EXEC = "ConfigExec";
-    const String CONFIG_MNGMT = "ConfigMngmt";
-    const String CONFIG_TRANSL = "ConfigTransl";
-    const String CONN_MNGMT = "ConnMngmt";
-    const String DATA_STORAGE = "DataStorage";
-    const String SCHEMA_MNGMT = "SchemaMngmt";
-    const String SESSION_MNGMT = "SessionMngmt";
-    const String SRV_USR_REQ_HANDLE = "SrvUsrReqHandle";
+    inline constexpr Log::ModuleId CONFIG_EXEC { Idx::CONFIG_EXEC, "ConfigExec" };
+    inline constexpr Log::ModuleId CONFIG_MNGMT { Idx::CONFIG_MNGMT, "ConfigMngmt" };
+    inline constexpr Log::ModuleId CONFIG_TRANSL { Idx::CONFIG_TRANSL, "ConfigTransl" };
+    inline constexpr Log::ModuleId CONN_MNGMT { Idx::CONN_MNGMT, "ConnMngmt" };
+    inline constexpr Log::ModuleId DATA_STORAGE { Idx::DATA_STORAGE, "DataStorage" };
+    inline constexpr Log::ModuleId POLICY_SIM { Idx::POLICY_SIM, "PolicySim" };
+    inline constexpr Log::ModuleId SCHEMA_MNGMT { Idx::SCHEMA_MNGMT, "SchemaMngmt" };
+    inline constexpr Log::ModuleId SESSION_MNGMT { Idx::SESSION_MNGMT, "SessionMngmt" };
+    inline constexpr Log::ModuleId SRV_USR_REQ_HANDLE { Idx::SRV_USR_REQ_HANDLE, "SrvUsrReqHandle" };
 } // namespace Name
 } // namespace Module
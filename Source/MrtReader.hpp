@@ -0,0 +1,563 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/Logging.hpp"
+#include "Lib/MappedFile.hpp"
+#include "Lib/WorkerPool.hpp"
+#include "RouteBatch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Policy {
+using namespace StdLib;
+
+/*
+    Reads the routes of the MRT dump (RFC 6396), i.e. the RIB snapshots (TABLE_DUMP_V2) and the announcements of
+    the BGP UPDATE messages (BGP4MP), like the dumps of RouteViews or RIPE RIS. The file is memory-mapped, split
+    into chunks at the boundaries of the records, and the chunks are decoded in parallel into their own batches,
+    which are concatenated in the order of the file. Withdrawals, multicast routes, RIB_GENERIC and the legacy
+    TABLE_DUMP records are skipped.
+*/
+class MrtReader {
+public:
+    MrtReader(const SharedPtr<Log::SpdLogger>& log, const SharedPtr<Utils::WorkerPool>& workerPool) : mLog(log), mWorkerPool(workerPool) {}
+
+    // Read() reads the routes of the given peers (indexes of the PEER_INDEX_TABLE), or of all the peers if none is given
+    Optional<RouteBatch> Read(const String& fileName, const Vector<uint16_t>& peerIdxs = {}) {
+        Utils::MappedFile file;
+        if (!file.Open(fileName)) {
+            mLog->error("Failed to open MRT file '{}'. Error: {}", fileName, file.Error());
+            return {};
+        }
+
+        uint16_t peersCount = 0;
+        auto chunks = SplitIntoChunks(file.Data(), file.Size(), peersCount);
+        if (!chunks.has_value()) {
+            mLog->error("Failed to split MRT file '{}' into records", fileName);
+            return {};
+        }
+
+        // Empty selection stands for all the peers
+        Vector<bool> isPeerSelected;
+        if (!peerIdxs.empty()) {
+            isPeerSelected.resize(peersCount, false);
+            for (const auto peerIdx : peerIdxs) {
+                if (peerIdx >= peersCount) {
+                    mLog->error("Peer index '{}' is out of the PEER_INDEX_TABLE of {} peers of MRT file '{}'", peerIdx, peersCount, fileName);
+                    return {};
+                }
+
+                isPeerSelected[peerIdx] = true;
+            }
+        }
+
+        Vector<RouteBatch> chunkRoutes(chunks.value().size());
+        // Offset of the first malformed record of the chunk, as the workers do not log
+        Vector<Optional<size_t>> chunkErrorOffsets(chunks.value().size());
+        auto readChunk = [data = file.Data(), &chunks, &isPeerSelected, &chunkRoutes, &chunkErrorOffsets](const size_t chunkIdx) {
+            ChunkDecoder decoder(isPeerSelected, chunkRoutes[chunkIdx]);
+            const auto& chunk = chunks.value()[chunkIdx];
+            for (auto offset = chunk.Begin; offset < chunk.End;) {
+                auto recordSize = HEADER_SIZE + ReadU32(data + offset + 8);
+                if (!decoder.DecodeRecord(ByteCursor(data + offset, data + offset + recordSize))) {
+                    chunkErrorOffsets[chunkIdx] = offset;
+                    return;
+                }
+
+                offset += recordSize;
+            }
+        };
+
+        if (mWorkerPool) {
+            mWorkerPool->RunParallel(chunks.value().size(), readChunk);
+        }
+        else {
+            for (size_t chunkIdx = 0; chunkIdx < chunks.value().size(); ++chunkIdx) {
+                readChunk(chunkIdx);
+            }
+        }
+
+        for (size_t chunkIdx = 0; chunkIdx < chunks.value().size(); ++chunkIdx) {
+            if (chunkErrorOffsets[chunkIdx].has_value()) {
+                mLog->error("Malformed MRT record at offset {} of file '{}'", chunkErrorOffsets[chunkIdx].value(), fileName);
+                return {};
+            }
+        }
+
+        auto routes = RouteBatch::Join(chunkRoutes);
+        mLog->info("Read {} routes from {} bytes of MRT file '{}'", routes.Size(), file.Size(), fileName);
+        return routes;
+    }
+
+private:
+    static constexpr size_t HEADER_SIZE = 12;
+    // Bytes of the records decoded by single task, big enough to make the scheduling cost negligible
+    static constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+    // Types and subtypes of the MRT records (RFC 6396, RFC 8050)
+    enum RecordType : uint16_t {
+        TABLE_DUMP_V2 = 13,
+        BGP4MP = 16,
+        BGP4MP_ET = 17
+    };
+
+    enum TableDumpV2Subtype : uint16_t {
+        PEER_INDEX_TABLE = 1,
+        RIB_IPV4_UNICAST = 2,
+        RIB_IPV6_UNICAST = 4,
+        RIB_IPV4_UNICAST_ADDPATH = 8,
+        RIB_IPV6_UNICAST_ADDPATH = 10
+    };
+
+    enum Bgp4mpSubtype : uint16_t {
+        BGP4MP_MESSAGE = 1,
+        BGP4MP_MESSAGE_AS4 = 4,
+        BGP4MP_MESSAGE_LOCAL = 6,
+        BGP4MP_MESSAGE_AS4_LOCAL = 7,
+        BGP4MP_MESSAGE_ADDPATH = 8,
+        BGP4MP_MESSAGE_AS4_ADDPATH = 9,
+        BGP4MP_MESSAGE_LOCAL_ADDPATH = 10,
+        BGP4MP_MESSAGE_AS4_LOCAL_ADDPATH = 11
+    };
+
+    // Types of the BGP path attributes (RFC 4271, RFC 1997, RFC 4360, RFC 4760, RFC 6793, RFC 8092)
+    enum AttributeType : uint8_t {
+        AS_PATH = 2,
+        MULTI_EXIT_DISC = 4,
+        LOCAL_PREF = 5,
+        COMMUNITIES = 8,
+        MP_REACH_NLRI = 14,
+        EXTENDED_COMMUNITIES = 16,
+        AS4_PATH = 17,
+        LARGE_COMMUNITY = 32
+    };
+
+    static constexpr uint8_t ATTR_FLAG_EXTENDED_LENGTH = 0x10;
+    static constexpr uint8_t AS_SET = 1;
+    static constexpr uint8_t AS_SEQUENCE = 2;
+    static constexpr uint16_t AFI_IPV4 = 1;
+    static constexpr uint16_t AFI_IPV6 = 2;
+    static constexpr uint8_t SAFI_UNICAST = 1;
+    static constexpr uint8_t BGP_MARKER_SIZE = 16;
+    static constexpr uint8_t BGP_UPDATE = 2;
+
+    struct Chunk {
+        size_t Begin = 0;
+        size_t End = 0;
+    };
+
+    SharedPtr<Log::SpdLogger> mLog;
+    SharedPtr<Utils::WorkerPool> mWorkerPool;
+
+    static uint16_t ReadU16(const uint8_t* data) { return static_cast<uint16_t>((data[0] << 8) | data[1]); }
+    static uint32_t ReadU32(const uint8_t* data) {
+        return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+    }
+
+    // Cursor over the big-endian fields of the record. The read beyond the end invalidates the cursor and returns zeros
+    class ByteCursor {
+    public:
+        ByteCursor() = default;
+        ByteCursor(const uint8_t* begin, const uint8_t* end) : mPos(begin), mEnd(end) {}
+
+        bool IsValid() const { return mIsValid; }
+        bool IsEmpty() const { return mPos == mEnd; }
+        size_t Remaining() const { return static_cast<size_t>(mEnd - mPos); }
+
+        uint8_t U8() { return Has(1) ? *mPos++ : 0; }
+        uint16_t U16() { return Has(2) ? (mPos += 2, ReadU16(mPos - 2)) : 0; }
+        uint32_t U32() { return Has(4) ? (mPos += 4, ReadU32(mPos - 4)) : 0; }
+        void Skip(const size_t size) { mPos += Has(size) ? size : 0; }
+
+        // Take() returns the cursor over the next bytes and moves behind them
+        ByteCursor Take(const size_t size) {
+            if (!Has(size)) {
+                return ByteCursor(nullptr, nullptr).Invalidated();
+            }
+
+            mPos += size;
+            return ByteCursor(mPos - size, mPos);
+        }
+
+    private:
+        const uint8_t* mPos = nullptr;
+        const uint8_t* mEnd = nullptr;
+        bool mIsValid = true;
+
+        bool Has(const size_t size) {
+            if (size <= Remaining()) {
+                return true;
+            }
+
+            mIsValid = false;
+            mPos = mEnd;
+            return false;
+        }
+
+        ByteCursor Invalidated() {
+            mIsValid = false;
+            return *this;
+        }
+    }; // class ByteCursor
+
+    // Attributes of the single path, decoded once for all the prefixes announced with them
+    struct PathAttributes {
+        Vector<uint32_t> AsPath;
+        Vector<uint32_t> As4Path;
+        Vector<Community> Communities;
+        Vector<ExtCommunity> ExtCommunities;
+        Vector<LargeCommunity> LargeCommunities;
+        Optional<uint32_t> LocalPreference;
+        Optional<uint32_t> Med;
+        ByteCursor MpReachNlri;
+        bool HasMpReachNlri = false;
+
+        void Clear() {
+            AsPath.clear();
+            As4Path.clear();
+            Communities.clear();
+            ExtCommunities.clear();
+            LargeCommunities.clear();
+            LocalPreference.reset();
+            Med.reset();
+            HasMpReachNlri = false;
+        }
+    }; // struct PathAttributes
+
+    // Decodes the records of single chunk. It is used by single thread only
+    class ChunkDecoder {
+    public:
+        ChunkDecoder(const Vector<bool>& isPeerSelected, RouteBatch& routes) : mIsPeerSelected(isPeerSelected), mRoutes(routes) {}
+
+        bool DecodeRecord(ByteCursor record) {
+            record.Skip(4); // Timestamp
+            auto type = record.U16();
+            auto subtype = record.U16();
+            record.Skip(4); // Length, already checked by the split into chunks
+            switch (type) {
+            case TABLE_DUMP_V2:
+                return DecodeTableDumpV2(subtype, record);
+            case BGP4MP_ET:
+                record.Skip(4); // Microseconds of the timestamp
+                [[fallthrough]];
+            case BGP4MP:
+                return DecodeBgp4mp(subtype, record);
+            default:
+                return true;
+            }
+        }
+
+    private:
+        const Vector<bool>& mIsPeerSelected;
+        RouteBatch& mRoutes;
+        PathAttributes mPathAttrs;
+
+        bool DecodeTableDumpV2(const uint16_t subtype, ByteCursor& record) {
+            bool isAddPath = (subtype == RIB_IPV4_UNICAST_ADDPATH) || (subtype == RIB_IPV6_UNICAST_ADDPATH);
+            Utils::IpAddress::Family family;
+            if ((subtype == RIB_IPV4_UNICAST) || (subtype == RIB_IPV4_UNICAST_ADDPATH)) {
+                family = Utils::IpAddress::Family::IPV4;
+            }
+            else if ((subtype == RIB_IPV6_UNICAST) || (subtype == RIB_IPV6_UNICAST_ADDPATH)) {
+                family = Utils::IpAddress::Family::IPV6;
+            }
+            else {
+                return true;
+            }
+
+            record.Skip(4); // Sequence number
+            auto prefix = DecodePrefix(record, family, false);
+            auto entriesCount = record.U16();
+            for (uint16_t entryIdx = 0; (entryIdx < entriesCount) && prefix.has_value(); ++entryIdx) {
+                auto peerIdx = record.U16();
+                record.Skip(isAddPath ? 8 : 4); // Originated time and path identifier
+                auto attrs = record.Take(record.U16());
+                if (!mIsPeerSelected.empty() && ((peerIdx >= mIsPeerSelected.size()) || !mIsPeerSelected[peerIdx])) {
+                    continue;
+                }
+
+                // TABLE_DUMP_V2 keeps 4-byte ASNs in AS_PATH, and the prefix only in the header of the record
+                if (!DecodeAttributes(attrs, true)) {
+                    return false;
+                }
+
+                AddRoute(prefix.value());
+            }
+
+            return prefix.has_value() && record.IsValid();
+        }
+
+        bool DecodeBgp4mp(const uint16_t subtype, ByteCursor& record) {
+            bool isAs4 = false;
+            bool isAddPath = false;
+            switch (subtype) {
+            case BGP4MP_MESSAGE:
+            case BGP4MP_MESSAGE_LOCAL:
+                break;
+            case BGP4MP_MESSAGE_AS4:
+            case BGP4MP_MESSAGE_AS4_LOCAL:
+                isAs4 = true;
+                break;
+            case BGP4MP_MESSAGE_ADDPATH:
+            case BGP4MP_MESSAGE_LOCAL_ADDPATH:
+                isAddPath = true;
+                break;
+            case BGP4MP_MESSAGE_AS4_ADDPATH:
+            case BGP4MP_MESSAGE_AS4_LOCAL_ADDPATH:
+                isAs4 = true;
+                isAddPath = true;
+                break;
+            default:
+                // State changes
+                return true;
+            }
+
+            record.Skip(isAs4 ? 8 : 4); // Peer and local ASN
+            record.Skip(2); // Interface index
+            auto afi = record.U16();
+            record.Skip((afi == AFI_IPV6) ? 32 : 8); // Peer and local address
+            record.Skip(BGP_MARKER_SIZE);
+            record.Skip(2); // Length of the message
+            if (record.U8() != BGP_UPDATE) {
+                return record.IsValid();
+            }
+
+            auto withdrawnRoutesSize = record.U16();
+            record.Skip(withdrawnRoutesSize);
+            auto attrs = record.Take(record.U16());
+            if (!record.IsValid() || !DecodeAttributes(attrs, isAs4)) {
+                return false;
+            }
+
+            // NLRI of IPv4 unicast is the rest of the message
+            while (!record.IsEmpty()) {
+                auto prefix = DecodePrefix(record, Utils::IpAddress::Family::IPV4, isAddPath);
+                if (!prefix.has_value()) {
+                    return false;
+                }
+
+                AddRoute(prefix.value());
+            }
+
+            if (!mPathAttrs.HasMpReachNlri) {
+                return true;
+            }
+
+            auto& mpReach = mPathAttrs.MpReachNlri;
+            auto mpAfi = mpReach.U16();
+            auto mpSafi = mpReach.U8();
+            mpReach.Skip(mpReach.U8()); // Next hop
+            mpReach.Skip(1); // Reserved
+            if (!mpReach.IsValid()) {
+                return false;
+            }
+
+            if (((mpAfi != AFI_IPV4) && (mpAfi != AFI_IPV6)) || (mpSafi != SAFI_UNICAST)) {
+                return true;
+            }
+
+            auto family = (mpAfi == AFI_IPV6) ? Utils::IpAddress::Family::IPV6 : Utils::IpAddress::Family::IPV4;
+            while (!mpReach.IsEmpty()) {
+                auto prefix = DecodePrefix(mpReach, family, isAddPath);
+                if (!prefix.has_value()) {
+                    return false;
+                }
+
+                AddRoute(prefix.value());
+            }
+
+            return true;
+        }
+
+        bool DecodeAttributes(ByteCursor attrs, const bool isAs4) {
+            mPathAttrs.Clear();
+            while (!attrs.IsEmpty()) {
+                auto flags = attrs.U8();
+                auto type = attrs.U8();
+                auto size = (flags & ATTR_FLAG_EXTENDED_LENGTH) ? attrs.U16() : attrs.U8();
+                auto value = attrs.Take(size);
+                switch (type) {
+                case AS_PATH:
+                    DecodeAsPath(value, isAs4, mPathAttrs.AsPath);
+                    break;
+                case AS4_PATH:
+                    DecodeAsPath(value, true, mPathAttrs.As4Path);
+                    break;
+                case MULTI_EXIT_DISC:
+                    mPathAttrs.Med = value.U32();
+                    break;
+                case LOCAL_PREF:
+                    mPathAttrs.LocalPreference = value.U32();
+                    break;
+                case COMMUNITIES:
+                    while (value.Remaining() >= 4) {
+                        auto asn = value.U16();
+                        mPathAttrs.Communities.push_back(Community { asn, value.U16() });
+                    }
+                    break;
+                case EXTENDED_COMMUNITIES:
+                    while (value.Remaining() >= 8) {
+                        mPathAttrs.ExtCommunities.push_back(DecodeExtCommunity(value));
+                    }
+                    break;
+                case LARGE_COMMUNITY:
+                    while (value.Remaining() >= 12) {
+                        auto asn = value.U32();
+                        auto local1 = value.U32();
+                        mPathAttrs.LargeCommunities.push_back(LargeCommunity { asn, local1, value.U32() });
+                    }
+                    break;
+                case MP_REACH_NLRI:
+                    mPathAttrs.MpReachNlri = value;
+                    mPathAttrs.HasMpReachNlri = true;
+                    break;
+                default:
+                    break;
+                }
+
+                if (!value.IsValid()) {
+                    return false;
+                }
+            }
+
+            // The speaker without 4-byte ASNs keeps them in AS4_PATH, and AS_TRANS in AS_PATH (RFC 6793)
+            if (!isAs4 && !mPathAttrs.As4Path.empty() && (mPathAttrs.AsPath.size() >= mPathAttrs.As4Path.size())) {
+                mPathAttrs.AsPath.resize(mPathAttrs.AsPath.size() - mPathAttrs.As4Path.size());
+                mPathAttrs.AsPath.insert(mPathAttrs.AsPath.end(), mPathAttrs.As4Path.begin(), mPathAttrs.As4Path.end());
+            }
+
+            return attrs.IsValid();
+        }
+
+        // DecodeAsPath() flattens AS_SEQUENCE and AS_SET segments into the path. The confederation segments are skipped
+        static void DecodeAsPath(ByteCursor& value, const bool isAs4, Vector<uint32_t>& asPath) {
+            while (!value.IsEmpty() && value.IsValid()) {
+                auto segmentType = value.U8();
+                auto asnsCount = value.U8();
+                bool isSkipped = (segmentType != AS_SEQUENCE) && (segmentType != AS_SET);
+                for (uint8_t asnIdx = 0; asnIdx < asnsCount; ++asnIdx) {
+                    auto asn = isAs4 ? value.U32() : value.U16();
+                    if (!isSkipped) {
+                        asPath.push_back(asn);
+                    }
+                }
+            }
+        }
+
+        /*
+            DecodeExtCommunity() maps the community onto 'type:ASN:value' of the JSON config: the type takes the type and
+            the subtype octets, and the global and local administrators the rest. The global administrator of the
+            2-octet AS specific community has 2 octets, of the other ones 4 octets.
+        */
+        static ExtCommunity DecodeExtCommunity(ByteCursor& value) {
+            static constexpr uint8_t TWO_OCTET_AS_SPECIFIC = 0x00;
+            static constexpr uint8_t TYPE_MASK = 0x3F; // Without IANA authority and transitive bits
+            ExtCommunity extCommunity;
+            extCommunity.Type = value.U16();
+            if (((extCommunity.Type >> 8) & TYPE_MASK) == TWO_OCTET_AS_SPECIFIC) {
+                extCommunity.Asn = value.U16();
+                extCommunity.Value = value.U32();
+            }
+            else {
+                extCommunity.Asn = value.U32();
+                extCommunity.Value = value.U16();
+            }
+
+            return extCommunity;
+        }
+
+        static Optional<Utils::IpPrefix> DecodePrefix(ByteCursor& cursor, const Utils::IpAddress::Family family, const bool isAddPath) {
+            if (isAddPath) {
+                cursor.Skip(4); // Path identifier
+            }
+
+            Utils::IpPrefix prefix;
+            prefix.Address.AddrFamily = family;
+            prefix.Length = cursor.U8();
+            auto prefixBytes = cursor.Take((prefix.Length + 7) / 8);
+            if (!prefixBytes.IsValid() || (prefix.Length > prefix.Address.BitsCount())) {
+                return {};
+            }
+
+            for (size_t byteIdx = 0; !prefixBytes.IsEmpty(); ++byteIdx) {
+                prefix.Address.Bytes[byteIdx] = prefixBytes.U8();
+            }
+
+            return prefix;
+        }
+
+        void AddRoute(const Utils::IpPrefix& prefix) {
+            mRoutes.AddRoute(prefix);
+            if (mPathAttrs.LocalPreference.has_value()) {
+                mRoutes.SetLocalPreference(mPathAttrs.LocalPreference.value());
+            }
+
+            if (mPathAttrs.Med.has_value()) {
+                mRoutes.SetMed(mPathAttrs.Med.value());
+            }
+
+            for (const auto asn : mPathAttrs.AsPath) {
+                mRoutes.AppendAsn(asn);
+            }
+
+            for (const auto& community : mPathAttrs.Communities) {
+                mRoutes.AppendCommunity(community);
+            }
+
+            for (const auto& extCommunity : mPathAttrs.ExtCommunities) {
+                mRoutes.AppendExtCommunity(extCommunity);
+            }
+
+            for (const auto& largeCommunity : mPathAttrs.LargeCommunities) {
+                mRoutes.AppendLargeCommunity(largeCommunity);
+            }
+        }
+    }; // class ChunkDecoder
+
+    // SplitIntoChunks() checks the sizes of all the records and reads the number of peers of the PEER_INDEX_TABLE
+    Optional<Vector<Chunk>> SplitIntoChunks(const uint8_t* data, const size_t size, uint16_t& peersCount) {
+        Vector<Chunk> chunks;
+        Chunk chunk;
+        for (size_t offset = 0; offset < size;) {
+            if (size - offset < HEADER_SIZE) {
+                mLog->error("Truncated header of MRT record at offset {}", offset);
+                return {};
+            }
+
+            auto recordSize = HEADER_SIZE + ReadU32(data + offset + 8);
+            if (recordSize > size - offset) {
+                mLog->error("Truncated MRT record at offset {}", offset);
+                return {};
+            }
+
+            if ((ReadU16(data + offset + 4) == TABLE_DUMP_V2) && (ReadU16(data + offset + 6) == PEER_INDEX_TABLE)) {
+                ByteCursor peerIndexTable(data + offset + HEADER_SIZE, data + offset + recordSize);
+                peerIndexTable.Skip(4); // Collector BGP ID
+                peerIndexTable.Skip(peerIndexTable.U16()); // View name
+                peersCount = peerIndexTable.U16();
+                if (!peerIndexTable.IsValid()) {
+                    mLog->error("Malformed PEER_INDEX_TABLE at offset {}", offset);
+                    return {};
+                }
+            }
+
+            offset += recordSize;
+            chunk.End = offset;
+            if (chunk.End - chunk.Begin >= CHUNK_SIZE) {
+                chunks.push_back(chunk);
+                chunk.Begin = chunk.End;
+            }
+        }
+
+        if (chunk.End > chunk.Begin) {
+            chunks.push_back(chunk);
+        }
+
+        return chunks;
+    }
+}; // class MrtReader
+} // namespace Policy
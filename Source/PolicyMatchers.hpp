@@ -0,0 +1,185 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/StdLib.hpp"
+#include "RouteBatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace Policy {
+using namespace StdLib;
+
+/*
+    Matchers of the conditions of the 'if-match' statement, compiled once from the lists of the JSON config and then
+    tested against the attributes of many routes:
+    - AsPathMatcher - 'as-path-eq', i.e. the path is exactly the given sequence of ASNs
+    - AsnSetMatcher - 'as-path-in', i.e. any ASN of the path is in the set
+    - CommunitySetMatcher, ExtCommunitySetMatcher and LargeCommunitySetMatcher - '*-community-in' (ContainsAny(),
+      i.e. any community of the route is in the set) and '*-community-eq' (Equals(), i.e. the communities of the route
+      regardless of their order and duplicates are the set)
+*/
+class AsPathMatcher {
+public:
+    AsPathMatcher() = default;
+    explicit AsPathMatcher(Vector<uint32_t> asPath) : mAsPath(std::move(asPath)) {}
+
+    bool Matches(const std::span<const uint32_t> asPath) const {
+        return (asPath.size() == mAsPath.size()) && std::equal(asPath.begin(), asPath.end(), mAsPath.begin());
+    }
+
+    const Vector<uint32_t>& AsPath() const { return mAsPath; }
+
+private:
+    Vector<uint32_t> mAsPath;
+}; // class AsPathMatcher
+
+// Key of the set member, which fits in 32 bits and keeps the order of the members
+template<typename T>
+struct SetMatcherKey;
+
+template<>
+struct SetMatcherKey<uint32_t> {
+    static uint32_t Of(const uint32_t asn) { return asn; }
+};
+
+template<>
+struct SetMatcherKey<Community> {
+    static uint32_t Of(const Community& community) { return (uint32_t(community.Asn) << 16) | community.Value; }
+};
+
+/*
+    Set of the members with 32-bit keys (ASNs and standard communities). The small set (the usual case of
+    the lists of the config) is kept as the array of keys padded to the whole blocks, which are compared with
+    the key at once by SIMD instructions, without any branch per member. The big set is kept sorted for
+    the binary search, behind the bitmap of 2^16 bits indexed by the folded key. The bitmap rejects most of
+    the keys, which are not in the set, at the cost of single memory access. It is exact for 2-byte ASNs.
+*/
+template<typename T>
+class KeySetMatcher {
+public:
+    KeySetMatcher() = default;
+    explicit KeySetMatcher(const Vector<T>& members) {
+        mKeys.reserve(members.size());
+        for (const auto& member : members) {
+            mKeys.push_back(SetMatcherKey<T>::Of(member));
+        }
+
+        std::ranges::sort(mKeys);
+        mKeys.erase(std::unique(mKeys.begin(), mKeys.end()), mKeys.end());
+        mKeysCount = mKeys.size();
+        if (mKeysCount <= MAX_LINEAR_KEYS_COUNT) {
+            // Padding by the copies of the last key does not change the result of the search
+            auto paddedKeysCount = ((mKeysCount + BLOCK_KEYS_COUNT - 1) / BLOCK_KEYS_COUNT) * BLOCK_KEYS_COUNT;
+            if (mKeysCount > 0) {
+                mKeys.resize(paddedKeysCount, mKeys.back());
+            }
+
+            return;
+        }
+
+        mBitmap.resize(BITMAP_BITS_COUNT / 64, 0);
+        for (const auto key : mKeys) {
+            auto bitIdx = FoldKey(key);
+            mBitmap[bitIdx / 64] |= uint64_t(1) << (bitIdx % 64);
+        }
+    }
+
+    size_t Size() const { return mKeysCount; }
+
+    bool Contains(const T& member) const {
+        auto key = SetMatcherKey<T>::Of(member);
+        if (mBitmap.empty()) {
+            return ContainsLinear(key);
+        }
+
+        auto bitIdx = FoldKey(key);
+        if ((mBitmap[bitIdx / 64] & (uint64_t(1) << (bitIdx % 64))) == 0) {
+            return false;
+        }
+
+        return std::binary_search(mKeys.begin(), mKeys.end(), key);
+    }
+
+    bool ContainsAny(const std::span<const T> members) const {
+        return std::ranges::any_of(members, [this](const T& member) { return Contains(member); });
+    }
+
+    // Equals() needs the buffer for the sorted keys of the members, which is reused between the calls
+    bool Equals(const std::span<const T> members, Vector<uint32_t>& sortedKeys) const {
+        sortedKeys.clear();
+        for (const auto& member : members) {
+            sortedKeys.push_back(SetMatcherKey<T>::Of(member));
+        }
+
+        std::ranges::sort(sortedKeys);
+        sortedKeys.erase(std::unique(sortedKeys.begin(), sortedKeys.end()), sortedKeys.end());
+        return (sortedKeys.size() == mKeysCount) && std::equal(sortedKeys.begin(), sortedKeys.end(), mKeys.begin());
+    }
+
+private:
+    static constexpr size_t BLOCK_KEYS_COUNT = 8;
+    static constexpr size_t MAX_LINEAR_KEYS_COUNT = 16;
+    static constexpr size_t BITMAP_BITS_COUNT = 1 << 16;
+
+    // Sorted keys, padded if there is no bitmap
+    Vector<uint32_t> mKeys;
+    size_t mKeysCount = 0;
+    Vector<uint64_t> mBitmap;
+
+    static uint32_t FoldKey(const uint32_t key) { return (key ^ (key >> 16)) & (BITMAP_BITS_COUNT - 1); }
+
+    bool ContainsLinear(const uint32_t key) const {
+        for (size_t blockIdx = 0; blockIdx < mKeys.size(); blockIdx += BLOCK_KEYS_COUNT) {
+            // Fixed number of the comparisons without the early exit is vectorised by the compiler
+            uint32_t isFound = 0;
+            for (size_t keyIdx = 0; keyIdx < BLOCK_KEYS_COUNT; ++keyIdx) {
+                isFound |= (mKeys[blockIdx + keyIdx] == key);
+            }
+
+            if (isFound) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}; // class KeySetMatcher
+
+// Set of the members which do not fit in 32 bits (extended and large communities), kept sorted for the binary search
+template<typename T>
+class SortedSetMatcher {
+public:
+    SortedSetMatcher() = default;
+    explicit SortedSetMatcher(Vector<T> members) : mMembers(std::move(members)) {
+        std::ranges::sort(mMembers);
+        mMembers.erase(std::unique(mMembers.begin(), mMembers.end()), mMembers.end());
+    }
+
+    size_t Size() const { return mMembers.size(); }
+    bool Contains(const T& member) const { return std::binary_search(mMembers.begin(), mMembers.end(), member); }
+
+    bool ContainsAny(const std::span<const T> members) const {
+        return std::ranges::any_of(members, [this](const T& member) { return Contains(member); });
+    }
+
+    bool Equals(const std::span<const T> members, Vector<T>& sortedMembers) const {
+        sortedMembers.assign(members.begin(), members.end());
+        std::ranges::sort(sortedMembers);
+        sortedMembers.erase(std::unique(sortedMembers.begin(), sortedMembers.end()), sortedMembers.end());
+        return sortedMembers == mMembers;
+    }
+
+private:
+    Vector<T> mMembers;
+}; // class SortedSetMatcher
+
+using AsnSetMatcher = KeySetMatcher<uint32_t>;
+using CommunitySetMatcher = KeySetMatcher<Community>;
+using ExtCommunitySetMatcher = SortedSetMatcher<ExtCommunity>;
+using LargeCommunitySetMatcher = SortedSetMatcher<LargeCommunity>;
+} // namespace Policy
@@ -0,0 +1,896 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Common.hpp"
+#include "JsonCommon.hpp"
+#include "JsonSchemaProperties.hpp"
+#include "Lib/ModuleRegistry.hpp"
+#include "Lib/PrefixSet.hpp"
+#include "Lib/WorkerPool.hpp"
+#include "Modules.hpp"
+#include "MrtReader.hpp"
+#include "PolicyMatchers.hpp"
+#include "PrefixListReader.hpp"
+#include "RouteBatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <span>
+
+namespace Policy {
+using namespace Json::Schema;
+using namespace StdLib;
+
+// Policy of the 'policy-list' compiled for the evaluation of many routes. The operands are ready for the lookups
+struct PolicyProgram {
+    enum class Verdict : uint8_t {
+        ACCEPT,
+        REJECT,
+        NEXT_TERM
+    };
+
+    struct Condition {
+        enum class Kind : uint8_t {
+            AS_PATH_EQ,
+            AS_PATH_IN,
+            COMMUNITY_EQ,
+            COMMUNITY_IN,
+            EXT_COMMUNITY_EQ,
+            EXT_COMMUNITY_IN,
+            LARGE_COMMUNITY_EQ,
+            LARGE_COMMUNITY_IN,
+            NET_IN,
+            NET_TYPE_EQ,
+            SOURCE_PROTOCOL_EQ
+        };
+
+        Kind CondKind;
+        // Index of the operand in the vector of the kind, or the value itself for NET_TYPE_EQ and SOURCE_PROTOCOL_EQ
+        uint32_t Operand = 0;
+    };
+
+    // The actions of the term are applied in the order of the rendered BIRD filter
+    struct Term {
+        String Name;
+        bool IsMatchAll = true;
+        Vector<Condition> Conditions;
+        uint32_t PrependedAsn = 0;
+        uint16_t PrependedCount = 0;
+        Optional<Community> AddedCommunity;
+        Optional<uint32_t> RemovedCommunitiesIdx;
+        Optional<uint32_t> LocalPreference;
+        Optional<uint32_t> Med;
+        Verdict Action = Verdict::NEXT_TERM;
+    };
+
+    String Name;
+    Vector<Term> Terms;
+    Verdict DefaultAction = Verdict::REJECT;
+    Vector<AsPathMatcher> AsPaths;
+    Vector<AsnSetMatcher> AsnSets;
+    Vector<CommunitySetMatcher> CommunitySets;
+    Vector<ExtCommunitySetMatcher> ExtCommunitySets;
+    Vector<LargeCommunitySetMatcher> LargeCommunitySets;
+    Vector<Utils::PrefixSet> PrefixSets;
+}; // struct PolicyProgram
+
+/*
+    Evaluates the policies of the JSON config ('policy-list') against the given routes the way BIRD evaluates the
+    filters rendered from them, without loading anything into BIRD. The policy is compiled once, and then the routes
+    are split into chunks evaluated in parallel by the worker pool. Only the counters of the chunks are merged, so
+    the result does not depend on the number of workers.
+*/
+class PolicySimulator {
+public:
+    enum Attribute : size_t {
+        AS_PATH,
+        COMMUNITY,
+        LOCAL_PREFERENCE,
+        MED,
+        ATTRIBUTES_COUNT
+    };
+
+    // Outcome of the single route, reported only for the first routes of the request
+    struct RouteOutcome {
+        PolicyProgram::Verdict Action = PolicyProgram::Verdict::REJECT;
+        Vector<uint32_t> MatchedTermIdxs;
+        Vector<uint32_t> AsPath;
+        Vector<Community> Communities;
+        uint32_t LocalPreference = 0;
+        uint32_t Med = 0;
+    };
+
+    struct Result {
+        uint64_t RoutesCount = 0;
+        uint64_t AcceptedCount = 0;
+        uint64_t RejectedCount = 0;
+        // Routes which have got to the end of the policy without being accepted or rejected by any term
+        uint64_t DefaultActionCount = 0;
+        Vector<uint64_t> MatchedCountByTerm;
+        // Accepted routes which leave the policy with the attribute changed
+        std::array<uint64_t, ATTRIBUTES_COUNT> ModifiedCountByAttribute {};
+        Vector<RouteOutcome> RouteOutcomes;
+    };
+
+    PolicySimulator(const SharedPtr<ModuleRegistry>& moduleRegistry, const SharedPtr<Utils::WorkerPool>& workerPool)
+      : mModuleRegistry(moduleRegistry), mWorkerPool(workerPool), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::POLICY_SIM)), mPrefixListReader(mLog), mMrtReader(mLog, workerPool) {}
+
+    /*
+        Simulate() handles the request like {"policy": "NAME", "routes": [...], "details": 10} and returns the report.
+        The policy comes from the 'config' of the request if there is any, or from the given (running) config.
+        If the local files are allowed, the 'routes' can be the name of the MRT dump, and 'peers' select the peers of
+        its PEER_INDEX_TABLE (e.g. {"policy": "NAME", "routes": "rib.mrt", "peers": [0]}).
+    */
+    Optional<Json::JSON> Simulate(const ByteStream& config, const ByteStream& request, const bool isLocalFileAllowed = false) {
+        try {
+            auto jRequest = Json::JSON::parse(request);
+            auto policyIt = jRequest.find(POLICY);
+            auto routesIt = jRequest.find(ROUTES);
+            if ((policyIt == jRequest.end()) || (routesIt == jRequest.end())) {
+                mLog->error("Not found key '{}' or '{}' in the simulation request", POLICY, ROUTES);
+                return {};
+            }
+
+            auto configIt = jRequest.find(CONFIG);
+            auto jConfig = (configIt != jRequest.end()) ? std::move(configIt.value()) : Json::JSON::parse(config);
+            auto policyName = policyIt.value().template get<String>();
+            auto program = Compile(jConfig, policyName);
+            if (!program.has_value()) {
+                mLog->error("Failed to compile policy '{}'", policyName);
+                return {};
+            }
+
+            Optional<RouteBatch> routes;
+            if (routesIt.value().is_string() && isLocalFileAllowed) {
+                auto peersIt = jRequest.find(PEERS);
+                auto peerIdxs = (peersIt != jRequest.end()) ? peersIt.value().template get<Vector<uint16_t>>() : Vector<uint16_t>();
+                routes = mMrtReader.Read(routesIt.value().template get<String>(), peerIdxs);
+            }
+            else {
+                routes = ReadRoutes(routesIt.value());
+            }
+
+            if (!routes.has_value()) {
+                mLog->error("Failed to read routes of the simulation request");
+                return {};
+            }
+
+            auto detailsIt = jRequest.find(DETAILS);
+            auto detailedRoutesCount = (detailsIt != jRequest.end()) ? detailsIt.value().template get<size_t>() : 0;
+            auto startTime = std::chrono::steady_clock::now();
+            auto result = Run(program.value(), routes.value(), detailedRoutesCount);
+            auto elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+            auto jResult = ToJson(program.value(), routes.value(), result);
+            jResult["elapsed-us"] = elapsedTime.count();
+            return jResult;
+        }
+        catch (const Exception& ex) {
+            mLog->error("Failed to simulate policy. Error: {}", ex.what());
+        }
+
+        return {};
+    }
+
+    // Compile() prepares the policy of the config for Run(). The terms which render no condition are skipped, like by the converter
+    Optional<PolicyProgram> Compile(const Json::JSON& jConfig, const String& policyName) {
+        auto bgpIt = jConfig.find(Property::BGP);
+        if (bgpIt == jConfig.end()) {
+            mLog->error("Not found key '{}' in JSON data", Property::BGP);
+            return {};
+        }
+
+        auto policyListIt = bgpIt->find(Property::POLICY_LIST);
+        if ((policyListIt == bgpIt->end()) || !policyListIt->contains(policyName)) {
+            mLog->error("Policy list '{}' does not exist", policyName);
+            return {};
+        }
+
+        PolicyProgram program;
+        program.Name = policyName;
+        for (const auto& [termName, termDetails] : policyListIt->at(policyName).items()) {
+            if (termName == Property::DEFAULT_ACTION) {
+                program.DefaultAction = (termDetails.template get<String>() == "permit") ? PolicyProgram::Verdict::ACCEPT : PolicyProgram::Verdict::REJECT;
+                continue;
+            }
+
+            PolicyProgram::Term term;
+            term.Name = termName;
+            if (!CompileConditions(*bgpIt, termDetails, term, program) || !CompileActions(*bgpIt, termDetails, term, program)) {
+                mLog->error("Failed to compile term '{}' of policy '{}'", termName, policyName);
+                return {};
+            }
+
+            if (term.Conditions.empty()) {
+                mLog->warn("Term '{}' of policy '{}' has no condition which is rendered into the target config. The term is skipped", termName, policyName);
+                continue;
+            }
+
+            program.Terms.push_back(std::move(term));
+        }
+
+        return program;
+    }
+
+    // ReadRoutes() reads routes like {"net": "192.0.2.0/24", "as-path": [65001], "community": ["65001:100"], "med": 10}
+    Optional<RouteBatch> ReadRoutes(const Json::JSON& jRoutes) {
+        if (!jRoutes.is_array()) {
+            mLog->error("Unsupported type of routes. Expected 'array' as list of routes");
+            return {};
+        }
+
+        RouteBatch routes;
+        routes.Reserve(jRoutes.size());
+        for (const auto& jRoute : jRoutes) {
+            auto netIt = jRoute.find(ROUTE_NET);
+            auto prefix = (netIt != jRoute.end()) ? Utils::IpPrefix::Parse(netIt.value().template get<String>()) : Optional<Utils::IpPrefix>();
+            if (!prefix.has_value()) {
+                mLog->error("Missing or invalid '{}' of route #{}", ROUTE_NET, routes.Size());
+                return {};
+            }
+
+            auto sourceProtocol = SourceProtocol::BGP;
+            auto sourceProtocolIt = jRoute.find(ROUTE_SOURCE_PROTOCOL);
+            if ((sourceProtocolIt != jRoute.end()) && (sourceProtocolIt.value().template get<String>() == SRC_PROTO_STATIC)) {
+                sourceProtocol = SourceProtocol::STATIC;
+            }
+
+            routes.AddRoute(prefix.value(), sourceProtocol);
+            if (jRoute.contains(ROUTE_LOCAL_PREFERENCE)) {
+                routes.SetLocalPreference(jRoute.at(ROUTE_LOCAL_PREFERENCE).template get<uint32_t>());
+            }
+
+            if (jRoute.contains(ROUTE_MED)) {
+                routes.SetMed(jRoute.at(ROUTE_MED).template get<uint32_t>());
+            }
+
+            if (jRoute.contains(ROUTE_AS_PATH)) {
+                for (const auto& jAsn : jRoute.at(ROUTE_AS_PATH)) {
+                    routes.AppendAsn(jAsn.template get<uint32_t>());
+                }
+            }
+
+            if (!ReadRouteCommunities<Community>(jRoute, ROUTE_COMMUNITY, [&routes](const Community& c) { routes.AppendCommunity(c); })
+                || !ReadRouteCommunities<ExtCommunity>(jRoute, ROUTE_EXT_COMMUNITY, [&routes](const ExtCommunity& c) { routes.AppendExtCommunity(c); })
+                || !ReadRouteCommunities<LargeCommunity>(jRoute, ROUTE_LARGE_COMMUNITY, [&routes](const LargeCommunity& c) { routes.AppendLargeCommunity(c); })) {
+                mLog->error("Invalid communities of route '{}'", prefix.value().ToString());
+                return {};
+            }
+        }
+
+        return routes;
+    }
+
+    // Run() evaluates the policy against all the routes. The outcome of each of the first 'detailedRoutesCount' routes is reported as well
+    Result Run(const PolicyProgram& program, const RouteBatch& routes, const size_t detailedRoutesCount = 0) {
+        Result result;
+        result.RoutesCount = routes.Size();
+        result.RouteOutcomes.resize(std::min(detailedRoutesCount, routes.Size()));
+        auto chunksCount = (routes.Size() + CHUNK_ROUTES_COUNT - 1) / CHUNK_ROUTES_COUNT;
+        Vector<Result> chunkResults(chunksCount);
+        auto evaluateChunk = [&program, &routes, &result, &chunkResults](const size_t chunkIdx) {
+            auto& chunkResult = chunkResults[chunkIdx];
+            chunkResult.MatchedCountByTerm.resize(program.Terms.size());
+            Evaluator evaluator(program, routes);
+            auto endRouteIdx = std::min(routes.Size(), (chunkIdx + 1) * CHUNK_ROUTES_COUNT);
+            for (auto routeIdx = chunkIdx * CHUNK_ROUTES_COUNT; routeIdx < endRouteIdx; ++routeIdx) {
+                auto* routeOutcome = (routeIdx < result.RouteOutcomes.size()) ? &result.RouteOutcomes[routeIdx] : nullptr;
+                evaluator.Evaluate(routeIdx, chunkResult, routeOutcome);
+            }
+        };
+
+        if (mWorkerPool) {
+            mWorkerPool->RunParallel(chunksCount, evaluateChunk);
+        }
+        else {
+            for (size_t chunkIdx = 0; chunkIdx < chunksCount; ++chunkIdx) {
+                evaluateChunk(chunkIdx);
+            }
+        }
+
+        result.MatchedCountByTerm.resize(program.Terms.size());
+        for (const auto& chunkResult : chunkResults) {
+            result.AcceptedCount += chunkResult.AcceptedCount;
+            result.RejectedCount += chunkResult.RejectedCount;
+            result.DefaultActionCount += chunkResult.DefaultActionCount;
+            for (size_t termIdx = 0; termIdx < program.Terms.size(); ++termIdx) {
+                result.MatchedCountByTerm[termIdx] += chunkResult.MatchedCountByTerm[termIdx];
+            }
+
+            for (size_t attrIdx = 0; attrIdx < ATTRIBUTES_COUNT; ++attrIdx) {
+                result.ModifiedCountByAttribute[attrIdx] += chunkResult.ModifiedCountByAttribute[attrIdx];
+            }
+        }
+
+        return result;
+    }
+
+private:
+    // Routes evaluated by single task, big enough to make the scheduling cost negligible
+    static constexpr size_t CHUNK_ROUTES_COUNT = 16384;
+
+    static constexpr auto CONFIG = "config";
+    static constexpr auto DETAILS = "details";
+    static constexpr auto PEERS = "peers";
+    static constexpr auto POLICY = "policy";
+    static constexpr auto ROUTES = "routes";
+    static constexpr auto ROUTE_AS_PATH = "as-path";
+    static constexpr auto ROUTE_COMMUNITY = "community";
+    static constexpr auto ROUTE_EXT_COMMUNITY = "ext-community";
+    static constexpr auto ROUTE_LARGE_COMMUNITY = "large-community";
+    static constexpr auto ROUTE_LOCAL_PREFERENCE = "local-preference";
+    static constexpr auto ROUTE_MED = "med";
+    static constexpr auto ROUTE_NET = "net";
+    static constexpr auto ROUTE_SOURCE_PROTOCOL = "source-protocol";
+
+    static constexpr auto NET_TYPE_IP4 = "ipv4";
+    static constexpr auto NET_TYPE_IP6 = "ipv6";
+    static constexpr auto SRC_PROTO_BGP = "BGP";
+    static constexpr auto SRC_PROTO_STATIC = "STATIC";
+
+    SharedPtr<ModuleRegistry> mModuleRegistry;
+    SharedPtr<Utils::WorkerPool> mWorkerPool;
+    SharedPtr<Log::SpdLogger> mLog;
+    Config::PrefixListReader mPrefixListReader;
+    MrtReader mMrtReader;
+
+    // Evaluator keeps the attributes changed by the actions aside the batch. It is used by single thread only
+    class Evaluator {
+    public:
+        Evaluator(const PolicyProgram& program, const RouteBatch& routes) : mProgram(program), mRoutes(routes) {}
+
+        void Evaluate(const size_t routeIdx, Result& result, RouteOutcome* routeOutcome) {
+            mRouteIdx = routeIdx;
+            mAsPath = mRoutes.AsPath(routeIdx);
+            mCommunities = mRoutes.Communities(routeIdx);
+            mLocalPreference = mRoutes.LocalPreference(routeIdx);
+            mMed = mRoutes.Med(routeIdx);
+            mIsAsPathOwned = false;
+            mIsCommunitiesOwned = false;
+            mIsCommunitiesModified = false;
+            auto action = PolicyProgram::Verdict::NEXT_TERM;
+            for (size_t termIdx = 0; (termIdx < mProgram.Terms.size()) && (action == PolicyProgram::Verdict::NEXT_TERM); ++termIdx) {
+                const auto& term = mProgram.Terms[termIdx];
+                if (!Matches(term)) {
+                    continue;
+                }
+
+                ++result.MatchedCountByTerm[termIdx];
+                if (routeOutcome) {
+                    routeOutcome->MatchedTermIdxs.push_back(static_cast<uint32_t>(termIdx));
+                }
+
+                Apply(term);
+                action = term.Action;
+            }
+
+            if (action == PolicyProgram::Verdict::NEXT_TERM) {
+                action = mProgram.DefaultAction;
+                ++result.DefaultActionCount;
+            }
+
+            if (action == PolicyProgram::Verdict::ACCEPT) {
+                ++result.AcceptedCount;
+                result.ModifiedCountByAttribute[AS_PATH] += mIsAsPathOwned ? 1 : 0;
+                result.ModifiedCountByAttribute[COMMUNITY] += mIsCommunitiesModified ? 1 : 0;
+                result.ModifiedCountByAttribute[LOCAL_PREFERENCE] += (mLocalPreference != mRoutes.LocalPreference(routeIdx)) ? 1 : 0;
+                result.ModifiedCountByAttribute[MED] += (mMed != mRoutes.Med(routeIdx)) ? 1 : 0;
+            }
+            else {
+                ++result.RejectedCount;
+            }
+
+            if (routeOutcome) {
+                routeOutcome->Action = action;
+                routeOutcome->AsPath.assign(mAsPath.begin(), mAsPath.end());
+                routeOutcome->Communities.assign(mCommunities.begin(), mCommunities.end());
+                routeOutcome->LocalPreference = mLocalPreference;
+                routeOutcome->Med = mMed;
+            }
+        }
+
+    private:
+        const PolicyProgram& mProgram;
+        const RouteBatch& mRoutes;
+        size_t mRouteIdx = 0;
+        // The attributes refer to the batch until the first change, and then to the own copy
+        std::span<const uint32_t> mAsPath;
+        std::span<const Community> mCommunities;
+        uint32_t mLocalPreference = 0;
+        uint32_t mMed = 0;
+        bool mIsAsPathOwned = false;
+        bool mIsCommunitiesOwned = false;
+        bool mIsCommunitiesModified = false;
+        Vector<uint32_t> mOwnAsPath;
+        Vector<Community> mOwnCommunities;
+        // Buffers of the '*-community-eq' matchers
+        Vector<uint32_t> mSortedCommunityKeys;
+        Vector<ExtCommunity> mSortedExtCommunities;
+        Vector<LargeCommunity> mSortedLargeCommunities;
+
+        bool Matches(const PolicyProgram::Term& term) {
+            for (const auto& condition : term.Conditions) {
+                if (Matches(condition) != term.IsMatchAll) {
+                    return !term.IsMatchAll;
+                }
+            }
+
+            return term.IsMatchAll;
+        }
+
+        bool Matches(const PolicyProgram::Condition& condition) {
+            using Kind = PolicyProgram::Condition::Kind;
+            switch (condition.CondKind) {
+            case Kind::AS_PATH_EQ:
+                return mProgram.AsPaths[condition.Operand].Matches(mAsPath);
+            case Kind::AS_PATH_IN:
+                return mProgram.AsnSets[condition.Operand].ContainsAny(mAsPath);
+            case Kind::COMMUNITY_EQ:
+                return mProgram.CommunitySets[condition.Operand].Equals(mCommunities, mSortedCommunityKeys);
+            case Kind::COMMUNITY_IN:
+                return mProgram.CommunitySets[condition.Operand].ContainsAny(mCommunities);
+            case Kind::EXT_COMMUNITY_EQ:
+                return mProgram.ExtCommunitySets[condition.Operand].Equals(mRoutes.ExtCommunities(mRouteIdx), mSortedExtCommunities);
+            case Kind::EXT_COMMUNITY_IN:
+                return mProgram.ExtCommunitySets[condition.Operand].ContainsAny(mRoutes.ExtCommunities(mRouteIdx));
+            case Kind::LARGE_COMMUNITY_EQ:
+                return mProgram.LargeCommunitySets[condition.Operand].Equals(mRoutes.LargeCommunities(mRouteIdx), mSortedLargeCommunities);
+            case Kind::LARGE_COMMUNITY_IN:
+                return mProgram.LargeCommunitySets[condition.Operand].ContainsAny(mRoutes.LargeCommunities(mRouteIdx));
+            case Kind::NET_IN:
+                return mProgram.PrefixSets[condition.Operand].Matches(mRoutes.Prefix(mRouteIdx));
+            case Kind::NET_TYPE_EQ:
+                return static_cast<uint32_t>(mRoutes.Prefix(mRouteIdx).Address.AddrFamily) == condition.Operand;
+            case Kind::SOURCE_PROTOCOL_EQ:
+                return static_cast<uint32_t>(mRoutes.Source(mRouteIdx)) == condition.Operand;
+            }
+
+            return false;
+        }
+
+        void Apply(const PolicyProgram::Term& term) {
+            if (term.PrependedCount > 0) {
+                if (!mIsAsPathOwned) {
+                    mOwnAsPath.assign(mAsPath.begin(), mAsPath.end());
+                    mIsAsPathOwned = true;
+                }
+
+                mOwnAsPath.insert(mOwnAsPath.begin(), term.PrependedCount, term.PrependedAsn);
+                mAsPath = mOwnAsPath;
+            }
+
+            if (term.AddedCommunity.has_value() && (std::ranges::find(mCommunities, term.AddedCommunity.value()) == mCommunities.end())) {
+                OwnCommunities();
+                mOwnCommunities.push_back(term.AddedCommunity.value());
+                mCommunities = mOwnCommunities;
+                mIsCommunitiesModified = true;
+            }
+
+            if (term.RemovedCommunitiesIdx.has_value() && mProgram.CommunitySets[term.RemovedCommunitiesIdx.value()].ContainsAny(mCommunities)) {
+                OwnCommunities();
+                const auto& removedCommunities = mProgram.CommunitySets[term.RemovedCommunitiesIdx.value()];
+                std::erase_if(mOwnCommunities, [&removedCommunities](const Community& community) {
+                    return removedCommunities.Contains(community);
+                });
+
+                mCommunities = mOwnCommunities;
+                mIsCommunitiesModified = true;
+            }
+
+            if (term.LocalPreference.has_value()) {
+                mLocalPreference = term.LocalPreference.value();
+            }
+
+            if (term.Med.has_value()) {
+                mMed = term.Med.value();
+            }
+        }
+
+        void OwnCommunities() {
+            if (!mIsCommunitiesOwned) {
+                mOwnCommunities.assign(mCommunities.begin(), mCommunities.end());
+                mIsCommunitiesOwned = true;
+            }
+        }
+    }; // class Evaluator
+
+    bool CompileConditions(const Json::JSON& jConfigBgpRoot, const Json::JSON& jTerm, PolicyProgram::Term& term, PolicyProgram& program) {
+        using Kind = PolicyProgram::Condition::Kind;
+        auto ifMatchIt = jTerm.find(Property::IF_MATCH);
+        if (ifMatchIt == jTerm.end()) {
+            mLog->error("Not found key '{}' in JSON data", Property::IF_MATCH);
+            return false;
+        }
+
+        const auto& jIfMatch = ifMatchIt.value();
+        term.IsMatchAll = !jIfMatch.contains(Property::MATCH_TYPE) || (jIfMatch.at(Property::MATCH_TYPE).template get<String>() != "ANY");
+        for (const auto& [propertyCond, kind] : { Pair { Property::AS_PATH_EQ, Kind::AS_PATH_EQ }, Pair { Property::AS_PATH_IN, Kind::AS_PATH_IN } }) {
+            auto jAsPath = FindList(jConfigBgpRoot, jIfMatch, propertyCond, Property::AS_PATH_LIST);
+            if (!jAsPath.has_value()) {
+                return false;
+            }
+
+            if (jAsPath.value() == nullptr) {
+                continue;
+            }
+
+            auto asPath = jAsPath.value()->template get<Vector<uint32_t>>();
+            if (kind == Kind::AS_PATH_EQ) {
+                program.AsPaths.emplace_back(std::move(asPath));
+                term.Conditions.push_back({ kind, static_cast<uint32_t>(program.AsPaths.size() - 1) });
+            }
+            else {
+                program.AsnSets.emplace_back(asPath);
+                term.Conditions.push_back({ kind, static_cast<uint32_t>(program.AsnSets.size() - 1) });
+            }
+        }
+
+        for (const auto& [propertyCond, kind] : { Pair { Property::COMMUNITY_EQ, Kind::COMMUNITY_EQ }, Pair { Property::COMMUNITY_IN, Kind::COMMUNITY_IN } }) {
+            auto jCommunities = FindList(jConfigBgpRoot, jIfMatch, propertyCond, Property::COMMUNITY_LIST);
+            if (!jCommunities.has_value()) {
+                return false;
+            }
+
+            if (jCommunities.value() == nullptr) {
+                continue;
+            }
+
+            auto communities = ReadCommunitySet<Community>(*jCommunities.value());
+            if (!communities.has_value()) {
+                return false;
+            }
+
+            program.CommunitySets.emplace_back(communities.value());
+            term.Conditions.push_back({ kind, static_cast<uint32_t>(program.CommunitySets.size() - 1) });
+        }
+
+        for (const auto& [propertyCond, kind] : { Pair { Property::EXT_COMMUNITY_EQ, Kind::EXT_COMMUNITY_EQ }, Pair { Property::EXT_COMMUNITY_IN, Kind::EXT_COMMUNITY_IN } }) {
+            auto jExtCommunities = FindList(jConfigBgpRoot, jIfMatch, propertyCond, Property::EXT_COMMUNITY_LIST);
+            if (!jExtCommunities.has_value()) {
+                return false;
+            }
+
+            if (jExtCommunities.value() == nullptr) {
+                continue;
+            }
+
+            auto extCommunities = ReadCommunitySet<ExtCommunity>(*jExtCommunities.value());
+            if (!extCommunities.has_value()) {
+                return false;
+            }
+
+            program.ExtCommunitySets.emplace_back(std::move(extCommunities.value()));
+            term.Conditions.push_back({ kind, static_cast<uint32_t>(program.ExtCommunitySets.size() - 1) });
+        }
+
+        for (const auto& [propertyCond, kind] : { Pair { Property::LARGE_COMMUNITY_EQ, Kind::LARGE_COMMUNITY_EQ }, Pair { Property::LARGE_COMMUNITY_IN, Kind::LARGE_COMMUNITY_IN } }) {
+            auto jLargeCommunities = FindList(jConfigBgpRoot, jIfMatch, propertyCond, Property::LARGE_COMMUNITY_LIST);
+            if (!jLargeCommunities.has_value()) {
+                return false;
+            }
+
+            if (jLargeCommunities.value() == nullptr) {
+                continue;
+            }
+
+            auto largeCommunities = ReadCommunitySet<LargeCommunity>(*jLargeCommunities.value());
+            if (!largeCommunities.has_value()) {
+                return false;
+            }
+
+            program.LargeCommunitySets.emplace_back(std::move(largeCommunities.value()));
+            term.Conditions.push_back({ kind, static_cast<uint32_t>(program.LargeCommunitySets.size() - 1) });
+        }
+
+        auto pfxSet = CompileNetCondition(jConfigBgpRoot, jIfMatch);
+        if (!pfxSet.has_value()) {
+            return false;
+        }
+
+        for (auto& netPfxSet : pfxSet.value()) {
+            program.PrefixSets.push_back(std::move(netPfxSet));
+            term.Conditions.push_back({ Kind::NET_IN, static_cast<uint32_t>(program.PrefixSets.size() - 1) });
+        }
+
+        auto netTypeIt = jIfMatch.find(Property::NET_TYPE_EQ);
+        if (netTypeIt != jIfMatch.end()) {
+            auto netType = netTypeIt.value().template get<String>();
+            if ((netType != NET_TYPE_IP4) && (netType != NET_TYPE_IP6)) {
+                mLog->error("Unsupported value of '{}'", Property::NET_TYPE_EQ);
+                return false;
+            }
+
+            auto addrFamily = (netType == NET_TYPE_IP4) ? Utils::IpAddress::Family::IPV4 : Utils::IpAddress::Family::IPV6;
+            term.Conditions.push_back({ Kind::NET_TYPE_EQ, static_cast<uint32_t>(addrFamily) });
+        }
+
+        auto srcProtoIt = jIfMatch.find(Property::SOURCE_PROTOCOL_EQ);
+        if (srcProtoIt != jIfMatch.end()) {
+            auto srcProto = srcProtoIt.value().template get<String>();
+            if ((srcProto != SRC_PROTO_BGP) && (srcProto != SRC_PROTO_STATIC)) {
+                mLog->error("Unsupported value of '{}'", Property::SOURCE_PROTOCOL_EQ);
+                return false;
+            }
+
+            auto sourceProtocol = (srcProto == SRC_PROTO_BGP) ? SourceProtocol::BGP : SourceProtocol::STATIC;
+            term.Conditions.push_back({ Kind::SOURCE_PROTOCOL_EQ, static_cast<uint32_t>(sourceProtocol) });
+        }
+
+        return true;
+    }
+
+    // CompileNetCondition() returns the prefix sets of 'net-eq' and 'net-in'. Like in the rendered filter, 'net-in' takes IPv6 prefixes only if there are no IPv4 ones
+    Optional<Vector<Utils::PrefixSet>> CompileNetCondition(const Json::JSON& jConfigBgpRoot, const Json::JSON& jIfMatch) {
+        Vector<Utils::PrefixSet> pfxSets;
+        auto netEqIt = jIfMatch.find(Property::NET_EQ);
+        if (netEqIt != jIfMatch.end()) {
+            Utils::PrefixSet pfxSet;
+            for (const auto& propertyPfxIP : { Property::PREFIX_V4, Property::PREFIX_V6 }) {
+                auto pfxIPIt = netEqIt->find(propertyPfxIP);
+                if ((pfxIPIt == netEqIt->end()) || (pfxIPIt->begin() == pfxIPIt->end())) {
+                    continue;
+                }
+
+                auto pfxRange = mPrefixListReader.ParsePrefixRange(pfxIPIt->begin().key(), pfxIPIt->begin().value());
+                if (!pfxRange.has_value()) {
+                    return {};
+                }
+
+                pfxSet.Insert(pfxRange.value());
+            }
+
+            if (!pfxSet.IsEmpty()) {
+                pfxSets.push_back(std::move(pfxSet));
+            }
+        }
+
+        auto netInIt = jIfMatch.find(Property::NET_IN);
+        if (netInIt == jIfMatch.end()) {
+            return pfxSets;
+        }
+
+        for (const auto& [propertyPfxList, propertyPfxIP] : { Pair { Property::PREFIX_V4_LIST, Property::PREFIX_V4 }, Pair { Property::PREFIX_V6_LIST, Property::PREFIX_V6 } }) {
+            const Json::JSON* jPrefixes = nullptr;
+            if (netInIt->contains(propertyPfxList)) {
+                auto pfxListName = netInIt->at(propertyPfxList).template get<String>();
+                auto pfxListSectionIt = jConfigBgpRoot.find(propertyPfxList);
+                if ((pfxListSectionIt == jConfigBgpRoot.end()) || !pfxListSectionIt->contains(pfxListName)) {
+                    mLog->error("Prefix IP list '{}' does not exist", pfxListName);
+                    return {};
+                }
+
+                jPrefixes = &pfxListSectionIt->at(pfxListName);
+            }
+            else if (netInIt->contains(propertyPfxIP)) {
+                jPrefixes = &netInIt->at(propertyPfxIP);
+            }
+
+            if (jPrefixes == nullptr) {
+                continue;
+            }
+
+            auto pfxSet = mPrefixListReader.MakePrefixSet(*jPrefixes);
+            if (!pfxSet.has_value()) {
+                return {};
+            }
+
+            pfxSet.value().ShrinkToFit();
+            pfxSets.push_back(std::move(pfxSet.value()));
+            break;
+        }
+
+        return pfxSets;
+    }
+
+    bool CompileActions(const Json::JSON& jConfigBgpRoot, const Json::JSON& jTerm, PolicyProgram::Term& term, PolicyProgram& program) {
+        auto thenIt = jTerm.find(Property::THEN);
+        if (thenIt == jTerm.end()) {
+            mLog->error("Not found key '{}' in JSON data", Property::THEN);
+            return false;
+        }
+
+        const auto& jThen = thenIt.value();
+        auto asPathPrependIt = jThen.find(Property::AS_PATH_PREPEND);
+        if (asPathPrependIt != jThen.end()) {
+            if (!asPathPrependIt->contains(Property::ASN)) {
+                mLog->error("Missing mandatory property '{}'", Property::ASN);
+                return false;
+            }
+
+            term.PrependedAsn = asPathPrependIt->at(Property::ASN).template get<uint32_t>();
+            term.PrependedCount = asPathPrependIt->contains(Property::N_TIMES) ? asPathPrependIt->at(Property::N_TIMES).template get<uint16_t>() : 1;
+        }
+
+        auto commAddIt = jThen.find(Property::COMMUNITY_ADD);
+        if (commAddIt != jThen.end()) {
+            // The community is either in place or the predefined list of single community
+            Optional<Vector<Community>> communities;
+            if (commAddIt->is_string()) {
+                communities = ReadCommunitySet<Community>(Json::JSON::array({ commAddIt.value() }));
+            }
+            else {
+                auto jCommunities = FindList(jConfigBgpRoot, jThen, Property::COMMUNITY_ADD, Property::COMMUNITY_LIST);
+                if (jCommunities.has_value()) {
+                    communities = ReadCommunitySet<Community>(*jCommunities.value());
+                }
+            }
+
+            if (!communities.has_value()) {
+                return false;
+            }
+
+            if (communities.value().size() != 1) {
+                mLog->error("BGP community allows to add only single value/community. The community list consists of {} communities", communities.value().size());
+                return false;
+            }
+
+            term.AddedCommunity = communities.value().front();
+        }
+
+        auto jRemovedCommunities = FindList(jConfigBgpRoot, jThen, Property::COMMUNITY_REMOVE, Property::COMMUNITY_LIST);
+        if (!jRemovedCommunities.has_value()) {
+            return false;
+        }
+
+        if (jRemovedCommunities.value() != nullptr) {
+            auto communities = ReadCommunitySet<Community>(*jRemovedCommunities.value());
+            if (!communities.has_value()) {
+                return false;
+            }
+
+            program.CommunitySets.emplace_back(communities.value());
+            term.RemovedCommunitiesIdx = static_cast<uint32_t>(program.CommunitySets.size() - 1);
+        }
+
+        if (jThen.contains(Property::LOCAL_PREFERENCE_SET)) {
+            term.LocalPreference = jThen.at(Property::LOCAL_PREFERENCE_SET).template get<uint32_t>();
+        }
+
+        if (jThen.contains(Property::MED_SET)) {
+            term.Med = jThen.at(Property::MED_SET).template get<uint32_t>();
+        }
+
+        auto actionIt = jThen.find(Property::ACTION);
+        if (actionIt == jThen.end()) {
+            mLog->error("Not found key '{}' in JSON data", Property::ACTION);
+            return false;
+        }
+
+        // 'call-next' (also with the rule) renders neither 'accept' nor 'reject', so the route goes to the next term
+        if (actionIt->is_string() && (actionIt.value().template get<String>() == "permit")) {
+            term.Action = PolicyProgram::Verdict::ACCEPT;
+        }
+        else if (actionIt->is_string() && (actionIt.value().template get<String>() == "deny")) {
+            term.Action = PolicyProgram::Verdict::REJECT;
+        }
+
+        return true;
+    }
+
+    /*
+        FindList() returns the list of the property, which is either in place (JSON array) or refers to the predefined
+        list by name (e.g. {"community-list": "NAME"}). It returns null if there is no such property, and nothing if
+        the predefined list does not exist.
+    */
+    Optional<const Json::JSON*> FindList(const Json::JSON& jConfigBgpRoot, const Json::JSON& jParent, const String& property, const String& propertyList) {
+        auto propertyIt = jParent.find(property);
+        if (propertyIt == jParent.end()) {
+            return nullptr;
+        }
+
+        if (!propertyIt->is_object()) {
+            return &propertyIt.value();
+        }
+
+        auto listNameIt = propertyIt->find(propertyList);
+        if ((listNameIt == propertyIt->end()) || !listNameIt->is_string()) {
+            mLog->error("Unsupported type of '{}' property. Expected 'string' as predefined list name of '{}'", property, propertyList);
+            return {};
+        }
+
+        auto listName = listNameIt.value().template get<String>();
+        auto listSectionIt = jConfigBgpRoot.find(propertyList);
+        if ((listSectionIt == jConfigBgpRoot.end()) || !listSectionIt->contains(listName)) {
+            mLog->error("List '{}' of '{}' does not exist", listName, propertyList);
+            return {};
+        }
+
+        return &listSectionIt->at(listName);
+    }
+
+    template<typename T>
+    Optional<Vector<T>> ReadCommunitySet(const Json::JSON& jCommunities) {
+        Vector<T> communities;
+        for (const auto& jCommunity : jCommunities) {
+            auto community = T::Parse(jCommunity.template get<String>());
+            if (!community.has_value()) {
+                mLog->error("Invalid community '{}'", jCommunity.template get<String>());
+                return {};
+            }
+
+            communities.push_back(community.value());
+        }
+
+        SortUnique(communities);
+        return communities;
+    }
+
+    template<typename T, typename Appender>
+    bool ReadRouteCommunities(const Json::JSON& jRoute, const String& property, const Appender& append) {
+        auto communitiesIt = jRoute.find(property);
+        if (communitiesIt == jRoute.end()) {
+            return true;
+        }
+
+        for (const auto& jCommunity : communitiesIt.value()) {
+            auto community = T::Parse(jCommunity.template get<String>());
+            if (!community.has_value()) {
+                mLog->error("Invalid community '{}'", jCommunity.template get<String>());
+                return false;
+            }
+
+            append(community.value());
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    static void SortUnique(Vector<T>& values) {
+        std::ranges::sort(values);
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+    }
+
+    static String ToString(const PolicyProgram::Verdict verdict) { return (verdict == PolicyProgram::Verdict::ACCEPT) ? "accept" : "reject"; }
+
+    Json::JSON ToJson(const PolicyProgram& program, const RouteBatch& routes, const Result& result) {
+        Json::JSON jResult;
+        jResult[POLICY] = program.Name;
+        jResult["routes-count"] = result.RoutesCount;
+        jResult["accepted-count"] = result.AcceptedCount;
+        jResult["rejected-count"] = result.RejectedCount;
+        jResult["default-action-count"] = result.DefaultActionCount;
+        jResult["terms"] = Json::JSON::object();
+        for (size_t termIdx = 0; termIdx < program.Terms.size(); ++termIdx) {
+            jResult["terms"][program.Terms[termIdx].Name]["matched-count"] = result.MatchedCountByTerm[termIdx];
+        }
+
+        jResult["modified"] = {
+            { ROUTE_AS_PATH, result.ModifiedCountByAttribute[AS_PATH] },
+            { ROUTE_COMMUNITY, result.ModifiedCountByAttribute[COMMUNITY] },
+            { ROUTE_LOCAL_PREFERENCE, result.ModifiedCountByAttribute[LOCAL_PREFERENCE] },
+            { ROUTE_MED, result.ModifiedCountByAttribute[MED] }
+        };
+
+        if (result.RouteOutcomes.empty()) {
+            return jResult;
+        }
+
+        auto& jRoutes = jResult[ROUTES] = Json::JSON::array();
+        for (size_t routeIdx = 0; routeIdx < result.RouteOutcomes.size(); ++routeIdx) {
+            const auto& routeOutcome = result.RouteOutcomes[routeIdx];
+            Json::JSON jRoute;
+            jRoute[ROUTE_NET] = routes.Prefix(routeIdx).ToString();
+            jRoute[Property::ACTION] = ToString(routeOutcome.Action);
+            jRoute["terms"] = Json::JSON::array();
+            for (const auto termIdx : routeOutcome.MatchedTermIdxs) {
+                jRoute["terms"].push_back(program.Terms[termIdx].Name);
+            }
+
+            jRoute[ROUTE_AS_PATH] = routeOutcome.AsPath;
+            jRoute[ROUTE_COMMUNITY] = Json::JSON::array();
+            for (const auto& community : routeOutcome.Communities) {
+                jRoute[ROUTE_COMMUNITY].push_back(community.ToString());
+            }
+
+            jRoute[ROUTE_LOCAL_PREFERENCE] = routeOutcome.LocalPreference;
+            jRoute[ROUTE_MED] = routeOutcome.Med;
+            jRoutes.push_back(std::move(jRoute));
+        }
+
+        return jResult;
+    }
+}; // class PolicySimulator
+} // namespace Policy
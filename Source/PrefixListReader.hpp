@@ -0,0 +1,66 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "JsonCommon.hpp"
+#include "JsonSchemaProperties.hpp"
+#include "Lib/Logging.hpp"
+#include "Lib/PrefixSet.hpp"
+
+namespace Config {
+using namespace Json::Schema;
+using namespace StdLib;
+/*
+    Reads the prefixes of the JSON config (the prefix as the key, its optional 'ge' and 'le' attributes as the value)
+    into prefix ranges and sets. The BIRD config converter and the policy simulator read the prefixes the same way,
+    so the simulation matches exactly the routes which the rendered config matches.
+*/
+class PrefixListReader {
+public:
+    explicit PrefixListReader(const SharedPtr<Log::SpdLogger>& log) : mLog(log) {}
+
+    // ParsePrefixRange() reads the prefix (JSON key) and its optional 'ge' and 'le' attributes. Without 'le' the range
+    // ends at the length of the address if 'ge' is given, otherwise at the length of the prefix
+    Optional<Utils::PrefixRange> ParsePrefixRange(const String& pfx, const Json::JSON& attrs) const {
+        auto prefix = Utils::IpPrefix::Parse(pfx);
+        if (!prefix.has_value()) {
+            mLog->error("Invalid prefix '{}'", pfx);
+            return {};
+        }
+
+        auto pfxLen = prefix.value().Length;
+        auto geIt = attrs.find(Property::PREFIX_GE_ATTR);
+        auto leIt = attrs.find(Property::PREFIX_LE_ATTR);
+        auto minPfxRange = (geIt != attrs.end()) ? geIt.value().template get<uint16_t>() : uint16_t(pfxLen);
+        auto maxPfxRange = (leIt != attrs.end()) ? leIt.value().template get<uint16_t>()
+                                                 : uint16_t((geIt != attrs.end()) ? prefix.value().Address.BitsCount() : pfxLen);
+        if ((pfxLen > minPfxRange) || (minPfxRange > maxPfxRange) || (maxPfxRange > prefix.value().Address.BitsCount())) {
+            mLog->error("Invalid prefix range <{},{}> of prefix '{}'", minPfxRange, maxPfxRange, pfx);
+            return {};
+        }
+
+        return Utils::PrefixRange { prefix.value(), static_cast<uint8_t>(minPfxRange), static_cast<uint8_t>(maxPfxRange) };
+    }
+
+    // MakePrefixSet() reads the prefixes (JSON object) into the set, which merges the duplicates
+    Optional<Utils::PrefixSet> MakePrefixSet(const Json::JSON& jPrefixes) const {
+        Utils::PrefixSet pfxSet;
+        for (const auto& [pfx, attrs] : jPrefixes.items()) {
+            auto pfxRange = ParsePrefixRange(pfx, attrs);
+            if (!pfxRange.has_value()) {
+                return {};
+            }
+
+            if (!pfxSet.Insert(pfxRange.value())) {
+                mLog->warn("Prefix '{}' duplicates the other prefixes of the list", pfx);
+            }
+        }
+
+        return pfxSet;
+    }
+
+private:
+    SharedPtr<Log::SpdLogger> mLog;
+}; // class PrefixListReader
+} // namespace Config
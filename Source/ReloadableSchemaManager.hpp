@@ -0,0 +1,113 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Common.hpp"
+#include "ISchemaManagement.hpp"
+#include "Lib/FileWatcher.hpp"
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+
+#include <functional>
+
+namespace Schema {
+using namespace StdLib;
+/*
+    Schema manager which can be replaced while the server is running. LoadSchema() builds and loads a new schema
+    manager aside the current one, and only if it succeeds (and the new schema is accepted, e.g. it still accepts
+    the running config), the new one is swapped in. Each validation holds its own reference to the manager it
+    has started with, so validations in progress finish against the old schema.
+*/
+class ReloadableSchemaManager : public ISchemaManagement {
+public:
+    using SchemaManagerFactory = std::function<SharedPtr<ISchemaManagement>()>;
+    using SchemaAcceptor = std::function<bool(ISchemaManagement& newSchemaMngr)>;
+
+    ReloadableSchemaManager(SharedPtr<ISchemaManagement> schemaMngr, SchemaManagerFactory schemaMngrFactory, const SharedPtr<ModuleRegistry>& moduleRegistry)
+      : mSchemaMngr(schemaMngr), mSchemaMngrFactory(std::move(schemaMngrFactory)), mModuleRegistry(moduleRegistry), mLog(moduleRegistry->LoggerRegistry()->Logger(Module::Name::SCHEMA_MNGMT)) {}
+    virtual ~ReloadableSchemaManager() {
+        StopWatching();
+    }
+
+    bool LoadSchema() override {
+        // Only one reload at a time, but it does not block validations
+        LockGuard<Mutex> reloadLock(mReloadMutex);
+        auto newSchemaMngr = mSchemaMngrFactory();
+        if (!newSchemaMngr || !newSchemaMngr->LoadSchema()) {
+            mLog->error("Failed to reload the schema. The current schema is still in use");
+            return false;
+        }
+
+        if (mSchemaAcceptor && !mSchemaAcceptor(*newSchemaMngr)) {
+            mLog->error("Failed to reload the schema. Error: The new schema has not been accepted. The current schema is still in use");
+            return false;
+        }
+
+        {
+            LockGuard<Mutex> lock(mSchemaMngrMutex);
+            mSchemaMngr.swap(newSchemaMngr);
+        }
+
+        mLog->info("Reloaded the schema");
+        // The old schema manager is released here, or by the last validation which still uses it
+        return true;
+    }
+
+    bool ValidateData(const ByteStream& data) override {
+        return CurrentSchemaManager()->ValidateData(data);
+    }
+
+    bool ValidateData(const ByteStream& data, String& errors) override {
+        return CurrentSchemaManager()->ValidateData(data, errors);
+    }
+
+    Map<String, uint64_t> Statistics() override {
+        return CurrentSchemaManager()->Statistics();
+    }
+
+    // SetSchemaAcceptor() sets the check which the new schema has to pass before it replaces the current one
+    void SetSchemaAcceptor(SchemaAcceptor schemaAcceptor) {
+        LockGuard<Mutex> reloadLock(mReloadMutex);
+        mSchemaAcceptor = std::move(schemaAcceptor);
+    }
+
+    // StartWatching() reloads the schema (from the watcher thread) whenever any schema file in the directory changes
+    bool StartWatching(const String& dirName) {
+        StopWatching();
+        mFileWatcher = std::make_unique<Utils::FileWatcher>(dirName, SCHEMA_FILE_EXTENSION, [this]() {
+            mLog->info("Schema files in '{}' have changed", mFileWatcher->DirName());
+            LoadSchema();
+        });
+
+        if (!mFileWatcher->Start()) {
+            mLog->error("Failed to watch schema files in '{}'. Error: {}", dirName, mFileWatcher->Error());
+            mFileWatcher.reset();
+            return false;
+        }
+
+        return true;
+    }
+
+    void StopWatching() {
+        mFileWatcher.reset();
+    }
+
+private:
+    static constexpr auto SCHEMA_FILE_EXTENSION = ".json";
+
+    SharedPtr<ISchemaManagement> mSchemaMngr;
+    SchemaManagerFactory mSchemaMngrFactory;
+    SchemaAcceptor mSchemaAcceptor;
+    Mutex mSchemaMngrMutex;
+    Mutex mReloadMutex;
+    UniquePtr<Utils::FileWatcher> mFileWatcher;
+    SharedPtr<ModuleRegistry> mModuleRegistry;
+    SharedPtr<Log::SpdLogger> mLog;
+
+    SharedPtr<ISchemaManagement> CurrentSchemaManager() {
+        LockGuard<Mutex> lock(mSchemaMngrMutex);
+        return mSchemaMngr;
+    }
+}; // class ReloadableSchemaManager
+} // namespace Schema
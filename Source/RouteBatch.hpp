@@ -0,0 +1,249 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/IpAddress.hpp"
+#include "Lib/StdLib.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace Policy {
+using namespace StdLib;
+
+namespace Detail {
+// ParseNumbers() reads exactly N decimal numbers separated by ':' (e.g. '65000:100'), each not greater than its limit
+template<size_t N>
+Optional<std::array<uint32_t, N>> ParseNumbers(StringView text, const std::array<uint32_t, N>& maxValues) {
+    std::array<uint32_t, N> numbers {};
+    for (size_t numberIdx = 0; numberIdx < N; ++numberIdx) {
+        auto numberSize = (numberIdx + 1 < N) ? text.find(':') : text.size();
+        if ((numberSize == StringView::npos) || (numberSize == 0)) {
+            return {};
+        }
+
+        auto [numberEnd, error] = std::from_chars(text.data(), text.data() + numberSize, numbers[numberIdx]);
+        if ((error != std::errc()) || (numberEnd != text.data() + numberSize) || (numbers[numberIdx] > maxValues[numberIdx])) {
+            return {};
+        }
+
+        text.remove_prefix(std::min(numberSize + 1, text.size()));
+    }
+
+    return numbers;
+}
+} // namespace Detail
+
+// Standard community (RFC 1997) written as 'ASN:value'
+struct Community {
+    uint16_t Asn = 0;
+    uint16_t Value = 0;
+
+    static Optional<Community> Parse(const StringView text) {
+        auto numbers = Detail::ParseNumbers<2>(text, { UINT16_MAX, UINT16_MAX });
+        if (!numbers.has_value()) {
+            return {};
+        }
+
+        return Community { static_cast<uint16_t>(numbers.value()[0]), static_cast<uint16_t>(numbers.value()[1]) };
+    }
+
+    String ToString() const { return std::to_string(Asn) + ":" + std::to_string(Value); }
+    auto operator<=>(const Community& other) const = default;
+}; // struct Community
+
+// Extended community (RFC 4360) written as 'type:ASN:value' like in the JSON config
+struct ExtCommunity {
+    uint16_t Type = 0;
+    uint32_t Asn = 0;
+    uint32_t Value = 0;
+
+    static Optional<ExtCommunity> Parse(const StringView text) {
+        auto numbers = Detail::ParseNumbers<3>(text, { UINT16_MAX, UINT32_MAX, UINT32_MAX });
+        if (!numbers.has_value()) {
+            return {};
+        }
+
+        return ExtCommunity { static_cast<uint16_t>(numbers.value()[0]), numbers.value()[1], numbers.value()[2] };
+    }
+
+    String ToString() const { return std::to_string(Type) + ":" + std::to_string(Asn) + ":" + std::to_string(Value); }
+    auto operator<=>(const ExtCommunity& other) const = default;
+}; // struct ExtCommunity
+
+// Large community (RFC 8092) written as 'ASN:local1:local2'
+struct LargeCommunity {
+    uint32_t Asn = 0;
+    uint32_t Local1 = 0;
+    uint32_t Local2 = 0;
+
+    static Optional<LargeCommunity> Parse(const StringView text) {
+        auto numbers = Detail::ParseNumbers<3>(text, { UINT32_MAX, UINT32_MAX, UINT32_MAX });
+        if (!numbers.has_value()) {
+            return {};
+        }
+
+        return LargeCommunity { numbers.value()[0], numbers.value()[1], numbers.value()[2] };
+    }
+
+    String ToString() const { return std::to_string(Asn) + ":" + std::to_string(Local1) + ":" + std::to_string(Local2); }
+    auto operator<=>(const LargeCommunity& other) const = default;
+}; // struct LargeCommunity
+
+enum class SourceProtocol : uint8_t {
+    BGP,
+    STATIC
+};
+
+/*
+    Routes kept column by column: each attribute of all the routes is kept in its own vector. The AS paths and
+    the communities of all the routes are kept in a single vector per attribute, and each route refers to its part
+    by the offset, so the batch of a full Internet table takes a few allocations and evaluation of a policy walks
+    the memory sequentially. AddRoute() starts the route, and the Append*() methods add the attributes to the last
+    route.
+*/
+class RouteBatch {
+public:
+    static constexpr uint32_t DEFAULT_LOCAL_PREFERENCE = 100;
+
+    void Reserve(const size_t routesCount) {
+        mPrefixes.reserve(routesCount);
+        mSourceProtocols.reserve(routesCount);
+        mLocalPreferences.reserve(routesCount);
+        mMeds.reserve(routesCount);
+        mAsPathOffsets.reserve(routesCount);
+        mCommunityOffsets.reserve(routesCount);
+        mExtCommunityOffsets.reserve(routesCount);
+        mLargeCommunityOffsets.reserve(routesCount);
+    }
+
+    void Clear() { *this = RouteBatch(); }
+
+    // Join() concatenates the batches (e.g. of the chunks read by many threads) in their order. The memory is reserved once
+    static RouteBatch Join(Vector<RouteBatch>& batches) {
+        RouteBatch joined;
+        joined.ReserveColumn(&RouteBatch::mPrefixes, batches);
+        joined.ReserveColumn(&RouteBatch::mSourceProtocols, batches);
+        joined.ReserveColumn(&RouteBatch::mLocalPreferences, batches);
+        joined.ReserveColumn(&RouteBatch::mMeds, batches);
+        joined.ReserveColumn(&RouteBatch::mAsPathOffsets, batches);
+        joined.ReserveColumn(&RouteBatch::mCommunityOffsets, batches);
+        joined.ReserveColumn(&RouteBatch::mExtCommunityOffsets, batches);
+        joined.ReserveColumn(&RouteBatch::mLargeCommunityOffsets, batches);
+        joined.ReserveColumn(&RouteBatch::mAsPaths, batches);
+        joined.ReserveColumn(&RouteBatch::mCommunities, batches);
+        joined.ReserveColumn(&RouteBatch::mExtCommunities, batches);
+        joined.ReserveColumn(&RouteBatch::mLargeCommunities, batches);
+        for (auto& batch : batches) {
+            joined.Append(batch);
+            batch.Clear();
+        }
+
+        return joined;
+    }
+
+    // Append() adds all the routes of the other batch after the routes of this batch
+    void Append(const RouteBatch& other) {
+        Concat(mPrefixes, other.mPrefixes);
+        Concat(mSourceProtocols, other.mSourceProtocols);
+        Concat(mLocalPreferences, other.mLocalPreferences);
+        Concat(mMeds, other.mMeds);
+        ConcatOffsets(mAsPathOffsets, other.mAsPathOffsets, mAsPaths.size());
+        ConcatOffsets(mCommunityOffsets, other.mCommunityOffsets, mCommunities.size());
+        ConcatOffsets(mExtCommunityOffsets, other.mExtCommunityOffsets, mExtCommunities.size());
+        ConcatOffsets(mLargeCommunityOffsets, other.mLargeCommunityOffsets, mLargeCommunities.size());
+        Concat(mAsPaths, other.mAsPaths);
+        Concat(mCommunities, other.mCommunities);
+        Concat(mExtCommunities, other.mExtCommunities);
+        Concat(mLargeCommunities, other.mLargeCommunities);
+    }
+
+    size_t AddRoute(const Utils::IpPrefix& prefix, const SourceProtocol sourceProtocol = SourceProtocol::BGP) {
+        mPrefixes.push_back(prefix);
+        mSourceProtocols.push_back(sourceProtocol);
+        mLocalPreferences.push_back(DEFAULT_LOCAL_PREFERENCE);
+        mMeds.push_back(0);
+        mAsPathOffsets.push_back(static_cast<uint32_t>(mAsPaths.size()));
+        mCommunityOffsets.push_back(static_cast<uint32_t>(mCommunities.size()));
+        mExtCommunityOffsets.push_back(static_cast<uint32_t>(mExtCommunities.size()));
+        mLargeCommunityOffsets.push_back(static_cast<uint32_t>(mLargeCommunities.size()));
+        return mPrefixes.size() - 1;
+    }
+
+    void SetLocalPreference(const uint32_t localPreference) { mLocalPreferences.back() = localPreference; }
+    void SetMed(const uint32_t med) { mMeds.back() = med; }
+    void AppendAsn(const uint32_t asn) { mAsPaths.push_back(asn); }
+    void AppendCommunity(const Community& community) { mCommunities.push_back(community); }
+    void AppendExtCommunity(const ExtCommunity& extCommunity) { mExtCommunities.push_back(extCommunity); }
+    void AppendLargeCommunity(const LargeCommunity& largeCommunity) { mLargeCommunities.push_back(largeCommunity); }
+
+    size_t Size() const { return mPrefixes.size(); }
+    bool IsEmpty() const { return mPrefixes.empty(); }
+
+    const Utils::IpPrefix& Prefix(const size_t routeIdx) const { return mPrefixes[routeIdx]; }
+    SourceProtocol Source(const size_t routeIdx) const { return mSourceProtocols[routeIdx]; }
+    uint32_t LocalPreference(const size_t routeIdx) const { return mLocalPreferences[routeIdx]; }
+    uint32_t Med(const size_t routeIdx) const { return mMeds[routeIdx]; }
+    std::span<const uint32_t> AsPath(const size_t routeIdx) const { return Part(mAsPaths, mAsPathOffsets, routeIdx); }
+    std::span<const Community> Communities(const size_t routeIdx) const { return Part(mCommunities, mCommunityOffsets, routeIdx); }
+    std::span<const ExtCommunity> ExtCommunities(const size_t routeIdx) const { return Part(mExtCommunities, mExtCommunityOffsets, routeIdx); }
+    std::span<const LargeCommunity> LargeCommunities(const size_t routeIdx) const { return Part(mLargeCommunities, mLargeCommunityOffsets, routeIdx); }
+
+    size_t MemoryBytes() const {
+        return sizeof(*this) + mPrefixes.capacity() * sizeof(Utils::IpPrefix) + mSourceProtocols.capacity() * sizeof(SourceProtocol)
+            + (mLocalPreferences.capacity() + mMeds.capacity()) * sizeof(uint32_t)
+            + (mAsPathOffsets.capacity() + mCommunityOffsets.capacity() + mExtCommunityOffsets.capacity() + mLargeCommunityOffsets.capacity()) * sizeof(uint32_t)
+            + mAsPaths.capacity() * sizeof(uint32_t) + mCommunities.capacity() * sizeof(Community)
+            + mExtCommunities.capacity() * sizeof(ExtCommunity) + mLargeCommunities.capacity() * sizeof(LargeCommunity);
+    }
+
+private:
+    Vector<Utils::IpPrefix> mPrefixes;
+    Vector<SourceProtocol> mSourceProtocols;
+    Vector<uint32_t> mLocalPreferences;
+    Vector<uint32_t> mMeds;
+    // Offset of the first entry of each route, the route ends where the next one begins
+    Vector<uint32_t> mAsPathOffsets;
+    Vector<uint32_t> mCommunityOffsets;
+    Vector<uint32_t> mExtCommunityOffsets;
+    Vector<uint32_t> mLargeCommunityOffsets;
+    Vector<uint32_t> mAsPaths;
+    Vector<Community> mCommunities;
+    Vector<ExtCommunity> mExtCommunities;
+    Vector<LargeCommunity> mLargeCommunities;
+
+    template<typename T>
+    static std::span<const T> Part(const Vector<T>& entries, const Vector<uint32_t>& offsets, const size_t routeIdx) {
+        auto endOffset = (routeIdx + 1 < offsets.size()) ? offsets[routeIdx + 1] : entries.size();
+        return std::span<const T>(entries.data() + offsets[routeIdx], entries.data() + endOffset);
+    }
+
+    template<typename T>
+    void ReserveColumn(Vector<T> RouteBatch::*column, const Vector<RouteBatch>& batches) {
+        auto entriesCount = (this->*column).size();
+        for (const auto& batch : batches) {
+            entriesCount += (batch.*column).size();
+        }
+
+        (this->*column).reserve(entriesCount);
+    }
+
+    template<typename T>
+    static void Concat(Vector<T>& entries, const Vector<T>& otherEntries) {
+        entries.insert(entries.end(), otherEntries.begin(), otherEntries.end());
+    }
+
+    static void ConcatOffsets(Vector<uint32_t>& offsets, const Vector<uint32_t>& otherOffsets, const size_t entriesCount) {
+        offsets.reserve(offsets.size() + otherOffsets.size());
+        for (const auto offset : otherOffsets) {
+            offsets.push_back(static_cast<uint32_t>(entriesCount + offset));
+        }
+    }
+}; // class RouteBatch
+} // namespace Policy
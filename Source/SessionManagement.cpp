@@ -43,6 +43,7 @@ SessionManager::SessionManager(const std::chrono::seconds session_timeout_sec, S
 
                 LockGuard<Mutex> __(_session_token_mutex);
                 _leased_session_tokens.erase(session_token);
+                _sessions_active.Set(_leased_session_tokens.size());
             }
 
             expired_session_token.clear();
@@ -77,7 +78,9 @@ SessionManager::SessionManager(const std::chrono::seconds session_timeout_sec, S
             std::this_thread::sleep_for(5s);
         }
     } },
-    _module_registry(module_registry), _log(module_registry->LoggerRegistry()->Logger(Module::Name::SESSION_MNGMT)) {
+    _module_registry(module_registry), _log(module_registry->LoggerRegistry()->Logger(Module::Name::SESSION_MNGMT)),
+    _sessions_created(module_registry->Metrics()->GetCounter("bgp_config_api_sessions_created_total", "Number of the session tokens registered")),
+    _sessions_active(module_registry->Metrics()->GetGauge("bgp_config_api_sessions_active", "Number of the session tokens leased now")) {
     _checking_session_expiration_thread.detach();
 }
 
@@ -86,6 +89,7 @@ SessionManager::~SessionManager() {
 }
 
 bool SessionManager::RegisterSessionToken(const Http::Request &req, Http::Response &res) {
+    Tracing::ScopedSpan span(*_module_registry->Tracer(), "SessionManager::RegisterSessionToken");
     LockGuard<Mutex> _(_session_token_mutex);
     if (_leased_session_tokens.find(req.body) != _leased_session_tokens.end()) {
         res.status = HTTP::StatusCode::CONFLICT; // Resource already exists
@@ -94,12 +98,15 @@ bool SessionManager::RegisterSessionToken(const Http::Request &req, Http::Respon
 
     auto now = std::chrono::system_clock::now();
     _leased_session_tokens[req.body] = SessionDetails { now, now };
+    _sessions_created.Increment();
+    _sessions_active.Set(_leased_session_tokens.size());
     _log->info("Registered new session token '{}'", req.body);
     res.status = HTTP::StatusCode::CREATED;
     return true;
 }
 
 bool SessionManager::CheckSessionToken(const Http::Request &req, Http::Response &res) {
+    Tracing::ScopedSpan span(*_module_registry->Tracer(), "SessionManager::CheckSessionToken");
     auto session_token = GetSessionTokenHelper(req);
     if (!session_token.has_value()) {
         res.status = HTTP::StatusCode::TOKEN_REQUIRED;
@@ -119,6 +126,7 @@ bool SessionManager::CheckSessionToken(const Http::Request &req, Http::Response
 };
 
 bool SessionManager::SetActiveSessionToken(const Http::Request &req, Http::Response &res) {
+    Tracing::ScopedSpan span(*_module_registry->Tracer(), "SessionManager::SetActiveSessionToken");
     if (!CheckSessionToken(req, res)) {
         return false;
     }
@@ -138,6 +146,7 @@ bool SessionManager::SetActiveSessionToken(const Http::Request &req, Http::Respo
 };
 
 bool SessionManager::CheckActiveSessionToken(const Http::Request &req, Http::Response &res) {
+    Tracing::ScopedSpan span(*_module_registry->Tracer(), "SessionManager::CheckActiveSessionToken");
     auto session_token = GetSessionTokenHelper(req);
     if (!session_token.has_value()) {
         res.status = HTTP::StatusCode::TOKEN_REQUIRED;
@@ -162,6 +171,7 @@ bool SessionManager::CheckActiveSessionToken(const Http::Request &req, Http::Res
 };
 
 bool SessionManager::RemoveSessionToken(const Http::Request &req, Http::Response &res) {
+    Tracing::ScopedSpan span(*_module_registry->Tracer(), "SessionManager::RemoveSessionToken");
     if (!CheckSessionToken(req, res)) {
         return false;
     }
@@ -171,6 +181,7 @@ bool SessionManager::RemoveSessionToken(const Http::Request &req, Http::Response
 
     LockGuard<Mutex> _(_session_token_mutex);
     _leased_session_tokens.erase(session_token.value());
+    _sessions_active.Set(_leased_session_tokens.size());
     _log->info("Successfully removed session token '{}'", session_token.value());
     if (_active_session_token.has_value() && (session_token.value() == _active_session_token)) {
         _log->info("Removed active session token '{}'", session_token.value());
@@ -230,6 +241,18 @@ Optional<String> SessionManager::GetSessionTokenHelper(const Http::Request &req)
     return auth.substr(std::strlen(HTTP::Header::Tokens::BEARER) + 1);
 }
 
+Optional<String> SessionManager::PeekSessionToken(const Http::Request &req) {
+    String auth = req.get_header_value(HTTP::Header::Tokens::AUTHORIZATION);
+    Utils::fTrim(auth);
+    // Authorization: Bearer TOKEN
+    auto token_pos = std::strlen(HTTP::Header::Tokens::BEARER) + 1;
+    if ((auth.size() <= token_pos) || !auth.starts_with(HTTP::Header::Tokens::BEARER)) {
+        return {};
+    }
+
+    return auth.substr(token_pos);
+}
+
 Optional<String> SessionManager::GetActiveSessionToken() {
     return _active_session_token;
 }
@@ -37,6 +37,8 @@ public:
 
     Std::Optional<Std::String> GetSessionToken(const Http::Request &req);
     Std::Optional<Std::String> GetActiveSessionToken();
+    // PeekSessionToken() returns the token given by the request as it is, i.e. neither checked nor logged when missing
+    static Std::Optional<Std::String> PeekSessionToken(const Http::Request &req);
 
     bool RegisterSessionTimeoutCallback(const Std::String& callback_receiver, SessionTimeoutCB session_timeout_cb);
     void RemoveSessionTimeoutCallback(const Std::String& callback_receiver);
@@ -69,6 +71,8 @@ private:
     Std::Mutex _session_token_timers_mutex;
     const Std::SharedPtr<ModuleRegistry> _module_registry;
     Std::SharedPtr<Log::SpdLogger> _log;
+    Metrics::Counter& _sessions_created;
+    Metrics::Gauge& _sessions_active;
 
     Std::Optional<Std::String> GetSessionTokenHelper(const Http::Request &req);
 };
@@ -0,0 +1,38 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#include "Test/IpAddressTest.hpp"
+#include "Test/PolicyMatchersTest.hpp"
+#include "Test/PrefixSetTest.hpp"
+#include "Test/SchemaValidationTest.hpp"
+#include "Test/TimerServiceTest.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace Std = StdLib;
+
+// Benchmarks are not the part of the self-tests, since their results depend on the machine. Run them by hand
+// (optionally with the names of the benchmarks to run)
+int main(const int argc, const char* argv[]) {
+    const Std::Vector<Std::Pair<Std::String, std::function<void()>>> benchmarks = {
+        { "ParseIPv4", Utils::Test::BenchmarkParseIPv4 },
+        { "AsnSetMatcher", Policy::Test::BenchmarkAsnSetMatcher },
+        { "PrefixListMemory", Utils::Test::BenchmarkPrefixListMemory },
+        { "ValidateData", Schema::Test::BenchmarkValidateData },
+        { "TimerService", Utils::Test::BenchmarkTimerService },
+    };
+
+    for (const auto& [name, benchmark] : benchmarks) {
+        if ((argc > 1) && (std::find(argv + 1, argv + argc, name) == argv + argc)) {
+            continue;
+        }
+
+        benchmark();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "BirdConfigConverter.hpp"
+#include "Lib/ModuleRegistry.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace Config::Test {
+using namespace StdLib;
+
+// ConvertBgpConfig() converts the config of the given BGP section into BIRD config, empty one if the conversion fails
+inline String ConvertBgpConfig(BirdConfigConverter& converter, const String& bgpConfigText) {
+    auto configText = R"({ "router-id": "192.0.2.1", "bgp": )" + bgpConfigText + " }";
+    auto birdConfig = converter.Convert(ByteStream(configText.begin(), configText.end()));
+    return birdConfig.has_value() ? String(birdConfig.value().begin(), birdConfig.value().end()) : String();
+}
+
+// IsRendered() checks that all the parts are in the BIRD config, and logs the missing ones
+inline bool IsRendered(const String& birdConfig, const Vector<String>& expectedParts) {
+    bool isRendered = true;
+    for (const auto& expectedPart : expectedParts) {
+        if (birdConfig.find(expectedPart) == String::npos) {
+            SPDLOG_ERROR("BIRD config does not have '{}':\n{}", expectedPart, birdConfig);
+            isRendered = false;
+        }
+    }
+
+    return isRendered;
+}
+
+/*
+    Named prefix lists are built once per converted config and rendered sorted, with the duplicated ranges merged.
+    The lists of the previous config must not leak into the next one, and the references to the lists are checked
+    against the lists of the family.
+*/
+inline bool RenderPrefixLists() {
+    SPDLOG_INFO("[TEST] Render the named and in-place prefix lists of the BGP config");
+    SPDLOG_INFO("[BEGIN]");
+    BirdConfigConverter converter(std::make_shared<ModuleRegistry>());
+    bool isPassed = true;
+    auto birdConfig = ConvertBgpConfig(converter, R"({
+        "prefix-v4-list": { "PL4": { "10.1.0.0/16": {}, "10.0.0.0/8": { "le": 24 }, "192.0.2.0/24": { "ge": 25, "le": 26 } } },
+        "prefix-v6-list": { "PL6": { "2001:db8::/32": {} } },
+        "policy-list": { "P1": {
+            "term-10": { "if-match": { "net-in": { "prefix-v4-list": "PL4" } }, "then": { "action": "permit" } },
+            "term-20": { "if-match": { "net-in": { "prefix-v4": { "198.51.100.0/24": {}, "192.0.2.0/24": {} } } }, "then": { "action": "deny" } } } },
+        "sessions": {}
+    })");
+    isPassed = IsRendered(birdConfig, {
+        "define PL4 = [\n    10.0.0.0/8{8,24},\n    10.1.0.0/16,\n    192.0.2.0/24{25,26}\n];",
+        "define PL6 = [\n    2001:db8::/32\n];",
+        "if ((net ~ PL4)) then {",
+        "if ((net ~ [192.0.2.0/24,198.51.100.0/24])) then {",
+    }) && isPassed;
+
+    birdConfig = ConvertBgpConfig(converter, R"({ "prefix-v4-list": { "PL5": { "203.0.113.0/24": {} } }, "sessions": {} })");
+    isPassed = IsRendered(birdConfig, { "define PL5 = [\n    203.0.113.0/24\n];" }) && isPassed;
+    if (birdConfig.find("PL4") != String::npos) {
+        SPDLOG_ERROR("Prefix list of the previous config is rendered:\n{}", birdConfig);
+        isPassed = false;
+    }
+
+    const Vector<Pair<String, String>> invalidConfigs = {
+        { "invalid prefix", R"({ "prefix-v4-list": { "PL4": { "10.0.0.0/33": {} } }, "sessions": {} })" },
+        { "list name taken by the other family", R"({ "prefix-v4-list": { "PL": {} }, "prefix-v6-list": { "PL": {} }, "sessions": {} })" },
+        { "reference to the list of the other family", R"({
+            "prefix-v6-list": { "PL6": { "2001:db8::/32": {} } },
+            "policy-list": { "P1": { "term-10": { "if-match": { "net-in": { "prefix-v4-list": "PL6" } }, "then": { "action": "permit" } } } },
+            "sessions": {}
+        })" },
+    };
+
+    for (const auto& [name, bgpConfigText] : invalidConfigs) {
+        if (!ConvertBgpConfig(converter, bgpConfigText).empty()) {
+            SPDLOG_ERROR("Config with the {} is converted", name);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// The 'default-action' entry of the policy is not a term, but the statement which ends the filter
+inline bool RenderPolicyDefaultAction() {
+    SPDLOG_INFO("[TEST] End the rendered filters with the default action of the policy");
+    SPDLOG_INFO("[BEGIN]");
+    BirdConfigConverter converter(std::make_shared<ModuleRegistry>());
+    auto birdConfig = ConvertBgpConfig(converter, R"({
+        "policy-list": {
+            "PERMIT_POLICY": {
+                "term-10": { "if-match": { "net-in": { "prefix-v4": { "192.0.2.0/24": {} } } }, "then": { "action": "deny" } },
+                "default-action": "permit"
+            },
+            "DENY_POLICY": {
+                "term-10": { "if-match": { "net-in": { "prefix-v4": { "192.0.2.0/24": {} } } }, "then": { "action": "permit" } },
+                "default-action": "deny"
+            },
+            "IMPLICIT_POLICY": {
+                "term-10": { "if-match": { "net-in": { "prefix-v4": { "192.0.2.0/24": {} } } }, "then": { "action": "permit" } }
+            }
+        },
+        "sessions": {}
+    })");
+
+    bool isPassed = IsRendered(birdConfig, {
+        "filter PERMIT_POLICY {\n    if ((net ~ [192.0.2.0/24])) then {\n        reject;\n    }\n    accept;\n}",
+        "filter DENY_POLICY {\n    if ((net ~ [192.0.2.0/24])) then {\n        accept;\n    }\n    reject;\n}",
+        "filter IMPLICIT_POLICY {\n    if ((net ~ [192.0.2.0/24])) then {\n        accept;\n    }\n    reject;\n}",
+    });
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// The large-community conditions are rendered for the named lists and the in-place ones, as the simulator evaluates them
+inline bool RenderLargeCommunityConditions() {
+    SPDLOG_INFO("[TEST] Render the large-community conditions of the named and in-place lists");
+    SPDLOG_INFO("[BEGIN]");
+    BirdConfigConverter converter(std::make_shared<ModuleRegistry>());
+    auto birdConfig = ConvertBgpConfig(converter, R"({
+        "large-community-list": { "LCL": [ "65000:1:1", "65000:1:2" ] },
+        "policy-list": { "P1": {
+            "term-10": { "if-match": { "large-community-in": { "large-community-list": "LCL" } }, "then": { "action": "deny" } },
+            "term-20": { "if-match": { "large-community-eq": [ "65000:2:1", "65000:2:2" ] }, "then": { "action": "permit" } },
+            "term-30": { "if-match": { "large-community-in": [ "65000:3:1" ], "net-in": { "prefix-v4": { "192.0.2.0/24": {} } } }, "then": { "action": "permit" } } } },
+        "sessions": {}
+    })");
+    bool isPassed = IsRendered(birdConfig, {
+        "define LCL = [(65000,1,1),(65000,1,2)];",
+        "if ((bgp_large_community ~ LCL)) then {",
+        "if ((bgp_large_community = [(65000,2,1),(65000,2,2)])) then {",
+        "if ((bgp_large_community ~ [(65000,3,1)]) && (net ~ [192.0.2.0/24])) then {",
+    });
+
+    const Vector<Pair<String, String>> invalidConfigs = {
+        { "reference to the missing list", R"({
+            "large-community-list": { "LCL": [ "65000:1:1" ] },
+            "policy-list": { "P1": { "term-10": { "if-match": { "large-community-in": { "large-community-list": "MISSING" } }, "then": { "action": "deny" } } } },
+            "sessions": {}
+        })" },
+        { "empty in-place list", R"({
+            "policy-list": { "P1": { "term-10": { "if-match": { "large-community-eq": [] }, "then": { "action": "deny" } } } },
+            "sessions": {}
+        })" },
+    };
+
+    for (const auto& [name, bgpConfigText] : invalidConfigs) {
+        if (!ConvertBgpConfig(converter, bgpConfigText).empty()) {
+            SPDLOG_ERROR("Config with the {} is converted", name);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Config::Test
@@ -0,0 +1,117 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "ConfigChangeClassifier.hpp"
+#include "Lib/ModuleRegistry.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <functional>
+
+namespace Config::Test {
+using namespace StdLib;
+
+// LoadedBgpConfig() makes the sessions using the policies, which use the lists: S1 uses P1 (PL1) and P2 (CL1), S2 uses
+// P2 only, and S3 no policy, while P3 (PL2) is not used by any session
+inline Json::JSON LoadedBgpConfig() {
+    return Json::JSON::parse(R"({
+        "log-level": "info",
+        "bgp": {
+            "as": 65000,
+            "prefix-v4-list": {
+                "PL1": [ { "prefix": "10.0.0.0/8", "le": 24 } ],
+                "PL2": [ { "prefix": "192.168.0.0/16" } ]
+            },
+            "community-list": { "CL1": [ "65000:1" ] },
+            "policy-list": {
+                "P1": { "10": { "if-match": { "prefix-v4-list": "PL1" }, "action": "accept" } },
+                "P2": { "10": { "if-match": { "community-list": "CL1" }, "action": "reject" } },
+                "P3": { "10": { "if-match": { "prefix-v4-list": "PL2" }, "action": "accept" } }
+            },
+            "sessions": {
+                "S1": { "remote-as": 65001, "address-family": { "ipv4-unicast": { "policy-in": "P1", "policy-out": "P2" } } },
+                "S2": { "remote-as": 65002, "address-family": { "ipv4-unicast": { "policy-in": "P2" } } },
+                "S3": { "remote-as": 65003, "address-family": { "ipv4-unicast": {} } }
+            }
+        }
+    })");
+}
+
+/*
+    Each change of the loaded config is classified by the most disruptive kind it contains, and the changed lists and
+    policies mark the sessions which use them (through the policies), except for the added sessions.
+*/
+inline bool ClassifyConfigChanges() {
+    SPDLOG_INFO("[TEST] Classify the config changes and find the sessions with the changed filters");
+    SPDLOG_INFO("[BEGIN]");
+    using Kind = Executing::ConfigChange::Kind;
+    struct Case {
+        String Name;
+        std::function<void(Json::JSON& jConfig)> Change;
+        Kind ExpectedKind;
+        Vector<String> ExpectedSessions;
+    };
+
+    const Vector<Case> cases = {
+        { "no change", [](Json::JSON&) {}, Kind::NONE, {} },
+        { "prefix list of the policy-in", [](Json::JSON& jConfig) { jConfig["bgp"]["prefix-v4-list"]["PL1"][0]["le"] = 32; }, Kind::FILTER_ONLY, { "S1" } },
+        { "community list of the policy of two sessions", [](Json::JSON& jConfig) { jConfig["bgp"]["community-list"]["CL1"].push_back("65000:2"); },
+            Kind::FILTER_ONLY, { "S1", "S2" } },
+        { "list of the unused policy", [](Json::JSON& jConfig) { jConfig["bgp"]["prefix-v4-list"]["PL2"].clear(); }, Kind::FILTER_ONLY, {} },
+        { "added list", [](Json::JSON& jConfig) { jConfig["bgp"]["prefix-v4-list"]["PL3"] = Json::JSON::array(); }, Kind::FILTER_ONLY, {} },
+        { "policy", [](Json::JSON& jConfig) { jConfig["bgp"]["policy-list"]["P1"]["10"]["action"] = "reject"; }, Kind::FILTER_ONLY, { "S1" } },
+        { "policy referring to another list", [](Json::JSON& jConfig) { jConfig["bgp"]["policy-list"]["P3"]["10"]["if-match"]["prefix-v4-list"] = "PL1"; },
+            Kind::FILTER_ONLY, {} },
+        { "policy of the session", [](Json::JSON& jConfig) { jConfig["bgp"]["sessions"]["S2"]["address-family"]["ipv4-unicast"]["policy-in"] = "P1"; },
+            Kind::FILTER_ONLY, { "S2" } },
+        { "added policy of the session", [](Json::JSON& jConfig) { jConfig["bgp"]["sessions"]["S3"]["address-family"]["ipv4-unicast"]["policy-out"] = "P3"; },
+            Kind::FILTER_ONLY, { "S3" } },
+        { "session attribute", [](Json::JSON& jConfig) { jConfig["bgp"]["sessions"]["S2"]["remote-as"] = 65102; }, Kind::SESSION_ATTRIBUTE, {} },
+        { "session attribute and list", [](Json::JSON& jConfig) {
+                jConfig["bgp"]["sessions"]["S3"]["remote-as"] = 65103;
+                jConfig["bgp"]["prefix-v4-list"]["PL1"].clear();
+            }, Kind::SESSION_ATTRIBUTE, { "S1" } },
+        { "added session and list", [](Json::JSON& jConfig) {
+                jConfig["bgp"]["sessions"]["S4"] = jConfig["bgp"]["sessions"]["S1"];
+                jConfig["bgp"]["prefix-v4-list"]["PL1"].clear();
+            }, Kind::SESSION_SET, { "S1" } },
+        { "removed session", [](Json::JSON& jConfig) { jConfig["bgp"]["sessions"].erase("S2"); }, Kind::SESSION_SET, {} },
+        { "removed session and its policy", [](Json::JSON& jConfig) {
+                jConfig["bgp"]["sessions"].erase("S1");
+                jConfig["bgp"]["policy-list"]["P1"]["10"]["action"] = "reject";
+            }, Kind::SESSION_SET, {} },
+        { "BGP attribute", [](Json::JSON& jConfig) { jConfig["bgp"]["as"] = 65100; }, Kind::GLOBAL, {} },
+        { "global attribute and list", [](Json::JSON& jConfig) {
+                jConfig["log-level"] = "debug";
+                jConfig["bgp"]["prefix-v4-list"]["PL1"].clear();
+            }, Kind::GLOBAL, {} },
+    };
+
+    ConfigChangeClassifier classifier(std::make_shared<ModuleRegistry>());
+    auto jLoadedConfig = LoadedBgpConfig();
+    bool isPassed = true;
+    for (const auto& [name, makeChange, expectedKind, expectedSessions] : cases) {
+        auto jNewConfig = jLoadedConfig;
+        makeChange(jNewConfig);
+        auto change = classifier.Classify(jLoadedConfig, jNewConfig);
+        if ((change.ChangeKind != expectedKind) || (change.FilterChangedSessions != expectedSessions)) {
+            SPDLOG_ERROR("Change of the {} is classified as {} with sessions [{}] instead of {} with [{}]", name, static_cast<int>(change.ChangeKind),
+                fmt::join(change.FilterChangedSessions, ", "), static_cast<int>(expectedKind), fmt::join(expectedSessions, ", "));
+            isPassed = false;
+        }
+    }
+
+    auto loadedConfigData = jLoadedConfig.dump();
+    const String malformedConfigData = "{ \"bgp\": ";
+    auto change = classifier.Classify(ByteStream(loadedConfigData.begin(), loadedConfigData.end()), ByteStream(malformedConfigData.begin(), malformedConfigData.end()));
+    if (change.ChangeKind != Kind::GLOBAL) {
+        SPDLOG_ERROR("Change into the malformed config is classified as {} instead of the global one", static_cast<int>(change.ChangeKind));
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Config::Test
@@ -0,0 +1,208 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "FanOutConfigExecutor.hpp"
+#include "Lib/ModuleRegistry.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace Config::Test {
+using namespace StdLib;
+
+// Storage which only names the target config, as the fake executors do not read it
+class NamedStorage : public Storage::IDataStorage {
+public:
+    explicit NamedStorage(const String& uri) : IDataStorage(uri) {}
+
+    Optional<ByteStream> LoadData() override { return ByteStream(); }
+    bool SaveData([[maybe_unused]] const ByteStream& data) override { return true; }
+};
+
+/*
+    Meeting point of the operations run on all the instances. Each arrival waits for the other instances of the same
+    round, so the arrival sees the whole round only if the operations run at once, and times out if they run one by one.
+*/
+class Rendezvous {
+public:
+    explicit Rendezvous(const size_t instancesCount) : mInstancesCount(instancesCount) {}
+
+    bool Arrive() {
+        UniqueLock<Mutex> lock(mMutex);
+        const size_t roundEnd = (mArrivalsCount / mInstancesCount + 1) * mInstancesCount;
+        ++mArrivalsCount;
+        mArrived.notify_all();
+        return mArrived.wait_for(lock, std::chrono::seconds(2), [this, roundEnd]() { return mArrivalsCount >= roundEnd; });
+    }
+
+private:
+    const size_t mInstancesCount;
+    Mutex mMutex;
+    ConditionVariable mArrived;
+    size_t mArrivalsCount = 0;
+};
+
+// Executor of the single instance whose operations end as set by the test, and which counts its rollbacks
+class FakeConfigExecutor : public Executing::IConfigExecuting {
+public:
+    enum class Outcome { SUCCEED, FAIL, THROW };
+
+    FakeConfigExecutor(const String& configUri, Rendezvous& rendezvous) : IConfigExecuting(std::make_shared<NamedStorage>(configUri)), mRendezvous(rendezvous) {}
+
+    bool Validate() override { return Run(ValidateOutcome); }
+    bool Load() override { return Run(LoadOutcome); }
+    bool Load(const Executing::ConfigChange& change) override {
+        LoadedChangeKind = change.ChangeKind;
+        return Run(LoadOutcome);
+    }
+
+    bool Rollback(const SharedPtr<Storage::IDataStorage> backupConfig) override {
+        ++RollbacksCount;
+        RollbackConfigURI = backupConfig->URI();
+        return RollbackOutcome == Outcome::SUCCEED;
+    }
+
+    Outcome ValidateOutcome = Outcome::SUCCEED;
+    Outcome LoadOutcome = Outcome::SUCCEED;
+    Outcome RollbackOutcome = Outcome::SUCCEED;
+    bool IsRunConcurrently = true;
+    size_t RollbacksCount = 0;
+    String RollbackConfigURI;
+    Optional<Executing::ConfigChange::Kind> LoadedChangeKind;
+
+private:
+    Rendezvous& mRendezvous;
+
+    bool Run(const Outcome outcome) {
+        IsRunConcurrently = mRendezvous.Arrive() && IsRunConcurrently;
+        if (outcome == Outcome::THROW) {
+            throw std::runtime_error("Instance is not reachable");
+        }
+
+        return outcome == Outcome::SUCCEED;
+    }
+};
+
+/*
+    The config is validated and loaded on all the instances at once. When the load fails or throws on any instance,
+    exactly the instances which have loaded the config are rolled back, to the config of the fan-out executor.
+    Exceptions of the instances, thrown by the spawned threads and the calling one, fail the operation.
+*/
+inline bool LoadConfigOnAllInstances() {
+    SPDLOG_INFO("[TEST] Validate and load the config on all the instances, and roll back the loaded ones on failure");
+    SPDLOG_INFO("[BEGIN]");
+    using Outcome = FakeConfigExecutor::Outcome;
+    static constexpr size_t INSTANCES_COUNT = 3;
+    struct Case {
+        String Name;
+        Vector<Outcome> ValidateOutcomes;
+        Vector<Outcome> LoadOutcomes;
+        bool ExpectedResult;
+        Vector<size_t> ExpectedRollbacksCounts;
+    };
+
+    const auto S = Outcome::SUCCEED;
+    const auto F = Outcome::FAIL;
+    const auto T = Outcome::THROW;
+    const Vector<Case> cases = {
+        { "loaded on all", { S, S, S }, { S, S, S }, true, { 0, 0, 0 } },
+        { "load failed on the middle instance", { S, S, S }, { S, F, S }, false, { 1, 0, 1 } },
+        { "load thrown by the spawned thread", { S, S, S }, { T, S, S }, false, { 0, 1, 1 } },
+        { "load thrown by the calling thread", { S, S, S }, { S, S, T }, false, { 1, 1, 0 } },
+        { "load failed on all", { S, S, S }, { F, T, F }, false, { 0, 0, 0 } },
+        { "validation failed", { S, F, S }, { S, S, S }, false, { 0, 0, 0 } },
+        { "validation thrown", { S, S, T }, { S, S, S }, false, { 0, 0, 0 } },
+    };
+
+    bool isPassed = true;
+    for (const auto& [name, validateOutcomes, loadOutcomes, expectedResult, expectedRollbacksCounts] : cases) {
+        Rendezvous rendezvous(INSTANCES_COUNT);
+        Vector<SharedPtr<FakeConfigExecutor>> fakeExecutors;
+        Vector<SharedPtr<Executing::IConfigExecuting>> executors;
+        for (size_t instanceIdx = 0; instanceIdx < INSTANCES_COUNT; ++instanceIdx) {
+            fakeExecutors.push_back(std::make_shared<FakeConfigExecutor>(fmt::format("bird-{}.conf", instanceIdx), rendezvous));
+            fakeExecutors.back()->ValidateOutcome = validateOutcomes[instanceIdx];
+            fakeExecutors.back()->LoadOutcome = loadOutcomes[instanceIdx];
+            executors.push_back(fakeExecutors.back());
+        }
+
+        Executing::FanOutConfigExecutor fanOutExecutor(std::make_shared<NamedStorage>("bird.conf"), executors, std::make_shared<ModuleRegistry>());
+        // The config is loaded only if it is valid on all the instances, as the config server does
+        const bool result = fanOutExecutor.Validate() && fanOutExecutor.Load(Executing::ConfigChange { Executing::ConfigChange::Kind::FILTER_ONLY, { "S1" } });
+        if (result != expectedResult) {
+            SPDLOG_ERROR("Fan-out with the {} ends with {} instead of {}", name, result, expectedResult);
+            isPassed = false;
+        }
+
+        for (size_t instanceIdx = 0; instanceIdx < INSTANCES_COUNT; ++instanceIdx) {
+            const auto& fakeExecutor = *fakeExecutors[instanceIdx];
+            if (fakeExecutor.RollbacksCount != expectedRollbacksCounts[instanceIdx]) {
+                SPDLOG_ERROR("Fan-out with the {} rolls back instance #{} {} time(s) instead of {}", name, instanceIdx, fakeExecutor.RollbacksCount,
+                    expectedRollbacksCounts[instanceIdx]);
+                isPassed = false;
+            }
+
+            if ((fakeExecutor.RollbacksCount > 0) && (fakeExecutor.RollbackConfigURI != "bird.conf")) {
+                SPDLOG_ERROR("Fan-out with the {} rolls back instance #{} to '{}'", name, instanceIdx, fakeExecutor.RollbackConfigURI);
+                isPassed = false;
+            }
+
+            if (!fakeExecutor.IsRunConcurrently) {
+                SPDLOG_ERROR("Fan-out with the {} runs the operations of instance #{} not at once with the other instances", name, instanceIdx);
+                isPassed = false;
+            }
+
+            const bool isLoaded = fakeExecutor.LoadedChangeKind.has_value();
+            const bool isValidOnAll = static_cast<size_t>(std::count(validateOutcomes.begin(), validateOutcomes.end(), S)) == INSTANCES_COUNT;
+            if ((isLoaded != isValidOnAll) || (isLoaded && (fakeExecutor.LoadedChangeKind.value() != Executing::ConfigChange::Kind::FILTER_ONLY))) {
+                SPDLOG_ERROR("Fan-out with the {} does not pass the change to load to instance #{}", name, instanceIdx);
+                isPassed = false;
+            }
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// The explicit rollback runs on all the instances, and fails if it fails on any of them
+inline bool RollbackConfigOnAllInstances() {
+    SPDLOG_INFO("[TEST] Roll back the config on all the instances");
+    SPDLOG_INFO("[BEGIN]");
+    using Outcome = FakeConfigExecutor::Outcome;
+    static constexpr size_t INSTANCES_COUNT = 3;
+    bool isPassed = true;
+    for (const bool isFailedOnMiddle : { false, true }) {
+        Rendezvous rendezvous(INSTANCES_COUNT);
+        Vector<SharedPtr<FakeConfigExecutor>> fakeExecutors;
+        Vector<SharedPtr<Executing::IConfigExecuting>> executors;
+        for (size_t instanceIdx = 0; instanceIdx < INSTANCES_COUNT; ++instanceIdx) {
+            fakeExecutors.push_back(std::make_shared<FakeConfigExecutor>(fmt::format("bird-{}.conf", instanceIdx), rendezvous));
+            executors.push_back(fakeExecutors.back());
+        }
+
+        fakeExecutors[1]->RollbackOutcome = isFailedOnMiddle ? Outcome::FAIL : Outcome::SUCCEED;
+        Executing::FanOutConfigExecutor fanOutExecutor(std::make_shared<NamedStorage>("bird.conf"), executors, std::make_shared<ModuleRegistry>());
+        if (fanOutExecutor.Rollback(std::make_shared<NamedStorage>("bird.conf.backup")) == isFailedOnMiddle) {
+            SPDLOG_ERROR("Rollback {} on the middle instance ends with the opposite result", isFailedOnMiddle ? "failed" : "succeeded");
+            isPassed = false;
+        }
+
+        for (size_t instanceIdx = 0; instanceIdx < INSTANCES_COUNT; ++instanceIdx) {
+            if ((fakeExecutors[instanceIdx]->RollbacksCount != 1) || (fakeExecutors[instanceIdx]->RollbackConfigURI != "bird.conf.backup")) {
+                SPDLOG_ERROR("Instance #{} is rolled back {} time(s) to '{}' instead of once to the backup config", instanceIdx, fakeExecutors[instanceIdx]->RollbacksCount,
+                    fakeExecutors[instanceIdx]->RollbackConfigURI);
+                isPassed = false;
+            }
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Config::Test
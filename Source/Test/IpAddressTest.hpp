@@ -0,0 +1,128 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/IpAddress.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <random>
+#include <regex>
+
+namespace Utils::Test {
+using namespace StdLib;
+
+// Pattern of the IPv4 address the schema used to be checked with (see Config/Schemas/static-route-config.json)
+static constexpr auto IPV4_ADDRESS_PATTERN = "^(25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])\\.(25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])"
+                                             "\\.(25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])\\.(25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])$";
+
+inline bool ParseAddressesAndPrefixes() {
+    SPDLOG_INFO("[TEST] Parse IP addresses and prefixes and print them in the canonical form");
+    SPDLOG_INFO("[BEGIN]");
+    // Text and its canonical form, empty if the text is not valid
+    const Vector<Pair<String, String>> addresses = {
+        { "0.0.0.0", "0.0.0.0" }, { "192.168.0.1", "192.168.0.1" }, { "255.255.255.255", "255.255.255.255" },
+        { "256.0.0.1", "" }, { "192.168.01.1", "" }, { "1.2.3", "" }, { "1.2.3.4.5", "" }, { "1..2.3", "" }, { "1.2.3.4 ", "" },
+        { "::", "::" }, { "::1", "::1" }, { "2001:DB8::0:1", "2001:db8::1" }, { "2001:db8:0:0:1:0:0:1", "2001:db8::1:0:0:1" },
+        { "fe80::1:2:3:4:5:6", "fe80:0:1:2:3:4:5:6" }, { "fe80::1:2:3:4:5:6:7", "" }, { "::ffff:192.0.2.1", "::ffff:c000:201" }, { "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8" },
+        { "1:2:3:4:5:6:7:8:9", "" }, { "1::2::3", "" }, { "12345::", "" }, { "1:2:3:4:5:6:7", "" }, { ":1::", "" }, { "::g", "" }
+    };
+    const Vector<Pair<String, String>> prefixes = {
+        { "10.0.0.0/8", "10.0.0.0/8" }, { "0.0.0.0/0", "0.0.0.0/0" }, { "192.0.2.0/33", "" }, { "192.0.2.0/08", "" },
+        { "192.0.2.0/", "" }, { "192.0.2.0", "" }, { "2001:db8::/32", "2001:db8::/32" }, { "::/128", "::/128" }, { "::/129", "" }
+    };
+
+    bool isPassed = true;
+    for (const auto& [text, canonicalText] : addresses) {
+        auto address = IpAddress::Parse(text);
+        auto parsedText = address.has_value() ? address.value().ToString() : String();
+        if (parsedText != canonicalText) {
+            SPDLOG_ERROR("Address '{}' is parsed as '{}' instead of '{}'", text, parsedText, canonicalText);
+            isPassed = false;
+        }
+    }
+
+    for (const auto& [text, canonicalText] : prefixes) {
+        auto prefix = IpPrefix::Parse(text);
+        auto parsedText = prefix.has_value() ? prefix.value().ToString() : String();
+        if (parsedText != canonicalText) {
+            SPDLOG_ERROR("Prefix '{}' is parsed as '{}' instead of '{}'", text, parsedText, canonicalText);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// RandomAddressLikeText() makes text which often is, and often is just not, a valid IPv4 address
+inline String RandomAddressLikeText(std::mt19937& random) {
+    static constexpr StringView CHARS = "0123456789012345678901234567890123456789.";
+    String text;
+    auto octetsCount = std::uniform_int_distribution<int>(3, 5)(random);
+    for (int octetIdx = 0; octetIdx < octetsCount; ++octetIdx) {
+        if (octetIdx > 0) {
+            text += '.';
+        }
+
+        auto charsCount = std::uniform_int_distribution<int>(0, 4)(random);
+        for (int i = 0; i < charsCount; ++i) {
+            text += CHARS[std::uniform_int_distribution<size_t>(0, CHARS.size() - 1)(random)];
+        }
+    }
+
+    return text;
+}
+
+inline bool AgreeWithIPv4Pattern() {
+    SPDLOG_INFO("[TEST] Accept the same IPv4 addresses as the pattern of the schema");
+    SPDLOG_INFO("[BEGIN]");
+    const std::regex ipv4Pattern(IPV4_ADDRESS_PATTERN);
+    std::mt19937 random(2025);
+    size_t validCount = 0;
+    for (int i = 0; i < 200000; ++i) {
+        auto text = RandomAddressLikeText(random);
+        auto isValid = IpAddress::ParseIPv4(text).has_value();
+        if (isValid != std::regex_match(text, ipv4Pattern)) {
+            SPDLOG_ERROR("Address '{}' is {} by the parser, but not by the pattern", text, isValid ? "accepted" : "rejected");
+            return false;
+        }
+
+        validCount += isValid ? 1 : 0;
+    }
+
+    SPDLOG_INFO("Both accepted {} of 200000 random texts", validCount);
+    SPDLOG_INFO("[END]");
+    return true;
+}
+
+inline void BenchmarkParseIPv4() {
+    SPDLOG_INFO("[BENCHMARK] Check 1M IPv4 addresses by the parser and by the pattern of the schema");
+    Vector<String> texts;
+    std::mt19937 random(2025);
+    for (int i = 0; i < 1000000; ++i) {
+        texts.push_back(std::to_string(random() % 256) + "." + std::to_string(random() % 256) + "." + std::to_string(random() % 256) + "." + std::to_string(random() % 300));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t parsedCount = 0;
+    for (const auto& text : texts) {
+        parsedCount += IpAddress::Parse(text).has_value() ? 1 : 0;
+    }
+
+    auto parserTime = std::chrono::steady_clock::now() - start;
+    const std::regex ipv4Pattern(IPV4_ADDRESS_PATTERN);
+    start = std::chrono::steady_clock::now();
+    size_t matchedCount = 0;
+    for (const auto& text : texts) {
+        matchedCount += std::regex_match(text, ipv4Pattern) ? 1 : 0;
+    }
+
+    auto patternTime = std::chrono::steady_clock::now() - start;
+    SPDLOG_INFO("Parser: {} ns per address ({} valid), pattern: {} ns per address ({} valid)",
+        std::chrono::duration_cast<std::chrono::nanoseconds>(parserTime).count() / texts.size(), parsedCount,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(patternTime).count() / texts.size(), matchedCount);
+}
+} // namespace Utils::Test
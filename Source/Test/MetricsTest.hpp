@@ -0,0 +1,78 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/Metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <random>
+
+namespace Metrics::Test {
+using namespace StdLib;
+
+/*
+    The latencies around the powers of two (the bounds of the rendered buckets) and random ones are recorded, and
+    the count up to each power of two must be the exact number of the latencies lower than or equal to it, like
+    the 'le' bucket of Prometheus.
+*/
+inline bool CountLatenciesUpToBounds() {
+    SPDLOG_INFO("[TEST] Count the latencies of the histogram up to the powers of two inclusively");
+    SPDLOG_INFO("[BEGIN]");
+    Vector<uint64_t> latenciesNs = { 0, 1, 2, 3 };
+    for (size_t bitIdx = 2; bitIdx < 40; ++bitIdx) {
+        auto boundNs = uint64_t(1) << bitIdx;
+        latenciesNs.insert(latenciesNs.end(), { boundNs - 1, boundNs, boundNs + 1 });
+    }
+
+    std::mt19937_64 random(2025);
+    for (int i = 0; i < 10000; ++i) {
+        // Below 2^63, so the latency fits in std::chrono::nanoseconds
+        latenciesNs.push_back(random() >> (1 + random() % 63));
+    }
+
+    LatencyHistogram histogram;
+    for (const auto latencyNs : latenciesNs) {
+        histogram.Record(std::chrono::nanoseconds(static_cast<int64_t>(latencyNs)));
+    }
+
+    auto snapshot = histogram.TakeSnapshot();
+    bool isPassed = (snapshot.Count == latenciesNs.size());
+    for (size_t bitIdx = 0; bitIdx < 63; ++bitIdx) {
+        auto boundNs = uint64_t(1) << bitIdx;
+        auto expectedCount = static_cast<uint64_t>(std::ranges::count_if(latenciesNs, [boundNs](const uint64_t latencyNs) { return latencyNs <= boundNs; }));
+        if (snapshot.CountUpTo(boundNs) != expectedCount) {
+            SPDLOG_ERROR("Histogram counts {} latencies up to {} ns instead of {}", snapshot.CountUpTo(boundNs), boundNs, expectedCount);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+/*
+    The route pattern with the backslash as the label value and the help text with the new line must be rendered with
+    the escapes of the Prometheus text format only, since the strict parsers reject the others (e.g. '\d').
+*/
+inline bool EscapeRenderedLabelsAndHelp() {
+    SPDLOG_INFO("[TEST] Escape the label values and the help text of the rendered metrics");
+    SPDLOG_INFO("[BEGIN]");
+    MetricsRegistry registry;
+    registry.GetCounter("requests_total", "Number of the requests\nby \\route", { { "path", "/logs/latest/(\\d+)" } }).Increment();
+    registry.GetHistogram("request_duration_seconds", "Duration of the requests", { { "path", "/say \"hi\"\n" } });
+    auto text = registry.RenderPrometheusText();
+    bool isPassed = true;
+    for (const String expectedLine : { "# HELP requests_total Number of the requests\\nby \\\\route\n",
+        "requests_total{path=\"/logs/latest/(\\\\d+)\"} 1\n", "request_duration_seconds_count{path=\"/say \\\"hi\\\"\\n\"} 0\n" }) {
+        if (text.find(expectedLine) == String::npos) {
+            SPDLOG_ERROR("Rendered metrics miss the line '{}'", expectedLine.substr(0, expectedLine.size() - 1));
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Metrics::Test
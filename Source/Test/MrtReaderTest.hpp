@@ -0,0 +1,304 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/Logging.hpp"
+#include "MrtReader.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace Policy::Test {
+using namespace StdLib;
+
+// Writes the big-endian fields of the MRT records. The nested parts are written apart, so their sizes are known
+class MrtWriter {
+public:
+    MrtWriter& U8(const uint32_t value) { mData.push_back(static_cast<uint8_t>(value)); return *this; }
+    MrtWriter& U16(const uint32_t value) { return U8(value >> 8).U8(value); }
+    MrtWriter& U32(const uint32_t value) { return U16(value >> 16).U16(value); }
+    MrtWriter& Bytes(const Vector<uint8_t>& bytes) { mData.insert(mData.end(), bytes.begin(), bytes.end()); return *this; }
+    MrtWriter& Zeros(const size_t size) { mData.resize(mData.size() + size, 0); return *this; }
+
+    // Prefix() writes the length and the significant bytes of the prefix, like in NLRI
+    MrtWriter& Prefix(const String& text) {
+        auto prefix = Utils::IpPrefix::Parse(text).value();
+        U8(prefix.Length);
+        for (size_t byteIdx = 0; byteIdx < (prefix.Length + 7u) / 8; ++byteIdx) {
+            U8(prefix.Address.Bytes[byteIdx]);
+        }
+
+        return *this;
+    }
+
+    MrtWriter& Address(const String& text) {
+        auto address = Utils::IpAddress::Parse(text).value();
+        for (size_t byteIdx = 0; byteIdx < address.BitsCount() / 8; ++byteIdx) {
+            U8(address.Bytes[byteIdx]);
+        }
+
+        return *this;
+    }
+
+    // Attribute() writes the path attribute of the given value with the length of 1 byte
+    MrtWriter& Attribute(const uint8_t type, const MrtWriter& value) { return U8(0x40).U8(type).U8(value.Size()).Bytes(value.Data()); }
+
+    // AsPathSegment() writes the segment of the given type (AS_SET 1, AS_SEQUENCE 2) and ASN size
+    MrtWriter& AsPathSegment(const uint8_t type, const Vector<uint32_t>& asns, const bool isAs4) {
+        U8(type).U8(asns.size());
+        for (const auto asn : asns) {
+            isAs4 ? U32(asn) : U16(asn);
+        }
+
+        return *this;
+    }
+
+    // Record() writes the MRT header of the body
+    MrtWriter& Record(const uint16_t type, const uint16_t subtype, const MrtWriter& body) {
+        return U32(0).U16(type).U16(subtype).U32(body.Size()).Bytes(body.Data());
+    }
+
+    size_t Size() const { return mData.size(); }
+    const Vector<uint8_t>& Data() const { return mData; }
+
+private:
+    Vector<uint8_t> mData;
+}; // class MrtWriter
+
+namespace Mrt {
+    static constexpr uint16_t TABLE_DUMP_V2 = 13;
+    static constexpr uint16_t BGP4MP = 16;
+    static constexpr uint16_t PEER_INDEX_TABLE = 1;
+    static constexpr uint16_t RIB_IPV4_UNICAST = 2;
+    static constexpr uint16_t RIB_IPV6_UNICAST_ADDPATH = 10;
+    static constexpr uint16_t BGP4MP_MESSAGE = 1;
+    static constexpr uint16_t BGP4MP_MESSAGE_AS4 = 4;
+    static constexpr uint8_t AS_PATH = 2;
+    static constexpr uint8_t MULTI_EXIT_DISC = 4;
+    static constexpr uint8_t LOCAL_PREF = 5;
+    static constexpr uint8_t COMMUNITIES = 8;
+    static constexpr uint8_t MP_REACH_NLRI = 14;
+    static constexpr uint8_t EXTENDED_COMMUNITIES = 16;
+    static constexpr uint8_t AS4_PATH = 17;
+    static constexpr uint8_t LARGE_COMMUNITY = 32;
+    static constexpr uint8_t AS_SET = 1;
+    static constexpr uint8_t AS_SEQUENCE = 2;
+} // namespace Mrt
+
+// PeerIndexTable() makes the PEER_INDEX_TABLE of the peers of 4-byte ASNs and IPv4 addresses
+inline MrtWriter PeerIndexTable(const Vector<uint32_t>& peerAsns) {
+    MrtWriter body;
+    body.Address("192.0.2.254").U16(0).U16(peerAsns.size());
+    for (size_t peerIdx = 0; peerIdx < peerAsns.size(); ++peerIdx) {
+        body.U8(0x02).U32(peerIdx + 1).Address("192.0.2." + std::to_string(peerIdx + 1)).U32(peerAsns[peerIdx]);
+    }
+
+    return MrtWriter().Record(Mrt::TABLE_DUMP_V2, Mrt::PEER_INDEX_TABLE, body);
+}
+
+// Bgp4mpUpdate() makes the BGP4MP record of the UPDATE message of IPv4 session with the attributes and the NLRI
+inline MrtWriter Bgp4mpUpdate(const bool isAs4, const MrtWriter& attrs, const MrtWriter& nlri) {
+    MrtWriter message;
+    message.Zeros(16).U16(16 + 2 + 1 + 2 + 2 + attrs.Size() + nlri.Size()).U8(2).U16(0).U16(attrs.Size()).Bytes(attrs.Data()).Bytes(nlri.Data());
+    MrtWriter body;
+    isAs4 ? body.U32(65100).U32(65000) : body.U16(65100).U16(65000);
+    body.U16(0).U16(1).Address("192.0.2.1").Address("192.0.2.2").Bytes(message.Data());
+    return MrtWriter().Record(Mrt::BGP4MP, isAs4 ? Mrt::BGP4MP_MESSAGE_AS4 : Mrt::BGP4MP_MESSAGE, body);
+}
+
+// RoutesText() lists the routes with all their attributes, one route per line
+inline String RoutesText(const RouteBatch& routes) {
+    String text;
+    for (size_t routeIdx = 0; routeIdx < routes.Size(); ++routeIdx) {
+        text += fmt::format("{} path [{}] lp {} med {}", routes.Prefix(routeIdx).ToString(), fmt::join(routes.AsPath(routeIdx), " "),
+            routes.LocalPreference(routeIdx), routes.Med(routeIdx));
+        for (const auto& community : routes.Communities(routeIdx)) {
+            text += " c " + community.ToString();
+        }
+
+        for (const auto& extCommunity : routes.ExtCommunities(routeIdx)) {
+            text += " ec " + extCommunity.ToString();
+        }
+
+        for (const auto& largeCommunity : routes.LargeCommunities(routeIdx)) {
+            text += " lc " + largeCommunity.ToString();
+        }
+
+        text += "\n";
+    }
+
+    return text;
+}
+
+// ReadMrtRoutes() reads the routes of the records written into the temporary file, serially and by the worker pool
+inline Optional<String> ReadMrtRoutes(const MrtWriter& records, const Vector<uint16_t>& peerIdxs = {}) {
+    auto fileName = (std::filesystem::temp_directory_path() / ("mrt-reader-test-" + std::to_string(::getpid()))).string();
+    {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(records.Data().data()), records.Size());
+    }
+
+    // Logger without sinks, the malformed records are expected
+    auto log = std::make_shared<Log::SpdLogger>("mrt-reader-test");
+    auto serialRoutes = MrtReader(log, nullptr).Read(fileName, peerIdxs);
+    auto parallelRoutes = MrtReader(log, std::make_shared<Utils::WorkerPool>(2)).Read(fileName, peerIdxs);
+    std::filesystem::remove(fileName);
+    if (serialRoutes.has_value() != parallelRoutes.has_value()) {
+        SPDLOG_ERROR("MRT records are read {} serially, but {} by the worker pool", serialRoutes.has_value() ? "" : "not", parallelRoutes.has_value() ? "" : "not");
+        return "";
+    }
+
+    if (!serialRoutes.has_value()) {
+        return {};
+    }
+
+    auto routesText = RoutesText(serialRoutes.value());
+    if (RoutesText(parallelRoutes.value()) != routesText) {
+        SPDLOG_ERROR("Routes read by the worker pool:\n{}differ from the ones read serially:\n{}", RoutesText(parallelRoutes.value()), routesText);
+        return "";
+    }
+
+    return routesText;
+}
+
+// CheckMrtRoutes() logs the routes which differ from the expected ones
+inline bool CheckMrtRoutes(const String& name, const Optional<String>& routesText, const String& expectedRoutesText) {
+    if (!routesText.has_value()) {
+        SPDLOG_ERROR("Failed to read the routes of {}", name);
+        return false;
+    }
+
+    if (routesText.value() != expectedRoutesText) {
+        SPDLOG_ERROR("Routes of {} are read as:\n{}instead of:\n{}", name, routesText.value(), expectedRoutesText);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+    RIB dump of IPv4 entries of two peers and the IPv6 entry of ADD-PATH with AS_SET, read for all the peers and for
+    the selected ones. The peer out of the PEER_INDEX_TABLE is rejected.
+*/
+inline bool ReadTableDumpV2Routes() {
+    SPDLOG_INFO("[TEST] Read the routes of the RIB dump of the selected peers");
+    SPDLOG_INFO("[BEGIN]");
+    MrtWriter records = PeerIndexTable({ 65001, 65002 });
+    MrtWriter peer1Attrs;
+    peer1Attrs.Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65001, 4200000000 }, true))
+        .Attribute(Mrt::COMMUNITIES, MrtWriter().U16(65001).U16(100))
+        .Attribute(Mrt::LOCAL_PREF, MrtWriter().U32(200))
+        .Attribute(Mrt::MULTI_EXIT_DISC, MrtWriter().U32(10));
+    MrtWriter peer2Attrs;
+    peer2Attrs.Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65002 }, true))
+        .Attribute(Mrt::LARGE_COMMUNITY, MrtWriter().U32(65002).U32(1).U32(2));
+    MrtWriter ipv4Rib;
+    ipv4Rib.U32(0).Prefix("10.1.0.0/16").U16(2);
+    ipv4Rib.U16(0).U32(0).U16(peer1Attrs.Size()).Bytes(peer1Attrs.Data());
+    ipv4Rib.U16(1).U32(0).U16(peer2Attrs.Size()).Bytes(peer2Attrs.Data());
+    records.Record(Mrt::TABLE_DUMP_V2, Mrt::RIB_IPV4_UNICAST, ipv4Rib);
+
+    MrtWriter addPathAttrs;
+    addPathAttrs.Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65002, 65010 }, true).AsPathSegment(Mrt::AS_SET, { 1, 2 }, true))
+        .Attribute(Mrt::EXTENDED_COMMUNITIES, MrtWriter().U16(0x0002).U16(65002).U32(7));
+    MrtWriter ipv6Rib;
+    ipv6Rib.U32(1).Prefix("2001:db8::/32").U16(1);
+    ipv6Rib.U16(1).U32(0).U32(5).U16(addPathAttrs.Size()).Bytes(addPathAttrs.Data());
+    records.Record(Mrt::TABLE_DUMP_V2, Mrt::RIB_IPV6_UNICAST_ADDPATH, ipv6Rib);
+
+    const String peer1Routes = "10.1.0.0/16 path [65001 4200000000] lp 200 med 10 c 65001:100\n";
+    const String peer2Routes = "10.1.0.0/16 path [65002] lp 100 med 0 lc 65002:1:2\n"
+        "2001:db8::/32 path [65002 65010 1 2] lp 100 med 0 ec 2:65002:7\n";
+    bool isPassed = CheckMrtRoutes("all the peers", ReadMrtRoutes(records), peer1Routes + peer2Routes);
+    isPassed = CheckMrtRoutes("the first peer", ReadMrtRoutes(records, { 0 }), peer1Routes) && isPassed;
+    isPassed = CheckMrtRoutes("the second peer", ReadMrtRoutes(records, { 1 }), peer2Routes) && isPassed;
+    if (ReadMrtRoutes(records, { 2 }).has_value()) {
+        SPDLOG_ERROR("Routes of the peer out of the PEER_INDEX_TABLE are read");
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+/*
+    UPDATE messages of the 4-byte AS session with IPv4 NLRI and IPv6 MP_REACH_NLRI, and of the 2-byte AS session,
+    whose AS_PATH keeps AS_TRANS in place of the ASNs of AS4_PATH.
+*/
+inline bool ReadBgp4mpRoutes() {
+    SPDLOG_INFO("[TEST] Read the routes of the BGP UPDATE messages of 4-byte and 2-byte AS sessions");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr uint32_t AS_TRANS = 23456;
+    MrtWriter mpReach;
+    mpReach.U16(2).U8(1).U8(16).Address("2001:db8::1").U8(0).Prefix("2001:db8:1::/48").Prefix("2001:db8:2::/48");
+    MrtWriter as4Attrs;
+    as4Attrs.Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65100, 4200000000 }, true))
+        .Attribute(Mrt::MP_REACH_NLRI, mpReach);
+    MrtWriter records = Bgp4mpUpdate(true, as4Attrs, MrtWriter().Prefix("192.0.2.0/24"));
+
+    MrtWriter as2Attrs;
+    as2Attrs.Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65100, AS_TRANS, AS_TRANS }, false))
+        .Attribute(Mrt::AS4_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 4200000001, 4200000002 }, true))
+        .Attribute(Mrt::COMMUNITIES, MrtWriter().U16(65100).U16(1));
+    records.Bytes(Bgp4mpUpdate(false, as2Attrs, MrtWriter().Prefix("198.51.100.0/24").Prefix("0.0.0.0/0")).Data());
+
+    bool isPassed = CheckMrtRoutes("the UPDATE messages", ReadMrtRoutes(records),
+        "192.0.2.0/24 path [65100 4200000000] lp 100 med 0\n"
+        "2001:db8:1::/48 path [65100 4200000000] lp 100 med 0\n"
+        "2001:db8:2::/48 path [65100 4200000000] lp 100 med 0\n"
+        "198.51.100.0/24 path [65100 4200000001 4200000002] lp 100 med 0 c 65100:1\n"
+        "0.0.0.0/0 path [65100 4200000001 4200000002] lp 100 med 0 c 65100:1\n");
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// The files of the truncated or malformed records are rejected instead of reading the routes of their garbage
+inline bool RejectMalformedMrtRecords() {
+    SPDLOG_INFO("[TEST] Reject the truncated and malformed MRT records");
+    SPDLOG_INFO("[BEGIN]");
+    auto asPath = MrtWriter().Attribute(Mrt::AS_PATH, MrtWriter().AsPathSegment(Mrt::AS_SEQUENCE, { 65001 }, true));
+    auto ribRecord = [&asPath](const String& prefix, const size_t attrsSize) {
+        MrtWriter rib;
+        rib.U32(0).Prefix(prefix).U16(1).U16(0).U32(0).U16(attrsSize).Bytes(asPath.Data());
+        return MrtWriter().Record(Mrt::TABLE_DUMP_V2, Mrt::RIB_IPV4_UNICAST, rib);
+    };
+
+    MrtWriter prefixOf33Bits;
+    prefixOf33Bits.U32(0).U8(33).U32(0x0a000000).U8(0).U16(0);
+
+    auto withTruncatedRecord = PeerIndexTable({ 65001 });
+    withTruncatedRecord.Bytes(ribRecord("10.0.0.0/8", asPath.Size()).Data());
+    withTruncatedRecord = MrtWriter().Bytes(Vector<uint8_t>(withTruncatedRecord.Data().begin(), withTruncatedRecord.Data().end() - 1));
+
+    MrtWriter truncatedAttribute;
+    truncatedAttribute.U8(0x40).U8(Mrt::LOCAL_PREF).U8(8).U32(100);
+
+    const Vector<Pair<String, MrtWriter>> cases = {
+        { "truncated header", MrtWriter().U32(0).U16(Mrt::TABLE_DUMP_V2) },
+        { "truncated record", withTruncatedRecord },
+        { "truncated PEER_INDEX_TABLE", MrtWriter().Record(Mrt::TABLE_DUMP_V2, Mrt::PEER_INDEX_TABLE, MrtWriter().U32(0).U16(10).U8(0)) },
+        { "attributes beyond the RIB entry", PeerIndexTable({ 65001 }).Bytes(ribRecord("10.0.0.0/8", asPath.Size() + 1).Data()) },
+        { "prefix longer than the address", MrtWriter().Record(Mrt::TABLE_DUMP_V2, Mrt::RIB_IPV4_UNICAST, prefixOf33Bits) },
+        { "attribute beyond the attributes", Bgp4mpUpdate(true, truncatedAttribute, MrtWriter().Prefix("192.0.2.0/24")) },
+        { "truncated NLRI", Bgp4mpUpdate(true, asPath, MrtWriter().U8(24).U16(0xc000)) },
+        { "truncated MP_REACH_NLRI", Bgp4mpUpdate(true, MrtWriter().Attribute(Mrt::MP_REACH_NLRI, MrtWriter().U16(2).U8(1).U8(16).U32(0)), MrtWriter()) },
+    };
+
+    bool isPassed = true;
+    for (const auto& [name, records] : cases) {
+        auto routesText = ReadMrtRoutes(records);
+        if (routesText.has_value()) {
+            SPDLOG_ERROR("MRT file of the {} is read as:\n{}", name, routesText.value());
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Policy::Test
@@ -0,0 +1,129 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "PolicyMatchers.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <random>
+#include <set>
+
+namespace Policy::Test {
+using namespace StdLib;
+
+// RandomAsns() draws ASNs mostly from the 2-byte range, so they often fold into the same bits of the bitmap
+inline Vector<uint32_t> RandomAsns(std::mt19937& random, const size_t count) {
+    Vector<uint32_t> asns;
+    for (size_t asnIdx = 0; asnIdx < count; ++asnIdx) {
+        asns.push_back((random() % 4 == 0) ? random() : (random() % 70000));
+    }
+
+    return asns;
+}
+
+/*
+    Sets of both kinds (the padded array up to 16 keys, the bitmap beyond it) must answer Contains(), ContainsAny()
+    and Equals() the same as std::set, including the sets with duplicated members and the empty set.
+*/
+inline bool MatchSetsLikeStdSet() {
+    SPDLOG_INFO("[TEST] Match ASNs and communities by the set matchers the same as by std::set");
+    SPDLOG_INFO("[BEGIN]");
+    std::mt19937 random(2025);
+    bool isPassed = true;
+    for (const size_t setSize : { 0, 1, 7, 8, 9, 16, 17, 100, 1000 }) {
+        auto members = RandomAsns(random, setSize);
+        if (setSize > 2) {
+            members.push_back(members.front());
+        }
+
+        std::set<uint32_t> reference(members.begin(), members.end());
+        AsnSetMatcher matcher(members);
+        if (matcher.Size() != reference.size()) {
+            SPDLOG_ERROR("Set of {} ASN(s) has size {} instead of {}", setSize, matcher.Size(), reference.size());
+            isPassed = false;
+        }
+
+        auto queries = RandomAsns(random, 10000);
+        queries.insert(queries.end(), members.begin(), members.end());
+        for (const auto asn : queries) {
+            if (matcher.Contains(asn) != reference.contains(asn)) {
+                SPDLOG_ERROR("ASN {} is {} by the set of {} ASN(s)", asn, reference.contains(asn) ? "missed" : "falsely matched", setSize);
+                isPassed = false;
+                break;
+            }
+        }
+
+        Vector<uint32_t> sortedKeys;
+        Vector<uint32_t> shuffledMembers(reference.begin(), reference.end());
+        std::ranges::shuffle(shuffledMembers, random);
+        shuffledMembers.insert(shuffledMembers.end(), shuffledMembers.begin(), shuffledMembers.begin() + (shuffledMembers.size() / 2));
+        if (!matcher.Equals(shuffledMembers, sortedKeys)) {
+            SPDLOG_ERROR("Shuffled members with duplicates do not equal the set of {} ASN(s)", setSize);
+            isPassed = false;
+        }
+
+        if (!reference.empty()) {
+            shuffledMembers.pop_back();
+            shuffledMembers.push_back(*reference.rbegin() + 1);
+            if (matcher.Equals(shuffledMembers, sortedKeys)) {
+                SPDLOG_ERROR("Different members equal the set of {} ASN(s)", setSize);
+                isPassed = false;
+            }
+        }
+    }
+
+    const Vector<Community> communities = { { 65000, 1 }, { 65000, 2 }, { 1, 65000 } };
+    CommunitySetMatcher communityMatcher(communities);
+    const Vector<Community> routeCommunities = { { 65000, 3 }, { 1, 65000 } };
+    const Vector<Community> swappedCommunity = { { 65000, 1 }, { 2, 65000 } };
+    if (!communityMatcher.ContainsAny(routeCommunities) || communityMatcher.ContainsAny(std::span(swappedCommunity).subspan(1))) {
+        SPDLOG_ERROR("Community set does not tell apart the ASN and the value of the community");
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// BenchmarkSetMatcher() measures Contains() of the matcher against the binary search in the sorted vector
+inline void BenchmarkSetMatcher(const size_t setSize) {
+    static constexpr size_t QUERIES_COUNT = 1000000;
+    std::mt19937 random(2025);
+    auto members = RandomAsns(random, setSize);
+    AsnSetMatcher matcher(members);
+    std::ranges::sort(members);
+    // Every tenth query is the member of the set, like the ASNs of the routes which the policy looks for
+    auto queries = RandomAsns(random, QUERIES_COUNT);
+    for (size_t queryIdx = 0; queryIdx < queries.size(); queryIdx += 10) {
+        queries[queryIdx] = members[random() % members.size()];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t matchedCount = 0;
+    for (const auto asn : queries) {
+        matchedCount += matcher.Contains(asn) ? 1 : 0;
+    }
+
+    auto matcherTime = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    size_t searchedCount = 0;
+    for (const auto asn : queries) {
+        searchedCount += std::binary_search(members.begin(), members.end(), asn) ? 1 : 0;
+    }
+
+    auto searchTime = std::chrono::steady_clock::now() - start;
+    SPDLOG_INFO("Set of {} ASN(s) - matcher: {} ns per query ({} matched), binary search: {} ns per query ({} matched)", setSize,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(matcherTime).count() / QUERIES_COUNT, matchedCount,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(searchTime).count() / QUERIES_COUNT, searchedCount);
+}
+
+inline void BenchmarkAsnSetMatcher() {
+    SPDLOG_INFO("[BENCHMARK] Look up 1M ASNs in the sets of the 'as-path-in' condition");
+    for (const size_t setSize : { 4, 16, 100, 1000, 100000 }) {
+        BenchmarkSetMatcher(setSize);
+    }
+}
+} // namespace Policy::Test
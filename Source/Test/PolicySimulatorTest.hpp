@@ -0,0 +1,180 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/ModuleRegistry.hpp"
+#include "PolicySimulator.hpp"
+#include "PrefixListReader.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace Policy::Test {
+using namespace StdLib;
+
+// SimulatedBgpConfig() makes the policy, whose terms reject, accept with changes, and change the route for the next terms
+inline Json::JSON SimulatedBgpConfig() {
+    return Json::JSON::parse(R"({
+        "bgp": {
+            "prefix-v4-list": { "CUSTOMERS": { "10.0.0.0/8": { "le": 24 } } },
+            "policy-list": {
+                "POLICY": {
+                    "term-10": { "if-match": { "community-in": [ "65000:666" ] }, "then": { "action": "deny" } },
+                    "term-20": {
+                        "if-match": { "net-in": { "prefix-v4-list": "CUSTOMERS" } },
+                        "then": { "local-preference-set": 200, "community-add": "65000:100", "action": "permit" }
+                    },
+                    "term-30": {
+                        "if-match": { "as-path-in": [ 65100 ] },
+                        "then": { "as-path-prepend": { "asn": 65000, "n-times": 2 }, "med-set": 50, "community-remove": [ "65100:1" ], "action": "call-next" }
+                    },
+                    "default-action": "permit"
+                }
+            }
+        }
+    })");
+}
+
+// Route of the known outcome: the verdict, the matched terms and the attributes which leave the policy
+struct SimulatedRoute {
+    String RouteText;
+    PolicyProgram::Verdict Action;
+    Vector<uint32_t> MatchedTermIdxs;
+    Vector<uint32_t> AsPath;
+    Vector<String> Communities;
+    uint32_t LocalPreference;
+    uint32_t Med;
+};
+
+inline String OutcomeText(const PolicySimulator::RouteOutcome& outcome) {
+    Vector<String> communities;
+    for (const auto& community : outcome.Communities) {
+        communities.push_back(community.ToString());
+    }
+
+    return fmt::format("action {} terms [{}] path [{}] communities [{}] lp {} med {}", static_cast<int>(outcome.Action), fmt::join(outcome.MatchedTermIdxs, " "),
+        fmt::join(outcome.AsPath, " "), fmt::join(communities, " "), outcome.LocalPreference, outcome.Med);
+}
+
+/*
+    The known routes are repeated into the batch of several chunks, so the counters of the chunks are merged. The
+    counters and the outcomes of the first routes must be the same without the worker pool and with the pools of 1
+    and 4 workers.
+*/
+inline bool SimulateKnownRoutes() {
+    SPDLOG_INFO("[TEST] Simulate the policy against the routes of known outcomes by 1 and many workers");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr size_t REPEATS_COUNT = 20000;
+    using Verdict = PolicyProgram::Verdict;
+    const Vector<SimulatedRoute> knownRoutes = {
+        { R"({ "net": "10.1.0.0/16", "as-path": [ 65001 ] })", Verdict::ACCEPT, { 1 }, { 65001 }, { "65000:100" }, 200, 0 },
+        { R"({ "net": "10.1.0.0/16", "as-path": [ 65001 ], "community": [ "65000:666" ] })", Verdict::REJECT, { 0 }, { 65001 }, { "65000:666" }, 100, 0 },
+        { R"({ "net": "192.0.2.0/24", "as-path": [ 65100, 65200 ], "community": [ "65100:1", "65100:2" ], "med": 10 })", Verdict::ACCEPT, { 2 },
+            { 65000, 65000, 65100, 65200 }, { "65100:2" }, 100, 50 },
+        { R"({ "net": "10.0.0.0/25", "as-path": [ 65100 ], "local-preference": 300 })", Verdict::ACCEPT, { 2 }, { 65000, 65000, 65100 }, {}, 300, 50 },
+        { R"({ "net": "198.51.100.0/24", "as-path": [ 65001 ] })", Verdict::ACCEPT, {}, { 65001 }, {}, 100, 0 },
+    };
+
+    auto jRoutes = Json::JSON::array();
+    for (size_t repeatIdx = 0; repeatIdx < REPEATS_COUNT; ++repeatIdx) {
+        for (const auto& knownRoute : knownRoutes) {
+            jRoutes.push_back(Json::JSON::parse(knownRoute.RouteText));
+        }
+    }
+
+    bool isPassed = true;
+    const Vector<Pair<String, SharedPtr<Utils::WorkerPool>>> workerPools = {
+        { "no worker pool", nullptr },
+        { "1 worker", std::make_shared<Utils::WorkerPool>(1) },
+        { "4 workers", std::make_shared<Utils::WorkerPool>(4) },
+    };
+
+    for (const auto& [poolName, workerPool] : workerPools) {
+        PolicySimulator simulator(std::make_shared<ModuleRegistry>(), workerPool);
+        auto program = simulator.Compile(SimulatedBgpConfig(), "POLICY");
+        auto routes = simulator.ReadRoutes(jRoutes);
+        if (!program.has_value() || !routes.has_value()) {
+            SPDLOG_ERROR("Failed to compile the policy or to read the routes with {}", poolName);
+            isPassed = false;
+            continue;
+        }
+
+        auto result = simulator.Run(program.value(), routes.value(), knownRoutes.size());
+        using Attribute = PolicySimulator::Attribute;
+        const Vector<Pair<String, Pair<uint64_t, uint64_t>>> counts = {
+            { "routes", { result.RoutesCount, 5 * REPEATS_COUNT } },
+            { "accepted", { result.AcceptedCount, 4 * REPEATS_COUNT } },
+            { "rejected", { result.RejectedCount, REPEATS_COUNT } },
+            { "default action", { result.DefaultActionCount, 3 * REPEATS_COUNT } },
+            { "term-10 matches", { result.MatchedCountByTerm.at(0), REPEATS_COUNT } },
+            { "term-20 matches", { result.MatchedCountByTerm.at(1), REPEATS_COUNT } },
+            { "term-30 matches", { result.MatchedCountByTerm.at(2), 2 * REPEATS_COUNT } },
+            { "modified AS paths", { result.ModifiedCountByAttribute[Attribute::AS_PATH], 2 * REPEATS_COUNT } },
+            { "modified communities", { result.ModifiedCountByAttribute[Attribute::COMMUNITY], 2 * REPEATS_COUNT } },
+            { "modified local preferences", { result.ModifiedCountByAttribute[Attribute::LOCAL_PREFERENCE], REPEATS_COUNT } },
+            { "modified MEDs", { result.ModifiedCountByAttribute[Attribute::MED], 2 * REPEATS_COUNT } },
+        };
+
+        for (const auto& [countName, count] : counts) {
+            if (count.first != count.second) {
+                SPDLOG_ERROR("Simulation with {} counts {} {} instead of {}", poolName, count.first, countName, count.second);
+                isPassed = false;
+            }
+        }
+
+        for (size_t routeIdx = 0; routeIdx < knownRoutes.size(); ++routeIdx) {
+            const auto& knownRoute = knownRoutes[routeIdx];
+            PolicySimulator::RouteOutcome expectedOutcome { knownRoute.Action, knownRoute.MatchedTermIdxs, knownRoute.AsPath, {}, knownRoute.LocalPreference, knownRoute.Med };
+            for (const auto& community : knownRoute.Communities) {
+                expectedOutcome.Communities.push_back(Community::Parse(community).value());
+            }
+
+            auto outcomeText = OutcomeText(result.RouteOutcomes.at(routeIdx));
+            if (outcomeText != OutcomeText(expectedOutcome)) {
+                SPDLOG_ERROR("Simulation with {} of route {} ends with '{}' instead of '{}'", poolName, knownRoute.RouteText, outcomeText, OutcomeText(expectedOutcome));
+                isPassed = false;
+            }
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// The prefix ranges are read the same way by the converter and the simulator, so their edge cases are checked once here
+inline bool ReadPrefixRanges() {
+    SPDLOG_INFO("[TEST] Read the prefix ranges of the 'ge' and 'le' attributes");
+    SPDLOG_INFO("[BEGIN]");
+    const Vector<Pair<String, String>> cases = {
+        { R"({ "10.0.0.0/8": {} })", "10.0.0.0/8" },
+        { R"({ "10.0.0.0/8": { "ge": 16 } })", "10.0.0.0/8{16,32}" },
+        { R"({ "10.0.0.0/8": { "le": 24 } })", "10.0.0.0/8{8,24}" },
+        { R"({ "10.0.0.0/8": { "ge": 16, "le": 24 } })", "10.0.0.0/8{16,24}" },
+        { R"({ "2001:db8::/32": { "ge": 48 } })", "2001:db8::/32{48,128}" },
+        { R"({ "10.0.0.0/8": { "ge": 4 } })", "" },
+        { R"({ "10.0.0.0/8": { "le": 33 } })", "" },
+        { R"({ "10.0.0.0/8": { "ge": 24, "le": 16 } })", "" },
+        { R"({ "10.0.0.0/33": {} })", "" },
+    };
+
+    Config::PrefixListReader reader(std::make_shared<ModuleRegistry>()->LoggerRegistry()->Logger(Module::Name::POLICY_SIM));
+    bool isPassed = true;
+    for (const auto& [prefixesText, expectedRangeText] : cases) {
+        auto jPrefixes = Json::JSON::parse(prefixesText);
+        auto pfxRange = reader.ParsePrefixRange(jPrefixes.begin().key(), jPrefixes.begin().value());
+        auto rangeText = pfxRange.has_value() ? pfxRange.value().ToString() : String();
+        if (rangeText != expectedRangeText) {
+            SPDLOG_ERROR("Prefix range {} is read as '{}' instead of '{}'", prefixesText, rangeText, expectedRangeText);
+            isPassed = false;
+        }
+
+        if (reader.MakePrefixSet(jPrefixes).has_value() != !expectedRangeText.empty()) {
+            SPDLOG_ERROR("Prefix set of {} is {}read", prefixesText, expectedRangeText.empty() ? "" : "not ");
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Policy::Test
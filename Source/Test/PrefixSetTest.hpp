@@ -0,0 +1,249 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "JsonCommon.hpp"
+#include "Lib/PrefixSet.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <malloc.h>
+
+#include <chrono>
+#include <random>
+
+namespace Utils::Test {
+using namespace StdLib;
+
+inline PrefixRange MakePrefixRange(const StringView prefixText, const uint8_t minLength, const uint8_t maxLength) {
+    return { IpPrefix::Parse(prefixText).value(), minLength, maxLength };
+}
+
+// RangesText() joins the ranges in the syntax of BIRD prefix sets
+inline String RangesText(const PrefixSet& pfxSet) {
+    String text;
+    for (const auto& range : pfxSet.Ranges()) {
+        text += (text.empty() ? "" : ", ") + range.ToString();
+    }
+
+    return text;
+}
+
+inline bool AggregateKnownPrefixSets() {
+    SPDLOG_INFO("[TEST] Aggregate the prefix sets into the expected ranges");
+    SPDLOG_INFO("[BEGIN]");
+    // Ranges and the expected ranges after the aggregation
+    const Vector<Pair<Vector<PrefixRange>, String>> cases = {
+        { { MakePrefixRange("10.0.0.0/9", 9, 9), MakePrefixRange("10.128.0.0/9", 9, 9) }, "10.0.0.0/8{9,9}" },
+        { { MakePrefixRange("10.0.0.0/8", 8, 16), MakePrefixRange("10.1.0.0/16", 16, 24) }, "10.0.0.0/8{8,16}, 10.1.0.0/16{17,24}" },
+        { { MakePrefixRange("10.0.0.0/8", 8, 24), MakePrefixRange("10.1.0.0/16", 16, 20) }, "10.0.0.0/8{8,24}" },
+        { { MakePrefixRange("192.0.2.0/24", 24, 24), MakePrefixRange("198.51.100.0/24", 24, 24) }, "192.0.2.0/24, 198.51.100.0/24" },
+        { { MakePrefixRange("2001:db8::/33", 33, 48), MakePrefixRange("2001:db8:8000::/33", 33, 48) }, "2001:db8::/32{33,48}" },
+    };
+
+    bool isPassed = true;
+    for (const auto& [ranges, expectedText] : cases) {
+        PrefixSet pfxSet;
+        for (const auto& range : ranges) {
+            pfxSet.Insert(range);
+        }
+
+        pfxSet.Aggregate();
+        auto text = RangesText(pfxSet);
+        if (text != expectedText) {
+            SPDLOG_ERROR("Prefix set is aggregated into '{}' instead of '{}'", text, expectedText);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+/*
+    Random ranges are packed into 10.0.0.0/8, so they often share, nest and split the prefixes. Every route of the
+    lengths 8 to 20 within 10.0.0.0/8 (and a few outside of it) must be matched the same way before and after the
+    aggregation, and the aggregated set must not have more ranges than the original one.
+*/
+inline bool AggregateRandomPrefixSets() {
+    SPDLOG_INFO("[TEST] Match the same routes by the prefix set before and after the aggregation");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr size_t ROUNDS_COUNT = 50;
+    static constexpr size_t RANGES_COUNT = 64;
+    static constexpr uint8_t MAX_ROUTE_LENGTH = 20;
+
+    Vector<IpPrefix> routes;
+    for (uint8_t length = 8; length <= MAX_ROUTE_LENGTH; ++length) {
+        for (uint32_t routeIdx = 0; routeIdx < (1u << (length - 8)); ++routeIdx) {
+            auto address = 0x0a000000u | (routeIdx << (32 - length));
+            auto text = fmt::format("{}.{}.{}.0/{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff, length);
+            routes.push_back(IpPrefix::Parse(text).value());
+        }
+    }
+
+    routes.push_back(IpPrefix::Parse("0.0.0.0/0").value());
+    routes.push_back(IpPrefix::Parse("11.0.0.0/8").value());
+    routes.push_back(IpPrefix::Parse("10.0.0.0/24").value());
+
+    std::mt19937 random(2025);
+    bool isPassed = true;
+    for (size_t roundIdx = 0; (roundIdx < ROUNDS_COUNT) && isPassed; ++roundIdx) {
+        PrefixSet pfxSet;
+        for (size_t rangeIdx = 0; rangeIdx < RANGES_COUNT; ++rangeIdx) {
+            auto length = static_cast<uint8_t>(std::uniform_int_distribution<int>(8, 16)(random));
+            auto address = 0x0a000000u | (std::uniform_int_distribution<uint32_t>(0, 0xffff)(random) << 8);
+            address &= ~0u << (32 - length);
+            auto minLength = static_cast<uint8_t>(std::uniform_int_distribution<int>(length, MAX_ROUTE_LENGTH)(random));
+            auto maxLength = static_cast<uint8_t>(std::uniform_int_distribution<int>(minLength, MAX_ROUTE_LENGTH)(random));
+            auto text = fmt::format("{}.{}.{}.0/{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff, length);
+            pfxSet.Insert({ IpPrefix::Parse(text).value(), minLength, maxLength });
+        }
+
+        auto originalText = RangesText(pfxSet);
+        auto rangesCount = pfxSet.Ranges().size();
+        Vector<bool> matches;
+        matches.reserve(routes.size());
+        for (const auto& route : routes) {
+            matches.push_back(pfxSet.Matches(route));
+        }
+
+        pfxSet.Aggregate();
+        if (pfxSet.Ranges().size() > rangesCount) {
+            SPDLOG_ERROR("Prefix set '{}' is aggregated into more ranges '{}'", originalText, RangesText(pfxSet));
+            isPassed = false;
+        }
+
+        for (size_t routeIdx = 0; routeIdx < routes.size(); ++routeIdx) {
+            if (pfxSet.Matches(routes[routeIdx]) != matches[routeIdx]) {
+                SPDLOG_ERROR("Route {} is {} by '{}', but {} by its aggregation '{}'", routes[routeIdx].ToString(),
+                    matches[routeIdx] ? "matched" : "not matched", originalText, matches[routeIdx] ? "not" : "it is", RangesText(pfxSet));
+                isPassed = false;
+                break;
+            }
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+/*
+    Random ranges within 10.0.0.0/8 (of the lengths up to 14) are queried against the random sets, and the answers
+    are compared with the ones found by checking every route of the lengths 8 to 14 within 10.0.0.0/8 one by one.
+*/
+inline bool QueryRandomPrefixSets() {
+    SPDLOG_INFO("[TEST] Find the duplicated, overlapping and covered ranges of the prefix set");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr size_t ROUNDS_COUNT = 200;
+    static constexpr size_t QUERIES_COUNT = 100;
+    static constexpr uint8_t MAX_ROUTE_LENGTH = 14;
+
+    std::mt19937 random(2025);
+    auto makeRandomRange = [&random]() {
+        auto length = static_cast<uint8_t>(std::uniform_int_distribution<int>(8, MAX_ROUTE_LENGTH)(random));
+        auto address = 0x0a000000u | (std::uniform_int_distribution<uint32_t>(0, 0xff)(random) << 16);
+        address &= ~0u << (32 - length);
+        auto minLength = static_cast<uint8_t>(std::uniform_int_distribution<int>(length, MAX_ROUTE_LENGTH)(random));
+        auto maxLength = static_cast<uint8_t>(std::uniform_int_distribution<int>(minLength, MAX_ROUTE_LENGTH)(random));
+        return MakePrefixRange(fmt::format("{}.{}.0.0/{}", address >> 24, (address >> 16) & 0xff, length), minLength, maxLength);
+    };
+
+    auto toBits = [](const IpAddress& address) {
+        return (uint32_t(address.Bytes[0]) << 24) | (uint32_t(address.Bytes[1]) << 16) | (uint32_t(address.Bytes[2]) << 8) | address.Bytes[3];
+    };
+
+    auto isInside = [&toBits](const IpPrefix& route, const PrefixRange& range) {
+        auto mask = ~0u << (32 - range.Prefix.Length);
+        return (route.Length >= range.MinLength) && (route.Length <= range.MaxLength) && ((toBits(route.Address) & mask) == toBits(range.Prefix.Address));
+    };
+
+    Vector<IpPrefix> routes;
+    for (uint8_t length = 8; length <= MAX_ROUTE_LENGTH; ++length) {
+        for (uint32_t routeIdx = 0; routeIdx < (1u << (length - 8)); ++routeIdx) {
+            auto address = 0x0a000000u | (routeIdx << (32 - length));
+            routes.push_back(IpPrefix::Parse(fmt::format("{}.{}.0.0/{}", address >> 24, (address >> 16) & 0xff, length)).value());
+        }
+    }
+
+    bool isPassed = true;
+    for (size_t roundIdx = 0; (roundIdx < ROUNDS_COUNT) && isPassed; ++roundIdx) {
+        PrefixSet pfxSet;
+        Vector<PrefixRange> ranges(std::uniform_int_distribution<size_t>(1, 8)(random));
+        for (auto& range : ranges) {
+            range = makeRandomRange();
+            pfxSet.Insert(range);
+        }
+
+        for (size_t queryIdx = 0; (queryIdx < QUERIES_COUNT) && isPassed; ++queryIdx) {
+            auto query = makeRandomRange();
+            bool isOverlapped = false;
+            bool isCovered = true;
+            for (const auto& route : routes) {
+                if (!isInside(route, query)) {
+                    continue;
+                }
+
+                auto isMatched = std::any_of(ranges.begin(), ranges.end(), [&](const auto& range) { return isInside(route, range); });
+                isOverlapped = isOverlapped || isMatched;
+                isCovered = isCovered && isMatched;
+            }
+
+            bool isDuplicated = true;
+            for (auto length = query.MinLength; length <= query.MaxLength; ++length) {
+                isDuplicated = isDuplicated && std::any_of(ranges.begin(), ranges.end(), [&](const auto& range) {
+                    return (range.Prefix.ToString() == query.Prefix.ToString()) && (range.MinLength <= length) && (length <= range.MaxLength);
+                });
+            }
+
+            if ((pfxSet.Duplicates(query) != isDuplicated) || (pfxSet.Overlaps(query) != isOverlapped) || (pfxSet.Covers(query) != isCovered)) {
+                SPDLOG_ERROR("Range {} is duplicated {}, overlapped {} and covered {} by '{}' instead of {}, {} and {}", query.ToString(),
+                    pfxSet.Duplicates(query), pfxSet.Overlaps(query), pfxSet.Covers(query), RangesText(pfxSet), isDuplicated, isOverlapped, isCovered);
+                isPassed = false;
+            }
+        }
+    }
+
+    // The families do not mix
+    PrefixSet pfxSet;
+    pfxSet.Insert(MakePrefixRange("0.0.0.0/0", 0, 32));
+    if (pfxSet.Overlaps(MakePrefixRange("::/0", 0, 0)) || pfxSet.Covers(MakePrefixRange("2001:db8::/32", 32, 32))) {
+        SPDLOG_ERROR("IPv6 range is matched by the IPv4 prefix set '{}'", RangesText(pfxSet));
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// BenchmarkPrefixListMemory() measures the heap taken by the prefix list of 100k /24 prefixes in JSON and as the set. The
+// list is not bigger, since the JSON object keeps the keys in the order of insertion and parses in quadratic time
+inline void BenchmarkPrefixListMemory() {
+    SPDLOG_INFO("[BENCHMARK] Compare the memory of the prefix list of 100k prefixes in JSON and as the prefix set");
+    static constexpr uint32_t PREFIXES_COUNT = 100'000;
+    String listText = "{";
+    for (uint32_t pfxIdx = 0; pfxIdx < PREFIXES_COUNT; ++pfxIdx) {
+        auto address = (16u << 24) + (pfxIdx << 8);
+        listText += fmt::format("{}\"{}.{}.{}.0/24\": {{}}", (pfxIdx > 0) ? ", " : "", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff);
+    }
+
+    listText += "}";
+    // Big blocks (e.g. of the vectors) are mapped aside from the heap
+    auto heapBytes = []() { return mallinfo2().uordblks + mallinfo2().hblkhd; };
+    auto jsonHeapBytes = heapBytes();
+    auto jPrefixes = Json::JSON::parse(listText);
+    jsonHeapBytes = heapBytes() - jsonHeapBytes;
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto setHeapBytes = heapBytes();
+    PrefixSet pfxSet;
+    for (const auto& [pfx, attrs] : jPrefixes.items()) {
+        pfxSet.Insert(MakePrefixRange(pfx, 24, 24));
+    }
+
+    pfxSet.ShrinkToFit();
+    setHeapBytes = heapBytes() - setHeapBytes;
+    auto buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+    SPDLOG_INFO("JSON takes {} kB, the prefix set takes {} kB of the heap ({} kB by its own count), built in {} ms", jsonHeapBytes >> 10,
+        setHeapBytes >> 10, pfxSet.MemoryBytes() >> 10, buildTime.count());
+}
+} // namespace Utils::Test
@@ -0,0 +1,166 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+#include "FileStorage.hpp"
+#include "JsonFileStorage.hpp"
+#include "JsonSchemaManager.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <fstream>
+
+namespace Schema::Test {
+using namespace StdLib;
+
+inline Json::JSON SessionsSchema(const String& entryNamePattern) {
+    return Json::JSON::parse(R"({
+        "type": "object",
+        "properties": {
+            "sessions": {
+                "type": "object",
+                "patternProperties": { ")" + entryNamePattern + R"(": { "$ref": "#/$defs/session" } },
+                "additionalProperties": false
+            }
+        },
+        "$defs": {
+            "session": {
+                "type": "object",
+                "properties": { "as": { "type": "integer", "minimum": 1 } },
+                "required": [ "as" ]
+            }
+        }
+    })");
+}
+
+// SessionsData() makes entries which are all valid except for the listed ones
+inline ByteStream SessionsData(const size_t sessionsCount, const String& namePrefix) {
+    Json::JSON jData;
+    for (size_t i = 0; i < sessionsCount; ++i) {
+        jData["sessions"][namePrefix + std::to_string(i)]["as"] = i + 1;
+    }
+
+    jData["sessions"][namePrefix + "17"]["as"] = 0;
+    jData["sessions"][namePrefix + "150"].erase("as");
+    jData["sessions"]["bad.name"]["as"] = 1;
+    auto jStrData = jData.dump();
+    return ByteStream(jStrData.begin(), jStrData.end());
+}
+
+inline Optional<Json::JSON> ValidationErrors(const Json::JSON& jSchema, const ByteStream& data, const size_t workersCount) {
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    auto storage = std::make_shared<Storage::FileStorage>("/dev/null", moduleRegistry);
+    JsonSchemaManager schemaMngr(storage, moduleRegistry, std::make_shared<Utils::WorkerPool>(workersCount));
+    if (!schemaMngr.LoadSchema(jSchema)) {
+        return {};
+    }
+
+    String errors;
+    if (schemaMngr.ValidateData(data, errors)) {
+        return Json::JSON::array();
+    }
+
+    return Json::JSON::parse(errors);
+}
+
+inline bool HasErrorAt(const Json::JSON& jErrors, const String& pointer, const String& keyword) {
+    return std::any_of(jErrors.begin(), jErrors.end(), [&pointer, &keyword](const Json::JSON& jError) {
+        return (jError["pointer"] == pointer) && (jError["keyword"] == keyword);
+    });
+}
+
+inline bool ValidateEntriesInParallel() {
+    SPDLOG_INFO("[TEST] Validate entries of big collection in parallel with the same result as serially");
+    SPDLOG_INFO("[BEGIN]");
+    auto jSchema = SessionsSchema("^[a-zA-Z0-9_]+$");
+    auto data = SessionsData(200, "peer");
+    auto jSerialErrors = ValidationErrors(jSchema, data, 0);
+    auto jParallelErrors = ValidationErrors(jSchema, data, 4);
+    if (!jSerialErrors.has_value() || !jParallelErrors.has_value()) {
+        SPDLOG_ERROR("Failed to load the schema");
+        return false;
+    }
+
+    if (jSerialErrors.value() != jParallelErrors.value()) {
+        SPDLOG_ERROR("Parallel validation reported {} instead of {}", jParallelErrors.value().dump(), jSerialErrors.value().dump());
+        return false;
+    }
+
+    const auto& jErrors = jParallelErrors.value();
+    if ((jErrors.size() != 3) || !HasErrorAt(jErrors, "/sessions/peer17/as", "minimum")
+        || !HasErrorAt(jErrors, "/sessions/peer150", "required") || !HasErrorAt(jErrors, "/sessions", "additionalProperties")) {
+        SPDLOG_ERROR("Unexpected validation errors {}", jErrors.dump());
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+
+inline bool ValidateEntriesOfUnsplitCollection() {
+    SPDLOG_INFO("[TEST] Validate entries of collection whose entry name pattern is not split from the document");
+    SPDLOG_INFO("[BEGIN]");
+    auto jErrors = ValidationErrors(SessionsSchema("^peer[0-9]+$"), SessionsData(100, "peer"), 4);
+    if (!jErrors.has_value()) {
+        SPDLOG_ERROR("Failed to load the schema");
+        return false;
+    }
+
+    if (!HasErrorAt(jErrors.value(), "/sessions/peer17/as", "minimum")) {
+        SPDLOG_ERROR("Unexpected validation errors {}", jErrors.value().dump());
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+/*
+    BenchmarkValidateData() measures ValidateData() of the test config with its sessions copied into 20k ones, against
+    the schema of the repo (run it from the root of the repo), by the worker pools of 1 to 16 workers. The first
+    validation of each pool fills the validation cache of the sessions, the second one of the same config hits it.
+*/
+inline void BenchmarkValidateData() {
+    SPDLOG_INFO("[BENCHMARK] Validate the config of 20k BGP sessions by the worker pools of 1 to 16 workers");
+    static constexpr size_t SESSIONS_COUNT = 20'000;
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    std::ifstream configFile("Config/Test/bgp-config-test.json");
+    auto jConfig = Json::JSON::parse(configFile);
+    auto jSession = jConfig["bgp"]["sessions"]["peer2"];
+    auto& jSessions = jConfig["bgp"]["sessions"];
+    jSessions = Json::JSON::object();
+    for (size_t sessionIdx = 0; sessionIdx < SESSIONS_COUNT; ++sessionIdx) {
+        jSession["peer"]["address"] = fmt::format("10.{}.{}.1", sessionIdx >> 8, sessionIdx & 0xff);
+        jSessions["peer" + std::to_string(sessionIdx)] = jSession;
+    }
+
+    auto configText = jConfig.dump();
+    ByteStream data(configText.begin(), configText.end());
+    for (const size_t workersCount : { 1, 2, 4, 8, 16 }) {
+        auto storage = std::make_shared<Storage::JsonFileStorage>("Config/Schemas/bgp-main-config.json", moduleRegistry);
+        JsonSchemaManager schemaMngr(storage, moduleRegistry, std::make_shared<Utils::WorkerPool>(workersCount));
+        if (!schemaMngr.LoadSchema()) {
+            SPDLOG_ERROR("Failed to load the schema of the repo");
+            return;
+        }
+
+        Vector<std::chrono::milliseconds> validationTimes;
+        for (const auto cacheState : { "cold", "warm" }) {
+            auto startTime = std::chrono::steady_clock::now();
+            String errors;
+            if (!schemaMngr.ValidateData(data, errors)) {
+                SPDLOG_ERROR("Failed to validate the config with the {} cache. Errors: {}", cacheState, errors);
+                return;
+            }
+
+            validationTimes.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime));
+        }
+
+        SPDLOG_INFO("{} worker(s) validated the config in {} ms with the cold cache and in {} ms with the warm one", workersCount,
+            validationTimes[0].count(), validationTimes[1].count());
+    }
+}
+} // namespace Schema::Test
@@ -0,0 +1,72 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#include "Test/BirdConfigConverterTest.hpp"
+#include "Test/ConfigChangeClassifierTest.hpp"
+#include "Test/FanOutConfigExecutorTest.hpp"
+#include "Test/IpAddressTest.hpp"
+#include "Test/MetricsTest.hpp"
+#include "Test/MrtReaderTest.hpp"
+#include "Test/PolicyMatchersTest.hpp"
+#include "Test/PolicySimulatorTest.hpp"
+#include "Test/PrefixSetTest.hpp"
+#include "Test/SchemaValidationTest.hpp"
+#include "Test/SubprocessTest.hpp"
+#include "Test/TimerServiceTest.hpp"
+#include "Test/TracingTest.hpp"
+#include "Test/WalStorageTest.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+#include <functional>
+
+namespace Std = StdLib;
+
+int main(const int argc, const char* argv[]) {
+    const Std::Vector<Std::Pair<Std::String, std::function<bool()>>> tests = {
+        { "Utils::Test::ParseAddressesAndPrefixes", Utils::Test::ParseAddressesAndPrefixes },
+        { "Utils::Test::AgreeWithIPv4Pattern", Utils::Test::AgreeWithIPv4Pattern },
+        { "Utils::Test::AggregateKnownPrefixSets", Utils::Test::AggregateKnownPrefixSets },
+        { "Utils::Test::AggregateRandomPrefixSets", Utils::Test::AggregateRandomPrefixSets },
+        { "Utils::Test::QueryRandomPrefixSets", Utils::Test::QueryRandomPrefixSets },
+        { "Utils::Test::MatchReplyCodesOfSubprocess", Utils::Test::MatchReplyCodesOfSubprocess },
+        { "Utils::Test::FireTimersNotBeforeTheirDelay", Utils::Test::FireTimersNotBeforeTheirDelay },
+        { "Utils::Test::FireTimersInOrderAcrossCascades", Utils::Test::FireTimersInOrderAcrossCascades },
+        { "Utils::Test::RepeatTimerEveryInterval", Utils::Test::RepeatTimerEveryInterval },
+        { "Utils::Test::CancelPendingAndFiringTimers", Utils::Test::CancelPendingAndFiringTimers },
+        { "Utils::Test::IgnoreStaleTimerIds", Utils::Test::IgnoreStaleTimerIds },
+        { "Config::Test::ClassifyConfigChanges", Config::Test::ClassifyConfigChanges },
+        { "Config::Test::LoadConfigOnAllInstances", Config::Test::LoadConfigOnAllInstances },
+        { "Config::Test::RollbackConfigOnAllInstances", Config::Test::RollbackConfigOnAllInstances },
+        { "Config::Test::RenderPrefixLists", Config::Test::RenderPrefixLists },
+        { "Config::Test::RenderPolicyDefaultAction", Config::Test::RenderPolicyDefaultAction },
+        { "Config::Test::RenderLargeCommunityConditions", Config::Test::RenderLargeCommunityConditions },
+        { "Metrics::Test::CountLatenciesUpToBounds", Metrics::Test::CountLatenciesUpToBounds },
+        { "Metrics::Test::EscapeRenderedLabelsAndHelp", Metrics::Test::EscapeRenderedLabelsAndHelp },
+        { "Policy::Test::MatchSetsLikeStdSet", Policy::Test::MatchSetsLikeStdSet },
+        { "Policy::Test::ReadTableDumpV2Routes", Policy::Test::ReadTableDumpV2Routes },
+        { "Policy::Test::ReadBgp4mpRoutes", Policy::Test::ReadBgp4mpRoutes },
+        { "Policy::Test::RejectMalformedMrtRecords", Policy::Test::RejectMalformedMrtRecords },
+        { "Policy::Test::SimulateKnownRoutes", Policy::Test::SimulateKnownRoutes },
+        { "Policy::Test::ReadPrefixRanges", Policy::Test::ReadPrefixRanges },
+        { "Schema::Test::ValidateEntriesInParallel", Schema::Test::ValidateEntriesInParallel },
+        { "Schema::Test::ValidateEntriesOfUnsplitCollection", Schema::Test::ValidateEntriesOfUnsplitCollection },
+        { "Tracing::Test::ReadCompleteSpansWhilePushing", Tracing::Test::ReadCompleteSpansWhilePushing },
+        { "Storage::Test::RecoverCommittedDocument", Storage::Test::RecoverCommittedDocument },
+        { "Storage::Test::TruncateTornTail", Storage::Test::TruncateTornTail },
+        { "Storage::Test::CompleteInterruptedCheckpoint", Storage::Test::CompleteInterruptedCheckpoint },
+        { "Storage::Test::CommitWhileCheckpointing", Storage::Test::CommitWhileCheckpointing },
+    };
+
+    size_t failedTests = 0;
+    for (const auto& [name, test] : tests) {
+        if (!test()) {
+            spdlog::error("Test {} failed", name);
+            ++failedTests;
+        }
+    }
+
+    spdlog::info("Passed {} of {} test(s)", tests.size() - failedTests, tests.size());
+    return (failedTests == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
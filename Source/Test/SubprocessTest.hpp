@@ -0,0 +1,60 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/Subprocess.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace Utils::Test {
+using namespace StdLib;
+
+/*
+    Runs the shell scripts printing the replies of 'birdc -v' and checks the result is told by the reply codes at
+    the beginning of the lines: the words like 'error' within the message or on stderr do not fail the command.
+*/
+inline bool MatchReplyCodesOfSubprocess() {
+    SPDLOG_INFO("[TEST] Tell the result of the subprocess by the reply codes at the beginning of its lines");
+    SPDLOG_INFO("[BEGIN]");
+    struct Case {
+        String Script;
+        Subprocess::Status ExpectedStatus;
+        String ExpectedLine;
+    };
+
+    const Vector<Case> cases = {
+        { "printf '0001 BIRD ready.\\n0002 Reading configuration from /etc/bird/error-free.conf\\n0003 Reconfigured\\n'",
+            Subprocess::Status::SUCCESS_MARKER, "0003 Reconfigured" },
+        { "printf '0001 BIRD ready.\\n8002 /etc/bird/bird.conf:3:1 syntax error\\n'", Subprocess::Status::FAILURE_MARKER,
+            "8002 /etc/bird/bird.conf:3:1 syntax error" },
+        { "echo 'Error: the input device is not a TTY' >&2; printf '0020 Configuration OK'", Subprocess::Status::SUCCESS_MARKER,
+            "0020 Configuration OK" },
+        { "printf '0001 BIRD ready.\\n 0003 is not at the beginning\\n'; exit 3", Subprocess::Status::EXITED, "" },
+        { "sleep 5", Subprocess::Status::TIMED_OUT, "" },
+    };
+
+    bool isPassed = true;
+    for (const auto& [script, expectedStatus, expectedLine] : cases) {
+        Subprocess::Options options;
+        options.SuccessMarkers = { "0003", "0020" };
+        options.FailureMarkers = { "8", "9" };
+        options.AreMarkersLinePrefixes = true;
+        options.Timeout = std::chrono::milliseconds(500);
+        options.GracePeriod = std::chrono::milliseconds(100);
+        auto result = Subprocess::Run({ "/bin/sh", "-c", script }, options);
+        if ((result.RunStatus != expectedStatus) || (result.MatchedLine != expectedLine)) {
+            SPDLOG_ERROR("Script '{}' finished with status {} and line '{}' instead of {} and '{}'", script,
+                static_cast<int>(result.RunStatus), result.MatchedLine, static_cast<int>(expectedStatus), expectedLine);
+            isPassed = false;
+        }
+        else if ((expectedStatus == Subprocess::Status::EXITED) && (result.ExitCode != 3)) {
+            SPDLOG_ERROR("Script '{}' exited with code {} instead of 3", script, result.ExitCode);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+} // namespace Utils::Test
@@ -0,0 +1,327 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/StdLib.hpp"
+#include "Lib/TimerService.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <set>
+#include <thread>
+
+namespace Utils::Test {
+using namespace StdLib;
+
+// Clock of the tests, moved only by the test, so the timers of minutes and days are reached at once
+struct ManualClock {
+    using rep = int64_t;
+    using period = std::milli;
+    using duration = std::chrono::milliseconds;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = false;
+
+    static time_point now() { return time_point(duration(sNowMs.load())); }
+
+    static inline std::atomic<int64_t> sNowMs = 0;
+};
+
+using ManualTimerService = BasicTimerService<ManualClock>;
+
+// Labels of the fired timers with the times (in ms of the clock of the service) they have fired at
+class FiredTimers {
+public:
+    void Record(const int64_t label, const int64_t timeMs) {
+        LockGuard<Mutex> lock(mMutex);
+        mTimers.emplace_back(label, timeMs);
+    }
+
+    size_t Count() {
+        LockGuard<Mutex> lock(mMutex);
+        return mTimers.size();
+    }
+
+    Vector<Pair<int64_t, int64_t>> Timers() {
+        LockGuard<Mutex> lock(mMutex);
+        return mTimers;
+    }
+
+private:
+    Mutex mMutex;
+    Vector<Pair<int64_t, int64_t>> mTimers;
+};
+
+// WaitForFiredTimers() waits (in the real time) until the given number of timers have fired
+inline bool WaitForFiredTimers(FiredTimers& firedTimers, const size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (firedTimers.Count() < count) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+// MoveManualClock() sets the manual clock and gives the worker, which checks it every 1 ms, the time to catch up
+inline void MoveManualClock(const int64_t startMs, const int64_t elapsedMs) {
+    ManualClock::sNowMs = startMs + elapsedMs;
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+}
+
+/*
+    Timers of the random delays below and above the span of the level 0 (256 ms) run by the steady clock, and each
+    one must fire no earlier than its delay after it has been scheduled.
+*/
+inline bool FireTimersNotBeforeTheirDelay() {
+    SPDLOG_INFO("[TEST] Fire the timers not before their delays");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr size_t TIMERS_COUNT = 300;
+    using Clock = TimerService::Clock;
+    std::mt19937 random(2025);
+    std::atomic<size_t> earlyCount = 0;
+    std::atomic<size_t> firedCount = 0;
+    {
+        TimerService timerService;
+        for (size_t timerIdx = 0; timerIdx < TIMERS_COUNT; ++timerIdx) {
+            auto delay = std::chrono::milliseconds(random() % 300);
+            auto expiryTime = Clock::now() + delay;
+            timerService.Once(delay, [&earlyCount, &firedCount, expiryTime]() {
+                earlyCount += (Clock::now() < expiryTime) ? 1 : 0;
+                ++firedCount;
+            });
+        }
+
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        while ((firedCount < TIMERS_COUNT) && (Clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    SPDLOG_INFO("Fired {} of {} timers, {} of them early", firedCount.load(), TIMERS_COUNT, earlyCount.load());
+    SPDLOG_INFO("[END]");
+    return (firedCount == TIMERS_COUNT) && (earlyCount == 0);
+}
+
+/*
+    Timers placed in every level of the wheel (below and above 256 ms, 65536 ms and 16777216 ms) must be cascaded
+    down and fired in the order of their delays, each one exactly at its tick: the clock stops 1 ms before every
+    expiry, so the timer fired early is seen at the wrong time.
+*/
+inline bool FireTimersInOrderAcrossCascades() {
+    SPDLOG_INFO("[TEST] Fire the timers of all levels of the wheel in the order of their delays");
+    SPDLOG_INFO("[BEGIN]");
+    Vector<int64_t> delaysMs = { 1, 2, 255, 256, 257, 511, 512, 65535, 65536, 65537, 70000, 131072, 16777215, 16777216, 16777217, 20000000 };
+    std::mt19937 random(2025);
+    for (int i = 0; i < 100; ++i) {
+        delaysMs.push_back(1 + random() % 200000);
+    }
+
+    auto startMs = ManualClock::sNowMs.load();
+    FiredTimers firedTimers;
+    ManualTimerService timerService;
+    for (const auto delayMs : delaysMs) {
+        timerService.Once(std::chrono::milliseconds(delayMs), [&firedTimers, delayMs, startMs]() {
+            firedTimers.Record(delayMs, ManualClock::sNowMs.load() - startMs);
+        });
+    }
+
+    bool isPassed = true;
+    std::set<int64_t> expiriesMs(delaysMs.begin(), delaysMs.end());
+    for (const auto expiryMs : expiriesMs) {
+        MoveManualClock(startMs, expiryMs - 1);
+        MoveManualClock(startMs, expiryMs);
+        auto expectedCount = static_cast<size_t>(std::ranges::count_if(delaysMs, [expiryMs](const int64_t delayMs) { return delayMs <= expiryMs; }));
+        if (!WaitForFiredTimers(firedTimers, expectedCount)) {
+            SPDLOG_ERROR("Fired {} timers instead of {} by {} ms", firedTimers.Count(), expectedCount, expiryMs);
+            isPassed = false;
+            break;
+        }
+    }
+
+    int64_t lastDelayMs = 0;
+    for (const auto& [delayMs, firedAtMs] : firedTimers.Timers()) {
+        if ((delayMs < lastDelayMs) || (firedAtMs != delayMs)) {
+            SPDLOG_ERROR("Timer of {} ms fired at {} ms after the timer of {} ms", delayMs, firedAtMs, lastDelayMs);
+            isPassed = false;
+        }
+
+        lastDelayMs = delayMs;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed && (firedTimers.Count() == delaysMs.size());
+}
+
+// The repeating timer must fire once every interval, and not any more once it is cancelled
+inline bool RepeatTimerEveryInterval() {
+    SPDLOG_INFO("[TEST] Fire the repeating timer every interval until it is cancelled");
+    SPDLOG_INFO("[BEGIN]");
+    auto startMs = ManualClock::sNowMs.load();
+    FiredTimers firedTimers;
+    ManualTimerService timerService;
+    auto timerId = timerService.Repeat(std::chrono::milliseconds(100), [&firedTimers, startMs]() {
+        firedTimers.Record(0, ManualClock::sNowMs.load() - startMs);
+    });
+
+    bool isPassed = true;
+    for (int64_t repeatIdx = 1; repeatIdx <= 10; ++repeatIdx) {
+        MoveManualClock(startMs, repeatIdx * 100 - 1);
+        MoveManualClock(startMs, repeatIdx * 100);
+        isPassed = WaitForFiredTimers(firedTimers, static_cast<size_t>(repeatIdx)) && isPassed;
+    }
+
+    timerService.Cancel(timerId);
+    MoveManualClock(startMs, 1500);
+    auto timers = firedTimers.Timers();
+    for (size_t timerIdx = 0; timerIdx < timers.size(); ++timerIdx) {
+        if (timers[timerIdx].second != static_cast<int64_t>(timerIdx + 1) * 100) {
+            SPDLOG_ERROR("Repeating timer fired for the {}. time at {} ms", timerIdx + 1, timers[timerIdx].second);
+            isPassed = false;
+        }
+    }
+
+    SPDLOG_INFO("Repeating timer fired {} time(s)", timers.size());
+    SPDLOG_INFO("[END]");
+    return isPassed && (timers.size() == 10);
+}
+
+/*
+    Cancelled pending timers (of the level 0 and of the higher level) must not fire, and the timer cancelled from its
+    own callback must not be repeated. The timers scheduled after that must still fire.
+*/
+inline bool CancelPendingAndFiringTimers() {
+    SPDLOG_INFO("[TEST] Cancel the pending timers and the timers from their own callbacks");
+    SPDLOG_INFO("[BEGIN]");
+    auto startMs = ManualClock::sNowMs.load();
+    FiredTimers firedTimers;
+    ManualTimerService timerService;
+    auto recordTimer = [&firedTimers](const int64_t label) {
+        return [&firedTimers, label]() { firedTimers.Record(label, ManualClock::sNowMs.load()); };
+    };
+
+    auto cancelledTimerId = timerService.Once(std::chrono::milliseconds(100), recordTimer(1));
+    timerService.Once(std::chrono::milliseconds(100), recordTimer(2));
+    auto cancelledFarTimerId = timerService.Once(std::chrono::milliseconds(70000), recordTimer(3));
+    std::atomic<TimerService::TimerId> selfCancelledTimerId = 0;
+    selfCancelledTimerId = timerService.Repeat(std::chrono::milliseconds(50), [&timerService, &firedTimers, &selfCancelledTimerId]() {
+        firedTimers.Record(4, ManualClock::sNowMs.load());
+        timerService.Cancel(selfCancelledTimerId);
+    });
+
+    timerService.Cancel(cancelledTimerId);
+    timerService.Cancel(cancelledFarTimerId);
+    timerService.Cancel(cancelledFarTimerId);
+    for (const int64_t elapsedMs : { 50, 100, 150, 200, 70000 }) {
+        MoveManualClock(startMs, elapsedMs);
+    }
+
+    timerService.Once(std::chrono::milliseconds(10), recordTimer(5));
+    MoveManualClock(startMs, 70010);
+    bool isPassed = WaitForFiredTimers(firedTimers, 3);
+    std::multiset<int64_t> labels;
+    for (const auto& [label, firedAtMs] : firedTimers.Timers()) {
+        labels.insert(label);
+    }
+
+    if (labels != std::multiset<int64_t> { 2, 4, 5 }) {
+        SPDLOG_ERROR("Fired {} timer(s) instead of the timers 2, 4 and 5 only", labels.size());
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+/*
+    The node of the fired timer is reused by the next timer, so the id of the fired timer differs from the new one
+    only by the generation, and cancelling by the stale id must not cancel the new timer.
+*/
+inline bool IgnoreStaleTimerIds() {
+    SPDLOG_INFO("[TEST] Ignore the stale ids of the timers whose nodes are reused");
+    SPDLOG_INFO("[BEGIN]");
+    auto startMs = ManualClock::sNowMs.load();
+    FiredTimers firedTimers;
+    ManualTimerService timerService;
+    auto staleTimerId = timerService.Once(std::chrono::milliseconds(10), [&firedTimers]() { firedTimers.Record(1, 0); });
+    MoveManualClock(startMs, 10);
+    bool isPassed = WaitForFiredTimers(firedTimers, 1);
+    auto timerId = timerService.Once(std::chrono::milliseconds(10), [&firedTimers]() { firedTimers.Record(2, 0); });
+    if ((static_cast<uint32_t>(timerId) != static_cast<uint32_t>(staleTimerId)) || (timerId == staleTimerId)) {
+        SPDLOG_ERROR("New timer {:#x} does not reuse the node of the fired timer {:#x}", timerId, staleTimerId);
+        isPassed = false;
+    }
+
+    timerService.Cancel(staleTimerId);
+    MoveManualClock(startMs, 20);
+    if (!WaitForFiredTimers(firedTimers, 2)) {
+        SPDLOG_ERROR("New timer has been cancelled by the stale id");
+        isPassed = false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return isPassed;
+}
+
+// BenchmarkTimerService() measures Once() and Cancel() of 1M timers, and how late 1M timers spread over 1 s fire
+inline void BenchmarkTimerService() {
+    SPDLOG_INFO("[BENCHMARK] Schedule, cancel and fire 1M timers of the timer service");
+    static constexpr size_t TIMERS_COUNT = 1000000;
+    using Clock = TimerService::Clock;
+    std::mt19937 random(2025);
+    {
+        // Delays up to 1 hour, so the timers are spread over all levels of the wheel and none fires
+        TimerService timerService;
+        Vector<TimerService::TimerId> timerIds(TIMERS_COUNT);
+        auto start = Clock::now();
+        for (auto& timerId : timerIds) {
+            timerId = timerService.Once(std::chrono::milliseconds(1000 + random() % 3600000), []() {});
+        }
+
+        auto scheduleTime = Clock::now() - start;
+        std::ranges::shuffle(timerIds, random);
+        start = Clock::now();
+        for (const auto timerId : timerIds) {
+            timerService.Cancel(timerId);
+        }
+
+        auto cancelTime = Clock::now() - start;
+        SPDLOG_INFO("Once(): {} ns per timer, Cancel(): {} ns per timer",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(scheduleTime).count() / TIMERS_COUNT,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(cancelTime).count() / TIMERS_COUNT);
+    }
+
+    // The timers fire 1 to 2 s after scheduling, so all of them are scheduled before the first one fires. The worker
+    // writes the lateness of each timer, and the benchmark reads it once all of them have fired
+    Vector<int64_t> latenessesUs(TIMERS_COUNT);
+    std::atomic<size_t> firedCount = 0;
+    {
+        TimerService timerService;
+        auto start = Clock::now();
+        for (size_t timerIdx = 0; timerIdx < TIMERS_COUNT; ++timerIdx) {
+            auto delay = std::chrono::milliseconds(1000 + random() % 1000);
+            auto expiryTime = Clock::now() + delay;
+            timerService.Once(delay, [&latenessesUs, &firedCount, timerIdx, expiryTime]() {
+                latenessesUs[timerIdx] = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - expiryTime).count();
+                firedCount.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        while (firedCount.load(std::memory_order_acquire) < TIMERS_COUNT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        auto fireTime = Clock::now() - start;
+        std::ranges::sort(latenessesUs);
+        SPDLOG_INFO("Fired {} timers in {} ms, lateness: median {} us, p99 {} us, max {} us (min {} us)", TIMERS_COUNT,
+            std::chrono::duration_cast<std::chrono::milliseconds>(fireTime).count(), latenessesUs[TIMERS_COUNT / 2],
+            latenessesUs[TIMERS_COUNT * 99 / 100], latenessesUs.back(), latenessesUs.front());
+    }
+}
+} // namespace Utils::Test
@@ -0,0 +1,84 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/Tracing.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <thread>
+
+namespace Tracing::Test {
+using namespace StdLib;
+
+// MakeRecord() fills every field of the record from the single value, so the record mixed from two writes is told apart
+inline SpanRecord MakeRecord(const uint64_t value) {
+    SpanRecord record;
+    record.RequestId = value;
+    record.StartNs = value;
+    record.DurationNs = ~value;
+    record.SpanId = static_cast<uint32_t>(value);
+    record.ParentSpanId = static_cast<uint32_t>(value >> 32);
+    record.ThreadId = static_cast<uint32_t>(~value);
+    std::memset(record.Name, 'a' + static_cast<int>(value % 26), SpanRecord::MAX_NAME_SIZE - 1);
+    return record;
+}
+
+// IsRecordConsistent() compares the fields one by one, as the padding of the record is not copied reliably
+inline bool IsRecordConsistent(const SpanRecord& record) {
+    auto expectedRecord = MakeRecord(record.RequestId);
+    return (record.StartNs == expectedRecord.StartNs) && (record.DurationNs == expectedRecord.DurationNs) && (record.SpanId == expectedRecord.SpanId)
+        && (record.ParentSpanId == expectedRecord.ParentSpanId) && (record.ThreadId == expectedRecord.ThreadId)
+        && (std::memcmp(record.Name, expectedRecord.Name, SpanRecord::MAX_NAME_SIZE) == 0);
+}
+
+/*
+    Many writers push into the ring of only 4 slots, so they keep lapping it onto the same slots, while the reader
+    takes the records all the time. Every record read must be the complete record of single write.
+*/
+inline bool ReadCompleteSpansWhilePushing() {
+    SPDLOG_INFO("[TEST] Read only complete spans from the ring while many threads overwrite it");
+    SPDLOG_INFO("[BEGIN]");
+    static constexpr size_t WRITERS_COUNT = 8;
+    static constexpr uint64_t RECORDS_PER_WRITER_COUNT = 100000;
+
+    SpanRing ring(4);
+    std::atomic<bool> isStarted = false;
+    std::atomic<size_t> runningWritersCount = WRITERS_COUNT;
+    Vector<std::thread> writers;
+    for (size_t writerIdx = 0; writerIdx < WRITERS_COUNT; ++writerIdx) {
+        writers.emplace_back([&ring, &isStarted, &runningWritersCount, writerIdx]() {
+            while (!isStarted) {
+                std::this_thread::yield();
+            }
+
+            for (uint64_t recordIdx = 0; recordIdx < RECORDS_PER_WRITER_COUNT; ++recordIdx) {
+                ring.Push(MakeRecord((uint64_t(writerIdx) << 40) | recordIdx));
+            }
+
+            --runningWritersCount;
+        });
+    }
+
+    size_t readCount = 0;
+    size_t tornCount = 0;
+    isStarted = true;
+    bool isWriting = true;
+    do {
+        isWriting = (runningWritersCount > 0);
+        for (const auto& record : ring.Records()) {
+            ++readCount;
+            tornCount += IsRecordConsistent(record) ? 0 : 1;
+        }
+    } while (isWriting);
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    SPDLOG_INFO("Read {} spans, {} of them torn", readCount, tornCount);
+    SPDLOG_INFO("[END]");
+    return (tornCount == 0) && (ring.PushedCount() == WRITERS_COUNT * RECORDS_PER_WRITER_COUNT);
+}
+} // namespace Tracing::Test
@@ -0,0 +1,232 @@
+/** @copyright Copyright (C) 2025 Pawel Maslanka (pawmas@hotmail.com)
+ *  @license The GNU General Public License v3.0
+ */
+#pragma once
+
+#include "Lib/ModuleRegistry.hpp"
+#include "Modules.hpp"
+#include "JsonWalStorage.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <filesystem>
+#include <unistd.h>
+
+namespace Storage::Test {
+using namespace StdLib;
+
+// Directory removed together with all of the files the storage has left in it
+class ScopedTestDir {
+public:
+    explicit ScopedTestDir(const String& name)
+      : mPath(std::filesystem::temp_directory_path() / (name + "-" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(mPath);
+        std::filesystem::create_directories(mPath);
+    }
+    ~ScopedTestDir() {
+        std::error_code errCode = {};
+        std::filesystem::remove_all(mPath, errCode);
+    }
+
+    String File(const String& fileName) const { return (mPath / fileName).string(); }
+
+private:
+    const std::filesystem::path mPath;
+};
+
+inline bool WriteJsonFile(const String& fileName, const Json::JSON& jData) {
+    OFStream file(fileName, std::ios::trunc);
+    file << jData.dump();
+    return file.good();
+}
+
+inline ByteStream ToByteStream(const Json::JSON& jData) {
+    auto jStrData = jData.dump();
+    return ByteStream(jStrData.begin(), jStrData.end());
+}
+
+inline Optional<Json::JSON> LoadJson(IDataStorage& storage) {
+    auto data = storage.LoadData();
+    if (!data.has_value()) {
+        return {};
+    }
+
+    return Json::JSON::parse(data.value());
+}
+
+inline bool RecoverCommittedDocument() {
+    SPDLOG_INFO("[TEST] Recover the document from the checkpoint and the write-ahead log");
+    SPDLOG_INFO("[BEGIN]");
+    ScopedTestDir testDir("WalRecover");
+    const auto configFileName = testDir.File("config.json");
+    WriteJsonFile(configFileName, { { "counter", 0 } });
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    JsonWalStorage::Options options;
+    options.CheckpointRecords = 4;
+    {
+        JsonWalStorage storage(configFileName, moduleRegistry, options);
+        if (!LoadJson(storage).has_value()) {
+            SPDLOG_ERROR("Failed to load the initial document");
+            return false;
+        }
+
+        for (int i = 1; i <= 10; ++i) {
+            if (!storage.SaveData(ToByteStream({ { "counter", i } }))) {
+                SPDLOG_ERROR("Failed to save document #{}", i);
+                return false;
+            }
+        }
+    }
+
+    JsonWalStorage storage(configFileName, moduleRegistry, options);
+    auto jData = LoadJson(storage);
+    if (!jData.has_value() || (jData.value()["counter"] != 10)) {
+        SPDLOG_ERROR("Recovered document is {} instead of the last saved one", jData.has_value() ? jData.value().dump() : "none");
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+
+inline bool TruncateTornTail() {
+    SPDLOG_INFO("[TEST] Skip torn record at the end of the write-ahead log");
+    SPDLOG_INFO("[BEGIN]");
+    ScopedTestDir testDir("WalTornTail");
+    const auto configFileName = testDir.File("config.json");
+    WriteJsonFile(configFileName, { { "counter", 0 } });
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    JsonWalStorage::Options options;
+    options.CheckpointRecords = 1000;
+    String walFileName;
+    {
+        JsonWalStorage storage(configFileName, moduleRegistry, options);
+        walFileName = storage.WalURI();
+        LoadJson(storage);
+        storage.SaveData(ToByteStream({ { "counter", 1 } }));
+        storage.SaveData(ToByteStream({ { "counter", 2 } }));
+    }
+
+    const auto walSize = std::filesystem::file_size(walFileName);
+    {
+        // Record header promising more payload than there is, as if the process had died in the middle of append
+        OFStream walFile(walFileName, std::ios::binary | std::ios::app);
+        const uint32_t tornRecordHeader[] = { 1024, 0 };
+        walFile.write(reinterpret_cast<const char*>(tornRecordHeader), sizeof(tornRecordHeader));
+        walFile << "[{\"op\":";
+    }
+
+    JsonWalStorage storage(configFileName, moduleRegistry, options);
+    auto jData = LoadJson(storage);
+    if (!jData.has_value() || (jData.value()["counter"] != 2)) {
+        SPDLOG_ERROR("Recovered document is {} instead of the last saved one", jData.has_value() ? jData.value().dump() : "none");
+        return false;
+    }
+
+    if (std::filesystem::file_size(walFileName) != walSize) {
+        SPDLOG_ERROR("Torn tail of the write-ahead log has not been truncated");
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+
+inline bool CompleteInterruptedCheckpoint() {
+    SPDLOG_INFO("[TEST] Complete the checkpoint interrupted between renaming the checkpoint and the log");
+    SPDLOG_INFO("[BEGIN]");
+    ScopedTestDir testDir("WalInterruptedCheckpoint");
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    JsonWalStorage::Options options;
+    options.CheckpointRecords = 1000;
+    // The new checkpoint with its log, as the background checkpoint would have written them
+    const auto newConfigFileName = testDir.File("new.json");
+    WriteJsonFile(newConfigFileName, { { "counter", 1 } });
+    String newWalFileName;
+    {
+        JsonWalStorage storage(newConfigFileName, moduleRegistry, options);
+        newWalFileName = storage.WalURI();
+        LoadJson(storage);
+        storage.SaveData(ToByteStream({ { "counter", 2 } }));
+    }
+
+    // The old log which does not belong to the new checkpoint
+    const auto configFileName = testDir.File("config.json");
+    WriteJsonFile(configFileName, { { "counter", 0 } });
+    String walFileName;
+    {
+        JsonWalStorage storage(configFileName, moduleRegistry, options);
+        walFileName = storage.WalURI();
+        LoadJson(storage);
+        storage.SaveData(ToByteStream({ { "counter", 1 } }));
+    }
+
+    std::filesystem::copy_file(newConfigFileName, configFileName, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::copy_file(newWalFileName, walFileName + ".next");
+    JsonWalStorage storage(configFileName, moduleRegistry, options);
+    auto jData = LoadJson(storage);
+    if (!jData.has_value() || (jData.value()["counter"] != 2)) {
+        SPDLOG_ERROR("Recovered document is {} instead of the last saved one", jData.has_value() ? jData.value().dump() : "none");
+        return false;
+    }
+
+    if (std::filesystem::exists(walFileName + ".next")) {
+        SPDLOG_ERROR("Log of the interrupted checkpoint has not been renamed in place");
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+
+inline bool CommitWhileCheckpointing() {
+    SPDLOG_INFO("[TEST] Commit concurrently while the background checkpoints fold the log");
+    SPDLOG_INFO("[BEGIN]");
+    ScopedTestDir testDir("WalConcurrentCommits");
+    const auto configFileName = testDir.File("config.json");
+    WriteJsonFile(configFileName, { { "writer", -1 }, { "counter", 0 } });
+    auto moduleRegistry = std::make_shared<ModuleRegistry>();
+    JsonWalStorage::Options options;
+    options.CheckpointRecords = 8;
+    constexpr int WRITERS_COUNT = 4;
+    constexpr int COMMITS_PER_WRITER = 50;
+    Json::JSON jLastData;
+    {
+        JsonWalStorage storage(configFileName, moduleRegistry, options);
+        LoadJson(storage);
+        std::atomic<int> failedCommits = 0;
+        Vector<Thread> writers;
+        for (int writer = 0; writer < WRITERS_COUNT; ++writer) {
+            writers.emplace_back([&storage, &failedCommits, writer]() {
+                for (int i = 1; i <= COMMITS_PER_WRITER; ++i) {
+                    if (!storage.SaveData(ToByteStream({ { "writer", writer }, { "counter", i } }))) {
+                        ++failedCommits;
+                    }
+                }
+            });
+        }
+
+        for (auto& writer : writers) {
+            writer.join();
+        }
+
+        if (failedCommits > 0) {
+            SPDLOG_ERROR("{} commit(s) failed", failedCommits.load());
+            return false;
+        }
+
+        jLastData = LoadJson(storage).value_or(Json::JSON());
+    }
+
+    JsonWalStorage storage(configFileName, moduleRegistry, options);
+    auto jData = LoadJson(storage);
+    if (!jData.has_value() || (jData.value() != jLastData) || (jLastData["counter"] != COMMITS_PER_WRITER)) {
+        SPDLOG_ERROR("Recovered document is {} instead of {}", jData.has_value() ? jData.value().dump() : "none", jLastData.dump());
+        return false;
+    }
+
+    SPDLOG_INFO("[END]");
+    return true;
+}
+} // namespace Storage::Test